@@ -1,417 +1,658 @@
 /******************************************************************************
-Filename    : benchmark.c
+Filename    : rme_benchmark.c
 Author      : pry
 Date        : 04/09/2017
 Licence     : The Unlicense; see LICENSE for details.
-Description : The benchmark file for RME.
+Description : The benchmark of RME. This runs as the init process, measures the
+              user-level latency of the most frequently used kernel operations,
+              and leaves the results in RME_Bench_Result, where they can be read
+              out with a debugger when RME_Bench_Plat_Done is called.
+              Everything specific to a platform, including the timestamp counter,
+              lives in the header that "rme_benchmark_platform.h" includes and
+              in the matching rme_benchmark_<platform>.c; the project provides
+              "rme_benchmark_platform.h", just as it provides "rme_platform.h".
 ******************************************************************************/
 
-/* Defines *******************************************************************/
-/* Types */
-typedef signed int  s32;
-typedef signed short s16;
-typedef signed char  s8;
-typedef unsigned int  u32;
-typedef unsigned short u16;
-typedef unsigned char  u8;
-typedef s32 tid_t;
-typedef u32 ptr_t;
-typedef s32 cnt_t;
-typedef s32 cid_t;
-typedef s32 ret_t;
-
-#define BENCHMARK_STACK_SIZE 4096
-/* System service stub */
-#define RME_CAP_OP(OP,CAPID,ARG1,ARG2,ARG3) RME_Svc(((OP)<<(sizeof(ptr_t)*4)|(CAPID)),ARG1,ARG2,ARG3)
-#define RME_PARAM_D_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*4))
-#define RME_PARAM_Q_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*6))
-#define RME_PARAM_O_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*7))
-/* The parameter passing - not to be confused with kernel macros. These macros just place the parameters */
-#define RME_PARAM_D1(X)                     (((X)&RME_PARAM_D_MASK)<<(sizeof(ptr_t)*4))
-#define RME_PARAM_D0(X)                     ((X)&RME_PARAM_D_MASK)
-
-#define RME_PARAM_Q3(X)                     (((X)&RME_PARAM_Q_MASK)<<(sizeof(ptr_t)*6))
-#define RME_PARAM_Q2(X)                     (((X)&RME_PARAM_Q_MASK)<<(sizeof(ptr_t)*4))
-#define RME_PARAM_Q1(X)                     (((X)&RME_PARAM_Q_MASK)<<(sizeof(ptr_t)*2))
-#define RME_PARAM_Q0(X)                     ((X)&RME_PARAM_Q_MASK)
-
-#define RME_PARAM_O7(X)                     (((X)&RME_PARAM_O_MASK)<<(sizeof(ptr_t)*7))
-#define RME_PARAM_O6(X)                     (((X)&RME_PARAM_O_MASK)<<(sizeof(ptr_t)*6))
-#define RME_PARAM_O5(X)                     (((X)&RME_PARAM_O_MASK)<<(sizeof(ptr_t)*5))
-#define RME_PARAM_O4(X)                     (((X)&RME_PARAM_O_MASK)<<(sizeof(ptr_t)*4))
-#define RME_PARAM_O3(X)                     (((X)&RME_PARAM_O_MASK)<<(sizeof(ptr_t)*3))
-#define RME_PARAM_O2(X)                     (((X)&RME_PARAM_O_MASK)<<(sizeof(ptr_t)*2))
-#define RME_PARAM_O1(X)                     (((X)&RME_PARAM_O_MASK)<<(sizeof(ptr_t)*1))
-#define RME_PARAM_O0(X)                     ((X)&RME_PARAM_O_MASK)
-
-/* Initial boot capabilities - This should be in accordnace with the kernel settings */
-/* The capability table of the init process */
-#define RME_BOOT_CAPTBL          0
-/* The top-level page table of the init process - always 4GB full range split into 8 pages */
-#define RME_BOOT_PGTBL           1
-/* The top-level page table of the init process's SRAM */
-#define RME_BOOT_PGTBL_SRAM      2
-/* The init process */
-#define RME_BOOT_INIT_PROC       3
-/* The init thread */
-#define RME_BOOT_INIT_THD        4
-/* The initial kernel function capability */
-#define RME_BOOT_INIT_KERN       5
-/* The initial kernel memory capability */
-#define RME_BOOT_INIT_KMEM       6
-/* The initial timer endpoint */
-#define RME_BOOT_INIT_TIMER      7
-
-/* The test objects */
-#define RME_BOOT_BENCH_THD       8
-#define RME_BOOT_BENCH_PGTBL_TOP 9
-#define RME_BOOT_BENCH_PGTBL_SRAM 10
-
-/* Need to export the memory frontier! */
-/* Need to export the flags as well ! */
-/* Export the errno too */
-#define RME_BOOT_BENCH_KMEM_FRONTIER 0x10005000
-
-/* The stack safe size */
-#define RME_STACK_SAFE_SIZE 16
-
-#define RME_TSC() TIM2->CNT
-
-/* Need to export the system priority limit! */
-struct RME_CMX_Ret_Stack
-{
-    /* Normal registers */
-    ptr_t R0;
-    ptr_t R1;
-    ptr_t R2;
-    ptr_t R3;
-    ptr_t R12;
-    ptr_t LR;
-    ptr_t PC;
-    ptr_t XPSR;
-    /* FPU registers follow - no matter they are used or not, we reserve the space
-     * in stack creation */
-    ptr_t S0;
-    ptr_t S1;
-    ptr_t S2;
-    ptr_t S3;
-    ptr_t S4;
-    ptr_t S5;
-    ptr_t S6;
-    ptr_t S7;
-    ptr_t S8;
-    ptr_t S9;
-    ptr_t S10;
-    ptr_t S11;
-    ptr_t S12;
-    ptr_t S13;
-    ptr_t S14;
-    ptr_t S15;
-};
-/* End Defines ***************************************************************/
-
 /* Includes ******************************************************************/
-#include "RME.h"
-#include "stm32f4xx.h"
-/* Need to export error codes, and size of each object, in words! */
+#include "rme_benchmark_platform.h"
+#include "rme_benchmark.h"
+#include "rme.h"
 /* End Includes **************************************************************/
 
+/* Defines *******************************************************************/
+/* The benchmark capability table, in the capability table of the init process.
+ * The second process shares the capability table of the init process, so all
+ * the objects below can be reached from both processes with the same ID */
+#define RME_BENCH_CAPTBL                    8
+#define RME_BENCH_CAPTBL_NUM                16
+#define RME_BENCH_CAP(X)                    RME_CAPID(RME_BENCH_CAPTBL,X)
+/* The test objects in the benchmark capability table */
+#define RME_BENCH_THD_SWT                   0
+#define RME_BENCH_THD_SWT_PROC              1
+#define RME_BENCH_THD_RCV                   2
+#define RME_BENCH_THD_RCV_PROC              3
+#define RME_BENCH_SIG                       4
+#define RME_BENCH_SIG_RCV                   5
+#define RME_BENCH_SIG_RCV_PROC              6
+#define RME_BENCH_INV                       7
+#define RME_BENCH_INV_PROC                  8
+#define RME_BENCH_PROC                      9
+#define RME_BENCH_PGTBL_PROC                10
+#define RME_BENCH_PGTBL_MAP                 11
+#define RME_BENCH_CAPTBL_ADD                12
+#define RME_BENCH_CAPTBL_CRT                13
+
+/* The stacks of the threads and invocations, one for each */
+#define RME_BENCH_STACK_NUM                 6
+#define RME_BENCH_STACK_WORDS               1024
+/* A capability slot is 8 words on all platforms */
+#define RME_BENCH_CAP_SIZE                  (8*sizeof(ptr_t))
+/* Threads that want infinite budget ask for this much time */
+#define RME_BENCH_INF_TIME                  ((((ptr_t)(-1))>>1)-1)
+/* The priority of the receiving threads, so that a send preempts the sender */
+#define RME_BENCH_RCV_PRIO                  1
+/* End Defines ***************************************************************/
+
 /* Private Variables *********************************************************/
-/* The stack of the threads - enough for 4 threads */
-ptr_t RME_Stack[2048];
-u16 Time[10000];
-s8 RME_Bench_Buf[1024];
+/* The stacks of the threads and invocations */
+ptr_t RME_Bench_Stack[RME_BENCH_STACK_NUM][RME_BENCH_STACK_WORDS];
+/* Where the next kernel memory search starts */
+ptr_t RME_Bench_Kmem_Cur;
+/* The summary of all tests */
+struct RME_Bench_Result RME_Bench_Result;
 /* End Private Variables *****************************************************/
 
 /* Function Prototypes *******************************************************/
-extern ret_t RME_Svc(ptr_t Svc_Capid,ptr_t Param1, ptr_t Param2, ptr_t Param3);
-extern cnt_t RME_Sprint_Uint(s8* Buffer,u32 Arg_Int);
-extern void RME_Thd_Stub(void);
-extern void RME_Inv_Stub(void);
-ptr_t _RME_Stack_Init(ptr_t Stack, ptr_t Stub, ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4);
-void RME_Benchmark(void);
-void RME_Same_Proc_Thd_Switch_Test_Thd(ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4);
-void RME_Same_Proc_Thd_Switch_Test(void);
+ptr_t RME_Bench_Kmem(ptr_t Size, ptr_t Align_Order);
+void RME_Bench_Check(ret_t Retval);
+void RME_Bench_Stat_Init(struct RME_Bench_Stat* Stat);
+void RME_Bench_Stat_Add(struct RME_Bench_Stat* Stat, ptr_t Time, ret_t Retval);
+void RME_Bench_Stat_End(struct RME_Bench_Stat* Stat);
+void RME_Bench_Swt_Thd(ptr_t Param);
+void RME_Bench_Rcv_Thd(ptr_t Param);
+void RME_Bench_Inv_Entry(ptr_t Param);
+void RME_Bench_Thd_Crt(ptr_t Thd, cid_t Cap_Proc, ptr_t Prio, ptr_t Entry, ptr_t Param, ptr_t Stack);
+void RME_Bench_Inv_Crt(ptr_t Inv, cid_t Cap_Proc, ptr_t Stack);
+void RME_Bench_Init(void);
+void RME_Bench_TSC_Test(void);
+void RME_Bench_Sig_Snd_Test(void);
+void RME_Bench_Thd_Swt_Test(struct RME_Bench_Stat* Stat, cid_t Cap_Thd);
+void RME_Bench_Inv_Test(struct RME_Bench_Stat* Stat, cid_t Cap_Inv);
+void RME_Bench_Sig_Rcv_Test(struct RME_Bench_Stat* Stat, cid_t Cap_Sig);
+void RME_Bench_Captbl_Crt_Test(void);
+void RME_Bench_Captbl_Add_Test(void);
+void RME_Bench_Pgtbl_Test(void);
+void RME_Benchmark(ptr_t CPUID);
 /* End Function Prototypes ***************************************************/
 
-/* Begin Function:_RME_Tsc_Init ***********************************************
-Description : The initialization of timestamp counter. 19 secs before overflowing.
+/* Begin Function:RME_Bench_Kmem **********************************************
+Description : Find some free kernel memory for a test object. We are the only one
+              creating kernel objects, so the range found will stay free until we
+              create the object there; the next search starts after it.
+Input       : ptr_t Size - The size of the memory needed.
+              ptr_t Align_Order - The alignment of the memory, in powers of 2.
+Output      : None.
+Return      : ptr_t - The relative address of the memory in RME_BENCH_KMEM.
+******************************************************************************/
+ptr_t RME_Bench_Kmem(ptr_t Size, ptr_t Align_Order)
+{
+    ret_t Raddr;
+
+    Raddr=RME_CAP_OP(RME_SVC_KMEM_FIND,RME_BENCH_KMEM,
+                     Size,
+                     RME_Bench_Kmem_Cur,
+                     Align_Order);
+    RME_Bench_Check(Raddr);
+    if(Raddr<0)
+        return 0;
+
+    RME_Bench_Kmem_Cur=((ptr_t)Raddr)+Size;
+    return (ptr_t)Raddr;
+}
+/* End Function:RME_Bench_Kmem ***********************************************/
+
+/* Begin Function:RME_Bench_Check *********************************************
+Description : Count the failed system calls when creating the test objects.
+Input       : ret_t Retval - The return value of the system call.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Check(ret_t Retval)
+{
+    if(Retval<0)
+        RME_Bench_Result.Setup_Fail++;
+}
+/* End Function:RME_Bench_Check **********************************************/
+
+/* Begin Function:RME_Bench_Stat_Init *****************************************
+Description : Clear the statistics of a test before it starts.
+Input       : None.
+Output      : struct RME_Bench_Stat* Stat - The statistics.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Stat_Init(struct RME_Bench_Stat* Stat)
+{
+    Stat->Min=(ptr_t)(-1);
+    Stat->Max=0;
+    Stat->Avg=0;
+    Stat->Sum=0;
+    Stat->Num=0;
+    Stat->Fail=0;
+}
+/* End Function:RME_Bench_Stat_Init ******************************************/
+
+/* Begin Function:RME_Bench_Stat_Add ******************************************
+Description : Add one sample to the statistics of a test.
+Input       : struct RME_Bench_Stat* Stat - The statistics.
+              ptr_t Time - The time taken, including the timestamp overhead.
+              ret_t Retval - The return value of the system call measured.
+Output      : struct RME_Bench_Stat* Stat - The statistics.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Stat_Add(struct RME_Bench_Stat* Stat, ptr_t Time, ret_t Retval)
+{
+    if(Time>RME_Bench_Result.TSC_Overhead)
+        Time-=RME_Bench_Result.TSC_Overhead;
+    else
+        Time=0;
+
+    if(Time<Stat->Min)
+        Stat->Min=Time;
+    if(Time>Stat->Max)
+        Stat->Max=Time;
+    Stat->Sum+=Time;
+    Stat->Num++;
+
+    if(Retval<0)
+        Stat->Fail++;
+}
+/* End Function:RME_Bench_Stat_Add *******************************************/
+
+/* Begin Function:RME_Bench_Stat_End ******************************************
+Description : Calculate the average after all the samples of a test are in.
+Input       : struct RME_Bench_Stat* Stat - The statistics.
+Output      : struct RME_Bench_Stat* Stat - The statistics.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Stat_End(struct RME_Bench_Stat* Stat)
+{
+    if(Stat->Num!=0)
+        Stat->Avg=Stat->Sum/Stat->Num;
+}
+/* End Function:RME_Bench_Stat_End *******************************************/
+
+/* Begin Function:RME_Bench_Swt_Thd *******************************************
+Description : The thread for the thread switch tests. It switches back to the
+              init thread immediately, every time it is switched to.
+Input       : ptr_t Param - The parameter, unused.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Swt_Thd(ptr_t Param)
+{
+    while(1)
+    {
+        RME_CAP_OP(RME_SVC_THD_SWT,0,
+                   RME_BENCH_INIT_THD,
+                   0,
+                   0);
+    }
+}
+/* End Function:RME_Bench_Swt_Thd ********************************************/
+
+/* Begin Function:RME_Bench_Rcv_Thd *******************************************
+Description : The thread for the signal receive tests. It blocks on the endpoint
+              again as soon as it gets a signal, which hands the processor back
+              to the init thread.
+Input       : ptr_t Param - The signal endpoint to receive from.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Rcv_Thd(ptr_t Param)
+{
+    while(1)
+    {
+        RME_CAP_OP(RME_SVC_SIG_RCV,0,
+                   Param,
+                   RME_RCV_BS,
+                   0);
+    }
+}
+/* End Function:RME_Bench_Rcv_Thd ********************************************/
+
+/* Begin Function:RME_Bench_Inv_Entry *****************************************
+Description : The entry of the invocations. It just returns the parameter.
+Input       : ptr_t Param - The parameter.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Inv_Entry(ptr_t Param)
+{
+    RME_CAP_OP(RME_SVC_INV_RET,0,
+               Param,
+               0,
+               0);
+}
+/* End Function:RME_Bench_Inv_Entry ******************************************/
+
+/* Begin Function:RME_Bench_Thd_Crt *******************************************
+Description : Create a test thread, bind it to this processor under the init
+              thread, and give it infinite budget. If it has a higher priority
+              than the init thread, it runs until it blocks before we return.
+Input       : ptr_t Thd - The slot of the thread in the benchmark table.
+              cid_t Cap_Proc - The process to create the thread in.
+              ptr_t Prio - The priority of the thread.
+              ptr_t Entry - The entry of the thread.
+              ptr_t Param - The parameter of the thread.
+              ptr_t Stack - The stack to use.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Thd_Crt(ptr_t Thd, cid_t Cap_Proc, ptr_t Prio, ptr_t Entry, ptr_t Param, ptr_t Stack)
+{
+    /* No test thread runs above the receivers, so that is the maximum priority */
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_THD_CRT,RME_BENCH_CAPTBL,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_D0(Thd),
+                               RME_PARAM_D1(Cap_Proc)|RME_PARAM_D0(RME_BENCH_RCV_PRIO),
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0)));
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_THD_SCHED_BIND,RME_BENCH_CAP(Thd),
+                               RME_PARAM_D1(RME_BENCH_INIT_THD)|RME_PARAM_D0(RME_CAPID_NULL),
+                               0,
+                               Prio));
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_THD_EXEC_SET,RME_BENCH_CAP(Thd),
+                               Entry,
+                               RME_Bench_Plat_Stack(RME_Bench_Stack[Stack],RME_BENCH_STACK_WORDS),
+                               Param));
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_THD_TIME_XFER,0,
+                               RME_BENCH_CAP(Thd),
+                               RME_BENCH_INIT_THD,
+                               RME_BENCH_INF_TIME));
+}
+/* End Function:RME_Bench_Thd_Crt ********************************************/
+
+/* Begin Function:RME_Bench_Inv_Crt *******************************************
+Description : Create a test invocation.
+Input       : ptr_t Inv - The slot of the invocation in the benchmark table.
+              cid_t Cap_Proc - The process that the invocation runs in.
+              ptr_t Stack - The stack to use.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Inv_Crt(ptr_t Inv, cid_t Cap_Proc, ptr_t Stack)
+{
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_INV_CRT,RME_BENCH_CAPTBL,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_D0(Inv),
+                               Cap_Proc,
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0)));
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_INV_SET,0,
+                               RME_PARAM_D1(0)|RME_PARAM_D0(RME_BENCH_CAP(Inv)),
+                               (ptr_t)RME_Bench_Inv_Entry,
+                               RME_Bench_Plat_Stack(RME_Bench_Stack[Stack],RME_BENCH_STACK_WORDS)));
+}
+/* End Function:RME_Bench_Inv_Crt ********************************************/
+
+/* Begin Function:RME_Bench_Init **********************************************
+Description : Create all the kernel objects used by the tests. The second process
+              shares the capability table of the init process, and its page table
+              maps the same memory, so the code and stacks are the same; only the
+              page table switch differs from the same-process tests.
 Input       : None.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-void _RME_Tsc_Init(void)
+void RME_Bench_Init(void)
 {
-//    TIM_HandleTypeDef TIM2_Handle;
-//    
-//    /* Initialize timer 2 to run at the same speed as the CPU */
-//    TIM2_Handle.Instance=TIM2;
-//    TIM2_Handle.Init.Prescaler=0;
-//    TIM2_Handle.Init.CounterMode=TIM_COUNTERMODE_UP;
-//    TIM2_Handle.Init.Period=(ptr_t)(-1);
-//    TIM2_Handle.Init.ClockDivision=TIM_CLOCKDIVISION_DIV1;
-//    HAL_TIM_Base_Init(&TIM2_Handle);
-//    __HAL_RCC_TIM2_CLK_ENABLE();
-//    __HAL_TIM_ENABLE(&TIM2_Handle);
+    RME_Bench_Result.Setup_Fail=0;
+    RME_Bench_Kmem_Cur=RME_BENCH_KMEM_START;
+
+    /* The benchmark capability table */
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_CAPTBL_CRT,RME_BOOT_CAPTBL,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_D0(RME_BENCH_CAPTBL),
+                               RME_Bench_Kmem(RME_BENCH_CAPTBL_NUM*RME_BENCH_CAP_SIZE,0),
+                               RME_BENCH_CAPTBL_NUM));
+    /* The tables that we create capability tables in or delegate to. One more
+     * slot than the batch size is needed for waiting for quiescence */
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_CAPTBL_CRT,RME_BENCH_CAPTBL,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_D0(RME_BENCH_CAPTBL_ADD),
+                               RME_Bench_Kmem((RME_BENCH_BATCH+1)*RME_BENCH_CAP_SIZE,0),
+                               RME_BENCH_BATCH+1));
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_CAPTBL_CRT,RME_BENCH_CAPTBL,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_D0(RME_BENCH_CAPTBL_CRT),
+                               RME_Bench_Kmem((RME_BENCH_BATCH+1)*RME_BENCH_CAP_SIZE,0),
+                               RME_BENCH_BATCH+1));
+
+    /* The signal endpoints */
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_SIG_CRT,RME_BENCH_CAPTBL,
+                               RME_BENCH_KMEM,
+                               RME_BENCH_SIG,
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0)));
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_SIG_CRT,RME_BENCH_CAPTBL,
+                               RME_BENCH_KMEM,
+                               RME_BENCH_SIG_RCV,
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0)));
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_SIG_CRT,RME_BENCH_CAPTBL,
+                               RME_BENCH_KMEM,
+                               RME_BENCH_SIG_RCV_PROC,
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0)));
+
+    /* The page tables, then the second process */
+    RME_Bench_Plat_Pgtbl(RME_BENCH_CAPTBL, RME_BENCH_PGTBL_PROC, RME_BENCH_PGTBL_MAP);
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_PROC_CRT,RME_BENCH_CAPTBL,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_D0(RME_BENCH_PROC),
+                               RME_PARAM_D1(RME_BOOT_CAPTBL)|RME_PARAM_D0(RME_BENCH_CAP(RME_BENCH_PGTBL_PROC)),
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0)));
+
+    /* The switching threads are at the priority of the init thread, while the
+     * receiving threads are above it, so they run and block on creation */
+    RME_Bench_Thd_Crt(RME_BENCH_THD_SWT, RME_BOOT_INIT_PROC, 0,
+                      (ptr_t)RME_Bench_Swt_Thd, 0, 0);
+    RME_Bench_Thd_Crt(RME_BENCH_THD_SWT_PROC, RME_BENCH_CAP(RME_BENCH_PROC), 0,
+                      (ptr_t)RME_Bench_Swt_Thd, 0, 1);
+    RME_Bench_Thd_Crt(RME_BENCH_THD_RCV, RME_BOOT_INIT_PROC, RME_BENCH_RCV_PRIO,
+                      (ptr_t)RME_Bench_Rcv_Thd, RME_BENCH_CAP(RME_BENCH_SIG_RCV), 2);
+    RME_Bench_Thd_Crt(RME_BENCH_THD_RCV_PROC, RME_BENCH_CAP(RME_BENCH_PROC), RME_BENCH_RCV_PRIO,
+                      (ptr_t)RME_Bench_Rcv_Thd, RME_BENCH_CAP(RME_BENCH_SIG_RCV_PROC), 3);
+
+    /* The invocations */
+    RME_Bench_Inv_Crt(RME_BENCH_INV, RME_BOOT_INIT_PROC, 4);
+    RME_Bench_Inv_Crt(RME_BENCH_INV_PROC, RME_BENCH_CAP(RME_BENCH_PROC), 5);
 }
-/* End Function:_RME_Tsc_Init ************************************************/
+/* End Function:RME_Bench_Init ***********************************************/
 
-/* Begin Function:_RME_Stack_Init *********************************************
-Description : The thread's stack initializer, initializes the thread's stack.
+/* Begin Function:RME_Bench_TSC_Test ******************************************
+Description : Measure the cost of two back-to-back timestamp counter reads. We
+              take the minimum because this is a constant overhead.
 Input       : None.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-ptr_t _RME_Stack_Init(ptr_t Stack, ptr_t Stub, ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4)
+void RME_Bench_TSC_Test(void)
 {
-    struct RME_CMX_Ret_Stack* Stack_Ptr;
-    
-    Stack_Ptr=(struct RME_CMX_Ret_Stack*)(Stack-RME_STACK_SAFE_SIZE-sizeof(struct RME_CMX_Ret_Stack));
-    Stack_Ptr->R0=Param1;
-    Stack_Ptr->R1=Param2;
-    Stack_Ptr->R2=Param3;
-    Stack_Ptr->R3=Param4;
-    Stack_Ptr->R12=0;
-    Stack_Ptr->LR=0;
-    Stack_Ptr->PC=Stub;
-    /* Initialize the xPSR to avoid a transition to ARM state */
-    Stack_Ptr->XPSR=0x01000200;
-    
-    return (ptr_t)Stack_Ptr;
+    cnt_t Count;
+    ptr_t Temp;
+
+    RME_Bench_Result.TSC_Overhead=(ptr_t)(-1);
+    for(Count=0;Count<RME_BENCH_ROUNDS;Count++)
+    {
+        Temp=RME_BENCH_TSC();
+        Temp=RME_BENCH_TSC()-Temp;
+        if(Temp<RME_Bench_Result.TSC_Overhead)
+            RME_Bench_Result.TSC_Overhead=Temp;
+    }
 }
-/* End Function:_RME_Stack_Init **********************************************/
+/* End Function:RME_Bench_TSC_Test *******************************************/
 
-/* Begin Function:RME_Same_Proc_Thd_Switch_Test_Thd ***************************
-Description : The thread for testing same-process thread switching performance.
+/* Begin Function:RME_Bench_Sig_Snd_Test **************************************
+Description : The signal sending test. Nobody is receiving from the endpoint, so
+              this just increases the signal counter and never switches threads.
 Input       : None.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-void RME_Same_Proc_Thd_Switch_Test_Thd(ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4)
+void RME_Bench_Sig_Snd_Test(void)
 {
+    cnt_t Count;
+    ptr_t Temp;
     ret_t Retval;
-    /* Now we switch back to the init thread, immediately */
-    while(1)
+
+    RME_Bench_Stat_Init(&(RME_Bench_Result.Sig_Snd));
+    for(Count=0;Count<RME_BENCH_ROUNDS;Count++)
+    {
+        Temp=RME_BENCH_TSC();
+        Retval=RME_CAP_OP(RME_SVC_SIG_SND,0,
+                          RME_BENCH_CAP(RME_BENCH_SIG),
+                          0,
+                          0);
+        RME_Bench_Stat_Add(&(RME_Bench_Result.Sig_Snd), RME_BENCH_TSC()-Temp, Retval);
+    }
+    RME_Bench_Stat_End(&(RME_Bench_Result.Sig_Snd));
+}
+/* End Function:RME_Bench_Sig_Snd_Test ***************************************/
+
+/* Begin Function:RME_Bench_Thd_Swt_Test **************************************
+Description : The thread switch test. The thread switches back immediately, so
+              each sample is a round trip.
+Input       : cid_t Cap_Thd - The thread to switch to.
+Output      : struct RME_Bench_Stat* Stat - The statistics.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Thd_Swt_Test(struct RME_Bench_Stat* Stat, cid_t Cap_Thd)
+{
+    cnt_t Count;
+    ptr_t Temp;
+    ret_t Retval;
+
+    RME_Bench_Stat_Init(Stat);
+    for(Count=0;Count<RME_BENCH_ROUNDS;Count++)
     {
+        Temp=RME_BENCH_TSC();
         Retval=RME_CAP_OP(RME_SVC_THD_SWT,0,
-                          RME_BOOT_INIT_THD,
+                          Cap_Thd,
                           0,
                           0);
+        RME_Bench_Stat_Add(Stat, RME_BENCH_TSC()-Temp, Retval);
     }
+    RME_Bench_Stat_End(Stat);
 }
-/* End Function:RME_Same_Proc_Thd_Switch_Test_Thd ****************************/
+/* End Function:RME_Bench_Thd_Swt_Test ***************************************/
 
-/* Begin Function:RME_Same_Proc_Thd_Switch_Test *******************************
-Description : The same-process thread switch test code.
-Input       : None.
-Output      : None.
+/* Begin Function:RME_Bench_Inv_Test ******************************************
+Description : The synchronous invocation test. Each sample is an activation and
+              the return from it.
+Input       : cid_t Cap_Inv - The invocation to activate.
+Output      : struct RME_Bench_Stat* Stat - The statistics.
 Return      : None.
 ******************************************************************************/
-void RME_Same_Proc_Thd_Switch_Test(void)
+void RME_Bench_Inv_Test(struct RME_Bench_Stat* Stat, cid_t Cap_Inv)
 {
-    /* Intra-process thread switching time */
+    cnt_t Count;
+    ptr_t Temp;
     ret_t Retval;
+
+    RME_Bench_Stat_Init(Stat);
+    for(Count=0;Count<RME_BENCH_ROUNDS;Count++)
+    {
+        Temp=RME_BENCH_TSC();
+        Retval=RME_INV_OP(Cap_Inv,Count);
+        RME_Bench_Stat_Add(Stat, RME_BENCH_TSC()-Temp, Retval);
+    }
+    RME_Bench_Stat_End(Stat);
+}
+/* End Function:RME_Bench_Inv_Test *******************************************/
+
+/* Begin Function:RME_Bench_Sig_Rcv_Test **************************************
+Description : The signal send and receive test. The receiver is blocked on the
+              endpoint at a higher priority, so the send switches to it, and it
+              switches back when it blocks again. Each sample is a round trip.
+Input       : cid_t Cap_Sig - The signal endpoint that the receiver blocks on.
+Output      : struct RME_Bench_Stat* Stat - The statistics.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Sig_Rcv_Test(struct RME_Bench_Stat* Stat, cid_t Cap_Sig)
+{
     cnt_t Count;
-    ptr_t Stack_Addr;
     ptr_t Temp;
-    /* Initialize the thread's stack before entering it */
-    Stack_Addr=_RME_Stack_Init((ptr_t)(&RME_Stack[2047]),
-                               (ptr_t)RME_Thd_Stub,
-                               1, 2, 3, 4);
-    /* There are still many bugs in the kernel. Need a white-box test to guarantee
-     * that it is free of bugs. Find a scheme to do that */
-    Retval=RME_CAP_OP(RME_SVC_THD_CRT,RME_BOOT_CAPTBL,
-                      RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_D0(RME_BOOT_BENCH_THD),
-                      RME_PARAM_D1(RME_BOOT_INIT_PROC)|RME_PARAM_D0(31),
-                      RME_BOOT_BENCH_KMEM_FRONTIER);
-    
-    /* Bind the thread to the processor */
-    Retval=RME_CAP_OP(RME_SVC_THD_SCHED_BIND,0,
-                      RME_BOOT_BENCH_THD,
-                      RME_BOOT_INIT_THD,
-                      0);
-    
-    /* Set the execution information */
-    Retval=RME_CAP_OP(RME_SVC_THD_EXEC_SET,0,
-                      RME_BOOT_BENCH_THD,
-                      (ptr_t)RME_Same_Proc_Thd_Switch_Test_Thd,
-                      Stack_Addr);
-                      
-    /* Delegate some timeslice to it */
-    Retval=RME_CAP_OP(RME_SVC_THD_TIME_XFER,0,
-                      RME_BOOT_BENCH_THD,
-                      RME_BOOT_INIT_THD,
-                      10000000);
-    
-    /* Try to switch to that thread - should fail */
-    Retval=RME_CAP_OP(RME_SVC_THD_SWT,0,
-                      RME_BOOT_BENCH_THD,
-                      0,
-                      0);
-    /* Test result: intra-process ctxsw 358cycles/1.657us, frt w/mpu 163cycles/0.754us,
-    * composite 324. opted max:323
-    * all:33.0
-    * empty: 4.09 - 0.409us, most time spent on internals
-    * w/selections: 7.15 - maybe no need to check frozen cap from the proc.
-    * w/checkings:10.926 - 317us.
-    * total:16.57
-    * 16.2us now, after cleaning up two bad things
-    * 14.7us after CPUID optimizations. The quiescence hardly worked.
-    * no cache - 3 times slower, mainly due to the flash. ART does not really help.
-    * Performance cannot be further optimized anymore without compiler intrinsics.
-    * Something terribly wrong with systick. 38 second wrapwround
-    * This configuration, CPU works at 216MHz, correct, but the 
-    * The TSC is always 8 cycles between reads.
-    */
-    _RME_Tsc_Init();
-    for(Count=0;Count<10000;Count++)
+    ret_t Retval;
+
+    RME_Bench_Stat_Init(Stat);
+    for(Count=0;Count<RME_BENCH_ROUNDS;Count++)
     {
-        Temp=RME_TSC();
-        Retval=RME_CAP_OP(RME_SVC_THD_SWT,0,
-                          RME_BOOT_BENCH_THD,
+        Temp=RME_BENCH_TSC();
+        Retval=RME_CAP_OP(RME_SVC_SIG_SND,0,
+                          Cap_Sig,
                           0,
                           0);
-        Temp=RME_TSC()-Temp;
-        Time[Count]=Temp-8;
+        RME_Bench_Stat_Add(Stat, RME_BENCH_TSC()-Temp, Retval);
     }
-    
-    while(1);
+    RME_Bench_Stat_End(Stat);
 }
-/* End Function:RME_Same_Proc_Thd_Switch_Test ********************************/
+/* End Function:RME_Bench_Sig_Rcv_Test ***************************************/
 
-/* Begin Function:RME_Diff_Proc_Thd_Switch_Test_Thd ***************************
-Description : The thread for testing same-process thread switching performance.
+/* Begin Function:RME_Bench_Captbl_Crt_Test ***********************************
+Description : The capability table creation and deletion test. The tables are
+              created in batches; a new capability cannot be deleted until it is
+              quiescent, so before deleting a batch we wait on one more table
+              created after all the others. The memory is reused by each batch.
 Input       : None.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-void RME_Diff_Proc_Thd_Switch_Test_Thd(ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4)
+void RME_Bench_Captbl_Crt_Test(void)
 {
+    cnt_t Count;
+    cnt_t Batch;
+    ptr_t Raddr;
+    ptr_t Temp;
     ret_t Retval;
-    /* Now we switch back to the init thread, immediately */
-    while(1)
+
+    RME_Bench_Stat_Init(&(RME_Bench_Result.Captbl_Crt));
+    RME_Bench_Stat_Init(&(RME_Bench_Result.Captbl_Del));
+    Raddr=RME_Bench_Kmem((RME_BENCH_BATCH+1)*RME_BENCH_CAPTBL_ENTRY*RME_BENCH_CAP_SIZE,0);
+    for(Batch=0;Batch<RME_BENCH_ROUNDS;Batch+=RME_BENCH_BATCH)
     {
-        Retval=RME_CAP_OP(RME_SVC_THD_SWT,0,
-                          RME_BOOT_INIT_THD,
-                          0,
-                          0);
+        for(Count=0;Count<=RME_BENCH_BATCH;Count++)
+        {
+            Temp=RME_BENCH_TSC();
+            Retval=RME_CAP_OP(RME_SVC_CAPTBL_CRT,RME_BENCH_CAP(RME_BENCH_CAPTBL_CRT),
+                              RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_D0(Count),
+                              Raddr+Count*RME_BENCH_CAPTBL_ENTRY*RME_BENCH_CAP_SIZE,
+                              RME_BENCH_CAPTBL_ENTRY);
+            Temp=RME_BENCH_TSC()-Temp;
+            if(Count<RME_BENCH_BATCH)
+                RME_Bench_Stat_Add(&(RME_Bench_Result.Captbl_Crt), Temp, Retval);
+        }
+
+        while(RME_CAP_OP(RME_SVC_CAPTBL_DEL,RME_BENCH_CAP(RME_BENCH_CAPTBL_CRT),
+                         RME_BENCH_BATCH,0,0)==RME_ERR_CAP_QUIE);
+
+        for(Count=0;Count<RME_BENCH_BATCH;Count++)
+        {
+            Temp=RME_BENCH_TSC();
+            Retval=RME_CAP_OP(RME_SVC_CAPTBL_DEL,RME_BENCH_CAP(RME_BENCH_CAPTBL_CRT),
+                              Count,
+                              0,
+                              0);
+            RME_Bench_Stat_Add(&(RME_Bench_Result.Captbl_Del), RME_BENCH_TSC()-Temp, Retval);
+        }
     }
+    RME_Bench_Stat_End(&(RME_Bench_Result.Captbl_Crt));
+    RME_Bench_Stat_End(&(RME_Bench_Result.Captbl_Del));
 }
-/* End Function:RME_Diff_Proc_Thd_Switch_Test_Thd ****************************/
+/* End Function:RME_Bench_Captbl_Crt_Test ************************************/
 
-/* Begin Function:RME_Diff_Proc_Thd_Switch_Test *******************************
-Description : The same-process thread switch test code.
+/* Begin Function:RME_Bench_Captbl_Add_Test ***********************************
+Description : The capability delegation and removal test. The signal endpoint
+              capability is delegated in batches, and removed in the same way as
+              the tables are deleted in the creation test.
 Input       : None.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-void RME_Diff_Proc_Thd_Switch_Test(void)
+void RME_Bench_Captbl_Add_Test(void)
 {
-    /* Intra-process thread switching time */
+    cnt_t Count;
+    cnt_t Batch;
+    ptr_t Temp;
     ret_t Retval;
+
+    RME_Bench_Stat_Init(&(RME_Bench_Result.Captbl_Add));
+    RME_Bench_Stat_Init(&(RME_Bench_Result.Captbl_Rem));
+    for(Batch=0;Batch<RME_BENCH_ROUNDS;Batch+=RME_BENCH_BATCH)
+    {
+        for(Count=0;Count<=RME_BENCH_BATCH;Count++)
+        {
+            Temp=RME_BENCH_TSC();
+            Retval=RME_CAP_OP(RME_SVC_CAPTBL_ADD,0,
+                              RME_PARAM_D1(RME_BENCH_CAP(RME_BENCH_CAPTBL_ADD))|RME_PARAM_D0(Count),
+                              RME_PARAM_D1(RME_BENCH_CAPTBL)|RME_PARAM_D0(RME_BENCH_SIG),
+                              RME_SIG_FLAG_ALL);
+            Temp=RME_BENCH_TSC()-Temp;
+            if(Count<RME_BENCH_BATCH)
+                RME_Bench_Stat_Add(&(RME_Bench_Result.Captbl_Add), Temp, Retval);
+        }
+
+        while(RME_CAP_OP(RME_SVC_CAPTBL_REM,RME_BENCH_CAP(RME_BENCH_CAPTBL_ADD),
+                         RME_BENCH_BATCH,0,0)==RME_ERR_CAP_QUIE);
+
+        for(Count=0;Count<RME_BENCH_BATCH;Count++)
+        {
+            Temp=RME_BENCH_TSC();
+            Retval=RME_CAP_OP(RME_SVC_CAPTBL_REM,RME_BENCH_CAP(RME_BENCH_CAPTBL_ADD),
+                              Count,
+                              0,
+                              0);
+            RME_Bench_Stat_Add(&(RME_Bench_Result.Captbl_Rem), RME_BENCH_TSC()-Temp, Retval);
+        }
+    }
+    RME_Bench_Stat_End(&(RME_Bench_Result.Captbl_Add));
+    RME_Bench_Stat_End(&(RME_Bench_Result.Captbl_Rem));
+}
+/* End Function:RME_Bench_Captbl_Add_Test ************************************/
+
+/* Begin Function:RME_Bench_Pgtbl_Test ****************************************
+Description : The page mapping and unmapping test. The page is mapped into a page
+              table that is not used by any process, then unmapped again.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Pgtbl_Test(void)
+{
     cnt_t Count;
-    ptr_t Stack_Addr;
     ptr_t Temp;
-    ptr_t Frontier;
-    
-    Frontier=RME_BOOT_BENCH_KMEM_FRONTIER;
-    /* Initialize the thread's stack before entering it */
-    Stack_Addr=_RME_Stack_Init((ptr_t)(&RME_Stack[2047]),
-                               (ptr_t)RME_Thd_Stub,
-                               1, 2, 3, 4);
-    
-    /* Create the page table for the whole address space range */
-    Retval=RME_CAP_OP(RME_SVC_PGTBL_CRT,RME_BOOT_CAPTBL,
-                      RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_Q1(RME_BOOT_BENCH_PGTBL_TOP)|
-                      RME_PARAM_O1(29)|RME_PARAM_O0(3),
-                      Frontier,
-                      1);
-//    Frontier+=;
-//    /* Create the page table for the SRAM range */
-//    Retval=RME_CAP_OP(RME_SVC_PGTBL_CRT,RME_BOOT_CAPTBL,
-//                      RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_Q1(RME_BOOT_BENCH_PGTBL_SRAM)|
-//                      RME_PARAM_O1(16)|RME_PARAM_O0(3),
-//                      Frontier,
-//                      0x20000001);
-//    Frontier+=;
-//    /* Map the pages into the top-level and the second-level */
-//    RME_CAP_OP(RME_SVC_PGTBL_ADD,0,
-//               RME_PARAM_Q1(RME_BOOT_BENCH_PGTBL_TOP)|0,
-//               RME_PARAM_D1(RME_BOOT_PGTBL)|0,
-//               |0)
-                      
-                  
-    
-    
-    
-    Retval=RME_CAP_OP(RME_SVC_THD_CRT,RME_BOOT_CAPTBL,
-                      RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_D0(RME_BOOT_BENCH_THD),
-                      RME_PARAM_D1(RME_BOOT_INIT_PROC)|RME_PARAM_D0(31),
-                      RME_BOOT_BENCH_KMEM_FRONTIER);
-    
-    /* Bind the thread to the processor */
-    Retval=RME_CAP_OP(RME_SVC_THD_SCHED_BIND,0,
-                      RME_BOOT_BENCH_THD,
-                      RME_BOOT_INIT_THD,
-                      0);
-    
-    /* Set the execution information */
-    Retval=RME_CAP_OP(RME_SVC_THD_EXEC_SET,0,
-                      RME_BOOT_BENCH_THD,
-                      (ptr_t)RME_Same_Proc_Thd_Switch_Test_Thd,
-                      Stack_Addr);
-                      
-    /* Delegate some timeslice to it */
-    Retval=RME_CAP_OP(RME_SVC_THD_TIME_XFER,0,
-                      RME_BOOT_BENCH_THD,
-                      RME_BOOT_INIT_THD,
-                      10000000);
-    
-    /* Try to switch to that thread - should fail */
-    Retval=RME_CAP_OP(RME_SVC_THD_SWT,0,
-                      RME_BOOT_BENCH_THD,
-                      0,
-                      0);
-    /* Test result: intra-process ctxsw 358cycles/1.657us, frt w/mpu 163cycles/0.754us,
-    * composite 324. opted max:323
-    * all:33.0
-    * empty: 4.09 - 0.409us, most time spent on internals
-    * w/selections: 7.15 - maybe no need to check frozen cap from the proc.
-    * w/checkings:10.926 - 317us.
-    * total:16.57
-    * 16.2us now, after cleaning up two bad things
-    * 14.7us after CPUID optimizations. The quiescence hardly worked.
-    * no cache - 3 times slower, mainly due to the flash. ART does not really help.
-    * Performance cannot be further optimized anymore without compiler intrinsics.
-    * Something terribly wrong with systick. 38 second wrapwround
-    * This configuration, CPU works at 216MHz, correct, but the 
-    * The TSC is always 8 cycles between reads.
-    */
-    _RME_Tsc_Init();
-    for(Count=0;Count<10000;Count++)
+    ret_t Retval;
+
+    RME_Bench_Stat_Init(&(RME_Bench_Result.Pgtbl_Add));
+    RME_Bench_Stat_Init(&(RME_Bench_Result.Pgtbl_Rem));
+    for(Count=0;Count<RME_BENCH_ROUNDS;Count++)
     {
-        Temp=RME_TSC();
-        Retval=RME_CAP_OP(RME_SVC_THD_SWT,0,
-                          RME_BOOT_BENCH_THD,
-                          0,
+        Temp=RME_BENCH_TSC();
+        Retval=RME_CAP_OP(RME_SVC_PGTBL_ADD,RME_BENCH_MAP_FLAGS,
+                          RME_PARAM_D1(RME_BENCH_CAP(RME_BENCH_PGTBL_MAP))|RME_PARAM_D0(RME_BENCH_MAP_POS),
+                          RME_PARAM_D1(RME_BENCH_MAP_SRC)|RME_PARAM_D0(RME_BENCH_MAP_POS),
                           0);
-        Temp=RME_TSC()-Temp;
-        Time[Count]=Temp-8;
+        RME_Bench_Stat_Add(&(RME_Bench_Result.Pgtbl_Add), RME_BENCH_TSC()-Temp, Retval);
+
+        Temp=RME_BENCH_TSC();
+        Retval=RME_CAP_OP(RME_SVC_PGTBL_REM,0,
+                          RME_BENCH_CAP(RME_BENCH_PGTBL_MAP),
+                          RME_BENCH_MAP_POS,
+                          0);
+        RME_Bench_Stat_Add(&(RME_Bench_Result.Pgtbl_Rem), RME_BENCH_TSC()-Temp, Retval);
     }
-    
-    while(1);
+    RME_Bench_Stat_End(&(RME_Bench_Result.Pgtbl_Add));
+    RME_Bench_Stat_End(&(RME_Bench_Result.Pgtbl_Rem));
 }
-/* End Function:RME_Diff_Proc_Thd_Switch_Test ********************************/
+/* End Function:RME_Bench_Pgtbl_Test *****************************************/
 
 /* Begin Function:RME_Benchmark ***********************************************
-Description : The benchmark entry, also the init thread.
-Input       : None.
+Description : The benchmark entry, also the init thread. Creates all the kernel
+              objects used by the tests, then runs them one by one.
+Input       : ptr_t CPUID - The CPUID, always 0 for the init thread.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-void RME_Benchmark(void)
+void RME_Benchmark(ptr_t CPUID)
 {
-    RME_Same_Proc_Thd_Switch_Test();
+    RME_Bench_Plat_Init();
+    RME_Bench_Init();
+
+    /* Run the tests */
+    RME_Bench_TSC_Test();
+    RME_Bench_Sig_Snd_Test();
+    RME_Bench_Thd_Swt_Test(&(RME_Bench_Result.Thd_Swt), RME_BENCH_CAP(RME_BENCH_THD_SWT));
+    RME_Bench_Thd_Swt_Test(&(RME_Bench_Result.Thd_Swt_Proc), RME_BENCH_CAP(RME_BENCH_THD_SWT_PROC));
+    RME_Bench_Inv_Test(&(RME_Bench_Result.Inv), RME_BENCH_CAP(RME_BENCH_INV));
+    RME_Bench_Inv_Test(&(RME_Bench_Result.Inv_Proc), RME_BENCH_CAP(RME_BENCH_INV_PROC));
+    RME_Bench_Sig_Rcv_Test(&(RME_Bench_Result.Sig_Rcv), RME_BENCH_CAP(RME_BENCH_SIG_RCV));
+    RME_Bench_Sig_Rcv_Test(&(RME_Bench_Result.Sig_Rcv_Proc), RME_BENCH_CAP(RME_BENCH_SIG_RCV_PROC));
+    RME_Bench_Captbl_Crt_Test();
+    RME_Bench_Captbl_Add_Test();
+    RME_Bench_Pgtbl_Test();
+
+    /* Read out RME_Bench_Result here */
+    RME_Bench_Plat_Done();
+    while(1);
 }
 /* End Function:RME_Benchmark ************************************************/
 
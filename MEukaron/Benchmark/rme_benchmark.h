@@ -0,0 +1,68 @@
+/******************************************************************************
+Filename    : rme_benchmark.h
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The result structures of the RME benchmark, shared by rme_benchmark.c
+              and the platform hooks that print the results out.
+******************************************************************************/
+
+/* Defines *******************************************************************/
+#ifndef __RME_BENCHMARK_H__
+#define __RME_BENCHMARK_H__
+/* The statistics of one test */
+struct RME_Bench_Stat
+{
+    ptr_t Min;
+    ptr_t Max;
+    ptr_t Avg;
+    ptr_t Sum;
+    ptr_t Num;
+    /* Number of failed system calls, should be zero */
+    ptr_t Fail;
+};
+
+/* The statistics of all tests */
+struct RME_Bench_Result
+{
+    /* The cost of reading the timestamp counter alone, subtracted from all results */
+    ptr_t TSC_Overhead;
+    /* Number of failed system calls when creating the test objects, should be zero */
+    ptr_t Setup_Fail;
+    /* Nobody receives, so this never switches threads */
+    struct RME_Bench_Stat Sig_Snd;
+    /* These are round trips, thus two switches */
+    struct RME_Bench_Stat Thd_Swt;
+    struct RME_Bench_Stat Thd_Swt_Proc;
+    /* Invocation activation and return together */
+    struct RME_Bench_Stat Inv;
+    struct RME_Bench_Stat Inv_Proc;
+    /* Sending to a blocked receiver, and that receiver blocking again */
+    struct RME_Bench_Stat Sig_Rcv;
+    struct RME_Bench_Stat Sig_Rcv_Proc;
+    struct RME_Bench_Stat Captbl_Crt;
+    struct RME_Bench_Stat Captbl_Del;
+    struct RME_Bench_Stat Captbl_Add;
+    struct RME_Bench_Stat Captbl_Rem;
+    struct RME_Bench_Stat Pgtbl_Add;
+    struct RME_Bench_Stat Pgtbl_Rem;
+};
+/*****************************************************************************/
+/* __RME_BENCHMARK_H__ */
+#endif
+/* End Defines ***************************************************************/
+
+/* Public Global Variables ***************************************************/
+/*****************************************************************************/
+#ifndef __RME_BENCHMARK_MEMBERS__
+#define __RME_BENCHMARK_MEMBERS__
+/* The summary of all tests */
+extern struct RME_Bench_Result RME_Bench_Result;
+/*****************************************************************************/
+/* __RME_BENCHMARK_MEMBERS__ */
+#endif
+/* End Public Global Variables ***********************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
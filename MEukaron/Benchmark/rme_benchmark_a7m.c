@@ -0,0 +1,150 @@
+/******************************************************************************
+Filename    : rme_benchmark_a7m.c
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The ARMv7-M platform hooks of the RME benchmark. Build it together
+              with rme_benchmark.c and rme_benchmark_asm.s as the init process.
+              The results are left in RME_Bench_Result, and can be read out with
+              the debugger at RME_Bench_Plat_Done.
+******************************************************************************/
+
+/* Includes ******************************************************************/
+#include "rme_benchmark_a7m.h"
+#include "rme.h"
+/* End Includes **************************************************************/
+
+/* Defines *******************************************************************/
+/* The exception return stack frame that the threads start with */
+struct RME_A7M_Bench_Frame
+{
+    ptr_t R0;
+    ptr_t R1;
+    ptr_t R2;
+    ptr_t R3;
+    ptr_t R12;
+    ptr_t LR;
+    ptr_t PC;
+    ptr_t XPSR;
+};
+/* End Defines ***************************************************************/
+
+/* Function Prototypes *******************************************************/
+extern ptr_t RME_Bench_Kmem(ptr_t Size, ptr_t Align_Order);
+extern void RME_Bench_Check(ret_t Retval);
+extern void RME_Benchmark(ptr_t CPUID);
+int main(void);
+/* End Function Prototypes ***************************************************/
+
+/* Begin Function:RME_Bench_Plat_Init *****************************************
+Description : Initialize the timestamp counter. TIM2 counts up without prescaling
+              from 0 to 0xFFFFFFFF, which takes about 40 seconds or more.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Plat_Init(void)
+{
+    RME_A7M_RCC_APB1ENR|=0x01;
+    RME_A7M_TIM2_PSC=0;
+    RME_A7M_TIM2_ARR=(ptr_t)(-1);
+    /* Load the prescaler now, then start counting */
+    RME_A7M_TIM2_EGR=0x01;
+    RME_A7M_TIM2_CR1=0x01;
+}
+/* End Function:RME_Bench_Plat_Init ******************************************/
+
+/* Begin Function:RME_Bench_Plat_Stack ****************************************
+Description : Get the initial stack pointer of a thread or an invocation. The
+              kernel returns to user level through the exception frame on the
+              stack, so we place a frame there that enters RME_Thd_Stub. The stub
+              steps below the frame, so the frame is still there when the next
+              invocation starts on the same stack.
+Input       : ptr_t* Stack - The stack.
+              ptr_t Words - The size of the stack, in words.
+Output      : None.
+Return      : ptr_t - The initial stack pointer.
+******************************************************************************/
+ptr_t RME_Bench_Plat_Stack(ptr_t* Stack, ptr_t Words)
+{
+    struct RME_A7M_Bench_Frame* Frame;
+
+    Frame=(struct RME_A7M_Bench_Frame*)((((ptr_t)(&Stack[Words-16]))&(~((ptr_t)0x07)))-
+                                        sizeof(struct RME_A7M_Bench_Frame));
+    Frame->R0=0;
+    Frame->R1=0;
+    Frame->R2=0;
+    Frame->R3=0;
+    Frame->R12=0;
+    Frame->LR=0;
+    Frame->PC=(ptr_t)RME_Thd_Stub;
+    /* Initialize the xPSR to avoid a transition to ARM state */
+    Frame->XPSR=0x01000000;
+
+    return (ptr_t)Frame;
+}
+/* End Function:RME_Bench_Plat_Stack *****************************************/
+
+/* Begin Function:RME_Bench_Plat_Pgtbl ****************************************
+Description : Create the page tables used by the tests. The top-level page table
+              of the second process maps the same 8 pages as the init process's.
+              The mapping test uses another top-level page table of the same
+              kind, which is not used by any process.
+Input       : cid_t Cap_Captbl - The capability table to create them in.
+              ptr_t Pgtbl_Proc - The slot of the second process's page table.
+              ptr_t Pgtbl_Map - The slot of the page table to map pages into.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Plat_Pgtbl(cid_t Cap_Captbl, ptr_t Pgtbl_Proc, ptr_t Pgtbl_Map)
+{
+    cnt_t Count;
+
+    RME_Bench_Check(RME_CAP_OP(RME_PGTBL_SVC(RME_PGTBL_NUM_8,RME_SVC_PGTBL_CRT),Cap_Captbl,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_Q1(Pgtbl_Proc)|RME_PARAM_Q0(RME_PGTBL_SIZE_512M),
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0),
+                               0|RME_PGTBL_TOP));
+    for(Count=0;Count<8;Count++)
+    {
+        RME_Bench_Check(RME_CAP_OP(RME_SVC_PGTBL_ADD,RME_PGTBL_ALL_PERM,
+                                   RME_PARAM_D1(RME_CAPID(Cap_Captbl,Pgtbl_Proc))|RME_PARAM_D0(Count),
+                                   RME_PARAM_D1(RME_BOOT_PGTBL)|RME_PARAM_D0(Count),
+                                   0));
+    }
+
+    RME_Bench_Check(RME_CAP_OP(RME_PGTBL_SVC(RME_PGTBL_NUM_8,RME_SVC_PGTBL_CRT),Cap_Captbl,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_Q1(Pgtbl_Map)|RME_PARAM_Q0(RME_PGTBL_SIZE_512M),
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0),
+                               0|RME_PGTBL_TOP));
+}
+/* End Function:RME_Bench_Plat_Pgtbl *****************************************/
+
+/* Begin Function:RME_Bench_Plat_Done *****************************************
+Description : Called when all the tests are done. Set a breakpoint here with the
+              debugger, and look at RME_Bench_Result.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Plat_Done(void)
+{
+    return;
+}
+/* End Function:RME_Bench_Plat_Done ******************************************/
+
+/* Begin Function:main ********************************************************
+Description : The entry of the process, called by the C library after RME_Entry.
+Input       : None.
+Output      : None.
+Return      : int - This function never returns.
+******************************************************************************/
+int main(void)
+{
+    RME_Benchmark(0);
+    return 0;
+}
+/* End Function:main *********************************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
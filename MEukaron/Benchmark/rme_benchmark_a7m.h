@@ -0,0 +1,120 @@
+/******************************************************************************
+Filename    : rme_benchmark_a7m.h
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The ARMv7-M platform header of the RME benchmark. This describes the
+              boot capabilities, the memory that the tests can use and how to
+              read the timestamp counter on STM32F4/F7, for rme_benchmark.c.
+******************************************************************************/
+
+/* Defines *******************************************************************/
+#ifndef __RME_BENCHMARK_A7M_H__
+#define __RME_BENCHMARK_A7M_H__
+/* Types */
+typedef signed int s32;
+typedef signed short s16;
+typedef signed char s8;
+typedef unsigned int u32;
+typedef unsigned short u16;
+typedef unsigned char u8;
+typedef s32 tid_t;
+typedef u32 ptr_t;
+typedef s32 cnt_t;
+typedef s32 cid_t;
+typedef s32 ret_t;
+
+/* System service stub */
+#define RME_CAP_OP(OP,CAPID,ARG1,ARG2,ARG3) RME_Svc((((ptr_t)(OP))<<(sizeof(ptr_t)*4))|(CAPID),ARG1,ARG2,ARG3)
+/* Synchronous invocation stub */
+#define RME_INV_OP(CAP_INV,PARAM)           RME_Inv(((ptr_t)RME_SVC_INV_ACT)<<(sizeof(ptr_t)*4),CAP_INV,PARAM)
+/* Page table creation also passes the number order in the system call number */
+#define RME_PGTBL_SVC(NUM_ORDER,SVC)        ((((ptr_t)(NUM_ORDER))<<(sizeof(ptr_t)*2))|(SVC))
+/* Whether the page table is a top-level one, placed along with the base address */
+#define RME_PGTBL_TOP                       1
+#define RME_PGTBL_NOM                       0
+#define RME_PARAM_D_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*4))
+#define RME_PARAM_Q_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*6))
+/* The parameter passing - not to be confused with kernel macros. These macros just place the parameters */
+#define RME_PARAM_D1(X)                     (((X)&RME_PARAM_D_MASK)<<(sizeof(ptr_t)*4))
+#define RME_PARAM_D0(X)                     ((X)&RME_PARAM_D_MASK)
+#define RME_PARAM_Q1(X)                     (((X)&RME_PARAM_Q_MASK)<<(sizeof(ptr_t)*2))
+#define RME_PARAM_Q0(X)                     ((X)&RME_PARAM_Q_MASK)
+/* Capability ID placement */
+#define RME_CAPID_NULL                      (((cid_t)1)<<(sizeof(ptr_t)*4-1))
+#define RME_CAPID_2L                        (((cid_t)1)<<(sizeof(ptr_t)*2-1))
+#define RME_CAPID(X,Y)                      (((X)<<(sizeof(ptr_t)*2))|(Y)|RME_CAPID_2L)
+
+/* Initial boot capabilities - This should be in accordance with the kernel settings */
+/* The capability table of the init process */
+#define RME_BOOT_CAPTBL                     0
+/* The top-level page table of the init process - always 4GB full range split into 8 pages */
+#define RME_BOOT_PGTBL                      1
+/* The init process */
+#define RME_BOOT_INIT_PROC                  2
+/* The init thread */
+#define RME_BOOT_INIT_THD                   3
+/* The initial kernel memory capability */
+#define RME_BOOT_INIT_KMEM                  5
+
+/* The init thread */
+#define RME_BENCH_INIT_THD                  RME_BOOT_INIT_THD
+/* The kernel memory we create the objects in */
+#define RME_BENCH_KMEM                      RME_BOOT_INIT_KMEM
+/* The boot-time objects are all below the boot frontier */
+#define RME_BENCH_KMEM_START                0x1000
+/* An upper bound of the thread, invocation, signal, process and page table object
+ * sizes. The kernel memory is small, so this cannot be very generous */
+#define RME_BENCH_OBJ_SIZE                  0x200
+
+/* Number of rounds for each test */
+#define RME_BENCH_ROUNDS                    4096
+/* Number of capabilities we create or delegate before waiting for quiescence */
+#define RME_BENCH_BATCH                     16
+/* Number of slots in each capability table that we create */
+#define RME_BENCH_CAPTBL_ENTRY              4
+
+/* The page mapping test maps the SRAM page of the init process into a top-level
+ * page table that is not used by any process, and at the same position */
+#define RME_BENCH_MAP_SRC                   RME_BOOT_PGTBL
+#define RME_BENCH_MAP_POS                   1
+#define RME_BENCH_MAP_FLAGS                 RME_PGTBL_ALL_PERM
+
+/* The DWT cycle counter is in the private peripheral bus, which unprivileged code
+ * cannot access. We use the 32-bit TIM2 instead; it runs at half the processor
+ * clock on STM32F4/F7, so the results are in units of two cycles */
+#define RME_A7M_RCC_APB1ENR                 (*((volatile ptr_t*)0x40023840))
+#define RME_A7M_TIM2_CR1                    (*((volatile ptr_t*)0x40000000))
+#define RME_A7M_TIM2_EGR                    (*((volatile ptr_t*)0x40000014))
+#define RME_A7M_TIM2_CNT                    (*((volatile ptr_t*)0x40000024))
+#define RME_A7M_TIM2_PSC                    (*((volatile ptr_t*)0x40000028))
+#define RME_A7M_TIM2_ARR                    (*((volatile ptr_t*)0x4000002C))
+
+/* Read the timestamp counter */
+#define RME_BENCH_TSC()                     RME_A7M_TIM2_CNT
+/*****************************************************************************/
+/* __RME_BENCHMARK_A7M_H__ */
+#endif
+/* End Defines ***************************************************************/
+
+/* Public C Function Prototypes **********************************************/
+/*****************************************************************************/
+#ifndef __RME_BENCHMARK_A7M_MEMBERS__
+#define __RME_BENCHMARK_A7M_MEMBERS__
+extern ret_t RME_Svc(ptr_t Svc_Capid, ptr_t Param1, ptr_t Param2, ptr_t Param3);
+extern ret_t RME_Inv(ptr_t Svc_Capid, ptr_t Cap_Inv, ptr_t Param);
+extern void RME_Thd_Stub(void);
+
+/* Platform hooks of the benchmark */
+extern void RME_Bench_Plat_Init(void);
+extern ptr_t RME_Bench_Plat_Stack(ptr_t* Stack, ptr_t Words);
+extern void RME_Bench_Plat_Pgtbl(cid_t Cap_Captbl, ptr_t Pgtbl_Proc, ptr_t Pgtbl_Map);
+extern void RME_Bench_Plat_Done(void);
+/*****************************************************************************/
+/* __RME_BENCHMARK_A7M_MEMBERS__ */
+#endif
+/* End Public C Function Prototypes ******************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
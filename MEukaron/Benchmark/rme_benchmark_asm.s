@@ -23,6 +23,8 @@
                 EXPORT          RME_Thd_Stub
                 ;User level stub for synchronous invocation
                 EXPORT          RME_Inv_Stub
+                ;Synchronous invocation gate
+                EXPORT          RME_Inv
                 ;Shut the semihosting up
                 EXPORT          __user_setup_stackheap
 ;/* End Exports **************************************************************/
@@ -44,24 +46,32 @@ RME_Entry
 ;/* End Function:RME_Entry ***************************************************/
 
 ;/* Begin Function:RME_Thd_Stub ***********************************************
-;Description : The user level stub for thread creation.
+;Description : The user level stub for thread creation. The stack pointer is
+;              moved back below the exception frame that we came in with, so
+;              that the frame is still there if the stack is reused.
 ;Input       : R4 - The entry address.
-;              R5 - The stack address that we are using now.
+;              R5 - The parameter.
 ;Output      : None.
 ;*****************************************************************************/
 RME_Thd_Stub
+                SUB      SP,SP,#0x20        ; Keep the exception frame
+                MOV      R0,R5              ; Pass the parameter
                 BLX      R4                 ; Branch to the actual entry address
                 ;B        RME_Thd_Finish     ; Jump to exiting code, should never return.
                 B        .                  ; Capture faults.
 ;/* End Function:RME_Thd_Stub ************************************************/
 
 ;/* Begin Function:RME_Inv_Stub ***********************************************
-;Description : The user level stub for synchronous invocation.
+;Description : The user level stub for synchronous invocation. Each activation
+;              starts from the same exception frame on the invocation stack, so
+;              we must not overwrite it.
 ;Input       : R4 - The entry address.
-;              R5 - The stack address that we are using now.
+;              R5 - The parameter.
 ;Output      : None.
 ;*****************************************************************************/
 RME_Inv_Stub
+                SUB      SP,SP,#0x20        ; Keep the exception frame
+                MOV      R0,R5              ; Pass the parameter
                 BLX      R4                 ; Branch to the actual entry address
                 ;BX       RME_Inv_Finish     ; Jump to exiting code, should never return.
                 B        .                  ; Capture faults.
@@ -89,25 +99,26 @@ RME_Svc
 ;/* End Function:RME_Svc *****************************************************/
 
 ;/* Begin Function:RME_Inv ****************************************************
-;Description : Do an invocation, and get the return value for that invocation as well.
+;Description : Do an invocation. The kernel only restores SP and LR when the
+;              invocation returns, so all the callee-saved registers are saved
+;              here. The return value of the invocation itself is in R5, and we
+;              do not need it.
 ;Input       : R4 - The system call number/other information.
 ;              R5 - The invocation capability.
 ;              R6 - The first argument for the invocation.
-;              R7 - Argument 3.
 ;Output      : None.                              
 ;*****************************************************************************/
 RME_Inv
-                PUSH       {R4-R7}  ; Manual clobbering
+                PUSH       {R4-R11,LR} ; Manual clobbering
                 MOV        R4,R0    ; Manually pass the parameters according to ARM calling convention
                 MOV        R5,R1
                 MOV        R6,R2
-                MOV        R7,R3
                 SVC        #0x00   
                 MOV        R0,R4    ; This is the return value
-                POP        {R4-R7}  ; Manual recovering
+                POP        {R4-R11,LR} ; Manual recovering
                 BX         LR
                 B          .        ; Shouldn't reach here.       
-;/* End Function:RME_Svc *****************************************************/
+;/* End Function:RME_Inv *****************************************************/
 
 ;/* Begin Function:__user_setup_stackheap *************************************
 ;Description : We place the function here to shut the SEMIHOSTING up.
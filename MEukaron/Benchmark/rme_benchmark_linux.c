@@ -0,0 +1,180 @@
+/******************************************************************************
+Filename    : rme_benchmark_linux.c
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The Linux-hosted platform hooks of the RME benchmark. Build it
+              together with rme_benchmark.c, the kernel and the Linux platform,
+              with RME_Bench_Entry as the init thread entry; "make suite" in the
+              Linux project does all this. The results are printed when all the
+              tests are done, and then the host process exits.
+******************************************************************************/
+
+/* Includes ******************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "rme_benchmark_linux.h"
+#include "rme_benchmark.h"
+#include "rme.h"
+/* End Includes **************************************************************/
+
+/* Function Prototypes *******************************************************/
+extern ptr_t RME_Bench_Kmem(ptr_t Size, ptr_t Align_Order);
+extern void RME_Bench_Check(ret_t Retval);
+extern void RME_Benchmark(ptr_t CPUID);
+static void RME_Bench_Print(const char* Name, struct RME_Bench_Stat* Stat);
+void RME_Bench_Entry(ptr_t CPUID);
+/* End Function Prototypes ***************************************************/
+
+/* Begin Function:RME_Svc *****************************************************
+Description : The system call stub. The Linux-hosted kernel is entered through
+              its system call gate.
+Input       : ptr_t Svc_Capid - The system call number and capability ID.
+              ptr_t Param1 - Argument 1.
+              ptr_t Param2 - Argument 2.
+              ptr_t Param3 - Argument 3.
+Output      : None.
+Return      : ret_t - The return value of the system call.
+******************************************************************************/
+ret_t RME_Svc(ptr_t Svc_Capid, ptr_t Param1, ptr_t Param2, ptr_t Param3)
+{
+    return __RME_LINUX_Svc(Svc_Capid, Param1, Param2, Param3, 0);
+}
+/* End Function:RME_Svc ******************************************************/
+
+/* Begin Function:RME_Inv *****************************************************
+Description : The synchronous invocation stub. The parameter is passed where the
+              Linux-hosted kernel expects the first invocation argument.
+Input       : ptr_t Svc_Capid - The system call number.
+              ptr_t Cap_Inv - The invocation capability.
+              ptr_t Param - The parameter to the invocation.
+Output      : None.
+Return      : ret_t - The return value of the system call.
+******************************************************************************/
+ret_t RME_Inv(ptr_t Svc_Capid, ptr_t Cap_Inv, ptr_t Param)
+{
+    return __RME_LINUX_Svc(Svc_Capid, Cap_Inv, Param, 0, 0);
+}
+/* End Function:RME_Inv ******************************************************/
+
+/* Begin Function:RME_Bench_Plat_Init *****************************************
+Description : Initialize the timestamp counter. The host TSC is always running,
+              so there is nothing to do.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Plat_Init(void)
+{
+    return;
+}
+/* End Function:RME_Bench_Plat_Init ******************************************/
+
+/* Begin Function:RME_Bench_Plat_Stack ****************************************
+Description : Get the initial stack pointer of a thread or an invocation. The
+              kernel places the ucontext at the top of the stack by itself.
+Input       : ptr_t* Stack - The stack.
+              ptr_t Words - The size of the stack, in words.
+Output      : None.
+Return      : ptr_t - The initial stack pointer.
+******************************************************************************/
+ptr_t RME_Bench_Plat_Stack(ptr_t* Stack, ptr_t Words)
+{
+    return ((ptr_t)(&Stack[Words]))&(~((ptr_t)0x0F));
+}
+/* End Function:RME_Bench_Plat_Stack *****************************************/
+
+/* Begin Function:RME_Bench_Plat_Pgtbl ****************************************
+Description : Create the page tables used by the tests. The page tables are only
+              bookkeeping on the host, and the init process's one maps the whole
+              user space as one page. The top-level page table of the second
+              process maps that page too, and the mapping test uses another page
+              table of the same shape, which is not used by any process.
+Input       : cid_t Cap_Captbl - The capability table to create them in.
+              ptr_t Pgtbl_Proc - The slot of the second process's page table.
+              ptr_t Pgtbl_Map - The slot of the page table to map pages into.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Plat_Pgtbl(cid_t Cap_Captbl, ptr_t Pgtbl_Proc, ptr_t Pgtbl_Map)
+{
+    RME_Bench_Check(RME_CAP_OP(RME_PGTBL_SVC(RME_PGTBL_NUM_1,RME_SVC_PGTBL_CRT),Cap_Captbl,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_Q1(Pgtbl_Proc)|RME_PARAM_Q0(RME_PGTBL_SIZE_128T),
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0),
+                               0|RME_PGTBL_TOP));
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_PGTBL_ADD,RME_PGTBL_ALL_PERM,
+                               RME_PARAM_D1(RME_CAPID(Cap_Captbl,Pgtbl_Proc))|RME_PARAM_D0(0),
+                               RME_PARAM_D1(RME_BOOT_PGTBL)|RME_PARAM_D0(0),
+                               0));
+
+    RME_Bench_Check(RME_CAP_OP(RME_PGTBL_SVC(RME_PGTBL_NUM_1,RME_SVC_PGTBL_CRT),Cap_Captbl,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_Q1(Pgtbl_Map)|RME_PARAM_Q0(RME_PGTBL_SIZE_128T),
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,0),
+                               0|RME_PGTBL_NOM));
+}
+/* End Function:RME_Bench_Plat_Pgtbl *****************************************/
+
+/* Begin Function:RME_Bench_Print *********************************************
+Description : Print the statistics of one test, in TSC cycles.
+Input       : const char* Name - The name of the test.
+              struct RME_Bench_Stat* Stat - The statistics.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Print(const char* Name, struct RME_Bench_Stat* Stat)
+{
+    printf("%-14s Min %6llu Max %9llu Avg %6llu Fail %llu\n",
+           Name, Stat->Min, Stat->Max, Stat->Avg, Stat->Fail);
+}
+/* End Function:RME_Bench_Print **********************************************/
+
+/* Begin Function:RME_Bench_Plat_Done *****************************************
+Description : Called when all the tests are done. Print RME_Bench_Result, and
+              exit the host process.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Plat_Done(void)
+{
+    printf("\nTSC overhead %llu, setup failures %llu\n",
+           RME_Bench_Result.TSC_Overhead, RME_Bench_Result.Setup_Fail);
+    RME_Bench_Print("Sig_Snd", &(RME_Bench_Result.Sig_Snd));
+    RME_Bench_Print("Thd_Swt", &(RME_Bench_Result.Thd_Swt));
+    RME_Bench_Print("Thd_Swt_Proc", &(RME_Bench_Result.Thd_Swt_Proc));
+    RME_Bench_Print("Inv", &(RME_Bench_Result.Inv));
+    RME_Bench_Print("Inv_Proc", &(RME_Bench_Result.Inv_Proc));
+    RME_Bench_Print("Sig_Rcv", &(RME_Bench_Result.Sig_Rcv));
+    RME_Bench_Print("Sig_Rcv_Proc", &(RME_Bench_Result.Sig_Rcv_Proc));
+    RME_Bench_Print("Captbl_Crt", &(RME_Bench_Result.Captbl_Crt));
+    RME_Bench_Print("Captbl_Del", &(RME_Bench_Result.Captbl_Del));
+    RME_Bench_Print("Captbl_Add", &(RME_Bench_Result.Captbl_Add));
+    RME_Bench_Print("Captbl_Rem", &(RME_Bench_Result.Captbl_Rem));
+    RME_Bench_Print("Pgtbl_Add", &(RME_Bench_Result.Pgtbl_Add));
+    RME_Bench_Print("Pgtbl_Rem", &(RME_Bench_Result.Pgtbl_Rem));
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+}
+/* End Function:RME_Bench_Plat_Done ******************************************/
+
+/* Begin Function:RME_Bench_Entry *********************************************
+Description : The init thread of each CPU. CPU 0 runs the benchmark, and the
+              other CPUs just sleep on their ticks.
+Input       : ptr_t CPUID - The CPUID.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Entry(ptr_t CPUID)
+{
+    if(CPUID==0)
+        RME_Benchmark(0);
+
+    while(1)
+        RME_CAP_OP(RME_SVC_KERN,RME_BOOT_INIT_KERN,RME_BENCH_KERN_IDLE_SLEEP,0,0);
+}
+/* End Function:RME_Bench_Entry **********************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
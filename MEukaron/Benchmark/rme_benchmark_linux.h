@@ -0,0 +1,116 @@
+/******************************************************************************
+Filename    : rme_benchmark_linux.h
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The Linux-hosted platform header of the RME benchmark. This describes
+              the boot capabilities, the memory that the tests can use and how to
+              read the timestamp counter on the x64 host, for rme_benchmark.c.
+******************************************************************************/
+
+/* Defines *******************************************************************/
+#ifndef __RME_BENCHMARK_LINUX_H__
+#define __RME_BENCHMARK_LINUX_H__
+/* Types */
+typedef signed long long s64;
+typedef signed int s32;
+typedef signed short s16;
+typedef signed char s8;
+typedef unsigned long long u64;
+typedef unsigned int u32;
+typedef unsigned short u16;
+typedef unsigned char u8;
+typedef s64 tid_t;
+typedef u64 ptr_t;
+typedef s64 cnt_t;
+typedef s64 cid_t;
+typedef s64 ret_t;
+
+/* System service stub */
+#define RME_CAP_OP(OP,CAPID,ARG1,ARG2,ARG3) RME_Svc((((ptr_t)(OP))<<(sizeof(ptr_t)*4))|(CAPID),ARG1,ARG2,ARG3)
+/* Synchronous invocation stub */
+#define RME_INV_OP(CAP_INV,PARAM)           RME_Inv(((ptr_t)RME_SVC_INV_ACT)<<(sizeof(ptr_t)*4),CAP_INV,PARAM)
+/* Page table creation also passes the number order in the system call number */
+#define RME_PGTBL_SVC(NUM_ORDER,SVC)        ((((ptr_t)(NUM_ORDER))<<(sizeof(ptr_t)*2))|(SVC))
+/* Whether the page table is a top-level one, placed along with the base address */
+#define RME_PGTBL_TOP                       1
+#define RME_PGTBL_NOM                       0
+#define RME_PARAM_D_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*4))
+#define RME_PARAM_Q_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*6))
+/* The parameter passing - not to be confused with kernel macros. These macros just place the parameters */
+#define RME_PARAM_D1(X)                     (((X)&RME_PARAM_D_MASK)<<(sizeof(ptr_t)*4))
+#define RME_PARAM_D0(X)                     ((X)&RME_PARAM_D_MASK)
+#define RME_PARAM_Q1(X)                     (((X)&RME_PARAM_Q_MASK)<<(sizeof(ptr_t)*2))
+#define RME_PARAM_Q0(X)                     ((X)&RME_PARAM_Q_MASK)
+/* Capability ID placement */
+#define RME_CAPID_NULL                      (((cid_t)1)<<(sizeof(ptr_t)*4-1))
+#define RME_CAPID_2L                        (((cid_t)1)<<(sizeof(ptr_t)*2-1))
+#define RME_CAPID(X,Y)                      (((X)<<(sizeof(ptr_t)*2))|(Y)|RME_CAPID_2L)
+
+/* Initial boot capabilities - This should be in accordance with the kernel settings */
+/* The capability table of the init process */
+#define RME_BOOT_CAPTBL                     0
+/* The top-level page table of the init process - the whole host user space as one page */
+#define RME_BOOT_PGTBL                      1
+/* The init process */
+#define RME_BOOT_INIT_PROC                  2
+/* The capability table of the init threads */
+#define RME_BOOT_TBL_THD                    3
+/* The kernel function capability */
+#define RME_BOOT_INIT_KERN                  4
+/* The initial kernel memory capability */
+#define RME_BOOT_INIT_KMEM                  5
+
+/* The init thread on CPU 0 */
+#define RME_BENCH_INIT_THD                  RME_CAPID(RME_BOOT_TBL_THD,0)
+/* The kernel memory we create the objects in */
+#define RME_BENCH_KMEM                      RME_BOOT_INIT_KMEM
+/* The boot-time objects are registered as kernel objects, so the search skips them */
+#define RME_BENCH_KMEM_START                0
+/* An upper bound of the thread, invocation, signal, process and page table object sizes */
+#define RME_BENCH_OBJ_SIZE                  0x1000
+
+/* Number of rounds for each test */
+#define RME_BENCH_ROUNDS                    4096
+/* Number of capabilities we create or delegate before waiting for quiescence */
+#define RME_BENCH_BATCH                     256
+/* Number of slots in each capability table that we create */
+#define RME_BENCH_CAPTBL_ENTRY              16
+
+/* The page mapping test maps the only page of the init process into a page table
+ * of the same shape that is not used by any process, and at the same position */
+#define RME_BENCH_MAP_SRC                   RME_BOOT_PGTBL
+#define RME_BENCH_MAP_POS                   0
+#define RME_BENCH_MAP_FLAGS                 RME_PGTBL_ALL_PERM
+
+/* Kernel functions used */
+#define RME_BENCH_KERN_IDLE_SLEEP           0xF400
+
+/* Read the timestamp counter */
+#define RME_BENCH_TSC()                     __builtin_ia32_rdtsc()
+/*****************************************************************************/
+/* __RME_BENCHMARK_LINUX_H__ */
+#endif
+/* End Defines ***************************************************************/
+
+/* Public C Function Prototypes **********************************************/
+/*****************************************************************************/
+#ifndef __RME_BENCHMARK_LINUX_MEMBERS__
+#define __RME_BENCHMARK_LINUX_MEMBERS__
+extern ret_t __RME_LINUX_Svc(ptr_t Svc_Capid, ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t* Reg_Ret);
+extern ret_t RME_Svc(ptr_t Svc_Capid, ptr_t Param1, ptr_t Param2, ptr_t Param3);
+extern ret_t RME_Inv(ptr_t Svc_Capid, ptr_t Cap_Inv, ptr_t Param);
+
+/* Platform hooks of the benchmark */
+extern void RME_Bench_Plat_Init(void);
+extern ptr_t RME_Bench_Plat_Stack(ptr_t* Stack, ptr_t Words);
+extern void RME_Bench_Plat_Pgtbl(cid_t Cap_Captbl, ptr_t Pgtbl_Proc, ptr_t Pgtbl_Map);
+extern void RME_Bench_Plat_Done(void);
+/*****************************************************************************/
+/* __RME_BENCHMARK_LINUX_MEMBERS__ */
+#endif
+/* End Public C Function Prototypes ******************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
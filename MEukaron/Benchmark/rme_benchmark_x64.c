@@ -0,0 +1,98 @@
+/******************************************************************************
+Filename    : rme_benchmark_x64.c
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The x64 platform hooks of the RME benchmark. The benchmark is meant
+              to be run under QEMU as the init process. Build it together with
+              rme_benchmark.c and the assembly file, link it at address 0 and
+              convert it to a UVM_Init image that the kernel links in place of
+              UVM.c; the bench.sh in the x64 project does all this. The results
+              are left in RME_Bench_Result, and can be read out with the QEMU
+              gdbstub at RME_Bench_Plat_Done.
+******************************************************************************/
+
+/* Includes ******************************************************************/
+#include "rme_benchmark_x64.h"
+#include "rme.h"
+/* End Includes **************************************************************/
+
+/* Function Prototypes *******************************************************/
+extern ptr_t RME_Bench_Kmem(ptr_t Size, ptr_t Align_Order);
+extern void RME_Bench_Check(ret_t Retval);
+/* End Function Prototypes ***************************************************/
+
+/* Begin Function:RME_Bench_Plat_Init *****************************************
+Description : Initialize the timestamp counter. The x64 TSC is always running,
+              so there is nothing to do.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Plat_Init(void)
+{
+    return;
+}
+/* End Function:RME_Bench_Plat_Init ******************************************/
+
+/* Begin Function:RME_Bench_Plat_Stack ****************************************
+Description : Get the initial stack pointer of a thread or an invocation. The
+              kernel jumps to the entry directly, so the stack will be 8 bytes
+              off 16-byte alignment, as if we were called.
+Input       : ptr_t* Stack - The stack.
+              ptr_t Words - The size of the stack, in words.
+Output      : None.
+Return      : ptr_t - The initial stack pointer.
+******************************************************************************/
+ptr_t RME_Bench_Plat_Stack(ptr_t* Stack, ptr_t Words)
+{
+    return (((ptr_t)(&Stack[Words-16]))&(~((ptr_t)0x0F)))-sizeof(ptr_t);
+}
+/* End Function:RME_Bench_Plat_Stack *****************************************/
+
+/* Begin Function:RME_Bench_Plat_Pgtbl ****************************************
+Description : Create the page tables used by the tests. The top-level page table
+              of the second process gets the kernel half by itself, and we make
+              it share the first PDP of the init process, which covers the image
+              and the stacks. The mapping test uses a lone page directory.
+Input       : cid_t Cap_Captbl - The capability table to create them in.
+              ptr_t Pgtbl_Proc - The slot of the second process's page table.
+              ptr_t Pgtbl_Map - The slot of the page directory to map pages into.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Plat_Pgtbl(cid_t Cap_Captbl, ptr_t Pgtbl_Proc, ptr_t Pgtbl_Map)
+{
+    RME_Bench_Check(RME_CAP_OP(RME_PGTBL_SVC(RME_PGTBL_NUM_512,RME_SVC_PGTBL_CRT),Cap_Captbl,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_Q1(Pgtbl_Proc)|RME_PARAM_Q0(RME_PGTBL_SIZE_512G),
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,RME_PGTBL_SIZE_4K),
+                               0|RME_PGTBL_TOP));
+    RME_Bench_Check(RME_CAP_OP(RME_SVC_PGTBL_CON,0,
+                               RME_PARAM_D1(RME_CAPID(Cap_Captbl,Pgtbl_Proc))|
+                               RME_PARAM_D0(RME_CAPID(RME_BOOT_TBL_PGTBL,RME_BOOT_PDP(0))),
+                               0,
+                               RME_PGTBL_ALL_PERM));
+
+    RME_Bench_Check(RME_CAP_OP(RME_PGTBL_SVC(RME_PGTBL_NUM_512,RME_SVC_PGTBL_CRT),Cap_Captbl,
+                               RME_PARAM_D1(RME_BENCH_KMEM)|RME_PARAM_Q1(Pgtbl_Map)|RME_PARAM_Q0(RME_PGTBL_SIZE_2M),
+                               RME_Bench_Kmem(RME_BENCH_OBJ_SIZE,RME_PGTBL_SIZE_4K),
+                               0|RME_PGTBL_NOM));
+}
+/* End Function:RME_Bench_Plat_Pgtbl *****************************************/
+
+/* Begin Function:RME_Bench_Plat_Done *****************************************
+Description : Called when all the tests are done. Set a hardware breakpoint here
+              with the QEMU gdbstub, and print RME_Bench_Result.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Plat_Done(void)
+{
+    return;
+}
+/* End Function:RME_Bench_Plat_Done ******************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
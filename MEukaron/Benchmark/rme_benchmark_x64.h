@@ -0,0 +1,117 @@
+/******************************************************************************
+Filename    : rme_benchmark_x64.h
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The x64 platform header of the RME benchmark. This describes the
+              boot capabilities, the memory that the tests can use and how to
+              read the timestamp counter on x64, for rme_benchmark.c.
+******************************************************************************/
+
+/* Defines *******************************************************************/
+#ifndef __RME_BENCHMARK_X64_H__
+#define __RME_BENCHMARK_X64_H__
+/* Types */
+typedef signed long long s64;
+typedef signed int s32;
+typedef signed short s16;
+typedef signed char s8;
+typedef unsigned long long u64;
+typedef unsigned int u32;
+typedef unsigned short u16;
+typedef unsigned char u8;
+typedef s64 tid_t;
+typedef u64 ptr_t;
+typedef s64 cnt_t;
+typedef s64 cid_t;
+typedef s64 ret_t;
+
+/* System service stub */
+#define RME_CAP_OP(OP,CAPID,ARG1,ARG2,ARG3) RME_Svc((((ptr_t)(OP))<<(sizeof(ptr_t)*4))|(CAPID),ARG1,ARG2,ARG3)
+/* Synchronous invocation stub */
+#define RME_INV_OP(CAP_INV,PARAM)           RME_Inv(((ptr_t)RME_SVC_INV_ACT)<<(sizeof(ptr_t)*4),CAP_INV,PARAM)
+/* Page table creation also passes the number order in the system call number */
+#define RME_PGTBL_SVC(NUM_ORDER,SVC)        ((((ptr_t)(NUM_ORDER))<<(sizeof(ptr_t)*2))|(SVC))
+/* Whether the page table is a top-level one, placed along with the base address */
+#define RME_PGTBL_TOP                       1
+#define RME_PGTBL_NOM                       0
+#define RME_PARAM_D_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*4))
+#define RME_PARAM_Q_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*6))
+/* The parameter passing - not to be confused with kernel macros. These macros just place the parameters */
+#define RME_PARAM_D1(X)                     (((X)&RME_PARAM_D_MASK)<<(sizeof(ptr_t)*4))
+#define RME_PARAM_D0(X)                     ((X)&RME_PARAM_D_MASK)
+#define RME_PARAM_Q1(X)                     (((X)&RME_PARAM_Q_MASK)<<(sizeof(ptr_t)*2))
+#define RME_PARAM_Q0(X)                     ((X)&RME_PARAM_Q_MASK)
+/* Capability ID placement */
+#define RME_CAPID_NULL                      (((cid_t)1)<<(sizeof(ptr_t)*4-1))
+#define RME_CAPID_2L                        (((cid_t)1)<<(sizeof(ptr_t)*2-1))
+#define RME_CAPID(X,Y)                      (((X)<<(sizeof(ptr_t)*2))|(Y)|RME_CAPID_2L)
+
+/* Initial boot capabilities - This should be in accordance with the kernel settings */
+/* The capability table of the init process */
+#define RME_BOOT_CAPTBL                     0
+/* The capability table of the initial page tables */
+#define RME_BOOT_TBL_PGTBL                  1
+/* The init process */
+#define RME_BOOT_INIT_PROC                  2
+/* The capability table of the init threads */
+#define RME_BOOT_TBL_THD                    3
+/* The capability table of the kernel memory */
+#define RME_BOOT_TBL_KMEM                   5
+/* The positions of the initial page tables in their table */
+#define RME_BOOT_PML4                       0
+#define RME_BOOT_PDP(X)                     (RME_BOOT_PML4+1+(X))
+#define RME_BOOT_PDE(X)                     (RME_BOOT_PDP(16)+(X))
+
+/* The init thread on CPU 0 */
+#define RME_BENCH_INIT_THD                  RME_CAPID(RME_BOOT_TBL_THD,0)
+/* The kernel memory we create the objects in. This is the first Kmem1 segment,
+ * because Kmem2 does not allow page tables */
+#define RME_BENCH_KMEM                      RME_CAPID(RME_BOOT_TBL_KMEM,0)
+/* The first 16 2MB pages of Kmem1 hold the init process, and they are not
+ * registered as kernel objects, so we must never search them */
+#define RME_BENCH_KMEM_START                (16*0x200000ULL)
+/* An upper bound of the thread, invocation, signal and process object sizes */
+#define RME_BENCH_OBJ_SIZE                  0x1000
+
+/* Number of rounds for each test */
+#define RME_BENCH_ROUNDS                    4096
+/* Number of capabilities we create or delegate before waiting for quiescence */
+#define RME_BENCH_BATCH                     256
+/* Number of slots in each capability table that we create */
+#define RME_BENCH_CAPTBL_ENTRY              16
+
+/* The page mapping test maps this 2MB page of the init process into a page
+ * directory that is not connected anywhere, and at the same position */
+#define RME_BENCH_MAP_SRC                   RME_CAPID(RME_BOOT_TBL_PGTBL,RME_BOOT_PDE(0))
+#define RME_BENCH_MAP_POS                   15
+#define RME_BENCH_MAP_FLAGS                 RME_PGTBL_ALL_PERM
+
+/* Read the timestamp counter */
+#define RME_BENCH_TSC()                     RME_X64_TSC()
+/*****************************************************************************/
+/* __RME_BENCHMARK_X64_H__ */
+#endif
+/* End Defines ***************************************************************/
+
+/* Public C Function Prototypes **********************************************/
+/*****************************************************************************/
+#ifndef __RME_BENCHMARK_X64_MEMBERS__
+#define __RME_BENCHMARK_X64_MEMBERS__
+extern ret_t RME_Svc(ptr_t Svc_Capid, ptr_t Param1, ptr_t Param2, ptr_t Param3);
+extern ret_t RME_Inv(ptr_t Svc_Capid, ptr_t Cap_Inv, ptr_t Param);
+extern ptr_t RME_X64_TSC(void);
+
+/* Platform hooks of the benchmark */
+extern void RME_Bench_Plat_Init(void);
+extern ptr_t RME_Bench_Plat_Stack(ptr_t* Stack, ptr_t Words);
+extern void RME_Bench_Plat_Pgtbl(cid_t Cap_Captbl, ptr_t Pgtbl_Proc, ptr_t Pgtbl_Map);
+extern void RME_Bench_Plat_Done(void);
+/*****************************************************************************/
+/* __RME_BENCHMARK_X64_MEMBERS__ */
+#endif
+/* End Public C Function Prototypes ******************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
@@ -33,6 +33,8 @@ Description : The header of the kernel. Whitebox testing of all branches encapsu
 #define RME_ROUND_DOWN(NUM,POW)         ((NUM)&(RME_MASK_START(POW)))
 #define RME_ROUND_UP(NUM,POW)           RME_ROUND_DOWN((NUM)+RME_MASK_END(POW-1),POW)
 #define RME_POW2(POW)                   (((rme_ptr_t)1)<<(POW))
+/* Get the least significant bit of a nonzero word, with the platform's RME_MSB_GET */
+#define RME_LSB_GET(VAL)                RME_MSB_GET((VAL)&(~(VAL)+1))
 /* Check if address is aligned on word boundary */
 #define RME_IS_ALIGNED(ADDR)            (((ADDR)&RME_MASK_END(RME_WORD_ORDER-4))==0)
 /* Bit field extraction macros for easy extraction of parameters
@@ -67,6 +69,19 @@ Description : The header of the kernel. Whitebox testing of all branches encapsu
 /* The page table creation extra parameter packed in the svc number */
 #define RME_PARAM_PC(SVC)               ((SVC)>>((sizeof(rme_ptr_t)<<1)))
 
+/* The number of entries in the system call dispatch table. The system call number
+ * is masked with this minus one, so this must be a power of 2 */
+#define RME_SVC_TBL_NUM                 64
+/* The system call may switch the register set, and sets the return value by itself */
+#define RME_SVC_FLAG_SWT                (((rme_ptr_t)1)<<0)
+/* The system call may remove mappings, and other processors must drop them before we return */
+#define RME_SVC_FLAG_SYNC               (((rme_ptr_t)1)<<1)
+/* The system call can be done in a batch */
+#define RME_SVC_FLAG_BATCH              (((rme_ptr_t)1)<<2)
+/* The maximum number of operations in a single batched system call. This bounds
+ * the time that we spend in the kernel with the interrupts disabled */
+#define RME_SVC_BATCH_MAX               128
+
 /* The return procedure of a possible context switch - If successful, the function itself
  * is responsible for setting the parameters; If failed, we set the parameters for it.
  * Possible categories of context switch includes synchronous invocation and thread switch. */
@@ -143,6 +158,32 @@ do \
 while(0)
 #endif
 
+/* Kernel event tracing */
+/* #define RME_TRACE */
+/* The number of entries in each per-CPU trace ring is 2^RME_TRACE_ORDER */
+#define RME_TRACE_ORDER             8
+#define RME_TRACE_NUM               RME_POW2(RME_TRACE_ORDER)
+/* Trace recording macro */
+#ifdef RME_TRACE
+#define RME_TRACE_EVENT(TYPE,ARG0,ARG1) \
+do \
+{ \
+    _RME_Trace_Put(RME_CPU_LOCAL(),(TYPE),(rme_ptr_t)(ARG0),(rme_ptr_t)(ARG1)); \
+} \
+while(0)
+#else
+#define RME_TRACE_EVENT(TYPE,ARG0,ARG1) \
+do \
+{ \
+    \
+} \
+while(0)
+#endif
+
+/* Per-thread processor cycle accounting. This reads the cycle counter on each context
+ * switch, and on each invocation and return */
+#define RME_CYCLE_ACCT
+
 /* Kernel Object Table *******************************************************/
 /* Bitmap reference error */
 #define RME_ERR_KOT_BMP             (-1)
@@ -151,6 +192,11 @@ while(0)
 #define RME_KOTBL_SLOT_NUM          (RME_KMEM_SIZE>>RME_KMEM_SLOT_ORDER)
 #define RME_KOTBL_SLOT_SIZE         RME_POW2(RME_KMEM_SLOT_ORDER)
 #define RME_KOTBL_WORD_NUM          (RME_KOTBL_SLOT_NUM>>RME_WORD_ORDER)
+/* The summary bitmap has one bit for each word, which is set when the whole word is
+ * populated by a single object. In that case the word itself is left as zero */
+#define RME_KOTBL_SUM_NUM           ((RME_KOTBL_WORD_NUM+RME_WORD_BITS-1)>>RME_WORD_ORDER)
+#define RME_KOTBL_SUM_WORD(WORD)    ((WORD)>>RME_WORD_ORDER)
+#define RME_KOTBL_SUM_BIT(WORD)     RME_POW2((WORD)&RME_MASK_END(RME_WORD_ORDER-1))
 /* Round the kernel object size to the entry slot size */
 #define RME_KOTBL_ROUND(X)          RME_ROUND_UP(X,RME_KMEM_SLOT_ORDER)
 
@@ -177,6 +223,12 @@ while(0)
 /* This capability is currently freezed, and new operations cannot be initiated on it */
 #define RME_CAP_FROZEN              (((rme_ptr_t)1)<<((sizeof(rme_ptr_t)*6)-1))
 
+/* Capability resolution cache - caches where a 2-level capid lands. The
+ * number of entries is 2^RME_CAP_CACHE_ORDER and each CPU has its own. */
+#define RME_CAP_CACHE_ORDER         4
+#define RME_CAP_CACHE_NUM           RME_POW2(RME_CAP_CACHE_ORDER)
+#define RME_CAP_CACHE_HASH(X)       ((RME_CAP_H(X)^RME_CAP_L(X))&(RME_CAP_CACHE_NUM-1))
+
 /* Capability size macro */
 #define RME_CAP_SIZE                (8*sizeof(rme_ptr_t))
 /* Capability table size calculation macro */
@@ -326,10 +378,9 @@ do \
 { \
     /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
     (TEMP)=RME_READ_ACQUIRE(&((CAP)->Head.Type_Ref)); \
-    /* See if the slot is frozen, and its cap must be non-zero */ \
-    if(RME_UNLIKELY(((TEMP)&RME_CAP_FROZEN)!=0)) \
-        return RME_ERR_CAP_FROZEN; \
-    /* See if we are in the creation/delegation process - This frozen flag is set by the creator */ \
+    /* A frozen slot can still be deleted or removed, as the freeze only stops new \
+     * lookups through it. See if we are in the creation/delegation process - then \
+     * the frozen flag is set by the creator, and there is no type yet */ \
     if(RME_UNLIKELY(RME_CAP_TYPE(TEMP)==RME_CAP_NOP)) \
         return RME_ERR_CAP_NULL; \
     /* See if the cap type is correct. Only deletion checks type, while removing does not */ \
@@ -358,10 +409,9 @@ do \
 { \
     /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
     (TEMP)=RME_READ_ACQUIRE(&((CAP)->Head.Type_Ref)); \
-    /* See if the slot is frozen, and its cap must be non-zero */ \
-    if(RME_UNLIKELY(((TEMP)&RME_CAP_FROZEN)!=0)) \
-        return RME_ERR_CAP_FROZEN; \
-    /* See if we are in the creation/delegation process - This frozen flag is set by the creator */ \
+    /* A frozen slot can still be deleted or removed, as the freeze only stops new \
+     * lookups through it. See if we are in the creation/delegation process - then \
+     * the frozen flag is set by the creator, and there is no type yet */ \
     if(RME_UNLIKELY(RME_CAP_TYPE(TEMP)==RME_CAP_NOP)) \
         return RME_ERR_CAP_NULL; \
     /* See if the slot is quiescent */ \
@@ -461,24 +511,30 @@ do \
     /* Yes, this is a 2-level cap */ \
     else \
     { \
-        /* Check if the cap to potential captbl is over range */ \
-        if(RME_UNLIKELY(RME_CAP_H(CAP_NUM)>=((CAPTBL)->Entry_Num))) \
-            return RME_ERR_CAP_RANGE; \
-        /* Get the cap slot */ \
-        (PARAM)=(TYPE)(&RME_CAP_GETOBJ(CAPTBL,struct RME_Cap_Captbl*)[RME_CAP_H(CAP_NUM)]); \
-        /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
-        (TEMP)=RME_READ_ACQUIRE(&((PARAM)->Head.Type_Ref)); \
-        /* See if the captbl is frozen for deletion or removal */ \
-        if(RME_UNLIKELY(((TEMP)&RME_CAP_FROZEN)!=0)) \
-            return RME_ERR_CAP_FROZEN; \
-        /* See if this is a captbl */ \
-        if(RME_UNLIKELY(RME_CAP_TYPE(TEMP)!=RME_CAP_CAPTBL)) \
-            return RME_ERR_CAP_TYPE; \
-        /* Check if the 2nd-layer captbl is over range */ \
-        if(RME_UNLIKELY(RME_CAP_L(CAP_NUM)>=(((struct RME_Cap_Captbl*)(PARAM))->Entry_Num))) \
-            return RME_ERR_CAP_RANGE; \
-        /* Get the cap slot and check the type */ \
-        (PARAM)=(TYPE)(&RME_CAP_GETOBJ(PARAM,struct RME_Cap_Struct*)[RME_CAP_L(CAP_NUM)]); \
+        /* See if the per-CPU cache already knows where the slot is */ \
+        (PARAM)=(TYPE)_RME_Captbl_Cache_Get(CAPTBL,CAP_NUM); \
+        if((PARAM)==0) \
+        { \
+            /* Check if the cap to potential captbl is over range */ \
+            if(RME_UNLIKELY(RME_CAP_H(CAP_NUM)>=((CAPTBL)->Entry_Num))) \
+                return RME_ERR_CAP_RANGE; \
+            /* Get the cap slot */ \
+            (PARAM)=(TYPE)(&RME_CAP_GETOBJ(CAPTBL,struct RME_Cap_Captbl*)[RME_CAP_H(CAP_NUM)]); \
+            /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
+            (TEMP)=RME_READ_ACQUIRE(&((PARAM)->Head.Type_Ref)); \
+            /* See if the captbl is frozen for deletion or removal */ \
+            if(RME_UNLIKELY(((TEMP)&RME_CAP_FROZEN)!=0)) \
+                return RME_ERR_CAP_FROZEN; \
+            /* See if this is a captbl */ \
+            if(RME_UNLIKELY(RME_CAP_TYPE(TEMP)!=RME_CAP_CAPTBL)) \
+                return RME_ERR_CAP_TYPE; \
+            /* Check if the 2nd-layer captbl is over range */ \
+            if(RME_UNLIKELY(RME_CAP_L(CAP_NUM)>=(((struct RME_Cap_Captbl*)(PARAM))->Entry_Num))) \
+                return RME_ERR_CAP_RANGE; \
+            /* Get the cap slot and remember it in the cache */ \
+            (PARAM)=(TYPE)(&RME_CAP_GETOBJ(PARAM,struct RME_Cap_Struct*)[RME_CAP_L(CAP_NUM)]); \
+            _RME_Captbl_Cache_Set(CAPTBL,CAP_NUM,(struct RME_Cap_Struct*)(PARAM)); \
+        } \
         /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
         (TEMP)=RME_READ_ACQUIRE(&((PARAM)->Head.Type_Ref)); \
         /* See if the capability is frozen */ \
@@ -558,6 +614,8 @@ while(0)
 
 /* Thread binding state */
 #define RME_THD_UNBINDED           ((struct RME_CPU_Local*)((rme_ptr_t)(-1)))
+/* The thread is on its way to another core, and no core can operate on it */
+#define RME_THD_MIGRATING          ((struct RME_CPU_Local*)((rme_ptr_t)(-2)))
 /* Thread sched rcv faulty state */
 #define RME_THD_FAULT_FLAG         (((rme_ptr_t)1)<<(sizeof(rme_ptr_t)*8-2))
 /* Init thread infinite time marker */
@@ -569,6 +627,13 @@ while(0)
 /* Get the size of kernel objects */
 #define RME_PROC_SIZE              sizeof(struct RME_Proc_Struct)
 #define RME_THD_SIZE               sizeof(struct RME_Thd_Struct)
+/* Get the thread from its EDF list head */
+#define RME_EDF_THD(LIST)          ((struct RME_Thd_Struct*)(((struct RME_List*)(LIST))-2))
+/* Does thread A run before thread B on the same priority level? EDF threads run before
+ * the fixed-priority ones, and those with earlier deadlines run first */
+#define RME_EDF_BEFORE(A,B)        (((A)->Sched.Period!=0)&& \
+                                    (((B)->Sched.Period==0)|| \
+                                     (((rme_cnt_t)((A)->Sched.Deadline-(B)->Sched.Deadline))<0)))
     
 /* Time checking macro */
 #define RME_TIME_CHECK(DST,AMOUNT) \
@@ -587,6 +652,15 @@ while(0)
 /* The kernel object sizes */
 #define RME_INV_SIZE              sizeof(struct RME_Inv_Struct)
 #define RME_SIG_SIZE              sizeof(struct RME_Sig_Struct)
+/* The end of a per-CPU wakeup mailbox. This can never be a valid object address */
+#define RME_SIG_WAKE_END          ((rme_ptr_t)1)
+/* The number of words carried by each send to an endpoint with a payload ring */
+#define RME_SIG_DATA_NUM          2
+/* The maximum order of the number of slots in a payload ring */
+#define RME_SIG_RING_MAX_ORDER    16
+/* The size of an endpoint with a payload ring. The slots are right after the endpoint */
+#define RME_SIG_RING_SIZE(NUM)    (RME_SIG_SIZE+((NUM)*sizeof(struct RME_Sig_Slot)))
+#define RME_SIG_RING(SIG)         ((struct RME_Sig_Slot*)(((rme_ptr_t)(SIG))+RME_SIG_SIZE))
 
 /* Get the top of invocation stack */
 #define RME_INVSTK_TOP(THD)       ((struct RME_Inv_Struct*)((((THD)->Inv_Stack.Next)==&((THD)->Inv_Stack))? \
@@ -645,6 +719,17 @@ struct RME_Cap_Struct
     rme_ptr_t Info[3];
 };
 
+/* Batched system call operation, as placed in the user buffer */
+struct RME_Svc_Batch_Op
+{
+    /* The system call number in the upper half, and the capability ID in the lower half */
+    rme_ptr_t Svc_Capid;
+    /* The three parameters, in the same format as the normal system call */
+    rme_ptr_t Param[3];
+    /* The return value of this operation, filled in by the kernel */
+    rme_ptr_t Retval;
+};
+
 /* Capability Table **********************************************************/
 /* Capability table capability structure */
 struct RME_Cap_Captbl
@@ -695,6 +780,8 @@ struct RME_List
 /* Per-CPU run queue structure */
 struct RME_Run_Struct
 {
+    /* The summary bitmap marking to show if there are any bits set in a bitmap word */
+    rme_ptr_t Bitmap_Sum;
     /* The bitmap marking to show if there are active threads at a run level */
     rme_ptr_t Bitmap[RME_PRIO_WORD_NUM];
     /* The actual RME running list */
@@ -728,19 +815,38 @@ struct RME_Thd_Sched
     /* The list head for notifications - This will be inserted into scheduler
      * threads' event list */
     struct RME_List Notif; 
+    /* The list head for budget replenishment - This will be inserted into the
+     * per-core EDF list if this thread is in the EDF class */
+    struct RME_List EDF;
     /* What's the TID of the thread? */
     rme_ptr_t TID;
     /* What is the CPU-local data structure that this thread is on? If this is
      * 0xFF....FF, then this is not binded to any core. "struct RME_CPU_Local" is
      * not yet defined here but compilation will still pass - it is a pointer */
     struct RME_CPU_Local* CPU_Local;
+    /* The next thread in the migration mailbox of the core that we are moving to */
+    rme_ptr_t Migr_Next;
     /* How much time slices is left for this thread? */
     rme_ptr_t Slices;
+#ifdef RME_CYCLE_ACCT
+    /* How many processor cycles has this thread used, and how many of them were used
+     * in the invocations that it made? These wrap around, so only the differences
+     * between two readings make sense */
+    rme_ptr_t Cycles;
+    rme_ptr_t Inv_Cycles;
+#endif
+    /* The EDF period and the budget in each period. If the period is 0, this
+     * thread is not in the EDF class */
+    rme_ptr_t Period;
+    rme_ptr_t Budget;
+    /* The absolute deadline, which is also when the next period begins */
+    rme_ptr_t Deadline;
     /* What is the current state of the thread? */
     rme_ptr_t State;
     /* What is the reason for the fault that killed the thread? */
     rme_ptr_t Fault;
-    /* How many children refered to it as the scheduler thread? */
+    /* How many children refered to it as the scheduler thread? This includes the
+     * threads that are in some migration mailbox, so it is changed atomically */
     rme_ptr_t Refcnt;
     /* What's the priority of the thread? */
     rme_ptr_t Prio;
@@ -791,6 +897,16 @@ struct RME_Cap_Thd
 };
 
 /* Signal and Invocation *****************************************************/
+/* Payload ring slot structure */
+struct RME_Sig_Slot
+{
+    /* The sequence number. This is the position of the slot when it is free to be
+     * filled, and the position plus one when it is filled */
+    rme_ptr_t Seq;
+    /* The words carried */
+    rme_ptr_t Data[RME_SIG_DATA_NUM];
+};
+
 /* Signal object stucture */
 struct RME_Sig_Struct
 {
@@ -802,7 +918,15 @@ struct RME_Sig_Struct
     rme_ptr_t Refcnt;
     /* What thread blocked on this one */
     struct RME_Thd_Struct* Thd;
-
+    /* The next endpoint in the wakeup mailbox of the blocked thread's CPU. 0 if this
+     * is not in any mailbox; the last one in the mailbox have RME_SIG_WAKE_END here */
+    rme_ptr_t Wake_Next;
+    /* The number of slots in the payload ring, 0 if there is none. The signal count
+     * is then the number of filled slots that are not yet taken */
+    rme_ptr_t Ring_Num;
+    /* The positions to take from and to fill at next */
+    rme_ptr_t Ring_Head;
+    rme_ptr_t Ring_Tail;
 };
 
 /* Signal capability structure */
@@ -828,6 +952,10 @@ struct RME_Inv_Struct
     rme_ptr_t Fault_Ret_Flag;
     /* The registers to be saved in the invocation */
     struct RME_Iret_Struct Ret;
+#ifdef RME_CYCLE_ACCT
+    /* How many cycles the thread had used when it made the invocation */
+    rme_ptr_t Cycle_Act;
+#endif
 };
 
 /* Invocation capability structure */
@@ -837,6 +965,49 @@ struct RME_Cap_Inv
     rme_ptr_t Info[3];
 };
 
+/* Capability resolution cache entry */
+struct RME_Cap_Cache_Entry
+{
+    /* The master capability table object that the lookup started from */
+    rme_ptr_t Captbl;
+    /* The 2-level capability ID */
+    rme_ptr_t Capid;
+    /* The capability slot that it resolves to. 0 means not filled */
+    struct RME_Cap_Struct* Slot;
+    /* The value of RME_Captbl_Gen when the entry was filled */
+    rme_ptr_t Gen;
+};
+
+/* Per-CPU capability resolution cache */
+struct RME_Cap_Cache
+{
+    /* Number of hits and misses */
+    rme_ptr_t Hit;
+    rme_ptr_t Miss;
+    /* The entries */
+    struct RME_Cap_Cache_Entry Entry[RME_CAP_CACHE_NUM];
+};
+
+/* Kernel event trace entry */
+struct RME_Trace_Entry
+{
+    /* The cycle counter value when the event happened */
+    rme_ptr_t Time;
+    /* The event type, and its two arguments */
+    rme_ptr_t Type;
+    rme_ptr_t Arg[2];
+};
+
+/* Per-CPU kernel event trace ring */
+struct RME_Trace
+{
+    /* The number of events ever recorded. The next one goes to this position, and
+     * the oldest one still held is RME_TRACE_NUM before it */
+    rme_ptr_t Head;
+    /* The entries */
+    struct RME_Trace_Entry Entry[RME_TRACE_NUM];
+};
+
 /* CPU-local data structure */
 struct RME_CPU_Local
 {
@@ -848,8 +1019,31 @@ struct RME_CPU_Local
     struct RME_Sig_Struct* Tick_Sig;
     /* The vector signal endpoint */
     struct RME_Sig_Struct* Vect_Sig;
+    /* The wakeup mailbox. Other CPUs post endpoints that have our threads blocked on
+     * them here, and then poke us with __RME_Wake_IPI */
+    rme_ptr_t Wake_Head;
+    /* The migration mailbox. Other CPUs post the threads that they move to us here,
+     * and we adopt them on the wakeup IPI or the next tick. 0 if it is empty */
+    rme_ptr_t Migr_Head;
+#ifdef RME_CYCLE_ACCT
+    /* The cycle counter value when the current thread was last charged its cycles */
+    rme_ptr_t Cycle_Last;
+#endif
     /* The runqueue and bitmap */
     struct RME_Run_Struct Run;
+    /* The EDF threads on this CPU, in the order of their deadlines */
+    struct RME_List EDF;
+    /* The capability resolution cache */
+    struct RME_Cap_Cache Cap_Cache;
+#ifdef RME_TRACE
+    /* The kernel event trace ring */
+    struct RME_Trace Trace;
+#endif
+#if(RME_TICKLESS==RME_TRUE)
+    /* The timestamps when the tick endpoint and the time slices were last accounted */
+    rme_ptr_t Tick_Last;
+    rme_ptr_t Slice_Last;
+#endif
 };
 
 /* Kernel Function ***********************************************************/
@@ -860,6 +1054,18 @@ struct RME_Cap_Kern
     rme_ptr_t Info[3];
 };
 
+/* System Call ***************************************************************/
+/* System call dispatch table entry */
+struct RME_Svc_Entry
+{
+    /* The parameter unpacking stub */
+    rme_ret_t (*Func)(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                      rme_ptr_t Svc, rme_ptr_t Capid,
+                      rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+    /* What the system call may do, RME_SVC_FLAG_* */
+    rme_ptr_t Flag;
+};
+
 /*****************************************************************************/
 /* __RME_KERNEL_H_STRUCTS__ */
 #endif
@@ -884,8 +1090,9 @@ struct RME_Cap_Kern
 /* If the header is not used in the public mode */
 #ifndef __HDR_PUBLIC_MEMBERS__
 /*****************************************************************************/
-/* Kernel object table */
+/* Kernel object table, and its summary bitmap */
 static rme_ptr_t RME_Kotbl[RME_KOTBL_WORD_NUM];
+static rme_ptr_t RME_Kotbl_Sum[RME_KOTBL_SUM_NUM];
 /*****************************************************************************/
 /* End Private Global Variables **********************************************/
 
@@ -894,6 +1101,133 @@ static rme_ptr_t RME_Kotbl[RME_KOTBL_WORD_NUM];
 static rme_ret_t __RME_Low_Level_Check(void);
 static rme_ret_t _RME_Syscall_Init(void);
 
+/* Batched system calls */
+static volatile rme_ptr_t* _RME_Svc_Batch_Word(struct RME_Proc_Struct* Proc, rme_ptr_t Vaddr,
+                                               rme_ptr_t* Start, rme_ptr_t* End, rme_ptr_t* Kaddr);
+static rme_ret_t _RME_Svc_Batch_Act(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                    rme_ptr_t Vaddr, rme_ptr_t Num);
+/* System call parameter unpacking stubs */
+static rme_ret_t _RME_Svc_Null(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                               rme_ptr_t Svc, rme_ptr_t Capid,
+                               rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Sig_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Kern(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                               rme_ptr_t Svc, rme_ptr_t Capid,
+                               rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Sched_Prio(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                         rme_ptr_t Svc, rme_ptr_t Capid,
+                                         rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Sched_Free(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                         rme_ptr_t Svc, rme_ptr_t Capid,
+                                         rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Time_Xfer(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                        rme_ptr_t Svc, rme_ptr_t Capid,
+                                        rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Swt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Captbl_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                     rme_ptr_t Svc, rme_ptr_t Capid,
+                                     rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Captbl_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                     rme_ptr_t Svc, rme_ptr_t Capid,
+                                     rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Captbl_Frz(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                     rme_ptr_t Svc, rme_ptr_t Capid,
+                                     rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Captbl_Add(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                     rme_ptr_t Svc, rme_ptr_t Capid,
+                                     rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Captbl_Rem(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                     rme_ptr_t Svc, rme_ptr_t Capid,
+                                     rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Pgtbl_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                    rme_ptr_t Svc, rme_ptr_t Capid,
+                                    rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Pgtbl_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                    rme_ptr_t Svc, rme_ptr_t Capid,
+                                    rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Pgtbl_Add(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                    rme_ptr_t Svc, rme_ptr_t Capid,
+                                    rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Pgtbl_Rem(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                    rme_ptr_t Svc, rme_ptr_t Capid,
+                                    rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Pgtbl_Con(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                    rme_ptr_t Svc, rme_ptr_t Capid,
+                                    rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Pgtbl_Des(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                    rme_ptr_t Svc, rme_ptr_t Capid,
+                                    rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Proc_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                   rme_ptr_t Svc, rme_ptr_t Capid,
+                                   rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Proc_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                   rme_ptr_t Svc, rme_ptr_t Capid,
+                                   rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Proc_Cpt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                   rme_ptr_t Svc, rme_ptr_t Capid,
+                                   rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Proc_Pgt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                   rme_ptr_t Svc, rme_ptr_t Capid,
+                                   rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Exec_Set(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                       rme_ptr_t Svc, rme_ptr_t Capid,
+                                       rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Hyp_Set(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                      rme_ptr_t Svc, rme_ptr_t Capid,
+                                      rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Sched_Bind(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                         rme_ptr_t Svc, rme_ptr_t Capid,
+                                         rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Sched_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                        rme_ptr_t Svc, rme_ptr_t Capid,
+                                        rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Sig_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Sig_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Inv_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Inv_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Inv_Set(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Batch(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                rme_ptr_t Svc, rme_ptr_t Capid,
+                                rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Kmem_Find(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                    rme_ptr_t Svc, rme_ptr_t Capid,
+                                    rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Sig_Ring_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                       rme_ptr_t Svc, rme_ptr_t Capid,
+                                       rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Sched_EDF(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                        rme_ptr_t Svc, rme_ptr_t Capid,
+                                        rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Sched_Migr(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                         rme_ptr_t Svc, rme_ptr_t Capid,
+                                         rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+static rme_ret_t _RME_Svc_Thd_Cycle_Get(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                        rme_ptr_t Svc, rme_ptr_t Capid,
+                                        rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2);
+
 /* Capability Table **********************************************************/
 /* Capability system calls */
 static rme_ret_t _RME_Captbl_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl_Crt, 
@@ -927,6 +1261,18 @@ static rme_ret_t _RME_Run_Ins(struct RME_Thd_Struct* Thd);
 static rme_ret_t _RME_Run_Del(struct RME_Thd_Struct* Thd);
 static struct RME_Thd_Struct* _RME_Run_High(struct RME_CPU_Local* CPU_Local);
 static rme_ret_t _RME_Run_Notif(struct RME_Thd_Struct* Thd);
+static void _RME_Run_EDF_Ins(struct RME_Thd_Struct* Thd);
+static void _RME_Run_EDF_Rep(struct RME_CPU_Local* CPU_Local);
+static void _RME_Run_Migr(struct RME_CPU_Local* CPU_Local);
+#if(RME_TICKLESS==RME_TRUE)
+/* Tickless time accounting */
+static void _RME_Tick_Charge(struct RME_Thd_Struct* Thd);
+static void _RME_Tick_Rearm(struct RME_Thd_Struct* Thd);
+#endif
+#ifdef RME_CYCLE_ACCT
+/* Processor cycle accounting */
+static void _RME_Cycle_Charge(struct RME_Thd_Struct* Thd);
+#endif
 static rme_ret_t _RME_Run_Swt(struct RME_Reg_Struct* Reg,
                               struct RME_Thd_Struct* Curr_Thd, 
                               struct RME_Thd_Struct* Next_Thd);
@@ -950,6 +1296,12 @@ static rme_ret_t _RME_Thd_Sched_Prio(struct RME_Cap_Captbl* Captbl,
 static rme_ret_t _RME_Thd_Sched_Free(struct RME_Cap_Captbl* Captbl, 
                                      struct RME_Reg_Struct* Reg, rme_cid_t Cap_Thd);
 static rme_ret_t _RME_Thd_Sched_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg, rme_cid_t Cap_Thd);
+static rme_ret_t _RME_Thd_Sched_EDF(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                    rme_cid_t Cap_Thd, rme_ptr_t Period, rme_ptr_t Budget);
+static rme_ret_t _RME_Thd_Sched_Migr(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                     rme_cid_t Cap_Thd, rme_cid_t Cap_Thd_Sched);
+static rme_ret_t _RME_Thd_Cycle_Get(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                     rme_cid_t Cap_Thd, rme_ptr_t Type);
 static rme_ret_t _RME_Thd_Time_Xfer(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
                                     rme_cid_t Cap_Thd_Dst, rme_cid_t Cap_Thd_Src, rme_ptr_t Time);
 static rme_ret_t _RME_Thd_Swt(struct RME_Cap_Captbl* Captbl,
@@ -960,10 +1312,18 @@ static rme_ret_t _RME_Thd_Swt(struct RME_Cap_Captbl* Captbl,
 /* Signal system calls */
 static rme_ret_t _RME_Sig_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl,
                               rme_cid_t Cap_Kmem, rme_cid_t Cap_Sig, rme_ptr_t Raddr);
+static rme_ret_t _RME_Sig_Ring_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_cid_t Cap_Kmem,
+                                   rme_cid_t Cap_Sig, rme_ptr_t Raddr, rme_ptr_t Ring_Order);
 static rme_ret_t _RME_Sig_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_cid_t Cap_Sig);
-static rme_ret_t _RME_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg, rme_cid_t Cap_Sig);
+static rme_ret_t _RME_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                              rme_cid_t Cap_Sig, rme_ptr_t Data0, rme_ptr_t Data1);
 static rme_ret_t _RME_Sig_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
                               rme_cid_t Cap_Sig, rme_ptr_t Option);
+/* Cross-core wakeup */
+static void _RME_Sig_Wake(struct RME_Sig_Struct* Sig, struct RME_CPU_Local* CPU_Local);
+/* Payload ring */
+static rme_ret_t _RME_Sig_Ring_Put(struct RME_Sig_Struct* Sig, rme_ptr_t Data0, rme_ptr_t Data1);
+static void _RME_Sig_Ring_Get(struct RME_Sig_Struct* Sig, struct RME_Reg_Struct* Reg);
 /* Invocation system calls */
 static rme_ret_t _RME_Inv_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl,
                               rme_cid_t Cap_Kmem, rme_cid_t Cap_Inv, rme_cid_t Cap_Proc, rme_ptr_t Raddr);
@@ -971,13 +1331,92 @@ static rme_ret_t _RME_Inv_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captb
 static rme_ret_t _RME_Inv_Set(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Inv,
                               rme_ptr_t Entry, rme_ptr_t Stack, rme_ptr_t Fault_Ret_Flag);
 static rme_ret_t _RME_Inv_Act(struct RME_Cap_Captbl* Captbl, 
-                              struct RME_Reg_Struct* Reg, rme_cid_t Cap_Inv, rme_ptr_t Param);
+                              struct RME_Reg_Struct* Reg, rme_cid_t Cap_Inv);
 static rme_ret_t _RME_Inv_Ret(struct RME_Reg_Struct* Reg, rme_ptr_t Retval, rme_ptr_t Fault_Flag);
 
+/* Kernel Memory *************************************************************/
+/* Kernel object table operations */
+static rme_ret_t _RME_Kotbl_Word_Mark(rme_ptr_t Word, rme_ptr_t Mask);
+static rme_ret_t _RME_Kotbl_Full_Mark(rme_ptr_t Start, rme_ptr_t End);
+static rme_ret_t _RME_Kotbl_Full_Check(rme_ptr_t Start, rme_ptr_t End);
+static void _RME_Kotbl_Full_Erase(rme_ptr_t Start, rme_ptr_t End);
+static rme_ptr_t _RME_Kotbl_Busy(rme_ptr_t Slot, rme_ptr_t Limit);
+static rme_ptr_t _RME_Kotbl_Free(rme_ptr_t Slot, rme_ptr_t Limit);
+/* Kernel memory system calls */
+static rme_ret_t _RME_Kmem_Find(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Kmem,
+                                rme_ptr_t Size, rme_ptr_t Raddr, rme_ptr_t Align_Order);
+
 /* Kernel Function ***********************************************************/
 static rme_ret_t _RME_Kern_Act(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
                                rme_cid_t Cap_Kern, rme_ptr_t Func_ID, rme_ptr_t Sub_ID, rme_ptr_t Param1, rme_ptr_t Param2);
 
+/* System call dispatch table, indexed by the system call number */
+static const struct RME_Svc_Entry RME_Svc_Tbl[RME_SVC_TBL_NUM]=
+{
+    /* Synchronous invocation - handled by the fast paths */
+    {_RME_Svc_Null, 0},
+    {_RME_Svc_Null, 0},
+    /* Signal, kernel function and scheduling - these may switch the register set */
+    {_RME_Svc_Sig_Snd, RME_SVC_FLAG_SWT},
+    {_RME_Svc_Sig_Rcv, RME_SVC_FLAG_SWT},
+    {_RME_Svc_Kern, RME_SVC_FLAG_SWT},
+    {_RME_Svc_Thd_Sched_Prio, RME_SVC_FLAG_SWT},
+    {_RME_Svc_Thd_Sched_Free, RME_SVC_FLAG_SWT},
+    {_RME_Svc_Thd_Time_Xfer, RME_SVC_FLAG_SWT},
+    {_RME_Svc_Thd_Swt, RME_SVC_FLAG_SWT},
+    /* Capability table */
+    {_RME_Svc_Captbl_Crt, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Captbl_Del, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Captbl_Frz, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Captbl_Add, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Captbl_Rem, RME_SVC_FLAG_BATCH},
+    /* Page table */
+    {_RME_Svc_Pgtbl_Crt, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Pgtbl_Del, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Pgtbl_Add, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Pgtbl_Rem, RME_SVC_FLAG_SYNC|RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Pgtbl_Con, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Pgtbl_Des, RME_SVC_FLAG_SYNC|RME_SVC_FLAG_BATCH},
+    /* Process */
+    {_RME_Svc_Proc_Crt, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Proc_Del, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Proc_Cpt, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Proc_Pgt, RME_SVC_FLAG_BATCH},
+    /* Thread */
+    {_RME_Svc_Thd_Crt, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Thd_Del, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Thd_Exec_Set, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Thd_Hyp_Set, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Thd_Sched_Bind, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Thd_Sched_Rcv, 0},
+    /* Signal */
+    {_RME_Svc_Sig_Crt, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Sig_Del, RME_SVC_FLAG_BATCH},
+    /* Invocation */
+    {_RME_Svc_Inv_Crt, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Inv_Del, RME_SVC_FLAG_BATCH},
+    {_RME_Svc_Inv_Set, RME_SVC_FLAG_BATCH},
+    /* Batched operations */
+    {_RME_Svc_Batch, RME_SVC_FLAG_SYNC},
+    /* Kernel memory */
+    {_RME_Svc_Kmem_Find, RME_SVC_FLAG_BATCH},
+    /* Signal with payload ring */
+    {_RME_Svc_Sig_Ring_Crt, RME_SVC_FLAG_BATCH},
+    /* Thread EDF parameters - this may switch the register set */
+    {_RME_Svc_Thd_Sched_EDF, RME_SVC_FLAG_SWT},
+    /* Thread migration - this may switch the register set */
+    {_RME_Svc_Thd_Sched_Migr, RME_SVC_FLAG_SWT},
+    /* Thread cycle accounting - this writes the register set */
+    {_RME_Svc_Thd_Cycle_Get, 0},
+    /* Unused */
+    {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0},
+    {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0},
+    {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0},
+    {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0},
+    {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0},
+    {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}, {_RME_Svc_Null, 0}
+};
+
 /*****************************************************************************/
 #define __EXTERN__
 /* End Private C Function Prototypes *****************************************/
@@ -992,6 +1431,9 @@ static rme_ret_t _RME_Kern_Act(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Str
 /*****************************************************************************/
 /* Current timestamp counter */
 __EXTERN__ rme_ptr_t RME_Timestamp;
+/* Capability table generation counter, increased when any captbl cap is frozen,
+ * deleted, removed, created or delegated */
+__EXTERN__ rme_ptr_t RME_Captbl_Gen;
 /*****************************************************************************/
 
 /* End Public Global Variables ***********************************************/
@@ -1021,6 +1463,11 @@ __EXTERN__ rme_cnt_t RME_Print_String(rme_s8_t* String);
 __EXTERN__ rme_ret_t _RME_Captbl_Boot_Init(rme_cid_t Cap_Captbl, rme_ptr_t Vaddr, rme_ptr_t Entry_Num);
 __EXTERN__ rme_ret_t _RME_Captbl_Boot_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl_Crt,
                                           rme_cid_t Cap_Crt, rme_ptr_t Vaddr, rme_ptr_t Entry_Num);
+/* Capability resolution cache */
+__EXTERN__ struct RME_Cap_Struct* _RME_Captbl_Cache_Get(struct RME_Cap_Captbl* Captbl, rme_cid_t Capid);
+__EXTERN__ void _RME_Captbl_Cache_Set(struct RME_Cap_Captbl* Captbl, rme_cid_t Capid,
+                                      struct RME_Cap_Struct* Slot);
+__EXTERN__ rme_ret_t _RME_Captbl_Cache_Stat(rme_ptr_t Sub_ID);
 
 /* Page Table ****************************************************************/
 /* Boot-time calls */
@@ -1065,12 +1512,18 @@ __EXTERN__ rme_ret_t _RME_Thd_Boot_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t
 /* Kernel send facilities */
 __EXTERN__ rme_ret_t _RME_Kern_Snd(struct RME_Sig_Struct* Sig);
 __EXTERN__ void _RME_Kern_High(struct RME_Reg_Struct* Reg, struct RME_CPU_Local* CPU_Local);
+__EXTERN__ void _RME_Kern_Wake(struct RME_CPU_Local* CPU_Local);
 /* Boot-time calls */
 __EXTERN__ rme_ret_t _RME_Sig_Boot_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl,
                                        rme_cid_t Cap_Sig, rme_ptr_t Vaddr);
 
 /* Kernel Function ***********************************************************/
 __EXTERN__ rme_ret_t _RME_Kern_Boot_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_cid_t Cap_Kern);
+/* Kernel event trace */
+#ifdef RME_TRACE
+__EXTERN__ void _RME_Trace_Put(struct RME_CPU_Local* CPU_Local, rme_ptr_t Type, rme_ptr_t Arg0, rme_ptr_t Arg1);
+#endif
+__EXTERN__ rme_ret_t _RME_Trace_Get(struct RME_Reg_Struct* Reg, rme_ptr_t Sub_ID, rme_ptr_t Pos);
 
 /*****************************************************************************/
 /* Undefine "__EXTERN__" to avoid redefinition */
@@ -93,20 +93,31 @@ typedef rme_s32_t rme_ret_t;
 #endif
 /* CPU-local data structure location macro */
 #define RME_CPU_LOCAL()                 (&RME_A7M_Local)
+/* Free-running cycle counter - the DWT one, which is started at boot */
+#define RME_CYCLE_GET()                 RME_A7M_DWT_CYCCNT
 /* The order of bits in one CPU machine word */
 #define RME_WORD_ORDER                  5
 /* Forcing VA=PA in user memory segments */
 #define RME_VA_EQU_PA                   (RME_TRUE)
 /* Quiescence timeslice value */
 #define RME_QUIE_TIME                   0
+/* Tickless one-shot timer - not supported */
+#define RME_TICKLESS                    (RME_FALSE)
 /* Captbl size limit - not restricted */
 #define RME_CAPTBL_LIMIT                0
+/* The number of words passed to and returned from a synchronous invocation in registers */
+#define RME_INV_ARG_NUM         4
+#define RME_INV_RET_NUM         4
 /* Normal page directory size calculation macro */
 #define RME_PGTBL_SIZE_NOM(NUM_ORDER)   ((1<<(NUM_ORDER))*sizeof(rme_ptr_t)+sizeof(struct __RME_A7M_Pgtbl_Meta))
 /* Top-level page directory size calculation macro */
 #define RME_PGTBL_SIZE_TOP(NUM_ORDER)   (RME_PGTBL_SIZE_NOM(NUM_ORDER)+sizeof(struct __RME_A7M_MPU_Data))
+/* The kernel virtual address of a physical address - there is no address translation */
+#define RME_PA2VA(PA)                   ((rme_ptr_t)(PA))
 /* The kernel object allocation table address - original */
 #define RME_KOTBL                       RME_Kotbl
+/* The kernel object allocation table summary address - original */
+#define RME_KOTBL_SUM                   RME_Kotbl_Sum
 /* Compare-and-Swap(CAS) */
 #define RME_COMP_SWAP(PTR,OLD,NEW)      __RME_A7M_Comp_Swap(PTR,OLD,NEW)
 /* Fetch-and-Add(FAA) */
@@ -115,6 +126,9 @@ typedef rme_s32_t rme_ret_t;
 #define RME_FETCH_AND(PTR,OPERAND)      __RME_A7M_Fetch_And(PTR,OPERAND)
 /* Get most significant bit */
 #define RME_MSB_GET(VAL)                __RME_A7M_MSB_Get(VAL)
+/* Kernel memory primitives - these use LDM/STM bursts when word-aligned */
+#define RME_CLEAR(ADDR,SIZE)            __RME_A7M_Clear((void*)(ADDR),(SIZE))
+#define RME_MEMCPY(DST,SRC,NUM)         __RME_A7M_Memcpy((void*)(DST),(void*)(SRC),(NUM))
 /* No read/write barriers needed on Cortex-M, because they are currently all
  * single core. If this changes in the future, we may need DMB barriers. */
 #define RME_READ_ACQUIRE(X)             (*(X))
@@ -164,6 +178,15 @@ typedef rme_s32_t rme_ret_t;
 #define RME_A7M_ITM_TER                 RME_A7M_REG(0xE0000E00)
 #define RME_A7M_ITM_PORT(X)             RME_A7M_REG(0xE0000000+((X)<<2))
 
+#define RME_A7M_DEMCR                   RME_A7M_REG(0xE000EDFC)
+#define RME_A7M_DEMCR_TRCENA            (1U<<24)
+
+#define RME_A7M_DWT_CTRL                RME_A7M_REG(0xE0001000)
+#define RME_A7M_DWT_CTRL_CYCCNTENA      (1U<<0)
+#define RME_A7M_DWT_CYCCNT              RME_A7M_REG(0xE0001004)
+#define RME_A7M_DWT_LAR                 RME_A7M_REG(0xE0001FB0)
+#define RME_A7M_DWT_LAR_UNLOCK          (0xC5ACCE55U)
+
 #define RME_A7M_MPU_CTRL                RME_A7M_REG(0xE000ED94)
 #define RME_A7M_MPU_CTRL_PRIVDEF        (1U<<2)
 #define RME_A7M_MPU_CTRL_ENABLE         (1U<<0)
@@ -582,6 +605,9 @@ EXTERN void __RME_A7M_Barrier(void);
 EXTERN void __RME_A7M_Wait_Int(void);
 /* MSB counting */
 EXTERN rme_ptr_t __RME_A7M_MSB_Get(rme_ptr_t Val);
+/* Memory primitives */
+EXTERN void __RME_A7M_Clear(void* Addr, rme_ptr_t Size);
+EXTERN void __RME_A7M_Memcpy(void* Dst, void* Src, rme_ptr_t Num);
 /* Atomics */
 __EXTERN__ rme_ptr_t __RME_A7M_Comp_Swap(rme_ptr_t* Ptr, rme_ptr_t Old, rme_ptr_t New);
 __EXTERN__ rme_ptr_t __RME_A7M_Fetch_Add(rme_ptr_t* Ptr, rme_cnt_t Addend);
@@ -601,6 +627,8 @@ __EXTERN__ rme_ptr_t __RME_CPUID_Get(void);
 __EXTERN__ void __RME_A7M_Fault_Handler(struct RME_Reg_Struct* Reg);
 /* Generic interrupt handler */
 __EXTERN__ void __RME_A7M_Vect_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Vect_Num);
+/* Cross-core signal wakeup */
+__EXTERN__ void __RME_Wake_IPI(rme_ptr_t CPUID);
 /* Kernel function handler */
 __EXTERN__ rme_ret_t __RME_Kern_Func_Handler(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
                                              rme_ptr_t Func_ID, rme_ptr_t Sub_ID, rme_ptr_t Param1, rme_ptr_t Param2);
@@ -620,6 +648,7 @@ EXTERN void ___RME_A7M_Thd_Cop_Restore(struct RME_Cop_Struct* Cop_Reg);
 __EXTERN__ void __RME_Get_Syscall_Param(struct RME_Reg_Struct* Reg, rme_ptr_t* Svc,
                                         rme_ptr_t* Capid, rme_ptr_t* Param);
 __EXTERN__ void __RME_Set_Syscall_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval);
+__EXTERN__ void __RME_Set_Sig_Data(struct RME_Reg_Struct* Reg, rme_ptr_t Data0, rme_ptr_t Data1);
 /* Thread register sets */
 __EXTERN__ void __RME_Thd_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, rme_ptr_t Param, struct RME_Reg_Struct* Reg);
 __EXTERN__ void __RME_Thd_Reg_Copy(struct RME_Reg_Struct* Dst, struct RME_Reg_Struct* Src);
@@ -627,6 +656,7 @@ __EXTERN__ void __RME_Thd_Cop_Init(struct RME_Reg_Struct* Reg, struct RME_Cop_St
 __EXTERN__ void __RME_Thd_Cop_Save(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg);
 __EXTERN__ void __RME_Thd_Cop_Restore(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg);
 /* Invocation register sets */
+__EXTERN__ void __RME_Inv_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, struct RME_Reg_Struct* Reg);
 __EXTERN__ void __RME_Inv_Reg_Save(struct RME_Iret_Struct* Ret, struct RME_Reg_Struct* Reg);
 __EXTERN__ void __RME_Inv_Reg_Restore(struct RME_Reg_Struct* Reg, struct RME_Iret_Struct* Ret);
 __EXTERN__ void __RME_Set_Inv_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval);
@@ -642,6 +672,7 @@ __EXTERN__ rme_ptr_t __RME_Pgtbl_Del_Check(struct RME_Cap_Pgtbl* Pgtbl_Op);
 /* Setting the page table */
 EXTERN void ___RME_A7M_MPU_Set(rme_ptr_t MPU_Meta);
 __EXTERN__ void __RME_Pgtbl_Set(rme_ptr_t Pgtbl);
+__EXTERN__ void __RME_Pgtbl_Sync(void);
 /* Table operations */
 __EXTERN__ rme_ptr_t __RME_Pgtbl_Page_Map(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Paddr, rme_ptr_t Pos, rme_ptr_t Flags);
 __EXTERN__ rme_ptr_t __RME_Pgtbl_Page_Unmap(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos);
@@ -93,20 +93,31 @@ typedef rme_s32_t rme_ret_t;
 #endif
 /* CPU-local data structure */
 #define RME_CPU_LOCAL()                 (&(RME_C66X_CPU_Local[__RME_C66X_CPUID_Get()]))
+/* Free-running cycle counter - the low word of the timestamp counter */
+#define RME_CYCLE_GET()                 __RME_C66X_TSC_Get()
 /* The order of bits in one CPU machine word */
 #define RME_WORD_ORDER                  5
 /* Forcing VA=PA in user memory segments */
 #define RME_VA_EQU_PA                   (RME_TRUE)
 /* Quiescence timeslice value */
 #define RME_QUIE_TIME                   0
+/* Tickless one-shot timer - not supported */
+#define RME_TICKLESS                    (RME_FALSE)
 /* Captbl size limit - not restricted */
 #define RME_CAPTBL_LIMIT                0
+/* The number of words passed to and returned from a synchronous invocation in registers */
+#define RME_INV_ARG_NUM         4
+#define RME_INV_RET_NUM         4
 /* Normal page directory size calculation macro */
 #define RME_PGTBL_SIZE_NOM(NUM_ORDER)   ((1<<(NUM_ORDER))*sizeof(rme_ptr_t)+sizeof(struct __RME_C66X_Pgtbl_Meta))
 /* Top-level page directory size calculation macro */
 #define RME_PGTBL_SIZE_TOP(NUM_ORDER)   (RME_PGTBL_SIZE_NOM(NUM_ORDER)+sizeof(struct __RME_C66X_MMU_Data))
+/* The kernel virtual address of a physical address - there is no address translation */
+#define RME_PA2VA(PA)                   ((rme_ptr_t)(PA))
 /* The kernel object allocation table address - original */
 #define RME_KOTBL                       RME_Kotbl
+/* The kernel object allocation table summary address - original */
+#define RME_KOTBL_SUM                   RME_Kotbl_Sum
 /* Compare-and-Swap(CAS) */
 #define RME_COMP_SWAP(PTR,OLD,NEW)      __RME_C66X_Comp_Swap(PTR,OLD,NEW)
 /* Fetch-and-Add(FAA) */
@@ -115,6 +126,9 @@ typedef rme_s32_t rme_ret_t;
 #define RME_FETCH_AND(PTR,OPERAND)      __RME_C66X_Fetch_And(PTR,OPERAND)
 /* Get most significant bit */
 #define RME_MSB_GET(VAL)                __RME_C66X_MSB_Get(VAL)
+/* Kernel memory primitives - the generic word-wide ones */
+#define RME_CLEAR(ADDR,SIZE)            _RME_Clear((void*)(ADDR),(SIZE))
+#define RME_MEMCPY(DST,SRC,NUM)         _RME_Memcpy((void*)(DST),(void*)(SRC),(NUM))
 /* Read barrier on C66X - C66X only guarantees read-write ordering, thus this is required */
 #define RME_READ_ACQUIRE(X)             __RME_C66X_Read_Acquire(X)
 /* Write barrier on C66X - C66X only guarantees read-write ordering, thus this is required */
@@ -752,6 +766,9 @@ EXTERN void __RME_C66X_Set_ISTP(rme_ptr_t ISTP);
 EXTERN rme_ptr_t __RME_C66X_Get_EFR(void);
 EXTERN void __RME_C66X_Set_ECR(rme_ptr_t ECR);
 EXTERN rme_ptr_t __RME_C66X_Get_IERR(void);
+/* Cycle counter */
+EXTERN void __RME_C66X_TSC_Init(void);
+EXTERN rme_ptr_t __RME_C66X_TSC_Get(void);
 /* Atomics */
 __EXTERN__ rme_ptr_t __RME_C66X_Comp_Swap(rme_ptr_t* Ptr, rme_ptr_t Old, rme_ptr_t New);
 __EXTERN__ rme_ptr_t __RME_C66X_Fetch_Add(rme_ptr_t* Ptr, rme_cnt_t Addend);
@@ -784,6 +801,7 @@ __EXTERN__ struct RME_CPU_Local* __RME_CPU_Local_Get(void);
 __EXTERN__ void __RME_Get_Syscall_Param(struct RME_Reg_Struct* Reg, rme_ptr_t* Svc,
                                         rme_ptr_t* Capid, rme_ptr_t* Param);
 __EXTERN__ void __RME_Set_Syscall_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval);
+__EXTERN__ void __RME_Set_Sig_Data(struct RME_Reg_Struct* Reg, rme_ptr_t Data0, rme_ptr_t Data1);
 /* Thread register sets */
 __EXTERN__ void __RME_Thd_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, rme_ptr_t Param, struct RME_Reg_Struct* Reg);
 __EXTERN__ void __RME_Thd_Reg_Copy(struct RME_Reg_Struct* Dst, struct RME_Reg_Struct* Src);
@@ -791,6 +809,7 @@ __EXTERN__ void __RME_Thd_Cop_Init(struct RME_Reg_Struct* Reg, struct RME_Cop_St
 __EXTERN__ void __RME_Thd_Cop_Save(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg);
 __EXTERN__ void __RME_Thd_Cop_Restore(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg);
 /* Invocation register sets */
+__EXTERN__ void __RME_Inv_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, struct RME_Reg_Struct* Reg);
 __EXTERN__ void __RME_Inv_Reg_Save(struct RME_Iret_Struct* Ret, struct RME_Reg_Struct* Reg);
 __EXTERN__ void __RME_Inv_Reg_Restore(struct RME_Reg_Struct* Reg, struct RME_Iret_Struct* Ret);
 __EXTERN__ void __RME_Set_Inv_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval);
@@ -803,8 +822,11 @@ __EXTERN__ void __RME_C66X_Fault_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t C
 __EXTERN__ void __RME_C66X_Int_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Cause);
 /* Generic interrupt handler */
 __EXTERN__ void __RME_C66X_Generic_Handler(struct RME_Reg_Struct* Reg);
+/* Cross-core signal wakeup */
+__EXTERN__ void __RME_Wake_IPI(rme_ptr_t CPUID);
 /* Page table operations */
 __EXTERN__ void __RME_Pgtbl_Set(rme_ptr_t Pgtbl);
+__EXTERN__ void __RME_Pgtbl_Sync(void);
 __EXTERN__ rme_ptr_t __RME_Pgtbl_Kmem_Init(void);
 __EXTERN__ rme_ptr_t __RME_Pgtbl_Check(rme_ptr_t Start_Addr, rme_ptr_t Top_Flag, rme_ptr_t Size_Order, rme_ptr_t Num_Order, rme_ptr_t Vaddr);
 __EXTERN__ rme_ptr_t __RME_Pgtbl_Init(struct RME_Cap_Pgtbl* Pgtbl_Op);
@@ -0,0 +1,43 @@
+/******************************************************************************
+Filename   : rme_platform_LINUX_HOST.h
+Author     : pry
+Date       : 16/10/2026
+Licence    : The Unlicense; see LICENSE for details.
+Description: The configuration file for the Linux-hosted development profile.
+******************************************************************************/
+
+/* Defines *******************************************************************/
+/* The size of the kernel object virtual memory, mmap'd at boot */
+#define RME_KMEM_SIZE                0x4000000
+/* The size of the hypervisor reserved virtual memory, mmap'd at boot */
+#define RME_HYP_SIZE                 0x100000
+/* The granularity of kernel memory allocation, in bytes */
+#define RME_KMEM_SLOT_ORDER          4
+/* The maximum number of preemption priority levels in the system.
+ * This parameter must be divisible by the word length - 64 is usually sufficient.
+ * It can be overridden from the command line, which "make bench" does */
+#ifndef RME_MAX_PREEMPT_PRIO
+#define RME_MAX_PREEMPT_PRIO         64
+#endif
+/* Quiescence timeslice value - always 10 slices, roughly equivalent to 10ms */
+#define RME_QUIE_TIME                10
+
+/* Number of simulated CPUs in the system - each of them is a pthread */
+#define RME_LINUX_CPU_NUM            4
+/* Timer frequency - about 1000 ticks per second */
+#define RME_LINUX_TIMER_FREQ         1000
+/* Whether the timer tick preempts the user threads. If this is RME_FALSE,
+ * the ticks are only taken when the user thread enters the kernel */
+#define RME_LINUX_TIMER_PREEMPT      (RME_TRUE)
+/* The size of the boot-time capability table */
+#define RME_LINUX_BOOT_CAPTBL_SIZE   16
+/* The init thread entry and its stack size. The entry can be overridden as above */
+#ifndef RME_LINUX_INIT_ENTRY
+#define RME_LINUX_INIT_ENTRY         RME_Init
+#endif
+#define RME_LINUX_INIT_STACK_SIZE    0x100000
+/* End Defines ***************************************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
@@ -0,0 +1,486 @@
+/******************************************************************************
+Filename    : rme_platform_linux.h
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The header of "rme_platform_linux.c".
+******************************************************************************/
+
+/* Defines *******************************************************************/
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+#ifdef __HDR_DEFS__
+#ifndef __RME_PLATFORM_LINUX_H_DEFS__
+#define __RME_PLATFORM_LINUX_H_DEFS__
+/*****************************************************************************/
+/* Basic Types ***************************************************************/
+#ifndef __RME_S64_T__
+#define __RME_S64_T__
+typedef signed long long rme_s64_t;
+#endif
+
+#ifndef __RME_S32_T__
+#define __RME_S32_T__
+typedef signed int rme_s32_t;
+#endif
+
+#ifndef __RME_S16_T__
+#define __RME_S16_T__
+typedef signed short rme_s16_t;
+#endif
+
+#ifndef __RME_S8_T__
+#define __RME_S8_T__
+typedef signed char rme_s8_t;
+#endif
+
+#ifndef __RME_U64_T__
+#define __RME_U64_T__
+typedef unsigned long long rme_u64_t;
+#endif
+
+#ifndef __RME_U32_T__
+#define __RME_U32_T__
+typedef unsigned int rme_u32_t;
+#endif
+
+#ifndef __RME_U16_T__
+#define __RME_U16_T__
+typedef unsigned short rme_u16_t;
+#endif
+
+#ifndef __RME_U8_T__
+#define __RME_U8_T__
+typedef unsigned char rme_u8_t;
+#endif
+/* End Basic Types ***********************************************************/
+
+/* Begin Extended Types ******************************************************/
+#ifndef __RME_TID_T__
+#define __RME_TID_T__
+/* The typedef for the Thread ID */
+typedef rme_s64_t rme_tid_t;
+#endif
+
+#ifndef __RME_PTR_T__
+#define __RME_PTR_T__
+/* The typedef for the pointers - This is the raw style. Pointers must be unsigned */
+typedef rme_u64_t rme_ptr_t;
+#endif
+
+#ifndef __RME_CNT_T__
+#define __RME_CNT_T__
+/* The typedef for the count variables */
+typedef rme_s64_t rme_cnt_t;
+#endif
+
+#ifndef __RME_CID_T__
+#define __RME_CID_T__
+/* The typedef for capability ID */
+typedef rme_s64_t rme_cid_t;
+#endif
+
+#ifndef __RME_RET_T__
+#define __RME_RET_T__
+/* The type for process return value */
+typedef rme_s64_t rme_ret_t;
+#endif
+/* End Extended Types ********************************************************/
+
+/* System macros *************************************************************/
+/* Compiler "extern" keyword setting */
+#define EXTERN                          extern
+/* Compiler "inline" keyword setting */
+#define INLINE                          inline
+/* Compiler likely & unlikely setting */
+#ifdef likely
+#define RME_LIKELY(X)                   (likely(X))
+#else
+#define RME_LIKELY(X)                   (X)
+#endif
+#ifdef unlikely
+#define RME_UNLIKELY(X)                 (unlikely(X))
+#else
+#define RME_UNLIKELY(X)                 (X)
+#endif
+/* CPU-local data structure location macro - each simulated CPU is a pthread */
+#define RME_CPU_LOCAL()                 (RME_LINUX_Local)
+/* Free-running cycle counter - the host monotonic clock, in nanoseconds */
+#define RME_CYCLE_GET()                 __RME_LINUX_Cycle_Get()
+/* The order of bits in one CPU machine word */
+#define RME_WORD_ORDER                  6
+/* Forcing VA=PA in user memory segments - the host process has only one address space */
+#define RME_VA_EQU_PA                   (RME_TRUE)
+/* Tickless one-shot timer - not supported */
+#define RME_TICKLESS                    (RME_FALSE)
+/* Captbl size limit - not restricted */
+#define RME_CAPTBL_LIMIT                0
+/* The number of words passed to and returned from a synchronous invocation in registers */
+#define RME_INV_ARG_NUM         2
+#define RME_INV_RET_NUM         3
+/* Normal page directory size calculation macro */
+#define RME_PGTBL_SIZE_NOM(NUM_ORDER)   ((((rme_ptr_t)1)<<(NUM_ORDER))*sizeof(rme_ptr_t)+sizeof(struct __RME_LINUX_Pgtbl_Meta))
+/* Top-level page directory size calculation macro */
+#define RME_PGTBL_SIZE_TOP(NUM_ORDER)   RME_PGTBL_SIZE_NOM(NUM_ORDER)
+/* The kernel virtual address of a physical address - the boot page table maps the host 1:1 */
+#define RME_PA2VA(PA)                   ((rme_ptr_t)(PA))
+/* The virtual memory start address for the kernel objects - mmap'd at boot */
+#define RME_KMEM_VA_START               ((rme_ptr_t)RME_LINUX_Kmem_Base)
+/* The virtual memory start address for the virtual machines - mmap'd at boot */
+#define RME_HYP_VA_START                ((rme_ptr_t)RME_LINUX_Hyp_Base)
+/* The kernel object allocation table address - mmap'd at boot */
+#define RME_KOTBL                       (RME_LINUX_Kotbl)
+/* The kernel object allocation table summary address - mmap'd at boot */
+#define RME_KOTBL_SUM                   (RME_LINUX_Kotbl_Sum)
+/* Atomic instructions - the compiler builtins are good enough on the host */
+static INLINE rme_ptr_t _RME_LINUX_Comp_Swap(rme_ptr_t* Ptr, rme_ptr_t Old, rme_ptr_t New)
+{
+    return __sync_bool_compare_and_swap(Ptr, Old, New);
+}
+static INLINE rme_ptr_t _RME_LINUX_Fetch_Add(rme_ptr_t* Ptr, rme_cnt_t Addend)
+{
+    return __sync_fetch_and_add(Ptr, (rme_ptr_t)Addend);
+}
+static INLINE rme_ptr_t _RME_LINUX_Fetch_And(rme_ptr_t* Ptr, rme_ptr_t Operand)
+{
+    return __sync_fetch_and_and(Ptr, Operand);
+}
+static INLINE rme_ptr_t _RME_LINUX_MSB_Get(rme_ptr_t Val)
+{
+    return 63-__builtin_clzll(Val);
+}
+/* Compare-and-Swap(CAS) */
+#define RME_COMP_SWAP(PTR,OLD,NEW)      _RME_LINUX_Comp_Swap(PTR,OLD,NEW)
+/* Fetch-and-Add(FAA) */
+#define RME_FETCH_ADD(PTR,ADDEND)       _RME_LINUX_Fetch_Add(PTR,ADDEND)
+/* Fetch-and-And(FAND) */
+#define RME_FETCH_AND(PTR,OPERAND)      _RME_LINUX_Fetch_And(PTR,OPERAND)
+/* Get most significant bit */
+#define RME_MSB_GET(VAL)                _RME_LINUX_MSB_Get(VAL)
+/* Kernel memory primitives - the generic word-wide ones */
+#define RME_CLEAR(ADDR,SIZE)            _RME_Clear((void*)(ADDR),(SIZE))
+#define RME_MEMCPY(DST,SRC,NUM)         _RME_Memcpy((void*)(DST),(void*)(SRC),(NUM))
+/* The host may run the simulated CPUs on different cores, so we need real barriers */
+#define RME_READ_ACQUIRE(X)             __atomic_load_n((X),__ATOMIC_ACQUIRE)
+#define RME_WRITE_RELEASE(X,V)          __atomic_store_n((X),(V),__ATOMIC_RELEASE)
+
+/* The CPU and application specific macros are here */
+#include "rme_platform_linux_conf.h"
+/* End System macros *********************************************************/
+
+/* Linux specific macros *****************************************************/
+/* Traps *********************************************************************/
+/* Nothing pending - the kernel loop was entered for the first time */
+#define RME_LINUX_TRAP_NONE             (0)
+/* A system call from the user thread */
+#define RME_LINUX_TRAP_SVC              (1)
+/* A timer tick, delivered by the per-CPU POSIX timer */
+#define RME_LINUX_TRAP_TICK             (2)
+/* A fault raised by the user thread */
+#define RME_LINUX_TRAP_FAULT            (3)
+/* A signal wakeup request, delivered by another simulated CPU */
+#define RME_LINUX_TRAP_WAKE             (4)
+/* The signal used for the timer tick */
+#define RME_LINUX_TICK_SIGNAL           SIGALRM
+/* The signal used for the signal wakeup requests, which stands in for the IPI */
+#define RME_LINUX_WAKE_SIGNAL           SIGUSR1
+
+/* Faults ********************************************************************/
+/* The thread entry function returned, and there is no invocation to return to */
+#define RME_LINUX_FAULT_RETURN          (1)
+
+/* Initialization ************************************************************/
+/* The capability table of the init process */
+#define RME_BOOT_CAPTBL                 0
+/* The top-level page table of the init process - the whole user address space as one page */
+#define RME_BOOT_PGTBL                  1
+/* The init process */
+#define RME_BOOT_INIT_PROC              2
+/* The init thread capability table - one thread per CPU */
+#define RME_BOOT_TBL_THD                3
+/* The initial kernel function capability */
+#define RME_BOOT_INIT_KERN              4
+/* The initial kernel memory capability */
+#define RME_BOOT_INIT_KMEM              5
+/* The initial timer endpoint capability table - one endpoint per CPU */
+#define RME_BOOT_TBL_TIMER              6
+/* The initial default endpoint capability table for all other vectors - one per CPU */
+#define RME_BOOT_TBL_INT                7
+
+/* Booting capability layout */
+#define RME_LINUX_CPT                   ((struct RME_Cap_Captbl*)(RME_KMEM_VA_START))
+
+/* Page Table ****************************************************************/
+/* For Linux:
+ * The host process only has one address space, and all simulated processes
+ * share it. We keep the page tables only as bookkeeping data structures, so
+ * that the kernel's memory management can be exercised as-is; nothing is ever
+ * enforced. Page size orders are at least 4K, so we have 12 free bits.
+ *
+ * The layout of the page entry is:
+ * [63:12] Paddr - The physical address to map this page to.
+ * [11:8] Reserved.
+ * [7:2] Flags - The RME standard page flags.
+ * [1] Terminal - Is this page a terminal page, or points to another page table?
+ * [0] Present - Is this entry present?
+ *
+ * The layout of a directory entry is:
+ * [63:2] Paddr - The in-kernel physical address of the lower page directory.
+ *                Page directory flags are not supported.
+ * [1] Terminal - Is this page a terminal page, or points to another page table?
+ * [0] Present - Is this entry present?
+ */
+/* Get the actual table positions */
+#define RME_LINUX_PGTBL_TBL(X)          ((X)+(sizeof(struct __RME_LINUX_Pgtbl_Meta)/sizeof(rme_ptr_t)))
+/* Page entry bit definitions */
+#define RME_LINUX_PGTBL_PRESENT         (1U<<0)
+#define RME_LINUX_PGTBL_TERMINAL        (1U<<1)
+/* The RME standard flags of a page entry */
+#define RME_LINUX_PGTBL_FLAG_SET(X)     (((X)&0x3FU)<<2)
+#define RME_LINUX_PGTBL_FLAG_GET(X)     (((X)>>2)&0x3FU)
+/* The address mask for the actual page address */
+#define RME_LINUX_PGTBL_PTE_ADDR(X)     ((X)&(~((rme_ptr_t)0xFFFU)))
+/* The address mask for the next level page table address */
+#define RME_LINUX_PGTBL_PGD_ADDR(X)     ((X)&(~((rme_ptr_t)0x03U)))
+/* Page table metadata definitions */
+#define RME_LINUX_PGTBL_START(X)        ((X)&(~((rme_ptr_t)0x01U)))
+/*****************************************************************************/
+/* __RME_PLATFORM_LINUX_H_DEFS__ */
+#endif
+/* __HDR_DEFS__ */
+#endif
+/* End Defines ***************************************************************/
+
+/* Structs *******************************************************************/
+#ifdef __HDR_STRUCTS__
+#ifndef __RME_PLATFORM_LINUX_H_STRUCTS__
+#define __RME_PLATFORM_LINUX_H_STRUCTS__
+/* We used structs in the header */
+
+/* Use defines in these headers */
+#define __HDR_DEFS__
+#undef __HDR_DEFS__
+/*****************************************************************************/
+/* Register Manipulation *****************************************************/
+/* The register set struct. The host keeps the real registers in a ucontext
+ * on the thread's own stack; we only keep the pointer to it, together with
+ * the system call arguments that are passed through this structure */
+struct RME_Reg_Struct
+{
+    /* The system call return value */
+    rme_ptr_t Retval;
+    /* System call number and capability ID; the thread parameter on entry;
+     * the invocation return value on exit */
+    rme_ptr_t Arg0;
+    rme_ptr_t Arg1;
+    rme_ptr_t Arg2;
+    rme_ptr_t Arg3;
+    /* The entry of the thread, only used when it is first started */
+    rme_ptr_t Entry;
+    /* The address of the ucontext_t that holds the actual registers */
+    rme_ptr_t Ctx;
+};
+
+/* The coprocessor register set structure. The FPU state is kept in the
+ * ucontext along with everything else, thus nothing to save here */
+struct RME_Cop_Struct
+{
+    rme_ptr_t Reserved;
+};
+
+/* Invocation register set structure */
+struct RME_Iret_Struct
+{
+    rme_ptr_t Ctx;
+};
+
+/* Page Table ****************************************************************/
+/* Page table metadata structure */
+struct __RME_LINUX_Pgtbl_Meta
+{
+    /* The start mapping address of this page table */
+    rme_ptr_t Base_Addr;
+    /* The size/num order of this level */
+    rme_ptr_t Size_Num_Order;
+    /* How many page tables have this one mapped in */
+    rme_ptr_t Parent_Cnt;
+    /* How many page directories are mapped into this one */
+    rme_ptr_t Child_Cnt;
+};
+
+/* Simulated CPU *************************************************************/
+/* Everything a simulated CPU needs. The kernel runs on the pthread's own stack,
+ * and the user threads run on their own stacks; they switch to each other by
+ * swapcontext through the register set below, which is the trap frame */
+struct __RME_LINUX_CPU
+{
+    /* The kernel's CPU-local data - the structure is not defined yet here */
+    struct RME_CPU_Local* Local;
+    /* The trap frame of the current user thread */
+    struct RME_Reg_Struct Reg;
+    /* The kernel loop context that the traps will return to */
+    ucontext_t Kern_Ctx;
+    /* Whether we are in the kernel, or a tick or wakeup arrived while we were there */
+    volatile rme_ptr_t In_Kern;
+    volatile rme_ptr_t Tick_Pend;
+    volatile rme_ptr_t Wake_Pend;
+    /* The reason why the user thread trapped */
+    rme_ptr_t Trap;
+    /* The host thread and the tick timer */
+    pthread_t Thread;
+    timer_t Timer;
+    /* The stack of the init thread */
+    rme_ptr_t Init_Stack;
+};
+/*****************************************************************************/
+/* __RME_PLATFORM_LINUX_H_STRUCTS__ */
+#endif
+/* __HDR_STRUCTS__ */
+#endif
+/* End Structs ***************************************************************/
+
+/* Private Global Variables **************************************************/
+#if(!(defined __HDR_DEFS__||defined __HDR_STRUCTS__))
+#ifndef __RME_PLATFORM_LINUX_MEMBERS__
+#define __RME_PLATFORM_LINUX_MEMBERS__
+
+/* In this way we can use the data structures and definitions in the headers */
+#define __HDR_DEFS__
+
+#undef __HDR_DEFS__
+
+#define __HDR_STRUCTS__
+
+#undef __HDR_STRUCTS__
+
+/* If the header is not used in the public mode */
+#ifndef __HDR_PUBLIC_MEMBERS__
+/*****************************************************************************/
+/* The simulated CPUs */
+static struct __RME_LINUX_CPU RME_LINUX_CPU[RME_LINUX_CPU_NUM];
+static struct RME_CPU_Local RME_LINUX_CPU_Local[RME_LINUX_CPU_NUM];
+/* The simulated CPU that this host thread is */
+static __thread struct __RME_LINUX_CPU* RME_LINUX_Self;
+/* The template that all new thread contexts are copied from */
+static ucontext_t RME_LINUX_Ctx_Tmpl;
+/*****************************************************************************/
+/* End Private Global Variables **********************************************/
+
+/* Private C Function Prototypes *********************************************/
+/* Traps *********************************************************************/
+static void __RME_LINUX_Kern_Loop(struct __RME_LINUX_CPU* Self);
+static void __RME_LINUX_Kern_Exit(void);
+static void __RME_LINUX_Trap(rme_ptr_t Trap, rme_ptr_t Param);
+static void __RME_LINUX_Thd_Entry(void);
+static void __RME_LINUX_Int_Handler(int Signal, siginfo_t* Info, void* Context);
+/* Initialization ************************************************************/
+static void* __RME_LINUX_Map(rme_ptr_t Size);
+static void __RME_LINUX_Timer_Init(struct __RME_LINUX_CPU* Self);
+static void* __RME_LINUX_SMP_Entry(void* Param);
+/*****************************************************************************/
+#define __EXTERN__
+/* End Private C Function Prototypes *****************************************/
+
+/* Public Global Variables ***************************************************/
+/* __HDR_PUBLIC_MEMBERS__ */
+#else
+#define __EXTERN__ EXTERN
+/* __HDR_PUBLIC_MEMBERS__ */
+#endif
+
+/*****************************************************************************/
+/* The CPU-local data structure of this host thread */
+__EXTERN__ __thread struct RME_CPU_Local* RME_LINUX_Local;
+/* The kernel memory, kernel object table and hypervisor regions, mmap'd at boot */
+__EXTERN__ void* RME_LINUX_Kmem_Base;
+__EXTERN__ rme_ptr_t* RME_LINUX_Kotbl;
+__EXTERN__ rme_ptr_t* RME_LINUX_Kotbl_Sum;
+__EXTERN__ void* RME_LINUX_Hyp_Base;
+/*****************************************************************************/
+
+/* End Public Global Variables ***********************************************/
+
+/* Public C Function Prototypes **********************************************/
+/* Generic *******************************************************************/
+/* Interrupts */
+__EXTERN__ void __RME_Disable_Int(void);
+__EXTERN__ void __RME_Enable_Int(void);
+/* Debugging */
+__EXTERN__ rme_ptr_t __RME_Putchar(char Char);
+/* Getting CPUID */
+__EXTERN__ rme_ptr_t __RME_CPUID_Get(void);
+/* Cycle counter */
+__EXTERN__ rme_ptr_t __RME_LINUX_Cycle_Get(void);
+
+/* Handler *******************************************************************/
+/* Kernel function handler */
+__EXTERN__ rme_ret_t __RME_Kern_Func_Handler(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                             rme_ptr_t Func_ID, rme_ptr_t Sub_ID, rme_ptr_t Param1, rme_ptr_t Param2);
+/* Cross-core signal wakeup */
+__EXTERN__ void __RME_Wake_IPI(rme_ptr_t CPUID);
+/* User-level system call gate */
+__EXTERN__ rme_ret_t __RME_LINUX_Svc(rme_ptr_t Svc_Capid, rme_ptr_t Param1, rme_ptr_t Param2,
+                                     rme_ptr_t Param3, rme_ptr_t* Reg_Ret);
+
+/* Initialization ************************************************************/
+/* The init thread entry, supplied by the user program */
+EXTERN void RME_LINUX_INIT_ENTRY(rme_ptr_t CPUID);
+__EXTERN__ rme_ptr_t __RME_Low_Level_Init(void);
+__EXTERN__ rme_ptr_t __RME_Boot(void);
+__EXTERN__ void __RME_Enter_User_Mode(rme_ptr_t Entry_Addr, rme_ptr_t Stack_Addr, rme_ptr_t CPUID);
+
+/* Register Manipulation *****************************************************/
+/* Syscall parameter */
+__EXTERN__ void __RME_Get_Syscall_Param(struct RME_Reg_Struct* Reg, rme_ptr_t* Svc,
+                                        rme_ptr_t* Capid, rme_ptr_t* Param);
+__EXTERN__ void __RME_Set_Syscall_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval);
+__EXTERN__ void __RME_Set_Sig_Data(struct RME_Reg_Struct* Reg, rme_ptr_t Data0, rme_ptr_t Data1);
+/* Thread register sets */
+__EXTERN__ void __RME_Thd_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, rme_ptr_t Param, struct RME_Reg_Struct* Reg);
+__EXTERN__ void __RME_Thd_Reg_Copy(struct RME_Reg_Struct* Dst, struct RME_Reg_Struct* Src);
+__EXTERN__ void __RME_Thd_Cop_Init(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg);
+__EXTERN__ void __RME_Thd_Cop_Save(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg);
+__EXTERN__ void __RME_Thd_Cop_Restore(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg);
+/* Invocation register sets */
+__EXTERN__ void __RME_Inv_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, struct RME_Reg_Struct* Reg);
+__EXTERN__ void __RME_Inv_Reg_Save(struct RME_Iret_Struct* Ret, struct RME_Reg_Struct* Reg);
+__EXTERN__ void __RME_Inv_Reg_Restore(struct RME_Reg_Struct* Reg, struct RME_Iret_Struct* Ret);
+__EXTERN__ void __RME_Set_Inv_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval);
+
+/* Page Table ****************************************************************/
+/* Initialization */
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Kmem_Init(void);
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Init(struct RME_Cap_Pgtbl* Pgtbl_Op);
+/* Checking */
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Check(rme_ptr_t Base_Addr, rme_ptr_t Top_Flag,
+                                       rme_ptr_t Size_Order, rme_ptr_t Num_Order, rme_ptr_t Vaddr);
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Del_Check(struct RME_Cap_Pgtbl* Pgtbl_Op);
+/* Setting the page table */
+__EXTERN__ void __RME_Pgtbl_Set(rme_ptr_t Pgtbl);
+__EXTERN__ void __RME_Pgtbl_Sync(void);
+/* Table operations */
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Page_Map(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Paddr, rme_ptr_t Pos, rme_ptr_t Flags);
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Page_Unmap(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos);
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Pgdir_Map(struct RME_Cap_Pgtbl* Pgtbl_Parent, rme_ptr_t Pos,
+                                           struct RME_Cap_Pgtbl* Pgtbl_Child, rme_ptr_t Flags);
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Pgdir_Unmap(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos);
+/* Lookup and walking */
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Lookup(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos, rme_ptr_t* Paddr, rme_ptr_t* Flags);
+__EXTERN__ rme_ptr_t __RME_Pgtbl_Walk(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Vaddr, rme_ptr_t* Pgtbl,
+                                      rme_ptr_t* Map_Vaddr, rme_ptr_t* Paddr,
+                                      rme_ptr_t* Size_Order, rme_ptr_t* Num_Order, rme_ptr_t* Flags);
+
+/*****************************************************************************/
+/* Undefine "__EXTERN__" to avoid redefinition */
+#undef __EXTERN__
+/* __RME_PLATFORM_LINUX_MEMBERS__ */
+#endif
+/* !(defined __HDR_DEFS__||defined __HDR_STRUCTS__) */
+#endif
+/* End Public C Function Prototypes ******************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
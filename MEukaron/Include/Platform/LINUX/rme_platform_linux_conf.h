@@ -0,0 +1,15 @@
+/******************************************************************************
+Filename   : rme_platform_linux_conf.h
+Author     : pry
+Date       : 16/10/2026
+Licence    : The Unlicense; see LICENSE for details.
+Description: The configuration file for Linux-hosted profile settings.
+******************************************************************************/
+
+/* Config Includes ***********************************************************/
+#include "Platform/LINUX/Profiles/Host/rme_platform_LINUX_HOST.h"
+/* End Config Includes *******************************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
@@ -16,6 +16,8 @@ Description: The configuration file for X64 supercomputer profile.
 
 /* Number of CPUs in the system - max. 4096 ones are supported */
 #define RME_X64_CPU_NUM              256
+/* Number of NUMA nodes in the system - the extra ones are merged into the last */
+#define RME_X64_NODE_NUM             8
 /* Number of IOAPICs in the system - max. 256 ones are supported */
 #define RME_X64_IOAPIC_NUM           8
 /* Shared interrupt flag region address - not populated now */
@@ -24,6 +26,9 @@ Description: The configuration file for X64 supercomputer profile.
 #define RME_X64_FPU_TYPE             RME_X64_FPU_AVX512
 /* Timer frequency - about 1000 ticks per second */
 #define RME_X64_TIMER_FREQ           1000
+/* Tickless mode - the non-booting processors only take timer interrupts when
+ * a thread's slices run out or a thread waits for the next tick */
+#define RME_X64_TIMER_TICKLESS       (RME_FALSE)
 /* End Defines ***************************************************************/
 
 /* End Of File ***************************************************************/
@@ -104,18 +104,27 @@ typedef rme_s64_t rme_ret_t;
 #endif
 /* Get CPU-local data structure */
 #define RME_CPU_LOCAL()                      __RME_X64_CPU_Local_Get()
+/* Free-running cycle counter - the timestamp counter */
+#define RME_CYCLE_GET()                      __RME_X64_RDTSC()
 /* The order of bits in one CPU machine word */
 #define RME_WORD_ORDER                       6
 /* Forcing VA=PA in user memory segments */
 #define RME_VA_EQU_PA                        (RME_FALSE)
 /* Quiescence timeslice value - always 10 slices, roughly equivalent to 100ms */
 #define RME_QUIE_TIME                        10
+/* Tickless one-shot timer on the non-booting processors - decided by the profile */
+#define RME_TICKLESS                         (RME_X64_TIMER_TICKLESS)
 /* Captbl size limit - not restricted, user-level decides this */
 #define RME_CAPTBL_LIMIT                     0
+/* The number of words passed to and returned from a synchronous invocation in registers */
+#define RME_INV_ARG_NUM              6
+#define RME_INV_RET_NUM              6
 /* Normal page directory size calculation macro */
 #define RME_PGTBL_SIZE_NOM(NUM_ORDER)        ((1<<(NUM_ORDER))*sizeof(rme_ptr_t))
 /* Top-level page directory size calculation macro */
 #define RME_PGTBL_SIZE_TOP(NUM_ORDER)        RME_PGTBL_SIZE_NOM(NUM_ORDER)
+/* The kernel virtual address of a physical address, in the kernel linear mapping */
+#define RME_PA2VA(PA)                        RME_X64_PA2VA(PA)
 /* Initial stack size and address */
 #define RME_KMEM_STACK_ADDR                  ((rme_ptr_t)__RME_X64_Kern_Boot_Stack)
 /* The virtual memory start address for the kernel objects */
@@ -128,6 +137,8 @@ typedef rme_s64_t rme_ret_t;
 #define RME_HYP_SIZE                         0
 /* The kernel object allocation table address - relocated */
 #define RME_KOTBL                            ((rme_ptr_t*)0xFFFF800001000000)
+/* The kernel object allocation table summary address - right after the table */
+#define RME_KOTBL_SUM                        (RME_X64_Kotbl_Sum)
 /* Atomic instructions - The oficial release replaces all these with inline
  * assembly to boost speed. Sometimes this can harm compiler compatibility. If
  * you need normal assembly version, consider uncommenting the macro below. */
@@ -184,6 +195,9 @@ static INLINE rme_ptr_t _RME_X64_MSB_Get(rme_ptr_t Val)
 #define RME_FETCH_AND(PTR,OPERAND)           _RME_X64_Fetch_And(PTR,OPERAND)
 #define RME_MSB_GET(VAL)                     _RME_X64_MSB_Get(VAL)
 #endif
+/* Kernel memory primitives - these use the string instructions */
+#define RME_CLEAR(ADDR,SIZE)                 __RME_X64_Clear((void*)(ADDR),(SIZE))
+#define RME_MEMCPY(DST,SRC,NUM)              __RME_X64_Memcpy((void*)(DST),(void*)(SRC),(NUM))
 /* No read acquires needed because x86-64 guarantees read-read and read-write consistency */
 #define RME_READ_ACQUIRE(X)                  (*(X)) 
 /* No read acquires needed because x86-64 guarantees write-write consistency. In RME, we do
@@ -254,9 +268,22 @@ static INLINE rme_ptr_t _RME_X64_MSB_Get(rme_ptr_t Val)
 #define RME_X64_MADT_INT_SRC_OVERRIDE        2
 #define RME_X64_MADT_NMI_INT_SRC             3
 #define RME_X64_MADT_LAPIC_NMI               4
+#define RME_X64_MADT_X2APIC                  9
 
 #define RME_X64_APIC_LAPIC_ENABLED           1
 
+/* SRAT record types */
+#define RME_X64_SRAT_LAPIC                   0
+#define RME_X64_SRAT_MEM                     1
+#define RME_X64_SRAT_X2APIC                  2
+/* The enabled flag of all SRAT records */
+#define RME_X64_SRAT_ENABLED                 1
+/* How many memory ranges can the SRAT have */
+#define RME_X64_NUMA_MEM_NUM                 64
+/* The SLIT distances of the node itself and of other nodes, when there is no SLIT */
+#define RME_X64_NUMA_DIST_LOCAL              10
+#define RME_X64_NUMA_DIST_REMOTE             20
+
 /* Page entry bit definitions */
 /* No execution */
 #define RME_X64_MMU_NX                       (((rme_ptr_t)1)<<63)
@@ -297,6 +324,28 @@ static INLINE rme_ptr_t _RME_X64_MSB_Get(rme_ptr_t Val)
 /* Write info to MMU - no longer used because we have PCID */
 #define RME_X64_CR3_PCD                      (1<<4)
 #define RME_X64_CR3_PWT                      (1<<3)
+/* Do not flush the TLB entries of the PCID being switched to */
+#define RME_X64_CR3_NOFLUSH                  (((rme_ptr_t)1)<<63)
+
+/* PCIDs. PCID 0 is shared by the kernel and any table that we could not give
+ * an own PCID to; switching to these always flushes */
+#define RME_X64_PCID_NUM                     (4096)
+#define RME_X64_PCID_SHARED                  (0)
+/* INVPCID types */
+#define RME_X64_INVPCID_ADDR                 (0)
+#define RME_X64_INVPCID_SINGLE               (1)
+#define RME_X64_INVPCID_ALL_GLOBAL           (2)
+#define RME_X64_INVPCID_ALL                  (3)
+/* The number of words needed to hold one bit for each CPU */
+#define RME_X64_CPU_WORDS                    ((RME_X64_CPU_NUM+sizeof(rme_ptr_t)*8-1)/(sizeof(rme_ptr_t)*8))
+/* TLB shootdown. A removal from a page directory that is not the top-level may
+ * be seen through any PCID, so we do not know which one to flush. The address
+ * of a removal that can span many pages is not given; the whole PCID goes */
+#define RME_X64_SHOOT_PCID_ANY               RME_X64_PCID_SHARED
+#define RME_X64_SHOOT_ADDR_ALL               RME_ALLBITS
+/* The number of removals that a processor can batch before sending them out.
+ * More than this and the receivers will just flush the whole TLB */
+#define RME_X64_SHOOT_MAX                    (16)
 
 #define RME_X64_PGREG_POS(TABLE)             (((struct __RME_X64_Pgreg*)RME_X64_Layout.Pgreg_Start)[RME_X64_VA2PA(TABLE)>>RME_PGTBL_SIZE_4K])
 
@@ -310,6 +359,7 @@ static INLINE rme_ptr_t _RME_X64_MSB_Get(rme_ptr_t Val)
 #define RME_X64_PIT_CH1                      (0x41)
 #define RME_X64_PIT_CH2                      (0x42)
 #define RME_X64_PIT_CMD                      (0x43)
+#define RME_X64_PIT_CH2_GATE                 (0x61)
 #define RME_X64_RTC_CMD                      (0x70)
 #define RME_X64_RTC_DATA                     (0x71)
 #define RME_X64_PIC1                         (0x20)
@@ -320,6 +370,13 @@ static INLINE rme_ptr_t _RME_X64_MSB_Get(rme_ptr_t Val)
 #define RME_X64_CPUID_0_VENDOR_ID            (0x0)
 /* Processor info and feature bits */
 #define RME_X64_CPUID_1_INFO_FEATURE         (0x1)
+/* ECX bit 21 - x2APIC supported */
+#define RME_X64_CPUID_1_ECX_X2APIC           (1U<<21)
+/* ECX bit 17 - PCID supported */
+#define RME_X64_CPUID_1_ECX_PCID             (1U<<17)
+/* ECX bit 26/28 - XSAVE and AVX supported */
+#define RME_X64_CPUID_1_ECX_XSAVE            (1U<<26)
+#define RME_X64_CPUID_1_ECX_AVX              (1U<<28)
 /* Cache and TLB descriptor information */
 #define RME_X64_CPUID_2_CACHE_TLB            (0x2)
 /* Processor serial number */
@@ -328,8 +385,16 @@ static INLINE rme_ptr_t _RME_X64_MSB_Get(rme_ptr_t Val)
 #define RME_X64_CPUID_4_INTEL_TOPO1          (0x4)
 /* ECX=0, returns Intel extended features */
 #define RME_X64_CPUID_7_ECX0_INTEL_EXT       (0x7)
+/* EBX bit 10 - INVPCID supported */
+#define RME_X64_CPUID_7_EBX_ERMS             (1U<<9)
+#define RME_X64_CPUID_7_EBX_INVPCID          (1U<<10)
+/* EBX bit 16 - AVX-512 foundation supported */
+#define RME_X64_CPUID_7_EBX_AVX512F          (1U<<16)
 /* Intel thread/core and cache topology 2 */
 #define RME_X64_CPUID_B_INTEL_TOPO2          (0xB)
+/* Extended state enumeration; ECX=1, EAX bit 0 - XSAVEOPT supported */
+#define RME_X64_CPUID_D_XSTATE               (0xD)
+#define RME_X64_CPUID_D_ECX1_EAX_XSAVEOPT    (1U<<0)
 
 /* Get highest extenbded function supported */
 #define RME_X64_CPUID_E0_EXT_MAX             (0x80000000)
@@ -454,13 +519,15 @@ while(0)
 #define RME_X64_FAULT_VE                     (20)
 /* User interrupts */
 #define RME_X64_INT_USER(INT)                ((INT)+32)
-#define RME_X64_INT_SYSTICK                  RME_X64_INT_USER(2)
 
 /* User interrupts that are used by RME - map these two even further away */
 #define RME_X64_INT_SPUR                     RME_X64_INT_USER(0x80-32)
 #define RME_X64_INT_ERROR                    RME_X64_INT_USER(0x81-32)
 #define RME_X64_INT_IPI                      RME_X64_INT_USER(0x82-32)
-#define RME_X64_INT_SMP_SYSTICK              RME_X64_INT_USER(0x83-32)
+/* The LAPIC timer of each processor */
+#define RME_X64_INT_TIMER                    RME_X64_INT_USER(0x83-32)
+/* Cross-core signal wakeup requests from other processors */
+#define RME_X64_INT_WAKE                     RME_X64_INT_USER(0x84-32)
 
 /* LAPIC offsets - maybe we should use structs later on */
 #define RME_X64_LAPIC_ID                     (0x0020/4)
@@ -487,6 +554,9 @@ while(0)
 #define RME_X64_LAPIC_TIMER                  (0x0320/4)
 #define RME_X64_LAPIC_TIMER_X1               (0x0000000B)
 #define RME_X64_LAPIC_TIMER_PERIODIC         (0x00020000)
+/* The PIT input frequency, and the length of the LAPIC timer calibration window */
+#define RME_X64_PIT_FREQ                     (1193182)
+#define RME_X64_TIMER_CALIB_FREQ             (100)
 
 #define RME_X64_LAPIC_PCINT                  (0x0340/4)
 #define RME_X64_LAPIC_LINT0                  (0x0350/4)
@@ -498,9 +568,25 @@ while(0)
 #define RME_X64_LAPIC_TCCR                   (0x0390/4)
 #define RME_X64_LAPIC_TDCR                   (0x03E0/4)
 
-/* LAPIC R/W */
-#define RME_X64_LAPIC_READ(REG)              (((rme_u32_t*)RME_X64_PA2VA(RME_X64_LAPIC_Addr))[REG])
-#define RME_X64_LAPIC_WRITE(REG,VAL)         (((rme_u32_t*)RME_X64_PA2VA(RME_X64_LAPIC_Addr))[REG]=(VAL))
+/* x2APIC MSR space - each 16-byte MMIO register maps to one MSR, and the ICR
+ * becomes a single 64-bit MSR with the destination in the high 32 bits */
+#define RME_X64_X2APIC_MSR(REG)              (0x800+((REG)>>2))
+#define RME_X64_X2APIC_ICR                   RME_X64_X2APIC_MSR(RME_X64_LAPIC_ICRLO)
+
+/* LAPIC R/W - MSR-based when we are in x2APIC mode, MMIO otherwise */
+#define RME_X64_XAPIC_READ(REG)              (((volatile rme_u32_t*)RME_X64_PA2VA(RME_X64_LAPIC_Addr))[REG])
+#define RME_X64_XAPIC_WRITE(REG,VAL)         (((volatile rme_u32_t*)RME_X64_PA2VA(RME_X64_LAPIC_Addr))[REG]=(VAL))
+#define RME_X64_LAPIC_READ(REG) \
+    ((RME_X64_X2APIC!=0)?((rme_u32_t)__RME_X64_Read_MSR(RME_X64_X2APIC_MSR(REG))):RME_X64_XAPIC_READ(REG))
+#define RME_X64_LAPIC_WRITE(REG,VAL) \
+do \
+{ \
+    if(RME_X64_X2APIC!=0) \
+        __RME_X64_Write_MSR(RME_X64_X2APIC_MSR(REG),(VAL)); \
+    else \
+        RME_X64_XAPIC_WRITE(REG,VAL); \
+} \
+while(0)
 
 /* IOAPIC address - consider supporting multiple ones */
 #define RME_X64_IOAPIC_ADDR                 (RME_X64_PA2VA(0xFEC00000))
@@ -535,6 +621,7 @@ while(0)
 #define RME_X64_RFLAGS_IF                  (1<<9)
 
 /* MSR addresses */
+#define RME_X64_MSR_IA32_APIC_BASE         (0x1B)
 #define RME_X64_MSR_IA32_EFER              (0xC0000080)
 #define RME_X64_MSR_IA32_GS_BASE           (0xC0000101)
 #define RME_X64_MSR_IA32_KERNEL_GS_BASE    (0xC0000102)
@@ -544,6 +631,54 @@ while(0)
 
 /* MSR bits */
 #define RME_X64_MSR_IA32_EFER_SCE          (1)
+#define RME_X64_MSR_IA32_APIC_BASE_EXTD    (1<<10)
+#define RME_X64_MSR_IA32_APIC_BASE_EN      (1<<11)
+
+/* Control register bits */
+#define RME_X64_CR0_MP                     (1<<1)
+#define RME_X64_CR0_EM                     (1<<2)
+#define RME_X64_CR0_TS                     (1<<3)
+#define RME_X64_CR4_PGE                    (1<<7)
+#define RME_X64_CR4_OSFXSR                 (1<<9)
+#define RME_X64_CR4_OSXMMEXCPT             (1<<10)
+#define RME_X64_CR4_PCIDE                  (1<<17)
+#define RME_X64_CR4_OSXSAVE                (1<<18)
+/* XCR0 state components */
+#define RME_X64_XCR0_X87                   (1<<0)
+#define RME_X64_XCR0_SSE                   (1<<1)
+#define RME_X64_XCR0_AVX                   (1<<2)
+#define RME_X64_XCR0_OPMASK                (1<<5)
+#define RME_X64_XCR0_ZMM_HI256             (1<<6)
+#define RME_X64_XCR0_HI16_ZMM              (1<<7)
+
+/* The coprocessor context is a FXSAVE area when only SSE is in use, and a
+ * standard-format XSAVE area otherwise. Its size depends on the components */
+#if(RME_X64_FPU_TYPE==RME_X64_FPU_AVX512)
+#define RME_X64_XCR0                       (RME_X64_XCR0_X87|RME_X64_XCR0_SSE|RME_X64_XCR0_AVX| \
+                                            RME_X64_XCR0_OPMASK|RME_X64_XCR0_ZMM_HI256|RME_X64_XCR0_HI16_ZMM)
+#define RME_X64_COP_SIZE                   (2688)
+#elif(RME_X64_FPU_TYPE==RME_X64_FPU_AVX)
+#define RME_X64_XCR0                       (RME_X64_XCR0_X87|RME_X64_XCR0_SSE|RME_X64_XCR0_AVX)
+#define RME_X64_COP_SIZE                   (832)
+#else
+#define RME_X64_COP_SIZE                   (512)
+#endif
+/* The kernel memory is only word-aligned, and XSAVE wants 64 bytes */
+#define RME_X64_COP_ALIGN_ORDER            (6)
+#define RME_X64_COP_ALIGN                  (64)
+#define RME_X64_COP_AREA(COP)              RME_ROUND_UP((rme_ptr_t)((COP)->Area),RME_X64_COP_ALIGN_ORDER)
+/* Offsets in the save area */
+#define RME_X64_COP_FCW                    (0)
+#define RME_X64_COP_MXCSR                  (24)
+#define RME_X64_COP_MXCSR_MASK             (28)
+#define RME_X64_COP_XSTATE_BV              (512)
+#define RME_X64_COP_XCOMP_BV               (520)
+#define RME_X64_COP_XHDR_RSVD              (528)
+/* Initial values of FCW and MXCSR - all exceptions masked */
+#define RME_X64_FCW_INIT                   (0x037F)
+#define RME_X64_MXCSR_INIT                 (0x1F80)
+/* The MXCSR_MASK to assume when the processor reports zero */
+#define RME_X64_MXCSR_MASK_DEF             (0xFFBF)
 
 /* Segment definitions */
 #define RME_X64_SEG_KERNEL_CODE            (1*8)
@@ -553,13 +688,22 @@ while(0)
 #define RME_X64_SEG_EMPTY                  (3*8+3)
 
 /* Get kernel stack addresses */
-#define RME_X64_KSTACK(CPU)                (RME_X64_Layout.Stack_Start+((1+(CPU))<<RME_X64_KSTACK_ORDER))
+#define RME_X64_KSTACK(CPU)                (RME_X64_Layout.Stack_Start[CPU]+RME_POW2(RME_X64_KSTACK_ORDER))
 /* Get boot-time user stack addresses */
 #define RME_X64_USTACK(CPU)                (RME_POW2(RME_PGTBL_SIZE_2M)+((CPU)+1)*RME_POW2(RME_PGTBL_SIZE_2K))
 /* The base of CPU-local data area */
-#define RME_X64_CPU_LOCAL_BASE(CPU)        (RME_X64_Layout.PerCPU_Start+(CPU)*2*RME_POW2(RME_PGTBL_SIZE_4K))
+#define RME_X64_CPU_LOCAL_BASE(CPU)        (RME_X64_Layout.PerCPU_Start[CPU])
+/* The size of a CPU-local data area */
+#define RME_X64_CPU_LOCAL_SIZE             (2*RME_POW2(RME_PGTBL_SIZE_4K))
 /* Microsecond delay function - not needed in most cases */
 #define RME_X64_UDELAY(US)
+/* The AP trampoline code is copied here, and its 32-bit temporary stack is right above it */
+#define RME_X64_BOOT_CODE                  0x7000
+#define RME_X64_BOOT_TEMP_STACK            0x8000
+/* The boot slots that the APs look themselves up in. There are RME_X64_CPU_NUM+1 of them
+ * at most, and they must stay below the trampoline parameters at RME_X64_BOOT_CODE-16.
+ * The address is also hard-coded in the assembly */
+#define RME_X64_BOOT_SLOT                  0x5000
 /*****************************************************************************/
 /* __RME_PLATFORM_X64_H_DEFS__ */
 #endif
@@ -636,6 +780,17 @@ struct RME_X64_ACPI_MADT_LAPIC_Record
 	rme_u32_t Flags;
 } __attribute__((__packed__));
 
+/* MADT's x2APIC record - used for APIC IDs that do not fit in 8 bits */
+struct RME_X64_ACPI_MADT_X2APIC_Record
+{
+	rme_u8_t Type;
+	rme_u8_t Length;
+	rme_u16_t Reserved;
+	rme_u32_t X2APIC_ID;
+	rme_u32_t Flags;
+	rme_u32_t ACPI_UID;
+} __attribute__((__packed__));
+
 /* MADT's IOAPIC record */
 struct RME_X64_ACPI_MADT_IOAPIC_Record
 {
@@ -647,6 +802,67 @@ struct RME_X64_ACPI_MADT_IOAPIC_Record
 	rme_u32_t Interrupt_Base;
 } __attribute__((__packed__));
 
+/* System Resource Affinity Table header */
+struct RME_X64_ACPI_SRAT_Hdr
+{
+	struct RME_X64_ACPI_Desc_Hdr Header;
+	rme_u32_t Reserved1;
+	rme_u64_t Reserved2;
+    /* This is fine; GCC can take this */
+	rme_u8_t Table[0];
+} __attribute__((__packed__));
+
+/* SRAT's LAPIC affinity record */
+struct RME_X64_ACPI_SRAT_LAPIC_Record
+{
+	rme_u8_t Type;
+	rme_u8_t Length;
+	rme_u8_t Domain_Low;
+	rme_u8_t APIC_ID;
+	rme_u32_t Flags;
+	rme_u8_t SAPIC_EID;
+	rme_u8_t Domain_High[3];
+	rme_u32_t Clock_Domain;
+} __attribute__((__packed__));
+
+/* SRAT's memory affinity record */
+struct RME_X64_ACPI_SRAT_MEM_Record
+{
+	rme_u8_t Type;
+	rme_u8_t Length;
+	rme_u32_t Domain;
+	rme_u16_t Reserved1;
+	rme_u32_t Base_Low;
+	rme_u32_t Base_High;
+	rme_u32_t Length_Low;
+	rme_u32_t Length_High;
+	rme_u32_t Reserved2;
+	rme_u32_t Flags;
+	rme_u64_t Reserved3;
+} __attribute__((__packed__));
+
+/* SRAT's x2APIC affinity record */
+struct RME_X64_ACPI_SRAT_X2APIC_Record
+{
+	rme_u8_t Type;
+	rme_u8_t Length;
+	rme_u16_t Reserved1;
+	rme_u32_t Domain;
+	rme_u32_t X2APIC_ID;
+	rme_u32_t Flags;
+	rme_u32_t Clock_Domain;
+	rme_u32_t Reserved2;
+} __attribute__((__packed__));
+
+/* System Locality Information Table header */
+struct RME_X64_ACPI_SLIT_Hdr
+{
+	struct RME_X64_ACPI_Desc_Hdr Header;
+	rme_u64_t Localities;
+    /* This is fine; GCC can take this */
+	rme_u8_t Entry[0];
+} __attribute__((__packed__));
+
 /* MADT's interrupt source override record*/
 struct RME_X64_ACPI_MADT_SRC_OVERRIDE_Record
 {
@@ -698,6 +914,20 @@ struct RME_X64_Temp
 	rme_ptr_t Temp_User_SP;
 };
 
+/* A TLB shootdown request - the translation of an address in a PCID is gone */
+struct RME_X64_Shoot
+{
+	rme_ptr_t PCID;
+	rme_ptr_t Addr;
+};
+
+/* AP boot slot - the APs find their kernel stacks here by their LAPIC IDs */
+struct RME_X64_Boot_Slot
+{
+	rme_ptr_t LAPIC_ID;
+	rme_ptr_t Stack;
+};
+
 /* Per-CPU data structure */
 struct RME_X64_CPU_Info
 {
@@ -705,6 +935,27 @@ struct RME_X64_CPU_Info
 	rme_ptr_t LAPIC_ID;
 	/* Is the booting done on this CPU? */
 	volatile rme_ptr_t Boot_Done;
+	/* The timestamp counter value when the booting was done on this CPU */
+	volatile rme_ptr_t Boot_TSC;
+	/* The NUMA node of the CPU */
+	rme_ptr_t Node;
+	/* The TLB epoch that this CPU has caught up with */
+	volatile rme_ptr_t TLB_Epoch;
+	/* The PCID that this CPU is running in now */
+	volatile rme_ptr_t Cur_PCID;
+	/* The PCIDs whose TLB entries on this CPU must be flushed before use */
+	volatile rme_ptr_t PCID_Stale[RME_X64_PCID_NUM/(sizeof(rme_ptr_t)*8)];
+	/* The CPUs that have shootdown requests for this CPU, one bit each */
+	volatile rme_ptr_t Shoot_From[RME_X64_CPU_WORDS];
+	/* The shootdown requests made by this CPU that are not sent yet. If there
+	 * are too many, we just ask for a full flush */
+	volatile rme_ptr_t Shoot_Num;
+	volatile rme_ptr_t Shoot_Full;
+	volatile struct RME_X64_Shoot Shoot[RME_X64_SHOOT_MAX];
+	/* The CPUs that must receive them, and the number of acknowledgements that
+	 * we are still waiting for */
+	volatile rme_ptr_t Shoot_To[RME_X64_CPU_WORDS];
+	volatile rme_ptr_t Shoot_Wait;
 };
 
 /* Per-IOAPIC data structure */
@@ -743,87 +994,13 @@ struct RME_Reg_Struct
     rme_ptr_t SS;
 };
 
-/* The coprocessor register set structure. MMX and SSE */
+/* The coprocessor register set structure. This is just the FXSAVE/XSAVE area,
+ * with some slack so that RME_X64_COP_AREA can align it to 64 bytes. The MMX,
+ * x87 and XMM registers are in the legacy region; the upper halves of YMM, the
+ * opmasks and the ZMM registers are in the extended region if we have them */
 struct RME_Cop_Struct
 {
-	/* MMX registers first */
-	rme_ptr_t FPR_MMX0[2];
-	rme_ptr_t FPR_MMX1[2];
-	rme_ptr_t FPR_MMX2[2];
-	rme_ptr_t FPR_MMX3[2];
-	rme_ptr_t FPR_MMX4[2];
-	rme_ptr_t FPR_MMX5[2];
-	rme_ptr_t FPR_MMX6[2];
-	rme_ptr_t FPR_MMX7[2];
-	/* SSE registers follow */
-#if(RME_X64_FPU_TYPE==RME_FALSE)
-	rme_ptr_t XMM0[2];
-	rme_ptr_t XMM1[2];
-	rme_ptr_t XMM2[2];
-	rme_ptr_t XMM3[2];
-	rme_ptr_t XMM4[2];
-	rme_ptr_t XMM5[2];
-	rme_ptr_t XMM6[2];
-	rme_ptr_t XMM7[2];
-	rme_ptr_t XMM8[2];
-	rme_ptr_t XMM9[2];
-	rme_ptr_t XMM10[2];
-	rme_ptr_t XMM11[2];
-	rme_ptr_t XMM12[2];
-	rme_ptr_t XMM13[2];
-	rme_ptr_t XMM14[2];
-	rme_ptr_t XMM15[2];
-#elif(RME_X64_FPU_TYPE==RME_X64_FPU_AVX)
-	rme_ptr_t XYMM0[4];
-	rme_ptr_t XYMM1[4];
-	rme_ptr_t XYMM2[4];
-	rme_ptr_t XYMM3[4];
-	rme_ptr_t XYMM4[4];
-	rme_ptr_t XYMM5[4];
-	rme_ptr_t XYMM6[4];
-	rme_ptr_t XYMM7[4];
-	rme_ptr_t XYMM8[4];
-	rme_ptr_t XYMM9[4];
-	rme_ptr_t XYMM10[4];
-	rme_ptr_t XYMM11[4];
-	rme_ptr_t XYMM12[4];
-	rme_ptr_t XYMM13[4];
-	rme_ptr_t XYMM14[4];
-	rme_ptr_t XYMM15[4];
-#elif(RME_X64_FPU_TYPE==RME_X64_FPU_AVX512)
-	rme_ptr_t XYZMM0[8];
-	rme_ptr_t XYZMM1[8];
-	rme_ptr_t XYZMM2[8];
-	rme_ptr_t XYZMM3[8];
-	rme_ptr_t XYZMM4[8];
-	rme_ptr_t XYZMM5[8];
-	rme_ptr_t XYZMM6[8];
-	rme_ptr_t XYZMM7[8];
-	rme_ptr_t XYZMM8[8];
-	rme_ptr_t XYZMM9[8];
-	rme_ptr_t XYZMM10[8];
-	rme_ptr_t XYZMM11[8];
-	rme_ptr_t XYZMM12[8];
-	rme_ptr_t XYZMM13[8];
-	rme_ptr_t XYZMM14[8];
-	rme_ptr_t XYZMM15[8];
-	rme_ptr_t XYZMM16[8];
-	rme_ptr_t XYZMM17[8];
-	rme_ptr_t XYZMM18[8];
-	rme_ptr_t XYZMM19[8];
-	rme_ptr_t XYZMM20[8];
-	rme_ptr_t XYZMM21[8];
-	rme_ptr_t XYZMM22[8];
-	rme_ptr_t XYZMM23[8];
-	rme_ptr_t XYZMM24[8];
-	rme_ptr_t XYZMM25[8];
-	rme_ptr_t XYZMM26[8];
-	rme_ptr_t XYZMM27[8];
-	rme_ptr_t XYZMM28[8];
-	rme_ptr_t XYZMM29[8];
-	rme_ptr_t XYZMM30[8];
-	rme_ptr_t XYZMM31[8];
-#endif
+	rme_u8_t Area[RME_X64_COP_SIZE+RME_X64_COP_ALIGN];
 };
 
 /* Need to save SP and IP across synchronous invocation */
@@ -834,18 +1011,20 @@ struct RME_Iret_Struct
 };
 
 /* Memory information - the layout is (offset from VA base):
- * |0--640k|----------16MB|-----|-----|------|------|-----|3.25G-4G|-----|-----|
- * |Vectors|Kernel&Globals|Kotbl|Pgreg|PerCPU|Kpgtbl|Kmem1|  Hole  |Kmem2|Stack|
+ * |0--640k|----------16MB|-----|-----|------|-----|3.25G-4G|-----------------|
+ * |Vectors|Kernel&Globals|Kotbl|Pgreg|Kpgtbl|Kmem1|  Hole  |Kmem2 per node...|
  *  Vectors        : Interrupt vectors.
  *  Kernel&Globals : Initial kernel text segment and all static variables.
  *  Kotbl          : Kernel object registration table.
- *  PerCPU         : Per-CPU data structures.
  *  Kpgtbl         : Kernel page tables.
  *  Pgreg          : Page table registration table.
  *  Kmem1          : Kernel memory 1, linear mapping, allow creation of page tables.
  *  Hole           : Memory hole present at 3.25G-4G. For PCI devices.
  *  Kmem2          : Kernel memory 2, nonlinear mapping, no page table creation allowed.
- *  Stacks         : Kernel stacks, per-CPU.
+ *                   This is laid out node by node, so each node's part is contiguous.
+ *  The per-CPU data structures and the kernel stacks are taken from the top of
+ *  the Kmem2 of the CPU's node, or from the top of the first Kmem1 trunk if the
+ *  nodes are out of memory.
  *  All values are in bytes, and are virtual addresses.
  */
 struct RME_X64_Layout
@@ -856,8 +1035,7 @@ struct RME_X64_Layout
 	rme_ptr_t Pgreg_Start;
 	rme_ptr_t Pgreg_Size;
 
-	rme_ptr_t PerCPU_Start;
-	rme_ptr_t PerCPU_Size;
+	rme_ptr_t PerCPU_Start[RME_X64_CPU_NUM];
 
 	rme_ptr_t Kpgtbl_Start;
 	rme_ptr_t Kpgtbl_Size;
@@ -866,15 +1044,23 @@ struct RME_X64_Layout
 	rme_ptr_t Kmem1_Trunks;
 	rme_ptr_t Kmem1_Start[RME_X64_KMEM1_MAXSEGS];
 	rme_ptr_t Kmem1_Size[RME_X64_KMEM1_MAXSEGS];
+	rme_ptr_t Kmem1_Node[RME_X64_KMEM1_MAXSEGS];
 
 	rme_ptr_t Hole_Start;
 	rme_ptr_t Hole_Size;
 
-	rme_ptr_t Kmem2_Start;
-	rme_ptr_t Kmem2_Size;
+	rme_ptr_t Kmem2_Start[RME_X64_NODE_NUM];
+	rme_ptr_t Kmem2_Size[RME_X64_NODE_NUM];
 
-	rme_ptr_t Stack_Start;
-	rme_ptr_t Stack_Size;
+	rme_ptr_t Stack_Start[RME_X64_CPU_NUM];
+};
+
+/* A memory range in the SRAT */
+struct RME_X64_NUMA_Mem
+{
+	rme_ptr_t Start;
+	rme_ptr_t End;
+	rme_ptr_t Node;
 };
 
 /* The processor features */
@@ -936,9 +1122,17 @@ static volatile struct multiboot_info* RME_X64_MBInfo;
 static volatile struct RME_X64_Layout RME_X64_Layout;
 /* We currently support 256 CPUs max */
 static volatile rme_ptr_t RME_X64_Num_CPU;
-/* CPU counter */
+/* CPU counter - nonzero when the booting processor is still booting others */
 static volatile rme_ptr_t RME_X64_CPU_Cnt;
 static volatile struct RME_X64_CPU_Info RME_X64_CPU_Info[RME_X64_CPU_NUM];
+/* The NUMA nodes, and the proximity domain of each */
+static volatile rme_ptr_t RME_X64_Num_Node;
+static volatile rme_ptr_t RME_X64_Node_Domain[RME_X64_NODE_NUM];
+/* The memory ranges of the nodes */
+static volatile rme_ptr_t RME_X64_Num_NUMA_Mem;
+static volatile struct RME_X64_NUMA_Mem RME_X64_NUMA_Mem[RME_X64_NUMA_MEM_NUM];
+/* The relative distances between nodes */
+static volatile rme_u8_t RME_X64_Node_Dist[RME_X64_NODE_NUM][RME_X64_NODE_NUM];
 /* There can be max. 8 IOAPICs */
 static volatile rme_ptr_t RME_X64_Num_IOAPIC;
 static volatile struct RME_X64_IOAPIC_Info RME_X64_IOAPIC_Info[RME_X64_IOAPIC_NUM];
@@ -946,8 +1140,27 @@ static volatile struct RME_X64_IOAPIC_Info RME_X64_IOAPIC_Info[RME_X64_IOAPIC_NU
 static volatile rme_ptr_t RME_X64_LAPIC_Addr;
 /* The processor features */
 static volatile struct RME_X64_Features RME_X64_Feature;
-/* The PCID counter */
-static volatile rme_ptr_t RME_X64_PCID_Inc;
+/* Whether the LAPICs are driven in x2APIC mode */
+static volatile rme_ptr_t RME_X64_X2APIC;
+/* Whether we can use XSAVEOPT, and the MXCSR bits that the processor accepts */
+static volatile rme_ptr_t RME_X64_XSAVEOPT;
+static volatile rme_ptr_t RME_X64_MXCSR_Mask;
+/* Whether we have PCID and INVPCID */
+static volatile rme_ptr_t RME_X64_PCID;
+static volatile rme_ptr_t RME_X64_INVPCID;
+/* Do we have enhanced REP MOVSB/STOSB? */
+static volatile rme_ptr_t RME_X64_ERMS;
+/* The PCID allocation bitmap */
+static volatile rme_ptr_t RME_X64_PCID_Bitmap[RME_X64_PCID_NUM/(sizeof(rme_ptr_t)*8)];
+/* Increased whenever a mapping whose PCID is unknown is removed; each CPU flushes
+ * all its PCIDs before using one without flushing if it has not seen the latest
+ * epoch */
+static volatile rme_ptr_t RME_X64_TLB_Epoch;
+/* The CPUs that have ever run in each PCID since it was allocated, and may thus
+ * have TLB entries of it */
+static volatile rme_ptr_t RME_X64_PCID_CPU[RME_X64_PCID_NUM][RME_X64_CPU_WORDS];
+/* The LAPIC timer count of one tick, calibrated by the booting processor */
+static volatile rme_ptr_t RME_X64_LAPIC_Tick_Cnt;
 
 /* Translate the flags into X64 specific ones - the STATIC bit will never be
  * set thus no need to consider about it here. The flag bits order is shown below:
@@ -1116,6 +1329,12 @@ static void __RME_X64_UART_Init(void);
 static struct RME_X64_ACPI_RDSP_Desc* __RME_X64_RDSP_Scan(rme_ptr_t Base, rme_ptr_t Len);
 static struct RME_X64_ACPI_RDSP_Desc* __RME_X64_RDSP_Find(void);
 static rme_ret_t __RME_X64_SMP_Detect(struct RME_X64_ACPI_MADT_Hdr* MADT);
+/* Detect the NUMA nodes */
+static rme_ptr_t __RME_X64_NUMA_Domain(rme_ptr_t Domain);
+static void __RME_X64_NUMA_Detect(struct RME_X64_ACPI_SRAT_Hdr* SRAT, struct RME_X64_ACPI_SLIT_Hdr* SLIT);
+static rme_ptr_t __RME_X64_NUMA_Node(rme_ptr_t Addr);
+static rme_ptr_t __RME_X64_NUMA_Bound(rme_ptr_t Start, rme_ptr_t End);
+static rme_ptr_t __RME_X64_NUMA_Carve(rme_ptr_t Node, rme_ptr_t Size_Order);
 /* Debug output helper */
 static void __RME_X64_ACPI_Debug(struct RME_X64_ACPI_Desc_Hdr *Header);
 /* Initialize the ACPI */
@@ -1125,17 +1344,32 @@ static void __RME_X64_Feature_Get(void);
 /* Initialize memory according to GRUB multiboot specification */
 static void __RME_X64_Mem_Init(rme_ptr_t MMap_Addr, rme_ptr_t MMap_Length);
 /* Initialize CPU-local tables */
-static void __RME_X64_CPU_Local_Init(void);
+static void __RME_X64_CPU_Local_Init(rme_ptr_t CPUID);
 /* Get the RME CPU-local data structure given its CPUID */
 static struct RME_CPU_Local* __RME_X64_CPU_Local_Get_By_CPUID(rme_ptr_t CPUID);
 /* Initialize interrupt controllers */
 static void __RME_X64_PIC_Init(void);
 static void __RME_X64_LAPIC_Init(void);
+static void __RME_X64_LAPIC_IPI(rme_ptr_t LAPIC_ID, rme_ptr_t Cmd);
 static void __RME_X64_IOAPIC_Init(void);
 /* Enable/disable a vector in IOAPIC */
 static void __RME_X64_IOAPIC_Int_Enable(rme_ptr_t IRQ, rme_ptr_t CPUID);
 static void __RME_X64_IOAPIC_Int_Disable(rme_ptr_t IRQ);
+/* Initialize the FPU and the extended states */
+static void __RME_X64_FPU_Init(void);
+static void __RME_X64_FPU_Handler(void);
+/* PCID and TLB management */
+static void __RME_X64_TLB_Init(void);
+static void __RME_X64_TLB_Flush(void);
+static rme_ptr_t __RME_X64_PCID_Alloc(void);
+static void __RME_X64_PCID_Free(rme_ptr_t PCID);
+/* TLB shootdown */
+static void __RME_X64_Bitmap_Set(volatile rme_ptr_t* Bitmap, rme_ptr_t Pos);
+static void __RME_X64_Shoot_Inv(rme_ptr_t PCID, rme_ptr_t Addr);
+static void __RME_X64_Shoot_Add(rme_ptr_t PCID, rme_ptr_t Addr);
+static void __RME_X64_Shoot_Handler(void);
 /* Initialize timers */
+static void __RME_X64_Timer_Calib(void);
 static void __RME_X64_Timer_Init(void);
 /*****************************************************************************/
 #define __EXTERN__
@@ -1152,6 +1386,8 @@ static void __RME_X64_Timer_Init(void);
 EXTERN struct RME_X64_IDT_Entry RME_X64_IDT_Table[256];
 EXTERN struct __RME_X64_Kern_Pgtbl RME_X64_Kpgt;
 EXTERN rme_ptr_t __RME_X64_Kern_Boot_Stack[0];
+/* The kernel object allocation table summary, placed at boot */
+__EXTERN__ rme_ptr_t* RME_X64_Kotbl_Sum;
 /*****************************************************************************/
 
 /* End Public Global Variables ***********************************************/
@@ -1168,6 +1404,8 @@ EXTERN void __RME_X64_IDT_Load(rme_ptr_t* IDTR);
 EXTERN void __RME_X64_TSS_Load(rme_ptr_t TSS);
 EXTERN rme_ptr_t __RME_X64_CPUID_Get(rme_ptr_t EAX, rme_ptr_t* EBX, rme_ptr_t* ECX, rme_ptr_t* EDX);
 EXTERN void __RME_X64_Pgtbl_Set(rme_ptr_t Pgtbl);
+EXTERN void __RME_X64_INVPCID(rme_ptr_t Type, rme_ptr_t PCID, rme_ptr_t Addr);
+EXTERN void __RME_X64_INVLPG(rme_ptr_t Addr);
 /* Boot glue */
 EXTERN void __RME_X64_SMP_Boot_32(void);
 /* Vectors */
@@ -1446,8 +1684,11 @@ EXTERN void __RME_X64_USER255_Handler(void);
 EXTERN void __RME_Disable_Int(void);
 EXTERN void __RME_Enable_Int(void);
 EXTERN void __RME_X64_Halt(void);
-__EXTERN__ void __RME_X64_SMP_Tick(void);
 __EXTERN__ void __RME_X64_LAPIC_Ack(void);
+/* Cycle counter */
+EXTERN rme_ptr_t __RME_X64_RDTSC(void);
+/* Tickless timer */
+__EXTERN__ void __RME_Timer_Set(rme_ptr_t Ticks);
 /* Atomics */
 __EXTERN__ rme_ptr_t __RME_X64_Comp_Swap(rme_ptr_t* Ptr, rme_ptr_t Old, rme_ptr_t New);
 __EXTERN__ rme_ptr_t __RME_X64_Fetch_Add(rme_ptr_t* Ptr, rme_cnt_t Addend);
@@ -1455,11 +1696,25 @@ __EXTERN__ rme_ptr_t __RME_X64_Fetch_And(rme_ptr_t* Ptr, rme_ptr_t Operand);
 __EXTERN__ rme_ptr_t __RME_X64_Write_Release(void);
 /* MSB counting */
 EXTERN rme_ptr_t __RME_X64_MSB_Get(rme_ptr_t Val);
+/* Memory primitives */
+EXTERN void __RME_X64_Clear(void* Addr, rme_ptr_t Size);
+EXTERN void __RME_X64_Movsb(void* Dst, void* Src, rme_ptr_t Num);
+EXTERN void __RME_X64_Movsq(void* Dst, void* Src, rme_ptr_t Num);
+__EXTERN__ void __RME_X64_Memcpy(void* Dst, void* Src, rme_ptr_t Num);
 /* Debugging */
 __EXTERN__ rme_ptr_t __RME_Putchar(char Char);
 /* Coprocessor */
-EXTERN void ___RME_X64_Thd_Cop_Save(struct RME_Cop_Struct* Cop_Reg);
-EXTERN void ___RME_X64_Thd_Cop_Restore(struct RME_Cop_Struct* Cop_Reg);
+EXTERN rme_ptr_t __RME_X64_CR0_Get(void);
+EXTERN void __RME_X64_CR0_Set(rme_ptr_t CR0);
+EXTERN rme_ptr_t __RME_X64_CR4_Get(void);
+EXTERN void __RME_X64_CR4_Set(rme_ptr_t CR4);
+EXTERN void __RME_X64_XCR0_Set(rme_ptr_t XCR0);
+EXTERN void __RME_X64_CLTS(void);
+EXTERN void __RME_X64_FXSAVE(rme_ptr_t Area);
+EXTERN void __RME_X64_FXRSTOR(rme_ptr_t Area);
+EXTERN void __RME_X64_XSAVE(rme_ptr_t Area);
+EXTERN void __RME_X64_XSAVEOPT(rme_ptr_t Area);
+EXTERN void __RME_X64_XRSTOR(rme_ptr_t Area);
 /* Booting */
 EXTERN void _RME_Kmain(rme_ptr_t Stack);
 EXTERN void __RME_Enter_User_Mode(rme_ptr_t Entry_Addr, rme_ptr_t Stack_Addr, rme_ptr_t CPUID);
@@ -1472,6 +1727,7 @@ EXTERN struct RME_CPU_Local* __RME_X64_CPU_Local_Get(void);
 __EXTERN__ void __RME_Get_Syscall_Param(struct RME_Reg_Struct* Reg, rme_ptr_t* Svc,
                                         rme_ptr_t* Capid, rme_ptr_t* Param);
 __EXTERN__ void __RME_Set_Syscall_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval);
+__EXTERN__ void __RME_Set_Sig_Data(struct RME_Reg_Struct* Reg, rme_ptr_t Data0, rme_ptr_t Data1);
 /* Thread register sets */
 __EXTERN__ void __RME_Thd_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, rme_ptr_t Param, struct RME_Reg_Struct* Reg);
 __EXTERN__ void __RME_Thd_Reg_Copy(struct RME_Reg_Struct* Dst, struct RME_Reg_Struct* Src);
@@ -1479,7 +1735,7 @@ __EXTERN__ void __RME_Thd_Cop_Init(struct RME_Reg_Struct* Reg, struct RME_Cop_St
 __EXTERN__ void __RME_Thd_Cop_Save(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg);
 __EXTERN__ void __RME_Thd_Cop_Restore(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg);
 /* Invocation register sets */
-__EXTERN__ void __RME_Inv_Reg_Init(rme_ptr_t Param, struct RME_Reg_Struct* Reg);
+__EXTERN__ void __RME_Inv_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, struct RME_Reg_Struct* Reg);
 __EXTERN__ void __RME_Inv_Reg_Save(struct RME_Iret_Struct* Ret, struct RME_Reg_Struct* Reg);
 __EXTERN__ void __RME_Inv_Reg_Restore(struct RME_Reg_Struct* Reg, struct RME_Iret_Struct* Ret);
 __EXTERN__ void __RME_Set_Inv_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval);
@@ -1490,8 +1746,11 @@ __EXTERN__ rme_ret_t __RME_Kern_Func_Handler(struct RME_Cap_Captbl* Captbl, stru
 __EXTERN__ void __RME_X64_Fault_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Reason);
 /* Generic interrupt handler */
 __EXTERN__ void __RME_X64_Generic_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Int_Num);
+/* Cross-core signal wakeup */
+__EXTERN__ void __RME_Wake_IPI(rme_ptr_t CPUID);
 /* Page table operations */
 __EXTERN__ void __RME_Pgtbl_Set(rme_ptr_t Pgtbl);
+__EXTERN__ void __RME_Pgtbl_Sync(void);
 __EXTERN__ rme_ptr_t __RME_Pgtbl_Kmem_Init(void);
 __EXTERN__ rme_ptr_t __RME_Pgtbl_Check(rme_ptr_t Base_Addr, rme_ptr_t Top_Flag, rme_ptr_t Size_Order, rme_ptr_t Num_Order, rme_ptr_t Vaddr);
 __EXTERN__ rme_ptr_t __RME_Pgtbl_Init(struct RME_Cap_Pgtbl* Pgtbl_Op);
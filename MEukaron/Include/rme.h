@@ -179,10 +179,15 @@ Description : The header of the RME RTOS. This header defines the error codes,
 #define RME_THD_FLAG_XFER_DST           (1<<8)
 /* This cap to thread allows switching to it */
 #define RME_THD_FLAG_SWT                (1<<9)
+/* This cap to thread allows changing its EDF period and budget */
+#define RME_THD_FLAG_SCHED_EDF          (1<<10)
+/* This cap to thread allows reading how many processor cycles it used */
+#define RME_THD_FLAG_CYCLE_GET          (1<<11)
 /* This cap to thread allows all operations */
 #define RME_THD_FLAG_ALL                (RME_THD_FLAG_EXEC_SET|RME_THD_FLAG_HYP_SET|RME_THD_FLAG_SCHED_CHILD| \
                                          RME_THD_FLAG_SCHED_PARENT|RME_THD_FLAG_SCHED_PRIO|RME_THD_FLAG_SCHED_FREE| \
-                                         RME_THD_FLAG_SCHED_RCV|RME_THD_FLAG_XFER_SRC|RME_THD_FLAG_XFER_DST|RME_THD_FLAG_SWT)
+                                         RME_THD_FLAG_SCHED_RCV|RME_THD_FLAG_XFER_SRC|RME_THD_FLAG_XFER_DST|RME_THD_FLAG_SWT| \
+                                         RME_THD_FLAG_SCHED_EDF|RME_THD_FLAG_CYCLE_GET)
 
 /* Invocation */
 /* This cap to invocation allows setting parameters for it */
@@ -333,6 +338,11 @@ Description : The header of the RME RTOS. This header defines the error codes,
 #define RME_RCV_BM                      (1)
 #define RME_RCV_NS                      (2)
 #define RME_RCV_NM                      (3)
+
+/* Cycle reading options: all the cycles that a thread used, or those that it used
+ * in the invocations that it made */
+#define RME_THD_CYCLE_ALL               (0)
+#define RME_THD_CYCLE_INV               (1)
 /* End Special Definitions ***************************************************/
 
 /* Syystem Calls *************************************************************/
@@ -414,6 +424,22 @@ Description : The header of the RME RTOS. This header defines the error codes,
 #define RME_SVC_INV_DEL                 (33)
 /* Set entry&stack */
 #define RME_SVC_INV_SET                 (34)
+/* Batched operations ********************************************************/
+/* Do many non-switching operations in a single kernel entry */
+#define RME_SVC_BATCH                   (35)
+/* Kernel memory operations **************************************************/
+/* Find a free range in a kernel memory capability */
+#define RME_SVC_KMEM_FIND               (36)
+/* Signal operations, continued **********************************************/
+/* Create with a payload ring */
+#define RME_SVC_SIG_RING_CRT            (37)
+/* Thread operations, continued **********************************************/
+/* Set the EDF period and budget */
+#define RME_SVC_THD_SCHED_EDF           (38)
+/* Move to another processor */
+#define RME_SVC_THD_SCHED_MIGR          (39)
+/* Get the number of processor cycles used */
+#define RME_SVC_THD_CYCLE_GET           (40)
 /* End System Calls **********************************************************/
 
 /* Kernel Functions **********************************************************/
@@ -459,6 +485,13 @@ Description : The header of the RME RTOS. This header defines the error codes,
 #define RME_KERN_HPNP_LCPU_MOD          (0xF301)
 /* Modify physical memory configuration */
 #define RME_KERN_HPNP_PMEM_MOD          (0xF302)
+/* Query the NUMA topology */
+#define RME_KERN_HPNP_NUMA_INFO         (0xF303)
+/* Sub IDs of the above: the number of nodes, the node of a CPU, or the distance
+ * between two nodes */
+#define RME_KERN_NUMA_NODE_NUM          (0)
+#define RME_KERN_NUMA_CPU_NODE          (1)
+#define RME_KERN_NUMA_NODE_DIST         (2)
 /* Hot plug and pull operations **********************************************/
 /* Put CPU into idle sleep mode */
 #define RME_KERN_IDLE_SLEEP             (0xF400)
@@ -485,6 +518,19 @@ Description : The header of the RME RTOS. This header defines the error codes,
 #define RME_KERN_PERF_PHYS_MOD          (0xF505)
 /* Query or modify cumulative monitor register */
 #define RME_KERN_PERF_CUMUL_MOD         (0xF506)
+/* Query the capability resolution cache statistics of the current CPU */
+#define RME_KERN_PERF_CAP_CACHE         (0xF507)
+/* Sub IDs of the above: hit count, miss count, or reset both */
+#define RME_KERN_CAP_CACHE_HIT          (0)
+#define RME_KERN_CAP_CACHE_MISS         (1)
+#define RME_KERN_CAP_CACHE_CLR          (2)
+/* Read the kernel event trace of the current CPU, if it is compiled in */
+#define RME_KERN_PERF_TRACE             (0xF508)
+/* Sub IDs of the above: the number of events ever recorded, or the time of an
+ * event, or the type and the two arguments of an event */
+#define RME_KERN_TRACE_HEAD             (0)
+#define RME_KERN_TRACE_TIME             (1)
+#define RME_KERN_TRACE_DATA             (2)
 /* Hardware virtualization operations ****************************************/
 /* Create a virtual machine */
 #define RME_KERN_VM_CRT                 (0xF600)
@@ -531,6 +577,25 @@ Description : The header of the RME RTOS. This header defines the error codes,
 /* Modify data breakpoint state */
 #define RME_KERN_DEBUG_DBP_MOD          (0xF805)
 /* End Kernel Functions ******************************************************/
+
+/* Kernel Trace Events *******************************************************/
+/* System call entry - the service number and the capability ID */
+#define RME_TRACE_SVC_ENTRY             (0)
+/* System call exit - the service number and the return value */
+#define RME_TRACE_SVC_EXIT              (1)
+/* Context switch - the TIDs of the threads switched from and to */
+#define RME_TRACE_THD_SWT               (2)
+/* Kernel send - the endpoint, and the TID of the thread unblocked or -1 */
+#define RME_TRACE_KERN_SND              (3)
+/* User send - the endpoint, and the TID of the thread unblocked or -1 */
+#define RME_TRACE_SIG_SND               (4)
+/* Invocation activation - the invocation, and the process it enters */
+#define RME_TRACE_INV_ACT               (5)
+/* Invocation return - the return value and the fault flag */
+#define RME_TRACE_INV_RET               (6)
+/* Timer tick - the number of ticks accounted, and the TID of the current thread */
+#define RME_TRACE_TICK                  (7)
+/* End Kernel Trace Events ***************************************************/
 /* End Defines ***************************************************************/
 
 #endif /* __RME_H__ */
@@ -196,6 +196,8 @@ rme_ret_t __RME_Low_Level_Check(void)
     RME_ASSERT(RME_KMEM_SLOT_ORDER>=RME_WORD_ORDER-3);
     /* Make sure the number of priorities does not exceed half-word boundary */
     RME_ASSERT(RME_MAX_PREEMPT_PRIO<=RME_POW2(RME_WORD_BITS>>1));
+    /* Make sure the priority bitmap words can be summarized in one word */
+    RME_ASSERT(RME_PRIO_WORD_NUM<=RME_WORD_BITS);
     return 0;
 }
 /* End Function:__RME_Low_Level_Check ****************************************/
@@ -211,6 +213,8 @@ rme_ret_t _RME_Syscall_Init(void)
 {
     /* Set it to 0x00..FF.. */
     RME_Timestamp=(~((rme_ptr_t)(0)))>>(sizeof(rme_ptr_t)*4);
+    /* No capability table has been frozen yet */
+    RME_Captbl_Gen=0;
     
     return 0;
 }
@@ -231,13 +235,15 @@ void _RME_Svc_Handler(struct RME_Reg_Struct* Reg)
     rme_ptr_t Param[3];
     rme_ret_t Retval;
     rme_ptr_t Svc_Num;
+    rme_ptr_t Flag;
     struct RME_CPU_Local* CPU_Local;
     struct RME_Inv_Struct* Inv_Top;
     struct RME_Cap_Captbl* Captbl;
 
     /* Get the system call parameters from the system call */
     __RME_Get_Syscall_Param(Reg, &Svc, &Capid, Param);
-    Svc_Num=Svc&0x3F;
+    Svc_Num=Svc&(RME_SVC_TBL_NUM-1);
+    RME_TRACE_EVENT(RME_TRACE_SVC_ENTRY,Svc_Num,Capid);
     
     /* Fast path - synchronous invocation returning */
     if(Svc_Num==RME_SVC_INV_RET)
@@ -247,6 +253,7 @@ void _RME_Svc_Handler(struct RME_Reg_Struct* Reg)
         Retval=_RME_Inv_Ret(Reg      /* struct RME_Reg_Struct* Reg */,
                             Param[0] /* rme_ptr_t Retval */,
                             0        /* rme_ptr_t Fault_Flag */);
+        RME_TRACE_EVENT(RME_TRACE_SVC_EXIT,Svc_Num,Retval);
         RME_SWITCH_RETURN(Reg,Retval);
     }
     else
@@ -277,8 +284,8 @@ void _RME_Svc_Handler(struct RME_Reg_Struct* Reg)
         RME_COVERAGE_MARKER();
         
         Retval=_RME_Inv_Act(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
-                                    Param[0] /* rme_cid_t Cap_Inv */,
-                                    Param[1] /* rme_ptr_t Param */);
+                                    Param[0] /* rme_cid_t Cap_Inv */);
+        RME_TRACE_EVENT(RME_TRACE_SVC_EXIT,Svc_Num,Retval);
         RME_SWITCH_RETURN(Reg,Retval);
     }
     else
@@ -286,360 +293,1123 @@ void _RME_Svc_Handler(struct RME_Reg_Struct* Reg)
         RME_COVERAGE_MARKER();
     }
 
-    /* See if this operation can potentially cause a register set switch. All the 
-     * functions that may cause a register set switch is listed here. The behavior
-     * of these functions shall be: If the function is successful, they shall
-     * perform the return value saving on proper register stacks by themselves;
-     * if the function fails, it should not conduct such return value saving. These
-     * paths are less optimized than synchronous invocation, but are still optimized */
-    switch(Svc_Num)
+    /* Look up the unpacking stub of this system call. The table is always fully
+     * populated, so unused service numbers land on the error stub, and dispatching
+     * costs the same for every system call. The parameters are passed by value, so
+     * the stub does not read back the words that we just stored */
+    Flag=RME_Svc_Tbl[Svc_Num].Flag;
+    Retval=RME_Svc_Tbl[Svc_Num].Func(Captbl, Reg, Svc, Capid, Param[0], Param[1], Param[2]);
+    RME_TRACE_EVENT(RME_TRACE_SVC_EXIT,Svc_Num,Retval);
+    
+    /* Removing mappings may leave stale translations on other processors. They are
+     * all gone before we return, and removals in a batch are done together. These
+     * calls are marked with RME_SVC_FLAG_SYNC in the table */
+    if((Flag&RME_SVC_FLAG_SYNC)!=0)
     {
-        /* Send to a signal endpoint */
-        case RME_SVC_SIG_SND:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Sig_Snd(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
-                                        Param[0] /* rme_cid_t Cap_Sig */);
-            RME_SWITCH_RETURN(Reg,Retval);
-        }
-        /* Receive from a signal endpoint */
-        case RME_SVC_SIG_RCV:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Sig_Rcv(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
-                                        Param[0] /* rme_cid_t Cap_Sig */,
-                                        Param[1] /* rme_ptr_t Option */);
-            RME_SWITCH_RETURN(Reg,Retval);
-        }
-        /* Call kernel functions */
-        case RME_SVC_KERN:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Kern_Act(Captbl, Reg                    /* struct RME_Reg_Struct* Reg */,
-                                         Capid                  /* rme_cid_t Cap_Kern */,
-                                         RME_PARAM_D0(Param[0]) /* rme_ptr_t Func_ID */,
-                                         RME_PARAM_D1(Param[0]) /* rme_ptr_t Sub_ID */,
-                                         Param[1]               /* rme_ptr_t Param1 */,
-                                         Param[2]               /* rme_ptr_t Param2 */);
-            RME_SWITCH_RETURN(Reg,Retval);
-        }
-        /* Changing thread priority */
-        case RME_SVC_THD_SCHED_PRIO:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Thd_Sched_Prio(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
-                                               Param[0] /* rme_cid_t Cap_Thd */,
-                                               Param[1] /* rme_ptr_t Prio */);
-            RME_SWITCH_RETURN(Reg,Retval);
-        }
-        /* Free a thread from some core */
-        case RME_SVC_THD_SCHED_FREE:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Thd_Sched_Free(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
-                                               Param[0] /* rme_cid_t Cap_Thd */);
-            RME_SWITCH_RETURN(Reg,Retval);
-        }
-        /* Transfer time to a thread */
-        case RME_SVC_THD_TIME_XFER:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Thd_Time_Xfer(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
-                                              Param[0] /* rme_cid_t Cap_Thd_Dst */,
-                                              Param[1] /* rme_cid_t Cap_Thd_Src */, 
-                                              Param[2] /* rme_ptr_t Time */);
-            RME_SWITCH_RETURN(Reg,Retval);
-        }
-        /* Switch to another thread */
-        case RME_SVC_THD_SWT:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Thd_Swt(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
-                                        Param[0] /* rme_cid_t Cap_Thd */,
-                                        Param[1] /* rme_ptr_t Full_Yield */);
-            RME_SWITCH_RETURN(Reg, Retval);
-        }
-        default:
-        {
-            RME_COVERAGE_MARKER();
-            break;
-        }
-    } 
+        RME_COVERAGE_MARKER();
+        
+        __RME_Pgtbl_Sync();
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* See if this operation can potentially cause a register set switch. These are 
+     * marked with RME_SVC_FLAG_SWT in the table. The behavior of these functions shall
+     * be: If the function is successful, they shall perform the return value saving on
+     * proper register stacks by themselves; if the function fails, it should not
+     * conduct such return value saving */
+    if((Flag&RME_SVC_FLAG_SWT)!=0)
+    {
+        RME_COVERAGE_MARKER();
+        
+        RME_SWITCH_RETURN(Reg,Retval);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* It is guaranteed that these functions will never cause a context switch.
+     * We set the registers and return */
+    __RME_Set_Syscall_Retval(Reg, Retval);
+}
+/* End Function:_RME_Svc_Handler *********************************************/
+
+/* Begin Function:_RME_Svc_Null ***********************************************
+Description : The stub for all system call numbers that are not in use. The two
+              synchronous invocation calls are also placed here because they have
+              their own fast paths and never reach the dispatch table.
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              struct RME_Reg_Struct* Reg - The register set.
+              rme_ptr_t Svc - The full system call number word.
+              rme_ptr_t Capid - The major capability ID.
+              rme_ptr_t Param0 - The first system call parameter.
+              rme_ptr_t Param1 - The second system call parameter.
+              rme_ptr_t Param2 - The third system call parameter.
+Output      : None.
+Return      : rme_ret_t - Always RME_ERR_CAP_NULL.
+******************************************************************************/
+rme_ret_t _RME_Svc_Null(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                        rme_ptr_t Svc, rme_ptr_t Capid,
+                        rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return RME_ERR_CAP_NULL;
+}
+/* End Function:_RME_Svc_Null ************************************************/
+
+/* Begin Function:_RME_Svc_Sig_Snd ********************************************
+Description : Unpack the system call parameters of RME_SVC_SIG_SND and send to a
+              signal endpoint.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Sig_Snd.
+******************************************************************************/
+rme_ret_t _RME_Svc_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Sig_Snd(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                Param0   /* rme_cid_t Cap_Sig */,
+                                Param1   /* rme_ptr_t Data0 */,
+                                Param2   /* rme_ptr_t Data1 */);
+}
+/* End Function:_RME_Svc_Sig_Snd *********************************************/
+
+/* Begin Function:_RME_Svc_Sig_Rcv ********************************************
+Description : Unpack the system call parameters of RME_SVC_SIG_RCV and receive
+              from a signal endpoint.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Sig_Rcv.
+******************************************************************************/
+rme_ret_t _RME_Svc_Sig_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Sig_Rcv(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                Param0   /* rme_cid_t Cap_Sig */,
+                                Param1   /* rme_ptr_t Option */);
+}
+/* End Function:_RME_Svc_Sig_Rcv *********************************************/
+
+/* Begin Function:_RME_Svc_Kern ***********************************************
+Description : Unpack the system call parameters of RME_SVC_KERN and call kernel
+              functions.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Kern_Act.
+******************************************************************************/
+rme_ret_t _RME_Svc_Kern(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                        rme_ptr_t Svc, rme_ptr_t Capid,
+                        rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Kern_Act(Captbl, Reg                    /* struct RME_Reg_Struct* Reg */,
+                                 Capid                  /* rme_cid_t Cap_Kern */,
+                                 RME_PARAM_D0(Param0)   /* rme_ptr_t Func_ID */,
+                                 RME_PARAM_D1(Param0)   /* rme_ptr_t Sub_ID */,
+                                 Param1                 /* rme_ptr_t Param1 */,
+                                 Param2                 /* rme_ptr_t Param2 */);
+}
+/* End Function:_RME_Svc_Kern ************************************************/
+
+/* Begin Function:_RME_Svc_Thd_Sched_Prio *************************************
+Description : Unpack the system call parameters of RME_SVC_THD_SCHED_PRIO and
+              change thread priority.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Sched_Prio.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Sched_Prio(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Sched_Prio(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                       Param0   /* rme_cid_t Cap_Thd */,
+                                       Param1   /* rme_ptr_t Prio */);
+}
+/* End Function:_RME_Svc_Thd_Sched_Prio **************************************/
+
+/* Begin Function:_RME_Svc_Thd_Sched_Free *************************************
+Description : Unpack the system call parameters of RME_SVC_THD_SCHED_FREE and
+              free a thread from some core.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Sched_Free.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Sched_Free(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Sched_Free(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                       Param0   /* rme_cid_t Cap_Thd */);
+}
+/* End Function:_RME_Svc_Thd_Sched_Free **************************************/
+
+/* Begin Function:_RME_Svc_Thd_Time_Xfer **************************************
+Description : Unpack the system call parameters of RME_SVC_THD_TIME_XFER and
+              transfer time to a thread.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Time_Xfer.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Time_Xfer(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                 rme_ptr_t Svc, rme_ptr_t Capid,
+                                 rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Time_Xfer(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                      Param0   /* rme_cid_t Cap_Thd_Dst */,
+                                      Param1   /* rme_cid_t Cap_Thd_Src */,
+                                      Param2   /* rme_ptr_t Time */);
+}
+/* End Function:_RME_Svc_Thd_Time_Xfer ***************************************/
+
+/* Begin Function:_RME_Svc_Thd_Swt ********************************************
+Description : Unpack the system call parameters of RME_SVC_THD_SWT and switch to
+              another thread.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Swt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Swt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Swt(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                Param0   /* rme_cid_t Cap_Thd */,
+                                Param1   /* rme_ptr_t Full_Yield */);
+}
+/* End Function:_RME_Svc_Thd_Swt *********************************************/
+
+/* Begin Function:_RME_Svc_Captbl_Crt *****************************************
+Description : Unpack the system call parameters of RME_SVC_CAPTBL_CRT and create
+              a capability table.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Captbl_Crt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Captbl_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                              rme_ptr_t Svc, rme_ptr_t Capid,
+                              rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Captbl_Crt(Captbl, Capid                  /* rme_cid_t Cap_Captbl_Crt */,
+                                   RME_PARAM_D1(Param0)   /* rme_cid_t Cap_Kmem */,
+                                   RME_PARAM_D0(Param0)   /* rme_cid_t Cap_Crt */,
+                                   Param1                 /* rme_ptr_t Raddr */,
+                                   Param2                 /* rme_ptr_t Entry_Num */);
+}
+/* End Function:_RME_Svc_Captbl_Crt ******************************************/
+
+/* Begin Function:_RME_Svc_Captbl_Del *****************************************
+Description : Unpack the system call parameters of RME_SVC_CAPTBL_DEL and delete
+              a capability table.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Captbl_Del.
+******************************************************************************/
+rme_ret_t _RME_Svc_Captbl_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                              rme_ptr_t Svc, rme_ptr_t Capid,
+                              rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Captbl_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl_Del */,
+                                   Param0   /* rme_cid_t Cap_Captbl */);
+}
+/* End Function:_RME_Svc_Captbl_Del ******************************************/
+
+/* Begin Function:_RME_Svc_Captbl_Frz *****************************************
+Description : Unpack the system call parameters of RME_SVC_CAPTBL_FRZ and freeze
+              a capability.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Captbl_Frz.
+******************************************************************************/
+rme_ret_t _RME_Svc_Captbl_Frz(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                              rme_ptr_t Svc, rme_ptr_t Capid,
+                              rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Captbl_Frz(Captbl, Capid    /* rme_cid_t Cap_Captbl_Frz */,
+                                   Param0   /* rme_cid_t Cap_Frz */);
+}
+/* End Function:_RME_Svc_Captbl_Frz ******************************************/
+
+/* Begin Function:_RME_Svc_Captbl_Add *****************************************
+Description : Unpack the system call parameters of RME_SVC_CAPTBL_ADD and
+              delegate a capability.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Captbl_Add.
+******************************************************************************/
+rme_ret_t _RME_Svc_Captbl_Add(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                              rme_ptr_t Svc, rme_ptr_t Capid,
+                              rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Captbl_Add(Captbl, RME_PARAM_D1(Param0)    /* rme_cid_t Cap_Captbl_Dst */,
+                                   RME_PARAM_D0(Param0)    /* rme_cid_t Cap_Dst */,
+                                   RME_PARAM_D1(Param1)    /* rme_cid_t Cap_Captbl_Src */,
+                                   RME_PARAM_D0(Param1)    /* rme_cid_t Cap_Src */,
+                                   Param2                  /* rme_ptr_t Flags */,
+                                   RME_PARAM_KM(Svc,Capid) /* rme_ptr_t Ext_Flags */);
+}
+/* End Function:_RME_Svc_Captbl_Add ******************************************/
+
+/* Begin Function:_RME_Svc_Captbl_Rem *****************************************
+Description : Unpack the system call parameters of RME_SVC_CAPTBL_REM and remove
+              a delegated capability.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Captbl_Rem.
+******************************************************************************/
+rme_ret_t _RME_Svc_Captbl_Rem(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                              rme_ptr_t Svc, rme_ptr_t Capid,
+                              rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Captbl_Rem(Captbl, Capid    /* rme_cid_t Cap_Captbl_Rem */,
+                                   Param0   /* rme_cid_t Cap_Rem */);
+}
+/* End Function:_RME_Svc_Captbl_Rem ******************************************/
+
+/* Begin Function:_RME_Svc_Pgtbl_Crt ******************************************
+Description : Unpack the system call parameters of RME_SVC_PGTBL_CRT and create
+              a page table.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Pgtbl_Crt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Pgtbl_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_ptr_t Svc, rme_ptr_t Capid,
+                             rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Pgtbl_Crt(Captbl, Capid                     /* rme_cid_t Cap_Captbl */,
+                                  RME_PARAM_D1(Param0)      /* rme_cid_t Cap_Kmem */,
+                                  RME_PARAM_Q1(Param0)      /* rme_cid_t Cap_Pgtbl */,
+                                  Param1                    /* rme_ptr_t Raddr */,
+                                  Param2&(RME_ALLBITS<<1)   /* rme_ptr_t Base_Addr */,
+                                  RME_PARAM_PT(Param2)      /* rme_ptr_t Top_Flag */,
+                                  RME_PARAM_Q0(Param0)      /* rme_ptr_t Size_Order */,
+                                  RME_PARAM_PC(Svc)         /* rme_ptr_t Num_Order */);
+}
+/* End Function:_RME_Svc_Pgtbl_Crt *******************************************/
+
+/* Begin Function:_RME_Svc_Pgtbl_Del ******************************************
+Description : Unpack the system call parameters of RME_SVC_PGTBL_DEL and delete
+              a page table.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Pgtbl_Del.
+******************************************************************************/
+rme_ret_t _RME_Svc_Pgtbl_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_ptr_t Svc, rme_ptr_t Capid,
+                             rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Pgtbl_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
+                                  Param0   /* rme_cid_t Cap_Pgtbl */);
+}
+/* End Function:_RME_Svc_Pgtbl_Del *******************************************/
 
-    /* It is guaranteed that these functions will never cause a context switch */
-    switch(Svc_Num)
+/* Begin Function:_RME_Svc_Pgtbl_Add ******************************************
+Description : Unpack the system call parameters of RME_SVC_PGTBL_ADD and map a
+              page into a page table.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Pgtbl_Add.
+******************************************************************************/
+rme_ret_t _RME_Svc_Pgtbl_Add(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_ptr_t Svc, rme_ptr_t Capid,
+                             rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Pgtbl_Add(Captbl, RME_PARAM_D1(Param0)   /* rme_cid_t Cap_Pgtbl_Dst */,
+                                  RME_PARAM_D0(Param0)   /* rme_ptr_t Pos_Dst */,
+                                  Capid                  /* rme_ptr_t Flags_Dst */,
+                                  RME_PARAM_D1(Param1)   /* rme_cid_t Cap_Pgtbl_Src */,
+                                  RME_PARAM_D0(Param1)   /* rme_ptr_t Pos_Src */,
+                                  Param2                 /* rme_ptr_t Index */);
+}
+/* End Function:_RME_Svc_Pgtbl_Add *******************************************/
+
+/* Begin Function:_RME_Svc_Pgtbl_Rem ******************************************
+Description : Unpack the system call parameters of RME_SVC_PGTBL_REM and unmap a
+              page from a page table.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Pgtbl_Rem.
+******************************************************************************/
+rme_ret_t _RME_Svc_Pgtbl_Rem(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_ptr_t Svc, rme_ptr_t Capid,
+                             rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Pgtbl_Rem(Captbl, Param0   /* rme_cid_t Cap_Pgtbl */,
+                                  Param1   /* rme_ptr_t Pos */);
+}
+/* End Function:_RME_Svc_Pgtbl_Rem *******************************************/
+
+/* Begin Function:_RME_Svc_Pgtbl_Con ******************************************
+Description : Unpack the system call parameters of RME_SVC_PGTBL_CON and
+              construct a page table hierarchy.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Pgtbl_Con.
+******************************************************************************/
+rme_ret_t _RME_Svc_Pgtbl_Con(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_ptr_t Svc, rme_ptr_t Capid,
+                             rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Pgtbl_Con(Captbl, RME_PARAM_D1(Param0)   /* rme_cid_t Cap_Pgtbl_Parent */,
+                                  Param1                 /* rme_ptr_t Pos */,
+                                  RME_PARAM_D0(Param0)   /* rme_cid_t Cap_Pgtbl_Child */,
+                                  Param2                 /* rme_ptr_t Flags_Child */);
+}
+/* End Function:_RME_Svc_Pgtbl_Con *******************************************/
+
+/* Begin Function:_RME_Svc_Pgtbl_Des ******************************************
+Description : Unpack the system call parameters of RME_SVC_PGTBL_DES and
+              destruct a page table hierarchy.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Pgtbl_Des.
+******************************************************************************/
+rme_ret_t _RME_Svc_Pgtbl_Des(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_ptr_t Svc, rme_ptr_t Capid,
+                             rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Pgtbl_Des(Captbl, Param0   /* rme_cid_t Cap_Pgtbl */,
+                                  Param1   /* rme_ptr_t Pos */);
+}
+/* End Function:_RME_Svc_Pgtbl_Des *******************************************/
+
+/* Begin Function:_RME_Svc_Proc_Crt *******************************************
+Description : Unpack the system call parameters of RME_SVC_PROC_CRT and create a
+              process.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Proc_Crt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Proc_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                            rme_ptr_t Svc, rme_ptr_t Capid,
+                            rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Proc_Crt(Captbl, Capid                  /* rme_cid_t Cap_Captbl_Crt */,
+                                 RME_PARAM_D1(Param0)   /* rme_cid_t Cap_Kmem */,
+                                 RME_PARAM_D0(Param0)   /* rme_cid_t Cap_Proc */,
+                                 RME_PARAM_D1(Param1)   /* rme_cid_t Cap_Captbl */,
+                                 RME_PARAM_D0(Param1)   /* rme_cid_t Cap_Pgtbl */,
+                                 Param2                 /* rme_ptr_t Raddr */);
+}
+/* End Function:_RME_Svc_Proc_Crt ********************************************/
+
+/* Begin Function:_RME_Svc_Proc_Del *******************************************
+Description : Unpack the system call parameters of RME_SVC_PROC_DEL and delete a
+              process.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Proc_Del.
+******************************************************************************/
+rme_ret_t _RME_Svc_Proc_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                            rme_ptr_t Svc, rme_ptr_t Capid,
+                            rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Proc_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
+                                 Param0   /* rme_cid_t Cap_Proc */);
+}
+/* End Function:_RME_Svc_Proc_Del ********************************************/
+
+/* Begin Function:_RME_Svc_Proc_Cpt *******************************************
+Description : Unpack the system call parameters of RME_SVC_PROC_CPT and change
+              the capability table of a process.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Proc_Cpt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Proc_Cpt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                            rme_ptr_t Svc, rme_ptr_t Capid,
+                            rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Proc_Cpt(Captbl, Param0   /* rme_cid_t Cap_Proc */,
+                                 Param1   /* rme_cid_t Cap_Captbl */);
+}
+/* End Function:_RME_Svc_Proc_Cpt ********************************************/
+
+/* Begin Function:_RME_Svc_Proc_Pgt *******************************************
+Description : Unpack the system call parameters of RME_SVC_PROC_PGT and change
+              the page table of a process.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Proc_Pgt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Proc_Pgt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                            rme_ptr_t Svc, rme_ptr_t Capid,
+                            rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Proc_Pgt(Captbl, Param0   /* rme_cid_t Cap_Proc */,
+                                 Param1   /* rme_cid_t Cap_Pgtbl */);
+}
+/* End Function:_RME_Svc_Proc_Pgt ********************************************/
+
+/* Begin Function:_RME_Svc_Thd_Crt ********************************************
+Description : Unpack the system call parameters of RME_SVC_THD_CRT and create a
+              thread.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Crt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Crt(Captbl, Capid                  /* rme_cid_t Cap_Captbl */,
+                                RME_PARAM_D1(Param0)   /* rme_cid_t Cap_Kmem */,
+                                RME_PARAM_D0(Param0)   /* rme_cid_t Cap_Thd */,
+                                RME_PARAM_D1(Param1)   /* rme_cid_t Cap_Proc */,
+                                RME_PARAM_D0(Param1)   /* rme_ptr_t Max_Prio */,
+                                Param2                 /* rme_ptr_t Raddr */);
+}
+/* End Function:_RME_Svc_Thd_Crt *********************************************/
+
+/* Begin Function:_RME_Svc_Thd_Del ********************************************
+Description : Unpack the system call parameters of RME_SVC_THD_DEL and delete a
+              thread.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Del.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
+                                Param0   /* rme_cid_t Cap_Thd */);
+}
+/* End Function:_RME_Svc_Thd_Del *********************************************/
+
+/* Begin Function:_RME_Svc_Thd_Exec_Set ***************************************
+Description : Unpack the system call parameters of RME_SVC_THD_EXEC_SET and set
+              the entry and stack of a thread.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Exec_Set.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Exec_Set(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                rme_ptr_t Svc, rme_ptr_t Capid,
+                                rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Exec_Set(Captbl, Capid    /* rme_cid_t Cap_Thd */,
+                                     Param0   /* rme_ptr_t Entry */,
+                                     Param1   /* rme_ptr_t Stack */,
+                                     Param2   /* rme_ptr_t Param */);
+}
+/* End Function:_RME_Svc_Thd_Exec_Set ****************************************/
+
+/* Begin Function:_RME_Svc_Thd_Hyp_Set ****************************************
+Description : Unpack the system call parameters of RME_SVC_THD_HYP_SET and set a
+              thread as hypervisor-managed.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Hyp_Set.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Hyp_Set(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                               rme_ptr_t Svc, rme_ptr_t Capid,
+                               rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Hyp_Set(Captbl, Param0   /* rme_cid_t Cap_Thd */,
+                                    Param1   /* rme_ptr_t Kaddr */);
+}
+/* End Function:_RME_Svc_Thd_Hyp_Set *****************************************/
+
+/* Begin Function:_RME_Svc_Thd_Sched_Bind *************************************
+Description : Unpack the system call parameters of RME_SVC_THD_SCHED_BIND and
+              bind a thread to the current processor.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Sched_Bind.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Sched_Bind(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Sched_Bind(Captbl, Capid                  /* rme_cid_t Cap_Thd */,
+                                       RME_PARAM_D1(Param0)   /* rme_cid_t Cap_Thd_Sched */,
+                                       RME_PARAM_D0(Param0)   /* rme_cid_t Cap_Sig */,
+                                       Param1                 /* rme_tid_t TID */,
+                                       Param2                 /* rme_ptr_t Prio */);
+}
+/* End Function:_RME_Svc_Thd_Sched_Bind **************************************/
+
+/* Begin Function:_RME_Svc_Thd_Sched_Rcv **************************************
+Description : Unpack the system call parameters of RME_SVC_THD_SCHED_RCV and
+              receive scheduler notifications.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Sched_Rcv.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Sched_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                 rme_ptr_t Svc, rme_ptr_t Capid,
+                                 rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Sched_Rcv(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                      Param0   /* rme_cid_t Cap_Thd */);
+}
+/* End Function:_RME_Svc_Thd_Sched_Rcv ***************************************/
+
+/* Begin Function:_RME_Svc_Sig_Crt ********************************************
+Description : Unpack the system call parameters of RME_SVC_SIG_CRT and create a
+              signal endpoint.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Sig_Crt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Sig_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Sig_Crt(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
+                                Param0   /* rme_cid_t Cap_Kmem */,
+                                Param1   /* rme_cid_t Cap_Sig */,
+                                Param2   /* rme_ptr_t Raddr */);
+}
+/* End Function:_RME_Svc_Sig_Crt *********************************************/
+
+/* Begin Function:_RME_Svc_Sig_Del ********************************************
+Description : Unpack the system call parameters of RME_SVC_SIG_DEL and delete a
+              signal endpoint.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Sig_Del.
+******************************************************************************/
+rme_ret_t _RME_Svc_Sig_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Sig_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
+                                Param0   /* rme_cid_t Cap_Sig */);
+}
+/* End Function:_RME_Svc_Sig_Del *********************************************/
+
+/* Begin Function:_RME_Svc_Inv_Crt ********************************************
+Description : Unpack the system call parameters of RME_SVC_INV_CRT and create a
+              synchronous invocation port.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Inv_Crt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Inv_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Inv_Crt(Captbl, Capid                  /* rme_cid_t Cap_Captbl */,
+                                RME_PARAM_D1(Param0)   /* rme_cid_t Cap_Kmem */,
+                                RME_PARAM_D0(Param0)   /* rme_cid_t Cap_Inv */,
+                                Param1                 /* rme_cid_t Cap_Proc */,
+                                Param2                 /* rme_ptr_t Raddr */);
+}
+/* End Function:_RME_Svc_Inv_Crt *********************************************/
+
+/* Begin Function:_RME_Svc_Inv_Del ********************************************
+Description : Unpack the system call parameters of RME_SVC_INV_DEL and delete a
+              synchronous invocation port.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Inv_Del.
+******************************************************************************/
+rme_ret_t _RME_Svc_Inv_Del(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Inv_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
+                                Param0   /* rme_cid_t Cap_Inv */);
+}
+/* End Function:_RME_Svc_Inv_Del *********************************************/
+
+/* Begin Function:_RME_Svc_Inv_Set ********************************************
+Description : Unpack the system call parameters of RME_SVC_INV_SET and set the
+              entry and stack of an invocation port.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Inv_Set.
+******************************************************************************/
+rme_ret_t _RME_Svc_Inv_Set(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                           rme_ptr_t Svc, rme_ptr_t Capid,
+                           rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Inv_Set(Captbl, RME_PARAM_D0(Param0)   /* rme_cid_t Cap_Inv */,
+                                Param1                 /* rme_ptr_t Entry */,
+                                Param2                 /* rme_ptr_t Stack */,
+                                RME_PARAM_D1(Param0)   /* rme_ptr_t Fault_Ret_Flag */);
+}
+/* End Function:_RME_Svc_Inv_Set *********************************************/
+
+
+/* Begin Function:_RME_Svc_Batch **********************************************
+Description : Unpack the system call parameters of RME_SVC_BATCH and do the
+              batched operations.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Svc_Batch_Act.
+******************************************************************************/
+rme_ret_t _RME_Svc_Batch(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                         rme_ptr_t Svc, rme_ptr_t Capid,
+                         rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Svc_Batch_Act(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                      Param0   /* rme_ptr_t Vaddr */,
+                                      Param1   /* rme_ptr_t Num */);
+}
+/* End Function:_RME_Svc_Batch ***********************************************/
+
+/* Begin Function:_RME_Svc_Kmem_Find ******************************************
+Description : Unpack the system call parameters of RME_SVC_KMEM_FIND and find a
+              free kernel memory range.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Kmem_Find.
+******************************************************************************/
+rme_ret_t _RME_Svc_Kmem_Find(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_ptr_t Svc, rme_ptr_t Capid,
+                             rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Kmem_Find(Captbl, Capid    /* rme_cid_t Cap_Kmem */,
+                                  Param0   /* rme_ptr_t Size */,
+                                  Param1   /* rme_ptr_t Raddr */,
+                                  Param2   /* rme_ptr_t Align_Order */);
+}
+/* End Function:_RME_Svc_Kmem_Find *******************************************/
+
+/* Begin Function:_RME_Svc_Sig_Ring_Crt ***************************************
+Description : Unpack the system call parameters of RME_SVC_SIG_RING_CRT and create
+              a signal endpoint with a payload ring.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Sig_Ring_Crt.
+******************************************************************************/
+rme_ret_t _RME_Svc_Sig_Ring_Crt(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                rme_ptr_t Svc, rme_ptr_t Capid,
+                                rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Sig_Ring_Crt(Captbl, Capid                  /* rme_cid_t Cap_Captbl */,
+                                     RME_PARAM_D1(Param0)   /* rme_cid_t Cap_Kmem */,
+                                     RME_PARAM_D0(Param0)   /* rme_cid_t Cap_Sig */,
+                                     Param1                 /* rme_ptr_t Raddr */,
+                                     Param2                 /* rme_ptr_t Ring_Order */);
+}
+/* End Function:_RME_Svc_Sig_Ring_Crt ****************************************/
+
+/* Begin Function:_RME_Svc_Thd_Sched_EDF **************************************
+Description : Unpack the system call parameters of RME_SVC_THD_SCHED_EDF and set
+              the EDF period and budget of a thread.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Sched_EDF.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Sched_EDF(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                 rme_ptr_t Svc, rme_ptr_t Capid,
+                                 rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Sched_EDF(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                      Param0   /* rme_cid_t Cap_Thd */,
+                                      Param1   /* rme_ptr_t Period */,
+                                      Param2   /* rme_ptr_t Budget */);
+}
+/* End Function:_RME_Svc_Thd_Sched_EDF ***************************************/
+
+/* Begin Function:_RME_Svc_Thd_Sched_Migr *************************************
+Description : Unpack the system call parameters of RME_SVC_THD_SCHED_MIGR and move
+              a thread to another processor.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Sched_Migr.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Sched_Migr(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Svc, rme_ptr_t Capid,
+                                  rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Sched_Migr(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                       Param0   /* rme_cid_t Cap_Thd */,
+                                       Param1   /* rme_cid_t Cap_Thd_Sched */);
+}
+/* End Function:_RME_Svc_Thd_Sched_Migr **************************************/
+
+/* Begin Function:_RME_Svc_Thd_Cycle_Get **************************************
+Description : Unpack the system call parameters of RME_SVC_THD_CYCLE_GET and get
+              the number of processor cycles that a thread used.
+Input       : The same as _RME_Svc_Null.
+Output      : None.
+Return      : rme_ret_t - The return value of _RME_Thd_Cycle_Get.
+******************************************************************************/
+rme_ret_t _RME_Svc_Thd_Cycle_Get(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                 rme_ptr_t Svc, rme_ptr_t Capid,
+                                 rme_ptr_t Param0, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    RME_COVERAGE_MARKER();
+    
+    return _RME_Thd_Cycle_Get(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
+                                      Param0   /* rme_cid_t Cap_Thd */,
+                                      Param1   /* rme_ptr_t Type */);
+}
+/* End Function:_RME_Svc_Thd_Cycle_Get ***************************************/
+
+/* Begin Function:_RME_Svc_Batch_Word *****************************************
+Description : Find where a word of the batch array is accessible to the kernel.
+              The array is in the address space of the caller, and the page that
+              the word is on must be both readable and writable there. We access
+              the page through its physical address, so nothing we do here could
+              fault even if the page got unmapped meanwhile. The page found last
+              is remembered, so we walk the page table only once for each page.
+Input       : struct RME_Proc_Struct* Proc - The process that the array is in.
+              rme_ptr_t Vaddr - The user virtual address of the word.
+              rme_ptr_t* Start - The start of the page found last.
+              rme_ptr_t* End - The end of the page found last.
+              rme_ptr_t* Kaddr - The kernel address of the start of that page.
+Output      : rme_ptr_t* Start - The start of the page that the word is on.
+              rme_ptr_t* End - The end of the page that the word is on.
+              rme_ptr_t* Kaddr - The kernel address of the start of that page.
+Return      : volatile rme_ptr_t* - The kernel address of the word; 0 if it is not
+                                    accessible.
+******************************************************************************/
+volatile rme_ptr_t* _RME_Svc_Batch_Word(struct RME_Proc_Struct* Proc, rme_ptr_t Vaddr,
+                                        rme_ptr_t* Start, rme_ptr_t* End, rme_ptr_t* Kaddr)
+{
+    rme_ptr_t Paddr;
+    rme_ptr_t Size_Order;
+    rme_ptr_t Flags;
+    
+    /* Is it on the page found last? */
+    if((Vaddr<(*Start))||(Vaddr>=(*End)))
     {
-        /* Capability table */
-        case RME_SVC_CAPTBL_CRT:
-        {
-            RME_COVERAGE_MARKER();
-            Retval=_RME_Captbl_Crt(Captbl, Capid                  /* rme_cid_t Cap_Captbl_Crt */,
-                                           RME_PARAM_D1(Param[0]) /* rme_cid_t Cap_Kmem */,
-                                           RME_PARAM_D0(Param[0]) /* rme_cid_t Cap_Crt */,
-                                           Param[1]               /* rme_ptr_t Raddr */,
-                                           Param[2]               /* rme_ptr_t Entry_Num */);
-            break;
-        }
-        case RME_SVC_CAPTBL_DEL:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Captbl_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl_Del */,
-                                           Param[0] /* rme_cid_t Cap_Captbl */);
-            break;
-        }
-        case RME_SVC_CAPTBL_FRZ:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Captbl_Frz(Captbl, Capid    /* rme_cid_t Cap_Captbl_Frz */,
-                                           Param[0] /* rme_cid_t Cap_Frz */);
-            break;
-        }
-        case RME_SVC_CAPTBL_ADD:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Captbl_Add(Captbl, RME_PARAM_D1(Param[0])  /* rme_cid_t Cap_Captbl_Dst */,
-                                           RME_PARAM_D0(Param[0])  /* rme_cid_t Cap_Dst */,
-                                           RME_PARAM_D1(Param[1])  /* rme_cid_t Cap_Captbl_Src */,
-                                           RME_PARAM_D0(Param[1])  /* rme_cid_t Cap_Src */,
-                                           Param[2]                /* rme_ptr_t Flags */,
-                                           RME_PARAM_KM(Svc,Capid) /* rme_ptr_t Ext_Flags */);
-            break;
-        }
-        case RME_SVC_CAPTBL_REM:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Captbl_Rem(Captbl, Capid    /* rme_cid_t Cap_Captbl_Rem */,
-                                           Param[0] /* rme_cid_t Cap_Rem */);
-            break;
-        }
-        /* Page table */
-        case RME_SVC_PGTBL_CRT:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Pgtbl_Crt(Captbl, Capid                     /* rme_cid_t Cap_Captbl */,
-                                          RME_PARAM_D1(Param[0])    /* rme_cid_t Cap_Kmem */,
-                                          RME_PARAM_Q1(Param[0])    /* rme_cid_t Cap_Pgtbl */,
-                                          Param[1]                  /* rme_ptr_t Raddr */,
-                                          Param[2]&(RME_ALLBITS<<1) /* rme_ptr_t Base_Addr */,
-                                          RME_PARAM_PT(Param[2])    /* rme_ptr_t Top_Flag */,
-                                          RME_PARAM_Q0(Param[0])    /* rme_ptr_t Size_Order */,
-                                          RME_PARAM_PC(Svc)         /* rme_ptr_t Num_Order */);
-            break;
-        }
-        case RME_SVC_PGTBL_DEL:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Pgtbl_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
-                                          Param[0] /* rme_cid_t Cap_Pgtbl */);
-            break;
-        }
-        case RME_SVC_PGTBL_ADD:
+        RME_COVERAGE_MARKER();
+        
+        if(__RME_Pgtbl_Walk(Proc->Pgtbl, Vaddr, 0, Start, &Paddr, &Size_Order, 0, &Flags)!=0)
         {
             RME_COVERAGE_MARKER();
             
-            Retval=_RME_Pgtbl_Add(Captbl, RME_PARAM_D1(Param[0]) /* rme_cid_t Cap_Pgtbl_Dst */,
-                                          RME_PARAM_D0(Param[0]) /* rme_ptr_t Pos_Dst */,
-                                          Capid                  /* rme_ptr_t Flags_Dst */,
-                                          RME_PARAM_D1(Param[1]) /* rme_cid_t Cap_Pgtbl_Src */,
-                                          RME_PARAM_D0(Param[1]) /* rme_ptr_t Pos_Src */,
-                                          Param[2]               /* rme_ptr_t Index */);
-            break;
+            *End=*Start;
+            return 0;
         }
-        case RME_SVC_PGTBL_REM:
+        else
         {
             RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Pgtbl_Rem(Captbl, Param[0] /* rme_cid_t Cap_Pgtbl */,
-                                          Param[1] /* rme_ptr_t Pos */);
-            break;
         }
-        case RME_SVC_PGTBL_CON:
+        
+        if((Flags&(RME_PGTBL_READ|RME_PGTBL_WRITE))!=(RME_PGTBL_READ|RME_PGTBL_WRITE))
         {
             RME_COVERAGE_MARKER();
             
-            Retval=_RME_Pgtbl_Con(Captbl, RME_PARAM_D1(Param[0]) /* rme_cid_t Cap_Pgtbl_Parent */,
-                                          Param[1]               /* rme_ptr_t Pos */,
-                                          RME_PARAM_D0(Param[0]) /* rme_cid_t Cap_Pgtbl_Child */,
-                                          Param[2]               /* rme_ptr_t Flags_Child */);
-            break;
+            *End=*Start;
+            return 0;
         }
-        case RME_SVC_PGTBL_DES:
+        else
         {
             RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Pgtbl_Des(Captbl, Param[0] /* rme_cid_t Cap_Pgtbl */,
-                                          Param[1] /* rme_ptr_t Pos */);
-            break;
-        }
-        /* Process */
-        case RME_SVC_PROC_CRT:
-        {
-            Retval=_RME_Proc_Crt(Captbl, Capid                  /* rme_cid_t Cap_Captbl_Crt */,
-                                         RME_PARAM_D1(Param[0]) /* rme_cid_t Cap_Kmem */,
-                                         RME_PARAM_D0(Param[0]) /* rme_cid_t Cap_Proc */,
-                                         RME_PARAM_D1(Param[1]) /* rme_cid_t Cap_Captbl */,
-                                         RME_PARAM_D0(Param[1]) /* rme_cid_t Cap_Pgtbl */,
-                                         Param[2]               /* rme_ptr_t Raddr */);
-            break;
         }
-        case RME_SVC_PROC_DEL:
-        {
-            RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Proc_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
-                                         Param[0] /* rme_cid_t Cap_Proc */);
-            break;
-        }
-        case RME_SVC_PROC_CPT:
+        
+        *End=(*Start)+RME_POW2(Size_Order);
+        *Kaddr=RME_PA2VA(Paddr);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    return (volatile rme_ptr_t*)((*Kaddr)+(Vaddr-(*Start)));
+}
+/* End Function:_RME_Svc_Batch_Word ******************************************/
+
+/* Begin Function:_RME_Svc_Batch_Act ******************************************
+Description : Do a batch of system calls in a single kernel entry. This is used
+              to cut down the trap overhead when constructing or destructing a
+              lot of kernel objects. The operations are placed in an array of
+              struct RME_Svc_Batch_Op in the caller's own address space, whose
+              pages must be mapped readable and writable. Each operation is
+              encoded in exactly the same way as the normal system call, and its
+              return value will be written back to it. The operations are done in
+              order, and we stop at the first failure.
+              Each operation is copied in before it is done, so concurrent changes
+              from other processors will not give us an inconsistent view of it.
+              Only the operations that never cause a register set switch can be
+              batched. Those that do, and those that write the register set, are
+              not marked with RME_SVC_FLAG_BATCH in the system call table, and are
+              treated as a failure with RME_ERR_CAP_NULL.
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              struct RME_Reg_Struct* Reg - The register set.
+              rme_ptr_t Vaddr - The user virtual address of the array.
+              rme_ptr_t Num - The number of operations, at most RME_SVC_BATCH_MAX.
+Output      : None.
+Return      : rme_ret_t - The number of operations that completed successfully,
+                          which will be smaller than Num if there is a failure,
+                          or if the array became inaccessible halfway; or an
+                          error code if the first operation cannot be read.
+******************************************************************************/
+rme_ret_t _RME_Svc_Batch_Act(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_ptr_t Vaddr, rme_ptr_t Num)
+{
+    struct RME_CPU_Local* CPU_Local;
+    struct RME_Inv_Struct* Inv_Top;
+    struct RME_Proc_Struct* Proc;
+    struct RME_Svc_Batch_Op* Batch;
+    struct RME_Svc_Batch_Op Op;
+    volatile rme_ptr_t* Word;
+    rme_ptr_t Start;
+    rme_ptr_t End;
+    rme_ptr_t Kaddr;
+    rme_ptr_t Svc;
+    rme_ptr_t Svc_Num;
+    rme_ptr_t Capid;
+    rme_ptr_t Count;
+    rme_cnt_t Word_Cnt;
+    rme_ret_t Retval;
+    
+    /* See if the number of operations is allowed */
+    if((Num==0)||(Num>RME_SVC_BATCH_MAX))
+    {
+        RME_COVERAGE_MARKER();
+        
+        return RME_ERR_CAP_RANGE;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* The array must be aligned to word boundary, so no word is across two pages */
+    if(RME_IS_ALIGNED(Vaddr)&&((Vaddr+Num*sizeof(struct RME_Svc_Batch_Op))>Vaddr))
+    {
+        RME_COVERAGE_MARKER();
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+        
+        return RME_ERR_PGT_ADDR;
+    }
+    
+    /* The array is in the address space that we are running in */
+    CPU_Local=RME_CPU_LOCAL();
+    Inv_Top=RME_INVSTK_TOP(CPU_Local->Cur_Thd);
+    if(Inv_Top==0)
+    {
+        RME_COVERAGE_MARKER();
+        
+        Proc=(CPU_Local->Cur_Thd)->Sched.Proc;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+        
+        Proc=Inv_Top->Proc;
+    }
+    
+    Batch=(struct RME_Svc_Batch_Op*)Vaddr;
+    for(Count=0;Count<Num;Count++)
+    {
+        /* Operations done so far may have changed the mappings, so we always look
+         * the page up again for a new operation */
+        Start=0;
+        End=0;
+        Kaddr=0;
+        
+        /* Read each word of the operation exactly once */
+        Word=_RME_Svc_Batch_Word(Proc, (rme_ptr_t)&(Batch[Count].Svc_Capid), &Start, &End, &Kaddr);
+        if(Word!=0)
         {
             RME_COVERAGE_MARKER();
             
-            Retval=_RME_Proc_Cpt(Captbl, Param[0] /* rme_cid_t Cap_Proc */,
-                                         Param[1] /* rme_cid_t Cap_Captbl */);
-            break;
+            Op.Svc_Capid=*Word;
+            for(Word_Cnt=0;Word_Cnt<3;Word_Cnt++)
+            {
+                Word=_RME_Svc_Batch_Word(Proc, (rme_ptr_t)&(Batch[Count].Param[Word_Cnt]), &Start, &End, &Kaddr);
+                if(Word==0)
+                {
+                    RME_COVERAGE_MARKER();
+                    
+                    break;
+                }
+                else
+                {
+                    RME_COVERAGE_MARKER();
+                }
+                
+                Op.Param[Word_Cnt]=*Word;
+            }
         }
-        case RME_SVC_PROC_PGT:
+        else
         {
             RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Proc_Pgt(Captbl, Param[0] /* rme_cid_t Cap_Proc */,
-                                         Param[1] /* rme_cid_t Cap_Pgtbl */);
-            break;
         }
-        /* Thread */
-        case RME_SVC_THD_CRT:
+        
+        /* Stop if the operation cannot be read. If it is the first one, the array
+         * is not usable at all */
+        if(Word==0)
         {
             RME_COVERAGE_MARKER();
             
-            Retval=_RME_Thd_Crt(Captbl, Capid                  /* rme_cid_t Cap_Captbl */,
-                                        RME_PARAM_D1(Param[0]) /* rme_cid_t Cap_Kmem */,
-                                        RME_PARAM_D0(Param[0]) /* rme_cid_t Cap_Thd */,
-                                        RME_PARAM_D1(Param[1]) /* rme_cid_t Cap_Proc */,
-                                        RME_PARAM_D0(Param[1]) /* rme_ptr_t Max_Prio */,
-                                        Param[2]               /* rme_ptr_t Raddr */);
-            break;
-        }
-        case RME_SVC_THD_DEL:
-        {
-            RME_COVERAGE_MARKER();
+            if(Count==0)
+            {
+                RME_COVERAGE_MARKER();
+                
+                return RME_ERR_PGT_ADDR;
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
             
-            Retval=_RME_Thd_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
-                                        Param[0] /* rme_cid_t Cap_Thd */);
             break;
         }
-        case RME_SVC_THD_EXEC_SET:
+        else
         {
             RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Thd_Exec_Set(Captbl, Capid    /* rme_cid_t Cap_Thd */,
-                                             Param[0] /* rme_ptr_t Entry */,
-                                             Param[1] /* rme_ptr_t Stack */,
-                                             Param[2] /* rme_ptr_t Param */);
-            break;
         }
-        case RME_SVC_THD_HYP_SET:
+        
+        Svc=RME_PARAM_D1(Op.Svc_Capid);
+        Capid=RME_PARAM_D0(Op.Svc_Capid);
+        Svc_Num=Svc&(RME_SVC_TBL_NUM-1);
+        
+        /* Anything that may switch the register set or write to it cannot be batched */
+        if((RME_Svc_Tbl[Svc_Num].Flag&RME_SVC_FLAG_BATCH)==0)
         {
             RME_COVERAGE_MARKER();
             
-            Retval=_RME_Thd_Hyp_Set(Captbl, Param[0] /* rme_cid_t Cap_Thd */,
-                                            Param[1] /* rme_ptr_t Kaddr */);
-            break;
+            Retval=RME_ERR_CAP_NULL;
         }
-        case RME_SVC_THD_SCHED_BIND:
+        else
         {
             RME_COVERAGE_MARKER();
             
-            Retval=_RME_Thd_Sched_Bind(Captbl, Capid                  /* rme_cid_t Cap_Thd */,
-                                               RME_PARAM_D1(Param[0]) /* rme_cid_t Cap_Thd_Sched */,
-                                               RME_PARAM_D0(Param[0]) /* rme_cid_t Cap_Sig */,
-                                               Param[1]               /* rme_tid_t TID */,
-                                               Param[2]               /* rme_ptr_t Prio */);
-            break;
-        }
-        case RME_SVC_THD_SCHED_RCV:
-        {
-            RME_COVERAGE_MARKER();
+            /* The removals so far must be complete before anything else, because
+             * that may reuse the memory that the removed mappings pointed to */
+            if((RME_Svc_Tbl[Svc_Num].Flag&RME_SVC_FLAG_SYNC)==0)
+            {
+                RME_COVERAGE_MARKER();
+                
+                __RME_Pgtbl_Sync();
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
             
-            Retval=_RME_Thd_Sched_Rcv(Captbl, Reg      /* struct RME_Reg_Struct* Reg */,
-                                              Param[0] /* rme_cid_t Cap_Thd */);
-            break;
+            Retval=RME_Svc_Tbl[Svc_Num].Func(Captbl, Reg, Svc, Capid, Op.Param[0], Op.Param[1], Op.Param[2]);
         }
-        /* Signal */
-        case RME_SVC_SIG_CRT:
+        
+        /* The operation may have unmapped the array, so look it up again */
+        Start=0;
+        End=0;
+        Word=_RME_Svc_Batch_Word(Proc, (rme_ptr_t)&(Batch[Count].Retval), &Start, &End, &Kaddr);
+        if(Word!=0)
         {
             RME_COVERAGE_MARKER();
             
-            Retval=_RME_Sig_Crt(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
-                                        Param[0] /* rme_cid_t Cap_Kmem */,
-                                        Param[1] /* rme_cid_t Cap_Sig */, 
-                                        Param[2] /* rme_ptr_t Raddr */);
-            break;
+            *Word=(rme_ptr_t)Retval;
         }
-        case RME_SVC_SIG_DEL:
+        else
         {
             RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Sig_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
-                                        Param[0] /* rme_cid_t Cap_Sig */);
-            break;
         }
-        /* Invocation */
-        case RME_SVC_INV_CRT:
+        
+        if(Retval<0)
         {
             RME_COVERAGE_MARKER();
             
-            Retval=_RME_Inv_Crt(Captbl, Capid                  /* rme_cid_t Cap_Captbl */,
-                                        RME_PARAM_D1(Param[0]) /* rme_cid_t Cap_Kmem */,
-                                        RME_PARAM_D0(Param[0]) /* rme_cid_t Cap_Inv */,
-                                        Param[1]               /* rme_cid_t Cap_Proc */,
-                                        Param[2]               /* rme_ptr_t Raddr */);
             break;
         }
-        case RME_SVC_INV_DEL:
+        else
         {
             RME_COVERAGE_MARKER();
-            
-            Retval=_RME_Inv_Del(Captbl, Capid    /* rme_cid_t Cap_Captbl */,
-                                        Param[0] /* rme_cid_t Cap_Inv */);
-            break;
         }
-        case RME_SVC_INV_SET:
+        
+        /* This one is done, but we stop here if we cannot tell the caller so */
+        if(Word==0)
         {
             RME_COVERAGE_MARKER();
             
-            Retval=_RME_Inv_Set(Captbl, RME_PARAM_D0(Param[0]) /* rme_cid_t Cap_Inv */,
-                                        Param[1]               /* rme_ptr_t Entry */,
-                                        Param[2]               /* rme_ptr_t Stack */,
-                                        RME_PARAM_D1(Param[0]) /* rme_ptr_t Fault_Ret_Flag */);
+            Count++;
             break;
         }
-        /* This is an error */
-        default: 
+        else
         {
             RME_COVERAGE_MARKER();
-            
-            Retval=RME_ERR_CAP_NULL;
-            break;
         }
     }
     
-    /* We set the registers and return */
-    __RME_Set_Syscall_Retval(Reg, Retval);
+    return (rme_ret_t)Count;
 }
-/* End Function:_RME_Svc_Handler *********************************************/
+/* End Function:_RME_Svc_Batch_Act *******************************************/
 
 /* Begin Function:_RME_Timestamp_Inc ******************************************
 Description : This function is used in the drivers to update the timestamp value.
@@ -657,7 +1427,10 @@ rme_ptr_t _RME_Timestamp_Inc(rme_cnt_t Value)
 
 /* Begin Function:_RME_Tick_SMP_Handler ***************************************
 Description : The system tick timer handler of RME, on all processors except for
-              the main processor.
+              the main processor. In tickless mode, this is not called on every
+              tick; the time slices and tick signals of all the ticks that passed
+              since the last call are accounted here, and the one-shot timer is
+              then rearmed for the next event.
 Input       : struct RME_Reg_Struct* Reg - The register set when entering the handler.
 Output      : struct RME_Reg_Struct* Reg - The register set when exiting the handler.
 Return      : None.
@@ -665,29 +1438,56 @@ Return      : None.
 void _RME_Tick_SMP_Handler(struct RME_Reg_Struct* Reg)
 {
     struct RME_CPU_Local* CPU_Local;
+    rme_ptr_t Ticks;
+#if(RME_TICKLESS==RME_TRUE)
+    rme_ptr_t Now;
+    rme_ptr_t Old_Value;
+#endif
 
     CPU_Local=RME_CPU_LOCAL();
+#if(RME_TICKLESS==RME_TRUE)
+    /* The main processor keeps the timestamp, and we count from it */
+    Now=RME_Timestamp;
+    Ticks=Now-CPU_Local->Slice_Last;
+    CPU_Local->Slice_Last=Now;
+#else
+    Ticks=1;
+#endif
+    RME_TRACE_EVENT(RME_TRACE_TICK,Ticks,(CPU_Local->Cur_Thd)->Sched.TID);
+
     if((CPU_Local->Cur_Thd)->Sched.Slices<RME_THD_INF_TIME)
     {
         RME_COVERAGE_MARKER();
         
-        /* Decrease timeslice count */
-        (CPU_Local->Cur_Thd)->Sched.Slices--;
         /* See if the current thread's timeslice is used up */
-        if((CPU_Local->Cur_Thd)->Sched.Slices==0)
+        if((CPU_Local->Cur_Thd)->Sched.Slices<=Ticks)
         {
             RME_COVERAGE_MARKER();
             
             /* Running out of time. Kick this guy out and pick someone else */
+            (CPU_Local->Cur_Thd)->Sched.Slices=0;
             (CPU_Local->Cur_Thd)->Sched.State=RME_THD_TIMEOUT;
             /* Delete it from runqueue */
             _RME_Run_Del(CPU_Local->Cur_Thd);
-            /* Send a scheduler notification to its parent */
-            _RME_Run_Notif(CPU_Local->Cur_Thd);
+            /* Send a scheduler notification to its parent. EDF threads will get their
+             * budgets back when the next period begins, so nobody needs to know */
+            if((CPU_Local->Cur_Thd)->Sched.Period==0)
+            {
+                RME_COVERAGE_MARKER();
+
+                _RME_Run_Notif(CPU_Local->Cur_Thd);
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
         }
         else
         {
             RME_COVERAGE_MARKER();
+
+            /* Decrease timeslice count */
+            (CPU_Local->Cur_Thd)->Sched.Slices-=Ticks;
         }
     }
     else
@@ -695,14 +1495,198 @@ void _RME_Tick_SMP_Handler(struct RME_Reg_Struct* Reg)
         RME_COVERAGE_MARKER();
     }
 
+#if(RME_TICKLESS==RME_TRUE)
+    /* Send all the ticks that passed to the system ticker receive endpoint. The first
+     * one may unblock a thread, and the rest are just counted */
+    Ticks=Now-CPU_Local->Tick_Last;
+    CPU_Local->Tick_Last=Now;
+    if(Ticks!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        _RME_Kern_Snd(CPU_Local->Tick_Sig);
+        if(Ticks>1)
+        {
+            RME_COVERAGE_MARKER();
+
+            Old_Value=RME_FETCH_ADD(&(CPU_Local->Tick_Sig->Signal_Num),Ticks-1);
+            if((Old_Value+Ticks-1)>RME_MAX_SIG_NUM)
+            {
+                RME_COVERAGE_MARKER();
+
+                RME_FETCH_ADD(&(CPU_Local->Tick_Sig->Signal_Num),-(rme_cnt_t)(Ticks-1));
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+#else
     /* Send to the system ticker receive endpoint. This endpoint is per-core */
     _RME_Kern_Snd(CPU_Local->Tick_Sig);
+#endif
+
+    /* Adopt the threads that other cores moved here without poking us */
+    _RME_Run_Migr(CPU_Local);
+    /* Begin the new periods of the EDF threads that are due */
+    _RME_Run_EDF_Rep(CPU_Local);
 
     /* All kernel send complete, now pick the highest priority thread to run */
     _RME_Kern_High(Reg, CPU_Local);
+#if(RME_TICKLESS==RME_TRUE)
+    _RME_Tick_Rearm(CPU_Local->Cur_Thd);
+#endif
 }
 /* End Function:_RME_Tick_SMP_Handler ****************************************/
 
+#if(RME_TICKLESS==RME_TRUE)
+/* Begin Function:_RME_Tick_Charge ********************************************
+Description : Charge the ticks that passed since the last accounting to a thread
+              that is being switched out, in tickless mode. We never time it out
+              here, because it may be leaving the runqueue for other reasons; if
+              its slices are used up, we leave one slice to it, and the timer
+              will take that away as soon as it runs again.
+Input       : struct RME_Thd_Struct* Thd - The thread that is being switched out.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Tick_Charge(struct RME_Thd_Struct* Thd)
+{
+    struct RME_CPU_Local* CPU_Local;
+    rme_ptr_t Now;
+    rme_ptr_t Ticks;
+
+    CPU_Local=Thd->Sched.CPU_Local;
+    Now=RME_Timestamp;
+    Ticks=Now-CPU_Local->Slice_Last;
+    CPU_Local->Slice_Last=Now;
+
+    if(Thd->Sched.Slices<RME_THD_INF_TIME)
+    {
+        RME_COVERAGE_MARKER();
+
+        if(Thd->Sched.Slices>Ticks)
+        {
+            RME_COVERAGE_MARKER();
+
+            Thd->Sched.Slices-=Ticks;
+        }
+        else if(Thd->Sched.Slices!=0)
+        {
+            RME_COVERAGE_MARKER();
+
+            Thd->Sched.Slices=1;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+}
+/* End Function:_RME_Tick_Charge *********************************************/
+
+/* Begin Function:_RME_Tick_Rearm *********************************************
+Description : Arm the one-shot timer of this processor for the next event, in
+              tickless mode. The next event is the next tick if a thread waits
+              on the tick endpoint, or the running thread's slice expiry, or the
+              next EDF period; if none of these exists, the timer is stopped.
+Input       : struct RME_Thd_Struct* Thd - The thread that is going to run.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Tick_Rearm(struct RME_Thd_Struct* Thd)
+{
+    struct RME_CPU_Local* CPU_Local;
+    rme_ptr_t Ticks;
+    rme_cnt_t Left;
+
+    CPU_Local=Thd->Sched.CPU_Local;
+    if(CPU_Local->Tick_Sig->Thd!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        Ticks=1;
+    }
+    else if(Thd->Sched.Slices<RME_THD_INF_TIME)
+    {
+        RME_COVERAGE_MARKER();
+
+        Ticks=Thd->Sched.Slices;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+
+        Ticks=RME_THD_INF_TIME;
+    }
+
+    /* The earliest EDF period may begin before that */
+    if(CPU_Local->EDF.Next!=&(CPU_Local->EDF))
+    {
+        RME_COVERAGE_MARKER();
+
+        Left=(rme_cnt_t)(RME_EDF_THD(CPU_Local->EDF.Next)->Sched.Deadline-RME_Timestamp);
+        if(Left<=0)
+        {
+            RME_COVERAGE_MARKER();
+
+            Ticks=1;
+        }
+        else if(((rme_ptr_t)Left)<Ticks)
+        {
+            RME_COVERAGE_MARKER();
+
+            Ticks=(rme_ptr_t)Left;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+
+    __RME_Timer_Set(Ticks);
+}
+/* End Function:_RME_Tick_Rearm **********************************************/
+#endif
+
+#ifdef RME_CYCLE_ACCT
+/* Begin Function:_RME_Cycle_Charge *******************************************
+Description : Charge the processor cycles used since the last accounting to the
+              current thread of this processor.
+Input       : struct RME_Thd_Struct* Thd - The current thread.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Cycle_Charge(struct RME_Thd_Struct* Thd)
+{
+    struct RME_CPU_Local* CPU_Local;
+    rme_ptr_t Now;
+
+    CPU_Local=Thd->Sched.CPU_Local;
+    Now=RME_CYCLE_GET();
+    Thd->Sched.Cycles+=Now-CPU_Local->Cycle_Last;
+    CPU_Local->Cycle_Last=Now;
+}
+/* End Function:_RME_Cycle_Charge ********************************************/
+#endif
+
 /* Begin Function:_RME_Tick_Handler *******************************************
 Description : The system tick timer handler of RME.
 Input       : struct RME_Reg_Struct* Reg - The register set when entering the handler.
@@ -719,8 +1703,9 @@ void _RME_Tick_Handler(struct RME_Reg_Struct* Reg)
 /* End Function:_RME_Tick_Handler ********************************************/
 
 /* Begin Function:_RME_Clear **************************************************
-Description : Memset a memory area to zero. This is not fast due to byte operations;
-              this is not meant for large memory.
+Description : Memset a memory area to zero. This is the generic version that
+              works a word at a time when the address is aligned; the platforms
+              may provide faster ones with RME_CLEAR.
 Input       : void* Addr - The address to clear.
               rme_ptr_t Size - The size to clear.
 Output      : None.
@@ -728,16 +1713,34 @@ Return      : None.
 ******************************************************************************/
 void _RME_Clear(void* Addr, rme_ptr_t Size)
 {
-    rme_cnt_t Count;
+    rme_u8_t* Ptr;
+    rme_ptr_t* Word;
+    rme_ptr_t Count;
 
-    for(Count=0;Count<Size;Count++)
-        ((rme_u8_t*)Addr)[Count]=0;
+    Ptr=(rme_u8_t*)Addr;
+    /* Clear the bytes until the address is aligned */
+    while((Size!=0)&&((((rme_ptr_t)Ptr)&(sizeof(rme_ptr_t)-1))!=0))
+    {
+        *Ptr=0;
+        Ptr++;
+        Size--;
+    }
+
+    /* Clear the aligned words */
+    Word=(rme_ptr_t*)Ptr;
+    for(Count=0;Count<(Size>>(RME_WORD_ORDER-3));Count++)
+        Word[Count]=0;
+
+    /* Clear what is left */
+    Ptr=(rme_u8_t*)(&Word[Count]);
+    for(Count=0;Count<(Size&(sizeof(rme_ptr_t)-1));Count++)
+        Ptr[Count]=0;
 }
 /* End Function:_RME_Clear ***************************************************/
 
 /* Begin Function:_RME_Memcmp *************************************************
-Description : Compare two memory segments to see if they are equal. This is not
-              fast due to byte operations; this is not meant for large memory.
+Description : Compare two memory segments to see if they are equal. When both
+              are equally aligned, this skips over the equal words first.
 Input       : const void* Ptr1 - The first memory region.
               const void* Ptr2 - The second memory region.
               rme_ptr_t Num - The number of bytes to compare.
@@ -754,6 +1757,30 @@ rme_ret_t _RME_Memcmp(const void* Ptr1, const void* Ptr2, rme_ptr_t Num)
     Dst=(rme_u8_t*)Ptr1;
     Src=(rme_u8_t*)Ptr2;
 
+    /* Skip the equal words if we can - the different one is compared bytewise */
+    if(((((rme_ptr_t)Dst)^((rme_ptr_t)Src))&(sizeof(rme_ptr_t)-1))==0)
+    {
+        RME_COVERAGE_MARKER();
+
+        while((Num!=0)&&((((rme_ptr_t)Dst)&(sizeof(rme_ptr_t)-1))!=0)&&(*Dst==*Src))
+        {
+            Dst++;
+            Src++;
+            Num--;
+        }
+        while((Num>=sizeof(rme_ptr_t))&&((((rme_ptr_t)Dst)&(sizeof(rme_ptr_t)-1))==0)&&
+              (*((rme_ptr_t*)Dst)==*((rme_ptr_t*)Src)))
+        {
+            Dst+=sizeof(rme_ptr_t);
+            Src+=sizeof(rme_ptr_t);
+            Num-=sizeof(rme_ptr_t);
+        }
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+
     for(Count=0;Count<Num;Count++)
     {
         if(Dst[Count]!=Src[Count])
@@ -773,21 +1800,51 @@ rme_ret_t _RME_Memcmp(const void* Ptr1, const void* Ptr2, rme_ptr_t Num)
 /* End Function:_RME_Memcmp **************************************************/
 
 /* Begin Function:_RME_Memcpy *************************************************
-Description : Copy one segment of memory to another segment. This is not fast
-              due to byte operations; this is not meant for large memory.
-Input       : void* Dst - The first memory region.
-              void* Src - The second memory region.
-              rme_ptr_t Num - The number of bytes to compare.
-              rme_ptr_t Size - The size to clear.
+Description : Copy one segment of memory to another segment. This is the generic
+              version that copies a word at a time when both are equally aligned;
+              the platforms may provide faster ones with RME_MEMCPY.
+Input       : void* Dst - The destination memory region.
+              void* Src - The source memory region.
+              rme_ptr_t Num - The number of bytes to copy.
 Output      : None.
 Return      : None.
 ******************************************************************************/
 void _RME_Memcpy(void* Dst, void* Src, rme_ptr_t Num)
 {
-    rme_cnt_t Count;
+    rme_u8_t* Dst_Ptr;
+    rme_u8_t* Src_Ptr;
+    rme_ptr_t Count;
+
+    Dst_Ptr=(rme_u8_t*)Dst;
+    Src_Ptr=(rme_u8_t*)Src;
+
+    /* Copy words if they are equally aligned */
+    if(((((rme_ptr_t)Dst_Ptr)^((rme_ptr_t)Src_Ptr))&(sizeof(rme_ptr_t)-1))==0)
+    {
+        RME_COVERAGE_MARKER();
+
+        while((Num!=0)&&((((rme_ptr_t)Dst_Ptr)&(sizeof(rme_ptr_t)-1))!=0))
+        {
+            *Dst_Ptr=*Src_Ptr;
+            Dst_Ptr++;
+            Src_Ptr++;
+            Num--;
+        }
+
+        for(Count=0;Count<(Num>>(RME_WORD_ORDER-3));Count++)
+            ((rme_ptr_t*)Dst_Ptr)[Count]=((rme_ptr_t*)Src_Ptr)[Count];
+
+        Dst_Ptr+=Count*sizeof(rme_ptr_t);
+        Src_Ptr+=Count*sizeof(rme_ptr_t);
+        Num&=sizeof(rme_ptr_t)-1;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
 
     for(Count=0;Count<Num;Count++)
-        ((rme_u8_t*)Dst)[Count]=((rme_u8_t*)Src)[Count];
+        Dst_Ptr[Count]=Src_Ptr[Count];
 }
 /* End Function:_RME_Memcpy **************************************************/
 
@@ -1084,6 +2141,130 @@ rme_ret_t _RME_Captbl_Boot_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Capt
 }
 /* End Function:_RME_Captbl_Boot_Crt *****************************************/
 
+/* Begin Function:_RME_Captbl_Cache_Get ***************************************
+Description : Look up a 2-level capability ID in the capability resolution cache
+              of the current CPU. If the entry is valid, the slot is returned and
+              the master table walk can be skipped; the caller still needs to
+              check the type and the frozen flag of the slot it gets. On a miss,
+              the entry is claimed for this lookup and stamped with the current
+              generation, so that if any captbl gets frozen before the walk
+              completes, the entry will never be hit.
+              Each CPU only touches its own cache with interrupts disabled, so no
+              atomics are needed on the entries themselves.
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              rme_cid_t Capid - The 2-level capability ID.
+Output      : None.
+Return      : struct RME_Cap_Struct* - The cached capability slot; 0 if missed.
+******************************************************************************/
+struct RME_Cap_Struct* _RME_Captbl_Cache_Get(struct RME_Cap_Captbl* Captbl, rme_cid_t Capid)
+{
+    struct RME_Cap_Cache* Cache;
+    struct RME_Cap_Cache_Entry* Entry;
+    rme_ptr_t Gen;
+    
+    Cache=&(RME_CPU_LOCAL()->Cap_Cache);
+    Entry=&(Cache->Entry[RME_CAP_CACHE_HASH((rme_ptr_t)Capid)]);
+    /* Read the generation before anything in the tables is read */
+    Gen=RME_READ_ACQUIRE(&RME_Captbl_Gen);
+    
+    if(RME_LIKELY((Entry->Captbl==RME_CAP_GETOBJ(Captbl,rme_ptr_t))&&
+                  (Entry->Capid==(rme_ptr_t)Capid)&&
+                  (Entry->Gen==Gen)&&(Entry->Slot!=0)))
+    {
+        RME_COVERAGE_MARKER();
+        
+        Cache->Hit++;
+        return Entry->Slot;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    Cache->Miss++;
+    Entry->Captbl=RME_CAP_GETOBJ(Captbl,rme_ptr_t);
+    Entry->Capid=(rme_ptr_t)Capid;
+    Entry->Gen=Gen;
+    Entry->Slot=0;
+    return 0;
+}
+/* End Function:_RME_Captbl_Cache_Get ****************************************/
+
+/* Begin Function:_RME_Captbl_Cache_Set ***************************************
+Description : Fill in the slot of an entry that _RME_Captbl_Cache_Get missed on.
+              The generation stamped at that time is kept.
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              rme_cid_t Capid - The 2-level capability ID.
+              struct RME_Cap_Struct* Slot - The slot that the walk resolved to.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Captbl_Cache_Set(struct RME_Cap_Captbl* Captbl, rme_cid_t Capid,
+                           struct RME_Cap_Struct* Slot)
+{
+    struct RME_Cap_Cache_Entry* Entry;
+    
+    Entry=&(RME_CPU_LOCAL()->Cap_Cache.Entry[RME_CAP_CACHE_HASH((rme_ptr_t)Capid)]);
+    
+    /* Only fill it if nobody else claimed this entry in between */
+    if((Entry->Captbl==RME_CAP_GETOBJ(Captbl,rme_ptr_t))&&(Entry->Capid==(rme_ptr_t)Capid))
+    {
+        RME_COVERAGE_MARKER();
+        
+        Entry->Slot=Slot;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+}
+/* End Function:_RME_Captbl_Cache_Set ****************************************/
+
+/* Begin Function:_RME_Captbl_Cache_Stat **************************************
+Description : Get or clear the capability resolution cache statistics of the
+              current CPU.
+Input       : rme_ptr_t Sub_ID - RME_KERN_CAP_CACHE_HIT, RME_KERN_CAP_CACHE_MISS or
+                                 RME_KERN_CAP_CACHE_CLR.
+Output      : None.
+Return      : rme_ret_t - The hit or miss count (truncated to fit into a positive
+                          value); 0 when cleared; RME_ERR_KERN_OPFAIL if the sub
+                          function ID is not recognized.
+******************************************************************************/
+rme_ret_t _RME_Captbl_Cache_Stat(rme_ptr_t Sub_ID)
+{
+    struct RME_Cap_Cache* Cache;
+    
+    Cache=&(RME_CPU_LOCAL()->Cap_Cache);
+    
+    if(Sub_ID==RME_KERN_CAP_CACHE_HIT)
+    {
+        RME_COVERAGE_MARKER();
+        
+        return (rme_ret_t)(Cache->Hit&RME_MASK_END(sizeof(rme_ptr_t)*8-2));
+    }
+    else if(Sub_ID==RME_KERN_CAP_CACHE_MISS)
+    {
+        RME_COVERAGE_MARKER();
+        
+        return (rme_ret_t)(Cache->Miss&RME_MASK_END(sizeof(rme_ptr_t)*8-2));
+    }
+    else if(Sub_ID==RME_KERN_CAP_CACHE_CLR)
+    {
+        RME_COVERAGE_MARKER();
+        
+        Cache->Hit=0;
+        Cache->Miss=0;
+        return 0;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    return RME_ERR_KERN_OPFAIL;
+}
+/* End Function:_RME_Captbl_Cache_Stat ***************************************/
+
 /* Begin Function:_RME_Captbl_Crt *********************************************
 Description : Create a capability table.
 Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
@@ -1171,6 +2352,8 @@ rme_ret_t _RME_Captbl_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl_Cr
 
     /* At last, write into slot the correct information, and clear the frozen bit */
     RME_WRITE_RELEASE(&(Captbl_Crt->Head.Type_Ref),RME_CAP_TYPEREF(RME_CAP_CAPTBL,0));
+    /* No 2-level lookup cached before this may resolve through the new captbl */
+    RME_FETCH_ADD(&RME_Captbl_Gen,1);
     return 0;
 }
 /* End Function:_RME_Captbl_Crt **********************************************/
@@ -1229,8 +2412,11 @@ rme_ret_t _RME_Captbl_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl_De
 
     /* Now we can safely delete the cap */
     RME_CAP_REMDEL(Captbl_Del,Type_Ref);
+    /* 2-level lookups through this captbl may be cached on some CPU, and they must
+     * never hit again, because the memory will be reused */
+    RME_FETCH_ADD(&RME_Captbl_Gen,1);
     /* Try to depopulate the area - this must be successful */
-    RME_ASSERT(_RME_Kotbl_Erase(Object,Size)!=0);
+    RME_ASSERT(_RME_Kotbl_Erase(Object,Size)==0);
     
     return 0;
 }
@@ -1312,7 +2498,7 @@ rme_ret_t _RME_Captbl_Frz(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl_Fr
     Captbl_Frz->Head.Timestamp=RME_Timestamp;
     
     /* Finally, freeze it */
-    if(RME_COMP_SWAP(&(Captbl_Frz->Head.Type_Ref),Type_Ref,Type_Ref|RME_CAPTBL_FLAG_FRZ)==0)
+    if(RME_COMP_SWAP(&(Captbl_Frz->Head.Type_Ref),Type_Ref,Type_Ref|RME_CAP_FROZEN)==0)
     {
         RME_COVERAGE_MARKER();
         
@@ -1323,6 +2509,20 @@ rme_ret_t _RME_Captbl_Frz(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl_Fr
         RME_COVERAGE_MARKER();
     }
     
+    /* If this is a captbl, 2-level lookups through it may be cached on some CPU.
+     * Bump the generation so that all of them miss and walk the tables again,
+     * which will then see the frozen flag */
+    if(RME_CAP_TYPE(Type_Ref)==RME_CAP_CAPTBL)
+    {
+        RME_COVERAGE_MARKER();
+        
+        RME_FETCH_ADD(&RME_Captbl_Gen,1);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
     return 0;
 }
 /* End Function:_RME_Captbl_Frz **********************************************/
@@ -1669,6 +2869,17 @@ rme_ret_t _RME_Captbl_Add(struct RME_Cap_Captbl* Captbl,
     /* Write in the correct information at last */
     RME_WRITE_RELEASE(&(Cap_Dst_Struct->Head.Type_Ref),
                       RME_CAP_TYPEREF(RME_CAP_TYPE(Cap_Src_Struct->Head.Type_Ref),0));
+    /* No 2-level lookup cached before this may resolve through a new captbl */
+    if(RME_CAP_TYPE(Cap_Src_Struct->Head.Type_Ref)==RME_CAP_CAPTBL)
+    {
+        RME_COVERAGE_MARKER();
+        
+        RME_FETCH_ADD(&RME_Captbl_Gen,1);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
     return 0;
 }
 /* End Function:_RME_Captbl_Add **********************************************/
@@ -1705,6 +2916,17 @@ rme_ret_t _RME_Captbl_Rem(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl_Re
 
     /* Remove the cap at last */
     RME_CAP_REMDEL(Captbl_Rem,Type_Ref);
+    /* If this is a captbl, 2-level lookups through it may be cached on some CPU */
+    if(RME_CAP_TYPE(Type_Ref)==RME_CAP_CAPTBL)
+    {
+        RME_COVERAGE_MARKER();
+        
+        RME_FETCH_ADD(&RME_Captbl_Gen,1);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
     
     /* Check done, decrease its parent's refcnt */
     RME_FETCH_ADD(&(Parent->Head.Type_Ref), -1);
@@ -2302,7 +3524,7 @@ rme_ret_t _RME_Pgtbl_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rm
     /* Now we can safely delete the cap */
     RME_CAP_REMDEL(Pgtbl_Del,Type_Ref);
     /* Try to erase the area - This must be successful */
-    RME_ASSERT(_RME_Kotbl_Erase(Object, Size));
+    RME_ASSERT(_RME_Kotbl_Erase(Object, Size)==0);
     
     return 0;
 }
@@ -2479,7 +3701,7 @@ rme_ret_t _RME_Pgtbl_Rem(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Pgtbl, rme
     rme_ptr_t Type_Ref;
     
     /* Get the cap location that we care about */
-    RME_CAPTBL_GETCAP(Captbl,Cap_Pgtbl,RME_CAP_CAPTBL,struct RME_Cap_Pgtbl*,Pgtbl_Rem,Type_Ref);
+    RME_CAPTBL_GETCAP(Captbl,Cap_Pgtbl,RME_CAP_PGTBL,struct RME_Cap_Pgtbl*,Pgtbl_Rem,Type_Ref);
     /* Check if the target captbl is not frozen and allows such operations */
     RME_CAP_CHECK(Pgtbl_Rem,RME_PGTBL_FLAG_REM);
     /* Check the operation range - This is page table specific */
@@ -2655,125 +3877,426 @@ rme_ret_t _RME_Pgtbl_Con(struct RME_Cap_Captbl* Captbl,
     {
         RME_COVERAGE_MARKER();
 
-        return RME_ERR_PGT_MAP;
+        return RME_ERR_PGT_MAP;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    return 0;
+}
+/* End Function:_RME_Pgtbl_Con ***********************************************/
+
+/* Begin Function:_RME_Pgtbl_Des **********************************************
+Description : Unmap a child page table from the parent page table. Basically, we 
+              are doing the destruction of a page table.
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              rme_cid_t Cap_Pgtbl - The capability to the page table. 2-Level.
+              rme_ptr_t Pos - The virtual address to position unmap the child page
+                              table from.
+Output      : None.
+Return      : rme_ret_t - If the mapping is successful, it will return 0; else error code.
+******************************************************************************/
+rme_ret_t _RME_Pgtbl_Des(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Pgtbl, rme_ptr_t Pos)
+{
+    struct RME_Cap_Pgtbl* Pgtbl_Des;
+    rme_ptr_t Type_Ref;
+    
+    /* Get the cap location that we care about */
+    RME_CAPTBL_GETCAP(Captbl,Cap_Pgtbl,RME_CAP_PGTBL,struct RME_Cap_Pgtbl*,Pgtbl_Des,Type_Ref);
+    /* Check if the target captbl is not frozen and allows such operations */
+    RME_CAP_CHECK(Pgtbl_Des,RME_PGTBL_FLAG_DES);
+    /* Check the operation range - This is page table specific */
+    if((Pos>RME_PGTBL_FLAG_HIGH(Pgtbl_Des->Head.Flags))||
+       (Pos<RME_PGTBL_FLAG_LOW(Pgtbl_Des->Head.Flags)))
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_CAP_FLAG;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+
+    /* See if the unmapping range is allowed */
+    if((Pos>>RME_PGTBL_NUMORD(Pgtbl_Des->Size_Num_Order))!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PGT_ADDR;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Actually do the unmapping - This work is passed down to the driver layer.
+     * Successful or not will be determined by the driver layer. */
+    if(__RME_Pgtbl_Pgdir_Unmap(Pgtbl_Des, Pos)!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PGT_MAP;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    return 0;
+}
+/* End Function:_RME_Pgtbl_Des ***********************************************/
+
+/* Begin Function:_RME_Kotbl_Init *********************************************
+Description : Initialize the kernel object table according to the size of the table.
+              The summary bitmap that follows it is also cleared.
+Input       : rme_ptr_t Words - the number of words in the table.
+Output      : None.
+Return      : rme_ret_t - If the number of words are is not sufficient to hold all
+                          kernel memory, -1; else 0.
+******************************************************************************/
+rme_ret_t _RME_Kotbl_Init(rme_ptr_t Words)
+{
+    if(Words<RME_KOTBL_WORD_NUM)
+    {
+        RME_COVERAGE_MARKER();
+
+        return -1;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Avoid compiler warning about unused variable */
+    RME_Kotbl[0]=0;
+    RME_Kotbl_Sum[0]=0;
+
+    /* Zero out the whole table, and its summary */
+    RME_CLEAR(RME_KOTBL, Words*sizeof(rme_ptr_t));
+    RME_CLEAR(RME_KOTBL_SUM, ((Words+RME_WORD_BITS-1)>>RME_WORD_ORDER)*sizeof(rme_ptr_t));
+    
+    return 0;
+}
+/* End Function:_RME_Kotbl_Init **********************************************/
+
+/* Begin Function:_RME_Kotbl_Word_Mark ****************************************
+Description : Populate some bits in a single word of the kernel object bitmap.
+              After the bits are set, we check the summary bit of the word. If
+              someone have taken the whole word meanwhile, we back off. The whole
+              word marker does the same in the reverse order, thus at least one
+              of the two will see the other.
+Input       : rme_ptr_t Word - The word to populate.
+              rme_ptr_t Mask - The bits to populate in that word.
+Output      : None.
+Return      : rme_ret_t - If the operation is successful, it will return 0; else error code.
+******************************************************************************/
+rme_ret_t _RME_Kotbl_Word_Mark(rme_ptr_t Word, rme_ptr_t Mask)
+{
+    rme_ptr_t Old_Val;
+    
+    /* Someone already populated something here */
+    Old_Val=RME_KOTBL[Word];
+    if((Old_Val&Mask)!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_KOT_BMP;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Check done, do the marking with CAS */
+    if(RME_COMP_SWAP(&RME_KOTBL[Word],Old_Val,Old_Val|Mask)==0)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_KOT_BMP;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* See if the whole word belongs to someone else */
+    if((RME_KOTBL_SUM[RME_KOTBL_SUM_WORD(Word)]&RME_KOTBL_SUM_BIT(Word))!=0)
+    {
+        RME_COVERAGE_MARKER();
+        
+        RME_FETCH_AND(&(RME_KOTBL[Word]),~Mask);
+        return RME_ERR_KOT_BMP;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    return 0;
+}
+/* End Function:_RME_Kotbl_Word_Mark *****************************************/
+
+/* Begin Function:_RME_Kotbl_Full_Mark ****************************************
+Description : Populate a range of whole words of the kernel object bitmap. Only
+              the summary bits of these words are set, so this takes one CAS for
+              each summary word instead of one for each word. The words themselves
+              will stay zero. After this, we make sure that nobody have populated
+              any bits in these words.
+Input       : rme_ptr_t Start - The first word to populate.
+              rme_ptr_t End - The word after the last word to populate.
+Output      : None.
+Return      : rme_ret_t - If the operation is successful, it will return 0; else error code.
+******************************************************************************/
+rme_ret_t _RME_Kotbl_Full_Mark(rme_ptr_t Start, rme_ptr_t End)
+{
+    rme_ptr_t Count;
+    rme_ptr_t Next;
+    rme_ptr_t Mask;
+    rme_ptr_t Old_Val;
+    
+    /* Check&Mark the summary words */
+    for(Count=Start;Count<End;Count=Next)
+    {
+        Next=RME_ROUND_DOWN(Count,RME_WORD_ORDER)+RME_WORD_BITS;
+        if(Next>End)
+        {
+            RME_COVERAGE_MARKER();
+            
+            Next=End;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+        
+        Mask=RME_MASK(Count&RME_MASK_END(RME_WORD_ORDER-1),(Next-1)&RME_MASK_END(RME_WORD_ORDER-1));
+        Old_Val=RME_KOTBL_SUM[RME_KOTBL_SUM_WORD(Count)];
+        if(((Old_Val&Mask)!=0)||
+           (RME_COMP_SWAP(&RME_KOTBL_SUM[RME_KOTBL_SUM_WORD(Count)],Old_Val,Old_Val|Mask)==0))
+        {
+            RME_COVERAGE_MARKER();
+            
+            _RME_Kotbl_Full_Erase(Start, Count);
+            return RME_ERR_KOT_BMP;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+    }
+    
+    /* Nobody will keep any bits in these words from now on. See if someone did so before */
+    for(Count=Start;Count<End;Count++)
+    {
+        if(RME_KOTBL[Count]!=0)
+        {
+            RME_COVERAGE_MARKER();
+            
+            _RME_Kotbl_Full_Erase(Start, End);
+            return RME_ERR_KOT_BMP;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+    }
+    
+    return 0;
+}
+/* End Function:_RME_Kotbl_Full_Mark *****************************************/
+
+/* Begin Function:_RME_Kotbl_Full_Check ***************************************
+Description : Check if a range of whole words of the kernel object bitmap are
+              all populated by _RME_Kotbl_Full_Mark.
+Input       : rme_ptr_t Start - The first word to check.
+              rme_ptr_t End - The word after the last word to check.
+Output      : None.
+Return      : rme_ret_t - If they are all populated, 0; else error code.
+******************************************************************************/
+rme_ret_t _RME_Kotbl_Full_Check(rme_ptr_t Start, rme_ptr_t End)
+{
+    rme_ptr_t Count;
+    rme_ptr_t Next;
+    rme_ptr_t Mask;
+    
+    for(Count=Start;Count<End;Count=Next)
+    {
+        Next=RME_ROUND_DOWN(Count,RME_WORD_ORDER)+RME_WORD_BITS;
+        if(Next>End)
+        {
+            RME_COVERAGE_MARKER();
+            
+            Next=End;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+        
+        Mask=RME_MASK(Count&RME_MASK_END(RME_WORD_ORDER-1),(Next-1)&RME_MASK_END(RME_WORD_ORDER-1));
+        if((RME_KOTBL_SUM[RME_KOTBL_SUM_WORD(Count)]&Mask)!=Mask)
+        {
+            RME_COVERAGE_MARKER();
+            
+            return RME_ERR_KOT_BMP;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+    }
+    
+    return 0;
+}
+/* End Function:_RME_Kotbl_Full_Check ****************************************/
+
+/* Begin Function:_RME_Kotbl_Full_Erase ***************************************
+Description : Depopulate a range of whole words of the kernel object bitmap.
+Input       : rme_ptr_t Start - The first word to depopulate.
+              rme_ptr_t End - The word after the last word to depopulate.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Kotbl_Full_Erase(rme_ptr_t Start, rme_ptr_t End)
+{
+    rme_ptr_t Count;
+    rme_ptr_t Next;
+    rme_ptr_t Mask;
+    
+    for(Count=Start;Count<End;Count=Next)
+    {
+        Next=RME_ROUND_DOWN(Count,RME_WORD_ORDER)+RME_WORD_BITS;
+        if(Next>End)
+        {
+            RME_COVERAGE_MARKER();
+            
+            Next=End;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+        
+        Mask=RME_MASK(Count&RME_MASK_END(RME_WORD_ORDER-1),(Next-1)&RME_MASK_END(RME_WORD_ORDER-1));
+        /* Others may be working on the rest of this summary word - need atomic operations */
+        RME_FETCH_AND(&(RME_KOTBL_SUM[RME_KOTBL_SUM_WORD(Count)]),~Mask);
+    }
+}
+/* End Function:_RME_Kotbl_Full_Erase ****************************************/
+
+/* Begin Function:_RME_Kotbl_Mark *********************************************
+Description : Populate the kernel object bitmap contiguously. The start and end
+              words are populated bit by bit, while all the words between them
+              are populated as a whole in the summary bitmap.
+Input       : rme_ptr_t Kaddr - The kernel virtual address.
+              rme_ptr_t Size - The size of the memory to populate.
+Output      : None.
+Return      : rme_ret_t - If the operation is successful, it will return 0; else error code.
+******************************************************************************/
+rme_ret_t _RME_Kotbl_Mark(rme_ptr_t Kaddr, rme_ptr_t Size)
+{
+    /* The actual word to start the marking */
+    rme_ptr_t Start;
+    /* The actual word to end the marking */
+    rme_ptr_t End;
+    /* The mask at the start word */
+    rme_ptr_t Start_Mask;
+    /* The mask at the end word */
+    rme_ptr_t End_Mask;
+
+    /* Check if the marking is well aligned */
+    if((Kaddr&RME_MASK_END(RME_KMEM_SLOT_ORDER-1))!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_KOT_BMP;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
     
-    return 0;
-}
-/* End Function:_RME_Pgtbl_Con ***********************************************/
-
-/* Begin Function:_RME_Pgtbl_Des **********************************************
-Description : Unmap a child page table from the parent page table. Basically, we 
-              are doing the destruction of a page table.
-Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
-              rme_cid_t Cap_Pgtbl - The capability to the page table. 2-Level.
-              rme_ptr_t Pos - The virtual address to position unmap the child page
-                              table from.
-Output      : None.
-Return      : rme_ret_t - If the mapping is successful, it will return 0; else error code.
-******************************************************************************/
-rme_ret_t _RME_Pgtbl_Des(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Pgtbl, rme_ptr_t Pos)
-{
-    struct RME_Cap_Pgtbl* Pgtbl_Des;
-    rme_ptr_t Type_Ref;
+    /* Check if the marking is within range - unnecessary due to the kmem cap range limits */
+    /* if((Kaddr<RME_KMEM_VA_START)||((Kaddr+Size)>(RME_KMEM_VA_START+RME_KMEM_SIZE)))
+        return RME_ERR_KOT_BMP; */
     
-    /* Get the cap location that we care about */
-    RME_CAPTBL_GETCAP(Captbl,Cap_Pgtbl,RME_CAP_CAPTBL,struct RME_Cap_Pgtbl*,Pgtbl_Des,Type_Ref);
-    /* Check if the target captbl is not frozen and allows such operations */
-    RME_CAP_CHECK(Pgtbl_Des,RME_PGTBL_FLAG_DES);
-    /* Check the operation range - This is page table specific */
-    if((Pos>RME_PGTBL_FLAG_HIGH(Pgtbl_Des->Head.Flags))||
-       (Pos<RME_PGTBL_FLAG_LOW(Pgtbl_Des->Head.Flags)))
+    /* Round the marking to RME_KMEM_SLOT_ORDER boundary, and rely on compiler for optimization */
+    Start=(Kaddr-RME_KMEM_VA_START)>>RME_KMEM_SLOT_ORDER;
+    Start_Mask=RME_MASK_START(Start&RME_MASK_END(RME_WORD_ORDER-1));
+    Start=Start>>RME_WORD_ORDER;
+    
+    End=(Kaddr+Size-1-RME_KMEM_VA_START)>>RME_KMEM_SLOT_ORDER;
+    End_Mask=RME_MASK_END(End&RME_MASK_END(RME_WORD_ORDER-1));
+    End=End>>RME_WORD_ORDER;
+    
+    /* See if the start and end are in the same word */
+    if(Start==End)
     {
         RME_COVERAGE_MARKER();
-
-        return RME_ERR_CAP_FLAG;
+        
+        return _RME_Kotbl_Word_Mark(Start, Start_Mask&End_Mask);
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
-
-    /* See if the unmapping range is allowed */
-    if((Pos>>RME_PGTBL_NUMORD(Pgtbl_Des->Size_Num_Order))!=0)
+    
+    /* Check&Mark the start */
+    if(_RME_Kotbl_Word_Mark(Start, Start_Mask)!=0)
     {
         RME_COVERAGE_MARKER();
 
-        return RME_ERR_PGT_ADDR;
+        return RME_ERR_KOT_BMP;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
     
-    /* Actually do the unmapping - This work is passed down to the driver layer.
-     * Successful or not will be determined by the driver layer. */
-    if(__RME_Pgtbl_Pgdir_Unmap(Pgtbl_Des, Pos)!=0)
+    /* Check&Mark the middle */
+    if(_RME_Kotbl_Full_Mark(Start+1, End)!=0)
     {
         RME_COVERAGE_MARKER();
 
-        return RME_ERR_PGT_MAP;
+        RME_FETCH_AND(&(RME_KOTBL[Start]),~Start_Mask);
+        return RME_ERR_KOT_BMP;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
     
-    return 0;
-}
-/* End Function:_RME_Pgtbl_Des ***********************************************/
-
-/* Begin Function:_RME_Kotbl_Init *********************************************
-Description : Initialize the kernel object table according to the size of the table.
-Input       : rme_ptr_t Words - the number of words in the table.
-Output      : None.
-Return      : rme_ret_t - If the number of words are is not sufficient to hold all
-                          kernel memory, -1; else 0.
-******************************************************************************/
-rme_ret_t _RME_Kotbl_Init(rme_ptr_t Words)
-{
-    rme_ptr_t Count;
-    
-    if(Words<RME_KOTBL_WORD_NUM)
+    /* Check&Mark the end */
+    if(_RME_Kotbl_Word_Mark(End, End_Mask)!=0)
     {
         RME_COVERAGE_MARKER();
 
-        return -1;
+        _RME_Kotbl_Full_Erase(Start+1, End);
+        RME_FETCH_AND(&(RME_KOTBL[Start]),~Start_Mask);
+        return RME_ERR_KOT_BMP;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
     
-    /* Avoid compiler warning about unused variable */
-    RME_Kotbl[0]=0;
-
-    /* Zero out the whole table */
-    for(Count=0;Count<Words;Count++)
-    	RME_KOTBL[Count]=0;
-    
     return 0;
 }
-/* End Function:_RME_Kotbl_Init **********************************************/
+/* End Function:_RME_Kotbl_Mark **********************************************/
 
-/* Begin Function:_RME_Kotbl_Mark *********************************************
-Description : Populate the kernel object bitmap contiguously.
+/* Begin Function:_RME_Kotbl_Erase ********************************************
+Description : Depopulate the kernel object bitmap contiguously. We do not need 
+              CAS on erasure operations.
 Input       : rme_ptr_t Kaddr - The kernel virtual address.
-              rme_ptr_t Size - The size of the memory to populate.
+              rme_ptr_t Size - The size of the memory to depopulate.
 Output      : None.
 Return      : rme_ret_t - If the operation is successful, it will return 0; else error code.
 ******************************************************************************/
-rme_ret_t _RME_Kotbl_Mark(rme_ptr_t Kaddr, rme_ptr_t Size)
+rme_ret_t _RME_Kotbl_Erase(rme_ptr_t Kaddr, rme_ptr_t Size)
 {
-    rme_ptr_t Count;
-    /* The old value */
-    rme_ptr_t Old_Val;
-    /* Whether we need to undo our operations because of CAS failure */
-    rme_ptr_t Undo;
     /* The actual word to start the marking */
     rme_ptr_t Start;
     /* The actual word to end the marking */
@@ -2812,10 +4335,9 @@ rme_ret_t _RME_Kotbl_Mark(rme_ptr_t Kaddr, rme_ptr_t Size)
     if(Start==End)
     {
         RME_COVERAGE_MARKER();
-        
-        /* Someone already populated something here */
-        Old_Val=RME_KOTBL[Start];
-        if((Old_Val&(Start_Mask&End_Mask))!=0)
+
+        /* This address range is not fully populated */
+        if((RME_KOTBL[Start]&(Start_Mask&End_Mask))!=(Start_Mask&End_Mask))
         {
             RME_COVERAGE_MARKER();
 
@@ -2825,9 +4347,16 @@ rme_ret_t _RME_Kotbl_Mark(rme_ptr_t Kaddr, rme_ptr_t Size)
         {
             RME_COVERAGE_MARKER();
         }
-        
-        /* Check done, do the marking with CAS */
-        if(RME_COMP_SWAP(&RME_KOTBL[Start],Old_Val,Old_Val|(Start_Mask&End_Mask))==0)
+
+        /* Check done, do the unmarking - need atomic operations */
+        RME_FETCH_AND(&(RME_KOTBL[Start]),~(Start_Mask&End_Mask));
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+
+        /* Check the start */
+        if((RME_KOTBL[Start]&Start_Mask)!=Start_Mask)
         {
             RME_COVERAGE_MARKER();
 
@@ -2837,15 +4366,9 @@ rme_ret_t _RME_Kotbl_Mark(rme_ptr_t Kaddr, rme_ptr_t Size)
         {
             RME_COVERAGE_MARKER();
         }
-    }
-    else
-    {
-        RME_COVERAGE_MARKER();
         
-        Undo=0;
-        /* Check&Mark the start */
-        Old_Val=RME_KOTBL[Start];
-        if((Old_Val&Start_Mask)!=0)
+        /* Check the middle - they are in the summary bitmap */
+        if(_RME_Kotbl_Full_Check(Start+1, End)!=0)
         {
             RME_COVERAGE_MARKER();
 
@@ -2855,8 +4378,9 @@ rme_ret_t _RME_Kotbl_Mark(rme_ptr_t Kaddr, rme_ptr_t Size)
         {
             RME_COVERAGE_MARKER();
         }
-        
-        if(RME_COMP_SWAP(&RME_KOTBL[Start],Old_Val,Old_Val|Start_Mask)==0)
+
+        /* Check the end */
+        if((RME_KOTBL[End]&End_Mask)!=End_Mask)
         {
             RME_COVERAGE_MARKER();
 
@@ -2867,212 +4391,233 @@ rme_ret_t _RME_Kotbl_Mark(rme_ptr_t Kaddr, rme_ptr_t Size)
             RME_COVERAGE_MARKER();
         }
         
-        /* Check&Mark the middle */
-        for(Count=Start+1;Count<End;Count++)
-        {
-            Old_Val=RME_KOTBL[Count];
-            if(Old_Val!=0)
-            {
-                RME_COVERAGE_MARKER();
+        /* Erase the start - make it atomic */
+        RME_FETCH_AND(&(RME_KOTBL[Start]),~Start_Mask);
+        /* Erase the middle */
+        _RME_Kotbl_Full_Erase(Start+1, End);
+        /* Erase the end - make it atomic */
+        RME_FETCH_AND(&(RME_KOTBL[End]),~End_Mask);
+    }
+    
+    return 0;
+}
+/* End Function:_RME_Kotbl_Erase *********************************************/
 
-                Undo=1;
-                break;
-            }
-            else
-            {
-                RME_COVERAGE_MARKER();
-                
-                if(RME_COMP_SWAP(&RME_KOTBL[Count],Old_Val,RME_ALLBITS)==0)
-                {
-                    RME_COVERAGE_MARKER();
-                    
-                    Undo=1;
-                    break;
-                }
-                else
-                {
-                    RME_COVERAGE_MARKER();
-                }
-            }
-        }
-        
-        /* See if the middle part failed. If yes, we skip the end marking */
-        if(Undo==0)
+/* Begin Function:_RME_Kotbl_Busy *********************************************
+Description : Find the first populated slot in the kernel object bitmap.
+Input       : rme_ptr_t Slot - The slot to start the search from.
+              rme_ptr_t Limit - The slot to stop the search at.
+Output      : None.
+Return      : rme_ptr_t - The first populated slot, or Limit if there is none.
+******************************************************************************/
+rme_ptr_t _RME_Kotbl_Busy(rme_ptr_t Slot, rme_ptr_t Limit)
+{
+    rme_ptr_t Word;
+    rme_ptr_t Bits;
+    
+    while(Slot<Limit)
+    {
+        Word=Slot>>RME_WORD_ORDER;
+        /* The whole word is populated */
+        if((RME_KOTBL_SUM[RME_KOTBL_SUM_WORD(Word)]&RME_KOTBL_SUM_BIT(Word))!=0)
         {
             RME_COVERAGE_MARKER();
-
-            /* Check&Mark the end */
-            Old_Val=RME_KOTBL[End];
-            if((Old_Val&End_Mask)!=0)
-            {
-                RME_COVERAGE_MARKER();
-
-                Undo=1;
-            }
-            else
-            {
-                RME_COVERAGE_MARKER();
-
-                if(RME_COMP_SWAP(&RME_KOTBL[End],Old_Val,Old_Val|End_Mask)==0)
-                {
-                    RME_COVERAGE_MARKER();
-
-                    Undo=1;
-                }
-                else
-                {
-                    RME_COVERAGE_MARKER();
-                }
-            }
+            
+            return Slot;
         }
         else
         {
             RME_COVERAGE_MARKER();
         }
         
-        /* See if we need to undo. If yes, proceed to unroll and return error */
-        if(Undo!=0)
+        Bits=RME_KOTBL[Word]&RME_MASK_START(Slot&RME_MASK_END(RME_WORD_ORDER-1));
+        if(Bits!=0)
         {
             RME_COVERAGE_MARKER();
-
-            /* Undo the middle part - we do not need CAS here, because write back is always atomic */
-            for(Count--;Count>Start;Count--)
-                RME_KOTBL[Count]=0;
-            /* Undo the first word - need atomic instructions */
-            RME_FETCH_AND(&(RME_KOTBL[Start]),~Start_Mask);
-            /* Return failure */
-            return RME_ERR_KOT_BMP;
+            
+            Slot=(Word<<RME_WORD_ORDER)+RME_LSB_GET(Bits);
+            break;
         }
         else
         {
             RME_COVERAGE_MARKER();
         }
+        
+        Slot=(Word+1)<<RME_WORD_ORDER;
     }
     
-    return 0;
+    if(Slot<Limit)
+    {
+        RME_COVERAGE_MARKER();
+        
+        return Slot;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    return Limit;
 }
-/* End Function:_RME_Kotbl_Mark **********************************************/
+/* End Function:_RME_Kotbl_Busy **********************************************/
 
-/* Begin Function:_RME_Kotbl_Erase ********************************************
-Description : Depopulate the kernel object bitmap contiguously. We do not need 
-              CAS on erasure operations.
-Input       : rme_ptr_t Kaddr - The kernel virtual address.
-              rme_ptr_t Size - The size of the memory to depopulate.
+/* Begin Function:_RME_Kotbl_Free *********************************************
+Description : Find the first free slot in the kernel object bitmap. Summary words
+              that are all ones are skipped as a whole.
+Input       : rme_ptr_t Slot - The slot to start the search from.
+              rme_ptr_t Limit - The slot to stop the search at.
 Output      : None.
-Return      : rme_ret_t - If the operation is successful, it will return 0; else error code.
+Return      : rme_ptr_t - The first free slot, or Limit if there is none.
 ******************************************************************************/
-rme_ret_t _RME_Kotbl_Erase(rme_ptr_t Kaddr, rme_ptr_t Size)
+rme_ptr_t _RME_Kotbl_Free(rme_ptr_t Slot, rme_ptr_t Limit)
 {
-    /* The actual word to start the marking */
-    rme_ptr_t Start;
-    /* The actual word to end the marking */
-    rme_ptr_t End;
-    /* The mask at the start word */
-    rme_ptr_t Start_Mask;
-    /* The mask at the end word */
-    rme_ptr_t End_Mask;
-    rme_ptr_t Count;
-
-    /* Check if the marking is well aligned */
-    if((Kaddr&RME_MASK_END(RME_KMEM_SLOT_ORDER-1))!=0)
+    rme_ptr_t Word;
+    rme_ptr_t Sum;
+    rme_ptr_t Bits;
+    
+    while(Slot<Limit)
+    {
+        Word=Slot>>RME_WORD_ORDER;
+        Sum=RME_KOTBL_SUM[RME_KOTBL_SUM_WORD(Word)];
+        /* All words covered by this summary word are populated */
+        if(Sum==RME_ALLBITS)
+        {
+            RME_COVERAGE_MARKER();
+            
+            Slot=RME_ROUND_DOWN(Slot,RME_WORD_ORDER*2)+RME_POW2(RME_WORD_ORDER*2);
+        }
+        /* This word is populated */
+        else if((Sum&RME_KOTBL_SUM_BIT(Word))!=0)
+        {
+            RME_COVERAGE_MARKER();
+            
+            Slot=(Word+1)<<RME_WORD_ORDER;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+            
+            Bits=(~RME_KOTBL[Word])&RME_MASK_START(Slot&RME_MASK_END(RME_WORD_ORDER-1));
+            if(Bits!=0)
+            {
+                RME_COVERAGE_MARKER();
+                
+                Slot=(Word<<RME_WORD_ORDER)+RME_LSB_GET(Bits);
+                break;
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+            
+            Slot=(Word+1)<<RME_WORD_ORDER;
+        }
+    }
+    
+    if(Slot<Limit)
     {
         RME_COVERAGE_MARKER();
-
-        return RME_ERR_KOT_BMP;
+        
+        return Slot;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
     
-    /* Check if the marking is within range - unnecessary due to the kmem cap range limits */
-    /* if((Kaddr<RME_KMEM_VA_START)||((Kaddr+Size)>(RME_KMEM_VA_START+RME_KMEM_SIZE)))
-        return RME_ERR_KOT_BMP; */
-    
-    /* Round the marking to RME_KMEM_SLOT_ORDER boundary, and rely on compiler for optimization */
-    Start=(Kaddr-RME_KMEM_VA_START)>>RME_KMEM_SLOT_ORDER;
-    Start_Mask=RME_MASK_START(Start&RME_MASK_END(RME_WORD_ORDER-1));
-    Start=Start>>RME_WORD_ORDER;
+    return Limit;
+}
+/* End Function:_RME_Kotbl_Free **********************************************/
+
+/* Begin Function:_RME_Kmem_Find **********************************************
+Description : Find the first free range of kernel memory that is large enough in
+              a kernel memory capability. The result is only a hint, because
+              others may populate the range before we use it; if the creation
+              fails with RME_ERR_CAP_KOTBL, just find again.
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              rme_cid_t Cap_Kmem - The kernel memory capability. 2-Level.
+              rme_ptr_t Size - The size of the range to find.
+              rme_ptr_t Raddr - The relative virtual address to start the search from.
+              rme_ptr_t Align_Order - The alignment of the range to find, in powers
+                                      of 2. Anything smaller than the kernel object
+                                      table slot size means no alignment.
+Output      : None.
+Return      : rme_ret_t - If successful, the relative virtual address of the range;
+                          or an error code.
+******************************************************************************/
+rme_ret_t _RME_Kmem_Find(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Kmem,
+                         rme_ptr_t Size, rme_ptr_t Raddr, rme_ptr_t Align_Order)
+{
+    struct RME_Cap_Kmem* Kmem_Op;
+    rme_ptr_t Type_Ref;
+    rme_ptr_t Vaddr;
+    rme_ptr_t Slot;
+    rme_ptr_t Slot_Num;
+    rme_ptr_t Slot_End;
+    rme_ptr_t Busy;
     
-    End=(Kaddr+Size-1-RME_KMEM_VA_START)>>RME_KMEM_SLOT_ORDER;
-    End_Mask=RME_MASK_END(End&RME_MASK_END(RME_WORD_ORDER-1));
-    End=End>>RME_WORD_ORDER;
+    /* Get the capability slot */
+    RME_CAPTBL_GETCAP(Captbl,Cap_Kmem,RME_CAP_KMEM,struct RME_Cap_Kmem*,Kmem_Op,Type_Ref);
     
-    /* See if the start and end are in the same word */
-    if(Start==End)
+    /* See if the size and alignment make sense */
+    if((Size==0)||(Align_Order>=RME_WORD_BITS)||(Raddr>=(Kmem_Op->End-Kmem_Op->Start)))
     {
         RME_COVERAGE_MARKER();
-
-        /* This address range is not fully populated */
-        if((RME_KOTBL[Start]&(Start_Mask&End_Mask))!=(Start_Mask&End_Mask))
-        {
-            RME_COVERAGE_MARKER();
-
-            return RME_ERR_KOT_BMP;
-        }
-        else
-        {
-            RME_COVERAGE_MARKER();
-        }
-
-        /* Check done, do the unmarking - need atomic operations */
-        RME_FETCH_AND(&(RME_KOTBL[Start]),~(Start_Mask&End_Mask));
+        
+        return RME_ERR_CAP_RANGE;
     }
     else
     {
         RME_COVERAGE_MARKER();
-
-        /* Check the start */
-        if((RME_KOTBL[Start]&Start_Mask)!=Start_Mask)
+    }
+    
+    if(Align_Order<RME_KMEM_SLOT_ORDER)
+    {
+        RME_COVERAGE_MARKER();
+        
+        Align_Order=RME_KMEM_SLOT_ORDER;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    Slot_Num=RME_KOTBL_ROUND(Size)>>RME_KMEM_SLOT_ORDER;
+    Slot_End=(Kmem_Op->End-RME_KMEM_VA_START)>>RME_KMEM_SLOT_ORDER;
+    Vaddr=RME_ROUND_UP(Kmem_Op->Start+Raddr,Align_Order);
+    while(1)
+    {
+        /* See if we went out of range, or wrapped around when aligning */
+        if((Vaddr<Kmem_Op->Start)||(Vaddr>Kmem_Op->End)||((Kmem_Op->End-Vaddr)<Size))
         {
             RME_COVERAGE_MARKER();
-
-            return RME_ERR_KOT_BMP;
+            
+            return RME_ERR_CAP_KOTBL;
         }
         else
         {
             RME_COVERAGE_MARKER();
         }
         
-        /* Check the middle */
-        for(Count=Start+1;Count<End-1;Count++)
-        {
-            if(RME_KOTBL[Count]!=RME_ALLBITS)
-            {
-                RME_COVERAGE_MARKER();
-
-                return RME_ERR_KOT_BMP;
-            }
-            else
-            {
-                RME_COVERAGE_MARKER();
-            }
-        }
-
-        /* Check the end */
-        if((RME_KOTBL[End]&End_Mask)!=End_Mask)
+        Slot=(Vaddr-RME_KMEM_VA_START)>>RME_KMEM_SLOT_ORDER;
+        Busy=_RME_Kotbl_Busy(Slot, Slot+Slot_Num);
+        if(Busy==(Slot+Slot_Num))
         {
             RME_COVERAGE_MARKER();
-
-            return RME_ERR_KOT_BMP;
+            
+            return (rme_ret_t)(Vaddr-Kmem_Op->Start);
         }
         else
         {
             RME_COVERAGE_MARKER();
         }
         
-        /* Erase the start - make it atomic */
-        RME_FETCH_AND(&(RME_KOTBL[Start]),~Start_Mask);
-        /* Erase the middle - do not need atomics here */
-        for(Count=Start+1;Count<End-1;Count++)
-            RME_KOTBL[Count]=0;
-        /* Erase the end - make it atomic */
-        RME_FETCH_AND(&(RME_KOTBL[End]),~End_Mask);
+        /* Skip the populated run, and try again from the next free slot */
+        Slot=_RME_Kotbl_Free(Busy+1, Slot_End);
+        Vaddr=RME_ROUND_UP(RME_KMEM_VA_START+(Slot<<RME_KMEM_SLOT_ORDER),Align_Order);
     }
-    
-    return 0;
 }
-/* End Function:_RME_Kotbl_Erase *********************************************/
+/* End Function:_RME_Kmem_Find ***********************************************/
 
 /* Begin Function:_RME_Kmem_Boot_Crt ******************************************
 Description : This function is used to create boot-time kernel memory capability.
@@ -3146,18 +4691,40 @@ Return      : None.
 void _RME_CPU_Local_Init(struct RME_CPU_Local* CPU_Local, rme_ptr_t CPUID)
 {
     rme_cnt_t Prio_Cnt;
+    rme_cnt_t Count;
     
     CPU_Local->CPUID=CPUID;
     CPU_Local->Cur_Thd=0;
     CPU_Local->Vect_Sig=0;
     CPU_Local->Tick_Sig=0;
+    CPU_Local->Wake_Head=RME_SIG_WAKE_END;
+    CPU_Local->Migr_Head=0;
+#ifdef RME_CYCLE_ACCT
+    CPU_Local->Cycle_Last=RME_CYCLE_GET();
+#endif
+#if(RME_TICKLESS==RME_TRUE)
+    CPU_Local->Tick_Last=RME_Timestamp;
+    CPU_Local->Slice_Last=RME_Timestamp;
+#endif
     
     /* Initialize the run-queue and bitmap */
+    (CPU_Local->Run).Bitmap_Sum=0;
     for(Prio_Cnt=0;Prio_Cnt<RME_MAX_PREEMPT_PRIO;Prio_Cnt++)
     {
         (CPU_Local->Run).Bitmap[Prio_Cnt>>RME_WORD_ORDER]=0;
         __RME_List_Crt(&((CPU_Local->Run).List[Prio_Cnt]));
     }
+    /* No EDF threads yet */
+    __RME_List_Crt(&(CPU_Local->EDF));
+    
+    /* Initialize the capability resolution cache */
+    (CPU_Local->Cap_Cache).Hit=0;
+    (CPU_Local->Cap_Cache).Miss=0;
+    for(Count=0;Count<RME_CAP_CACHE_NUM;Count++)
+    {
+        (CPU_Local->Cap_Cache).Entry[Count].Captbl=0;
+        (CPU_Local->Cap_Cache).Entry[Count].Slot=0;
+    }
 }
 /* End Function:_RME_CPU_Local_Init ******************************************/
 
@@ -3266,6 +4833,8 @@ rme_ret_t __RME_Thd_Fatal(struct RME_Reg_Struct* Reg, rme_ptr_t Fault)
 Description : Insert a thread into the runqueue. In this function we do not check
               if the thread is on the current core, or is runnable, because it 
               should have been checked by someone else.
+              Fixed-priority threads always go to the end of their level. EDF
+              threads go before all of them, in the order of their deadlines.
 Input       : struct RME_Thd_Struct* Thd - The thread to insert.
               rme_ptr_t CPUID - The cpu to consult.
 Output      : None.
@@ -3275,16 +4844,33 @@ rme_ret_t _RME_Run_Ins(struct RME_Thd_Struct* Thd)
 {
     rme_ptr_t Prio;
     struct RME_CPU_Local* CPU_Local;
+    volatile struct RME_List* Next;
     
     Prio=Thd->Sched.Prio;
     CPU_Local=Thd->Sched.CPU_Local;
     /* It can't be unbinded or there must be an error */
     RME_ASSERT(CPU_Local!=RME_THD_UNBINDED);
     
+    /* Find the place to insert. We walk from the end, so fixed-priority threads cost nothing */
+    Next=&((CPU_Local->Run).List[Prio]);
+    if(Thd->Sched.Period!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        while((Next->Prev!=&((CPU_Local->Run).List[Prio]))&&
+              (RME_EDF_BEFORE(Thd,(struct RME_Thd_Struct*)(Next->Prev))))
+            Next=Next->Prev;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
     /* Insert this thread into the runqueue */
-    __RME_List_Ins(&(Thd->Sched.Run),(CPU_Local->Run).List[Prio].Prev,&((CPU_Local->Run).List[Prio]));
-    /* Set the bit in the bitmap */
+    __RME_List_Ins(&(Thd->Sched.Run),Next->Prev,Next);
+    /* Set the bit in the bitmap, and the bit for that word in the summary */
     (CPU_Local->Run).Bitmap[Prio>>RME_WORD_ORDER]|=RME_POW2(Prio&RME_MASK_END(RME_WORD_ORDER-1));
+    (CPU_Local->Run).Bitmap_Sum|=RME_POW2(Prio>>RME_WORD_ORDER);
     
     return 0;
 }
@@ -3316,6 +4902,17 @@ rme_ret_t _RME_Run_Del(struct RME_Thd_Struct* Thd)
         RME_COVERAGE_MARKER();
 
         (CPU_Local->Run).Bitmap[Prio>>RME_WORD_ORDER]&=~(RME_POW2(Prio&RME_MASK_END(RME_WORD_ORDER-1)));
+        /* If this is the last bit in the word, clear it in the summary as well */
+        if((CPU_Local->Run).Bitmap[Prio>>RME_WORD_ORDER]==0)
+        {
+            RME_COVERAGE_MARKER();
+            
+            (CPU_Local->Run).Bitmap_Sum&=~(RME_POW2(Prio>>RME_WORD_ORDER));
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
     }
     else
     {
@@ -3327,35 +4924,24 @@ rme_ret_t _RME_Run_Del(struct RME_Thd_Struct* Thd)
 /* End Function:_RME_Run_Del *************************************************/
 
 /* Begin Function:_RME_Run_High ***********************************************
-Description : Find the thread with the highest priority on the core.
+Description : Find the thread with the highest priority on the core. The summary
+              bitmap tells us the highest word that have any bits set, so this is
+              always two MSB lookups, regardless of the number of priorities.
 Input       : struct RME_CPU_Local* CPU_Local - The CPU-local data structure.
 Output      : None.
 Return      : struct RME_Thd_Struct* - The thread returned.
 ******************************************************************************/
 struct RME_Thd_Struct* _RME_Run_High(struct RME_CPU_Local* CPU_Local)
 {
-    rme_cnt_t Count;
+    rme_ptr_t Word;
     rme_ptr_t Prio;
     
-    /* We start looking for preemption priority levels from the highest */
-    for(Count=RME_PRIO_WORD_NUM-1;Count>=0;Count--)
-    {
-        if((CPU_Local->Run).Bitmap[Count]!=0)
-        {
-            RME_COVERAGE_MARKER();
-
-            break;
-        }
-        else
-        {
-            RME_COVERAGE_MARKER();
-        }
-    }
     /* It must be possible to find one thread per core */
-    RME_ASSERT(Count>=0);
-    /* Get the first "1"'s position in the word */
-    Prio=RME_MSB_GET((CPU_Local->Run).Bitmap[Count]);
-    Prio+=Count<<RME_WORD_ORDER;
+    RME_ASSERT((CPU_Local->Run).Bitmap_Sum!=0);
+    /* Get the highest word that have any bits set, then the first "1"'s position in it */
+    Word=RME_MSB_GET((CPU_Local->Run).Bitmap_Sum);
+    Prio=RME_MSB_GET((CPU_Local->Run).Bitmap[Word]);
+    Prio+=Word<<RME_WORD_ORDER;
     /* Now there is something at this priority level. Get it and start to run */
     return (struct RME_Thd_Struct*)((CPU_Local->Run).List[Prio].Next);
 }
@@ -3397,10 +4983,299 @@ rme_ret_t _RME_Run_Notif(struct RME_Thd_Struct* Thd)
     {
         RME_COVERAGE_MARKER();
     }
-
-    return 0;
+
+    return 0;
+}
+/* End Function:_RME_Run_Notif ***********************************************/
+
+/* Begin Function:_RME_Run_EDF_Ins ********************************************
+Description : Insert a thread into the EDF list of its core, in the order of the
+              deadlines.
+Input       : struct RME_Thd_Struct* Thd - The thread to insert.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Run_EDF_Ins(struct RME_Thd_Struct* Thd)
+{
+    struct RME_CPU_Local* CPU_Local;
+    volatile struct RME_List* Next;
+    
+    CPU_Local=Thd->Sched.CPU_Local;
+    
+    /* New periods are usually later than the existing ones, so we walk from the end */
+    Next=&(CPU_Local->EDF);
+    while((Next->Prev!=&(CPU_Local->EDF))&&(RME_EDF_BEFORE(Thd,RME_EDF_THD(Next->Prev))))
+        Next=Next->Prev;
+    
+    __RME_List_Ins(&(Thd->Sched.EDF),Next->Prev,Next);
+}
+/* End Function:_RME_Run_EDF_Ins *********************************************/
+
+/* Begin Function:_RME_Run_EDF_Rep ********************************************
+Description : Begin the new periods of all the EDF threads on this core that are
+              due. Their budgets are replenished, and those that have run out of
+              budget are put back into the run queue. The EDF list is in the order
+              of the deadlines, so we only look at the threads that are due, and
+              one more. This function includes no kernel send, but the caller needs
+              to call _RME_Kern_High after it.
+Input       : struct RME_CPU_Local* CPU_Local - The CPU-local data structure.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Run_EDF_Rep(struct RME_CPU_Local* CPU_Local)
+{
+    struct RME_Thd_Struct* Thd_Struct;
+    rme_ptr_t Now;
+    
+    Now=RME_Timestamp;
+    while(CPU_Local->EDF.Next!=&(CPU_Local->EDF))
+    {
+        Thd_Struct=RME_EDF_THD(CPU_Local->EDF.Next);
+        if(((rme_cnt_t)(Thd_Struct->Sched.Deadline-Now))>0)
+        {
+            RME_COVERAGE_MARKER();
+            
+            break;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+        
+        /* Begin the next period. If we are late by more than a period, begin it now */
+        Thd_Struct->Sched.Deadline+=Thd_Struct->Sched.Period;
+        if(((rme_cnt_t)(Thd_Struct->Sched.Deadline-Now))<=0)
+        {
+            RME_COVERAGE_MARKER();
+            
+            Thd_Struct->Sched.Deadline=Now+Thd_Struct->Sched.Period;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+        __RME_List_Del(Thd_Struct->Sched.EDF.Prev,Thd_Struct->Sched.EDF.Next);
+        _RME_Run_EDF_Ins(Thd_Struct);
+        
+        /* The budget is not accumulated; whatever is left from the last period is lost */
+        if(Thd_Struct->Sched.Slices<RME_THD_INF_TIME)
+        {
+            RME_COVERAGE_MARKER();
+            
+            Thd_Struct->Sched.Slices=Thd_Struct->Sched.Budget;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+        
+        /* The deadline changed, so it needs a new place in the run queue. If it ran
+         * out of budget, it can run again now. Blocked or faulted threads stay */
+        if((Thd_Struct->Sched.State==RME_THD_RUNNING)||(Thd_Struct->Sched.State==RME_THD_READY))
+        {
+            RME_COVERAGE_MARKER();
+            
+            _RME_Run_Del(Thd_Struct);
+            _RME_Run_Ins(Thd_Struct);
+        }
+        else if(Thd_Struct->Sched.State==RME_THD_TIMEOUT)
+        {
+            RME_COVERAGE_MARKER();
+            
+            Thd_Struct->Sched.State=RME_THD_READY;
+            _RME_Run_Ins(Thd_Struct);
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+    }
+}
+/* End Function:_RME_Run_EDF_Rep *********************************************/
+
+/* Begin Function:_RME_Run_Migr ***********************************************
+Description : Drain the migration mailbox of this core, and adopt the threads that
+              other cores moved here. The thread becomes ours, joins its new
+              scheduler and gets its run queue and EDF list membership back. If it
+              is still blocked, we look at its endpoint again, because the signals
+              sent to it while it was moving were only counted. If the scheduler
+              was freed before we got here, the thread is freed too, just like
+              _RME_Thd_Sched_Free does. This function includes no kernel send, but
+              the caller needs to call _RME_Kern_High after it.
+Input       : struct RME_CPU_Local* CPU_Local - The CPU-local data structure.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Run_Migr(struct RME_CPU_Local* CPU_Local)
+{
+    struct RME_Thd_Struct* Thd_Struct;
+    struct RME_Sig_Struct* Sig_Struct;
+    rme_ptr_t Thd_Next;
+    rme_ptr_t Old_Value;
+    
+    /* This is called on every tick, and the mailbox is empty most of the time */
+    if(CPU_Local->Migr_Head==0)
+    {
+        RME_COVERAGE_MARKER();
+        
+        return;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Take the whole mailbox at once */
+    do
+    {
+        Thd_Next=CPU_Local->Migr_Head;
+    }
+    while(RME_COMP_SWAP(&(CPU_Local->Migr_Head),Thd_Next,0)==0);
+    
+    while(Thd_Next!=0)
+    {
+        Thd_Struct=(struct RME_Thd_Struct*)Thd_Next;
+        Thd_Next=Thd_Struct->Sched.Migr_Next;
+        Thd_Struct->Sched.Migr_Next=0;
+        
+        /* Make it ours. This must be a full barrier, so that any sender that still sees
+         * it moving after this will have its signal seen below */
+        RME_COMP_SWAP((rme_ptr_t*)&(Thd_Struct->Sched.CPU_Local),
+                      (rme_ptr_t)RME_THD_MIGRATING,
+                      (rme_ptr_t)CPU_Local);
+        
+        /* The scheduler is still there, because the core that posted the thread keeps
+         * a reference to it until we look */
+        if(Thd_Struct->Sched.Parent->Sched.CPU_Local!=CPU_Local)
+        {
+            RME_COVERAGE_MARKER();
+            
+            /* The scheduler is gone, and we no longer need it. Nobody can take
+             * notifications for it now */
+            RME_FETCH_ADD(&(Thd_Struct->Sched.Parent->Sched.Refcnt), -1);
+            if(Thd_Struct->Sched.Sched_Sig!=0)
+            {
+                RME_COVERAGE_MARKER();
+
+                RME_FETCH_ADD(&(Thd_Struct->Sched.Sched_Sig->Refcnt), -1);
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+            
+            if(Thd_Struct->Sched.State==RME_THD_BLOCKED)
+            {
+                RME_COVERAGE_MARKER();
+                
+                __RME_Set_Syscall_Retval(&(Thd_Struct->Cur_Reg->Reg),RME_ERR_SIV_FREE);
+                Thd_Struct->Sched.Signal->Thd=0;
+                Thd_Struct->Sched.Signal=0;
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+            
+            /* We keep the fault if there is one, and wait for the Exec_Set to clear it */
+            if(Thd_Struct->Sched.State!=RME_THD_FAULT)
+            {
+                RME_COVERAGE_MARKER();
+                
+                Thd_Struct->Sched.State=RME_THD_TIMEOUT;
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+            Thd_Struct->Sched.Slices=0;
+            Thd_Struct->Sched.Period=0;
+            RME_WRITE_RELEASE((rme_ptr_t*)&(Thd_Struct->Sched.CPU_Local),(rme_ptr_t)RME_THD_UNBINDED);
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+            
+            /* The reference taken when the thread was posted is now the child's. Keep
+             * the deadline; the timestamp is the same on all cores */
+            if(Thd_Struct->Sched.Period!=0)
+            {
+                RME_COVERAGE_MARKER();
+                
+                _RME_Run_EDF_Ins(Thd_Struct);
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+            
+            if(Thd_Struct->Sched.State==RME_THD_READY)
+            {
+                RME_COVERAGE_MARKER();
+                
+                _RME_Run_Ins(Thd_Struct);
+            }
+            else if(Thd_Struct->Sched.State==RME_THD_BLOCKED)
+            {
+                RME_COVERAGE_MARKER();
+                
+                /* Take one signal for it, just like _RME_Kern_Wake does */
+                Sig_Struct=Thd_Struct->Sched.Signal;
+                do
+                {
+                    Old_Value=Sig_Struct->Signal_Num;
+                }
+                while((Old_Value!=0)&&(RME_COMP_SWAP(&(Sig_Struct->Signal_Num),Old_Value,Old_Value-1)==0));
+                
+                if(Old_Value!=0)
+                {
+                    RME_COVERAGE_MARKER();
+                    
+                    __RME_Set_Syscall_Retval(&(Thd_Struct->Cur_Reg->Reg), 1);
+                    if(Sig_Struct->Ring_Num!=0)
+                    {
+                        RME_COVERAGE_MARKER();
+
+                        _RME_Sig_Ring_Get(Sig_Struct, &(Thd_Struct->Cur_Reg->Reg));
+                    }
+                    else
+                    {
+                        RME_COVERAGE_MARKER();
+                    }
+                    if(Thd_Struct->Sched.Slices!=0)
+                    {
+                        RME_COVERAGE_MARKER();
+
+                        _RME_Run_Ins(Thd_Struct);
+                        Thd_Struct->Sched.State=RME_THD_READY;
+                    }
+                    else
+                    {
+                        RME_COVERAGE_MARKER();
+
+                        Thd_Struct->Sched.State=RME_THD_TIMEOUT;
+                    }
+                    
+                    Sig_Struct->Thd=0;
+                }
+                else
+                {
+                    RME_COVERAGE_MARKER();
+                }
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+        }
+    }
+    
+#if(RME_TICKLESS==RME_TRUE)
+    /* The EDF periods of the new threads may begin before the next event */
+    _RME_Tick_Rearm(CPU_Local->Cur_Thd);
+#endif
 }
-/* End Function:_RME_Run_Notif ***********************************************/
+/* End Function:_RME_Run_Migr ************************************************/
 
 /* Begin Function:_RME_Run_Swt ************************************************
 Description : Switch the register set and page table to another thread. 
@@ -3418,7 +5293,17 @@ rme_ret_t _RME_Run_Swt(struct RME_Reg_Struct* Reg,
     struct RME_Cap_Pgtbl* Curr_Pgtbl;
     struct RME_Inv_Struct* Next_Inv_Top;
     struct RME_Cap_Pgtbl* Next_Pgtbl;
-    
+
+    RME_TRACE_EVENT(RME_TRACE_THD_SWT,Curr_Thd->Sched.TID,Next_Thd->Sched.TID);
+#ifdef RME_CYCLE_ACCT
+    /* Charge the cycles used since the last switch to the thread that used them */
+    _RME_Cycle_Charge(Curr_Thd);
+#endif
+#if(RME_TICKLESS==RME_TRUE)
+    /* Charge the time used so far, and arm the timer for the next thread */
+    _RME_Tick_Charge(Curr_Thd);
+    _RME_Tick_Rearm(Next_Thd);
+#endif
     /* Save current context */
     __RME_Thd_Reg_Copy(&(Curr_Thd->Cur_Reg->Reg), Reg);
     __RME_Thd_Cop_Save(Reg, &(Curr_Thd->Cur_Reg->Cop_Reg));
@@ -3733,7 +5618,7 @@ rme_ret_t _RME_Proc_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme
     RME_FETCH_ADD(&(Object->Pgtbl->Head.Type_Ref), -1);
         
     /* Try to depopulate the area - this must be successful */
-    RME_ASSERT(_RME_Kotbl_Erase((rme_ptr_t)Object, RME_PROC_SIZE)!=0);
+    RME_ASSERT(_RME_Kotbl_Erase((rme_ptr_t)Object, RME_PROC_SIZE)==0);
     
     return 0;
 }
@@ -3942,6 +5827,7 @@ rme_ret_t _RME_Thd_Boot_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl,
     /* Set this initially to 1 to make it virtually unfreeable & undeletable */
     Thd_Struct->Sched.Refcnt=1;
     Thd_Struct->Sched.Slices=RME_THD_INIT_TIME;
+    Thd_Struct->Sched.Period=0;
     Thd_Struct->Sched.State=RME_THD_RUNNING;
     Thd_Struct->Sched.Signal=0;
     Thd_Struct->Sched.Prio=Prio;
@@ -3949,6 +5835,11 @@ rme_ret_t _RME_Thd_Boot_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl,
     Thd_Struct->Sched.Sched_Sig=0;
     /* Bind the thread to the current CPU */
     Thd_Struct->Sched.CPU_Local=CPU_Local;
+    Thd_Struct->Sched.Migr_Next=0;
+#ifdef RME_CYCLE_ACCT
+    Thd_Struct->Sched.Cycles=0;
+    Thd_Struct->Sched.Inv_Cycles=0;
+#endif
     /* This is a marking that this thread haven't sent any notifications */
     __RME_List_Crt(&(Thd_Struct->Sched.Notif));
     __RME_List_Crt(&(Thd_Struct->Sched.Event));
@@ -3970,7 +5861,8 @@ rme_ret_t _RME_Thd_Boot_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl,
      * Setting execution information for this is also prohibited. */
     Thd_Crt->Head.Flags=RME_THD_FLAG_SCHED_PRIO|RME_THD_FLAG_SCHED_PARENT|
                         RME_THD_FLAG_XFER_DST|RME_THD_FLAG_XFER_SRC|
-                        RME_THD_FLAG_SCHED_RCV|RME_THD_FLAG_SWT;
+                        RME_THD_FLAG_SCHED_RCV|RME_THD_FLAG_SWT|
+                        RME_THD_FLAG_SCHED_EDF|RME_THD_FLAG_CYCLE_GET;
     Thd_Crt->TID=0;
     
     /* Insert this into the runqueue, and set current thread to it */
@@ -4057,12 +5949,18 @@ rme_ret_t _RME_Thd_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_
     Thd_Struct->Sched.TID=0;
     Thd_Struct->Sched.Refcnt=0;
     Thd_Struct->Sched.Slices=0;
+    Thd_Struct->Sched.Period=0;
     Thd_Struct->Sched.State=RME_THD_TIMEOUT;
     Thd_Struct->Sched.Signal=0;
     Thd_Struct->Sched.Max_Prio=Max_Prio;
     Thd_Struct->Sched.Sched_Sig=0;
     /* Currently the thread is not binded to any particular CPU */
     Thd_Struct->Sched.CPU_Local=RME_THD_UNBINDED;
+    Thd_Struct->Sched.Migr_Next=0;
+#ifdef RME_CYCLE_ACCT
+    Thd_Struct->Sched.Cycles=0;
+    Thd_Struct->Sched.Inv_Cycles=0;
+#endif
     /* This is a marking that this thread haven't sent any notifications */
     __RME_List_Crt(&(Thd_Struct->Sched.Notif));
     __RME_List_Crt(&(Thd_Struct->Sched.Event));
@@ -4083,7 +5981,8 @@ rme_ret_t _RME_Thd_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_
                         RME_THD_FLAG_SCHED_CHILD|RME_THD_FLAG_SCHED_PARENT|
                         RME_THD_FLAG_SCHED_PRIO|RME_THD_FLAG_SCHED_FREE|
                         RME_THD_FLAG_SCHED_RCV|RME_THD_FLAG_SWT|
-                        RME_THD_FLAG_XFER_SRC|RME_THD_FLAG_XFER_DST;
+                        RME_THD_FLAG_XFER_SRC|RME_THD_FLAG_XFER_DST|
+                        RME_THD_FLAG_SCHED_EDF|RME_THD_FLAG_CYCLE_GET;
     Thd_Crt->TID=0;
     
     /* Creation complete */
@@ -4135,6 +6034,20 @@ rme_ret_t _RME_Thd_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_
         RME_COVERAGE_MARKER();
     }
     
+    /* See if some thread moving to another core still refers to it as the scheduler.
+     * That core will let go of it when it adopts that thread */
+    if(Thd_Struct->Sched.Refcnt!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        RME_CAP_DEFROST(Thd_Del,Type_Ref);
+        return RME_ERR_PTH_REFCNT;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
     /* Now we can safely delete the cap */
     RME_CAP_REMDEL(Thd_Del,Type_Ref);
     
@@ -4153,7 +6066,7 @@ rme_ret_t _RME_Thd_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_
     RME_FETCH_ADD(&(Thd_Struct->Sched.Proc->Refcnt), -1);
     
     /* Try to depopulate the area - this must be successful */
-    RME_ASSERT(_RME_Kotbl_Erase((rme_ptr_t)Thd_Struct,RME_THD_SIZE)!=0);
+    RME_ASSERT(_RME_Kotbl_Erase((rme_ptr_t)Thd_Struct,RME_THD_SIZE)==0);
     
     return 0;
 }
@@ -4224,32 +6137,273 @@ rme_ret_t _RME_Thd_Exec_Set(struct RME_Cap_Captbl* Captbl,
     
     return 0;
 }
-/* End Function:_RME_Thd_Exec_Set ********************************************/
+/* End Function:_RME_Thd_Exec_Set ********************************************/
+
+/* Begin Function:_RME_Thd_Hyp_Set ********************************************
+Description : Set the thread as hypervisor-managed. This means that the thread's
+              register set will be saved to somewhere that is indicated by the user,
+              instead of in the kernel data structures.
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              rme_cid_t Cap_Thd - The capability to the thread. 2-Level.
+              rme_ptr_t Kaddr - The kernel-accessible virtual address to save the register set to.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; or an error code.
+******************************************************************************/
+rme_ret_t _RME_Thd_Hyp_Set(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Thd, rme_ptr_t Kaddr)
+{
+    struct RME_Cap_Thd* Thd_Op;
+    struct RME_Thd_Struct* Thd_Struct;
+    rme_ptr_t Type_Ref;
+    
+    /* Get the capability slot */
+    RME_CAPTBL_GETCAP(Captbl,Cap_Thd,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Op,Type_Ref);
+    /* Check if the target cap is not frozen and allows such operations */
+    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_HYP_SET);
+    
+    /* See if the target thread is already binded. If no or incorrect, we just quit */
+    Thd_Struct=RME_CAP_GETOBJ(Thd_Op,struct RME_Thd_Struct*);
+    if(Thd_Struct->Sched.CPU_Local!=RME_CPU_LOCAL())
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PTH_INVSTATE;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Set the thread's register storage back to default if the address passed in is null */
+    if(Kaddr==0)
+    {
+        RME_COVERAGE_MARKER();
+
+        Thd_Struct->Cur_Reg=&(Thd_Struct->Def_Reg);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+        
+        /* Register external save area must be aligned to word boundary and accessible to the kernel */
+        if(RME_IS_ALIGNED(Kaddr)&&(Kaddr>=RME_HYP_VA_START)&&
+           ((Kaddr+sizeof(struct RME_Thd_Regs))<(RME_HYP_VA_START+RME_HYP_SIZE)))
+        {
+            RME_COVERAGE_MARKER();
+
+            Thd_Struct->Cur_Reg=(struct RME_Thd_Regs*)Kaddr;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+
+            return RME_ERR_PTH_PGTBL;
+        }
+    }
+    
+    return 0;
+}
+/* End Function:_RME_Thd_Hyp_Set *********************************************/
+
+/* Begin Function:_RME_Thd_Sched_Bind *****************************************
+Description : Set a thread's priority level, and its scheduler thread. When there
+              is any state change on this thread, a notification will be sent to
+              scheduler thread. If the state of the thread changes for multiple
+              times, then only the most recent state will be in the scheduler's 
+              receive queue.
+              The scheduler and the threads that it schedule must be on the same
+              core. When a thread wants to go from one core to another, its notification
+              to the scheduler must all be processed, and it must have no scheduler
+              notifications in itself (That is, unbinded). 
+              This must be called on the same core with the Cap_Thd_Sched, and the
+              Cap_Thd itself must be free.
+              It is impossible to set a thread's priority beyond its maximum priority. 
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              rme_cid_t Cap_Thd - The capability to the thread. 2-Level.
+              rme_cid_t Cap_Thd_Sched - The scheduler thread. 2-Level.
+              rme_cid_t Cap_Sig - The signal endpoint for scheduler notifications. This signal
+                                  endpoint will be sent to whenever this thread has a fault, or
+                                  timeouts. This is purely optional; if it is not needed, pass
+                                  in RME_CAPID_NULL which is a number smaller than zero.
+              rme_tid_t TID - The thread ID. This is user-supplied, and the kernel will not
+                              check whether there are two threads that have the same TID.
+              rme_ptr_t Prio - The priority level, higher is more critical.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; or an error code.
+******************************************************************************/
+rme_ret_t _RME_Thd_Sched_Bind(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Thd,
+                              rme_cid_t Cap_Thd_Sched, rme_cid_t Cap_Sig, rme_tid_t TID, rme_ptr_t Prio)
+{
+    struct RME_Cap_Thd* Thd_Op;
+    struct RME_Cap_Thd* Thd_Sched;
+    struct RME_Cap_Sig* Sig_Op;
+    struct RME_Thd_Struct* Thd_Op_Struct;
+    struct RME_Thd_Struct* Thd_Sched_Struct;
+    struct RME_Sig_Struct* Sig_Op_Struct;
+    struct RME_CPU_Local* Old_CPU_Local;
+    struct RME_CPU_Local* CPU_Local;
+    rme_ptr_t Type_Ref;
+    
+    /* Get the capability slot */
+    RME_CAPTBL_GETCAP(Captbl,Cap_Thd,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Op,Type_Ref);
+    RME_CAPTBL_GETCAP(Captbl,Cap_Thd_Sched,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Sched,Type_Ref);
+    /* Check if the target cap is not frozen and allows such operations */
+    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_CHILD);
+    RME_CAP_CHECK(Thd_Sched,RME_THD_FLAG_SCHED_PARENT);
+    
+    /* See if we need the signal endpoint for this operation */
+    if(Cap_Sig<RME_CAPID_NULL)
+    {
+        RME_COVERAGE_MARKER();
+
+        RME_CAPTBL_GETCAP(Captbl,Cap_Sig,RME_CAP_SIG,struct RME_Cap_Sig*,Sig_Op,Type_Ref);
+        RME_CAP_CHECK(Sig_Op,RME_SIG_FLAG_SCHED);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+
+    	Sig_Op=0;
+    }
+
+    /* Check the TID passed in to see whether it is good */
+    if((TID>=RME_THD_FAULT_FLAG)||(TID<0))
+    {
+        RME_COVERAGE_MARKER();
+
+    	return RME_ERR_PTH_TID;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+
+    /* See if the target thread is already binded. If yes, we just quit */
+    Thd_Op_Struct=RME_CAP_GETOBJ(Thd_Op,struct RME_Thd_Struct*);
+    Old_CPU_Local=Thd_Op_Struct->Sched.CPU_Local;
+    if(Old_CPU_Local!=RME_THD_UNBINDED)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PTH_INVSTATE;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* See if the parent thread is on the same core with the current processor */
+    CPU_Local=RME_CPU_LOCAL();
+    Thd_Sched_Struct=RME_CAP_GETOBJ(Thd_Sched,struct RME_Thd_Struct*);
+    if(Thd_Sched_Struct->Sched.CPU_Local!=CPU_Local)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PTH_INVSTATE;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+
+    /* See if we are trying to bind to ourself. This is prohibited */
+    if(Thd_Op_Struct==Thd_Sched_Struct)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PTH_NOTIF;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* See if the priority relationship is correct */
+    if(Thd_Sched_Struct->Sched.Max_Prio<Prio)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PTH_PRIO;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+
+    /* Yes, it is on the current processor. Try to bind the thread */
+    if(RME_COMP_SWAP((rme_ptr_t*)&(Thd_Op_Struct->Sched.CPU_Local),
+                     (rme_ptr_t)Old_CPU_Local,
+                     (rme_ptr_t)CPU_Local)==0)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PTH_CONFLICT;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Binding successful. Do operations to finish this. There's no need to worry about
+     * other cores' operations on this thread because this thread is already binded
+     * to this core */
+    Thd_Op_Struct->Sched.Parent=Thd_Sched_Struct;
+    Thd_Op_Struct->Sched.Prio=Prio;
+    Thd_Op_Struct->Sched.TID=TID;
+
+    /* Tie the signal endpoint to it if not zero */
+    if(Sig_Op==0)
+    {
+        RME_COVERAGE_MARKER();
+
+    	Thd_Op_Struct->Sched.Sched_Sig=0;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+
+        Sig_Op_Struct=RME_CAP_GETOBJ(Sig_Op,struct RME_Sig_Struct*);
+    	Thd_Op_Struct->Sched.Sched_Sig=Sig_Op_Struct;
+        /* Increase the reference count of the signal endpoint(not the capability!) */
+        RME_FETCH_ADD(&(Sig_Op_Struct->Refcnt), 1);
+    }
+
+    /* Other cores may be changing this when they post threads to it */
+    RME_FETCH_ADD(&(Thd_Sched_Struct->Sched.Refcnt), 1);
+    
+    return 0;
+}
+/* End Function:_RME_Thd_Sched_Bind ******************************************/
 
-/* Begin Function:_RME_Thd_Hyp_Set ********************************************
-Description : Set the thread as hypervisor-managed. This means that the thread's
-              register set will be saved to somewhere that is indicated by the user,
-              instead of in the kernel data structures.
+/* Begin Function:_RME_Thd_Sched_Prio *****************************************
+Description : Change a thread's priority level. This can only be called from the
+              core that have the thread binded.
+              This system call can cause a potential context switch.
+              It is impossible to set a thread's priority beyond its maximum priority. 
 Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              struct RME_Reg_Struct* Reg - The current register set.
               rme_cid_t Cap_Thd - The capability to the thread. 2-Level.
-              rme_ptr_t Kaddr - The kernel-accessible virtual address to save the register set to.
+              rme_ptr_t Prio - The priority level, higher is more critical.
 Output      : None.
 Return      : rme_ret_t - If successful, 0; or an error code.
 ******************************************************************************/
-rme_ret_t _RME_Thd_Hyp_Set(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Thd, rme_ptr_t Kaddr)
+rme_ret_t _RME_Thd_Sched_Prio(struct RME_Cap_Captbl* Captbl,
+                              struct RME_Reg_Struct* Reg,
+                              rme_cid_t Cap_Thd, rme_ptr_t Prio)
 {
     struct RME_Cap_Thd* Thd_Op;
     struct RME_Thd_Struct* Thd_Struct;
+    struct RME_CPU_Local* CPU_Local;
     rme_ptr_t Type_Ref;
     
     /* Get the capability slot */
     RME_CAPTBL_GETCAP(Captbl,Cap_Thd,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Op,Type_Ref);
     /* Check if the target cap is not frozen and allows such operations */
-    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_HYP_SET);
+    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_PRIO);
     
-    /* See if the target thread is already binded. If no or incorrect, we just quit */
-    Thd_Struct=RME_CAP_GETOBJ(Thd_Op,struct RME_Thd_Struct*);
-    if(Thd_Struct->Sched.CPU_Local!=RME_CPU_LOCAL())
+    /* See if the target thread is already binded to this core. If no, we just quit */
+    CPU_Local=RME_CPU_LOCAL();
+    Thd_Struct=(struct RME_Thd_Struct*)Thd_Op->Head.Object;
+    if(Thd_Struct->Sched.CPU_Local!=CPU_Local)
     {
         RME_COVERAGE_MARKER();
 
@@ -4260,222 +6414,314 @@ rme_ret_t _RME_Thd_Hyp_Set(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Thd, rme
         RME_COVERAGE_MARKER();
     }
     
-    /* Set the thread's register storage back to default if the address passed in is null */
-    if(Kaddr==0)
+    /* See if the priority relationship is correct */
+    if(Thd_Struct->Sched.Max_Prio<Prio)
     {
         RME_COVERAGE_MARKER();
 
-        Thd_Struct->Cur_Reg=&(Thd_Struct->Def_Reg);
+        return RME_ERR_PTH_PRIO;
     }
     else
     {
         RME_COVERAGE_MARKER();
+    }
+    
+    /* Now save the system call return value to the caller stack */
+    __RME_Set_Syscall_Retval(Reg,0);
+    
+    /* See if this thread is currently running, or is runnable. If yes, it must be
+     * in the run queue. Remove it from there and change priority, after changing
+     * priority, put it back, and see if we need a reschedule. */
+    if((Thd_Struct->Sched.State==RME_THD_RUNNING)||(Thd_Struct->Sched.State==RME_THD_READY))
+    {
+        RME_COVERAGE_MARKER();
+
+        _RME_Run_Del(Thd_Struct);
+        Thd_Struct->Sched.Prio=Prio;
+        _RME_Run_Ins(Thd_Struct);
         
-        /* Register external save area must be aligned to word boundary and accessible to the kernel */
-        if(RME_IS_ALIGNED(Kaddr)&&(Kaddr>=RME_HYP_VA_START)&&
-           ((Kaddr+sizeof(struct RME_Thd_Regs))<(RME_HYP_VA_START+RME_HYP_SIZE)))
+        /* Get the current highest-priority running thread */
+        Thd_Struct=_RME_Run_High(CPU_Local);
+        RME_ASSERT(Thd_Struct->Sched.Prio>=(CPU_Local->Cur_Thd)->Sched.Prio);
+        
+        /* See if we need a context switch */
+        if(Thd_Struct->Sched.Prio>(CPU_Local->Cur_Thd)->Sched.Prio)
         {
             RME_COVERAGE_MARKER();
 
-            Thd_Struct->Cur_Reg=(struct RME_Thd_Regs*)Kaddr;
+            /* This will cause a solid context switch - The current thread will be set
+             * to ready, and we will set the thread that we switch to to be running. */
+            _RME_Run_Swt(Reg,CPU_Local->Cur_Thd,Thd_Struct);
+            (CPU_Local->Cur_Thd)->Sched.State=RME_THD_READY;
+            Thd_Struct->Sched.State=RME_THD_RUNNING;
+            CPU_Local->Cur_Thd=Thd_Struct;
         }
         else
         {
             RME_COVERAGE_MARKER();
-
-            return RME_ERR_PTH_PGTBL;
         }
     }
+    else
+    {
+        RME_COVERAGE_MARKER();
+
+        Thd_Struct->Sched.Prio=Prio;
+    }
     
     return 0;
 }
-/* End Function:_RME_Thd_Hyp_Set *********************************************/
+/* End Function:_RME_Thd_Sched_Prio ******************************************/
 
-/* Begin Function:_RME_Thd_Sched_Bind *****************************************
-Description : Set a thread's priority level, and its scheduler thread. When there
-              is any state change on this thread, a notification will be sent to
-              scheduler thread. If the state of the thread changes for multiple
-              times, then only the most recent state will be in the scheduler's 
-              receive queue.
-              The scheduler and the threads that it schedule must be on the same
-              core. When a thread wants to go from one core to another, its notification
-              to the scheduler must all be processed, and it must have no scheduler
-              notifications in itself (That is, unbinded). 
-              This must be called on the same core with the Cap_Thd_Sched, and the
-              Cap_Thd itself must be free.
-              It is impossible to set a thread's priority beyond its maximum priority. 
+/* Begin Function:_RME_Thd_Sched_Free *****************************************
+Description : Free a thread from its current binding. This function can only be
+              executed from the same core on with the thread.
+              This system call can cause a potential context switch.
 Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              struct RME_Reg_Struct* Reg - The current register set.
               rme_cid_t Cap_Thd - The capability to the thread. 2-Level.
-              rme_cid_t Cap_Thd_Sched - The scheduler thread. 2-Level.
-              rme_cid_t Cap_Sig - The signal endpoint for scheduler notifications. This signal
-                                  endpoint will be sent to whenever this thread has a fault, or
-                                  timeouts. This is purely optional; if it is not needed, pass
-                                  in RME_CAPID_NULL which is a number smaller than zero.
-              rme_tid_t TID - The thread ID. This is user-supplied, and the kernel will not
-                              check whether there are two threads that have the same TID.
-              rme_ptr_t Prio - The priority level, higher is more critical.
 Output      : None.
 Return      : rme_ret_t - If successful, 0; or an error code.
 ******************************************************************************/
-rme_ret_t _RME_Thd_Sched_Bind(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Thd,
-                              rme_cid_t Cap_Thd_Sched, rme_cid_t Cap_Sig, rme_tid_t TID, rme_ptr_t Prio)
+rme_ret_t _RME_Thd_Sched_Free(struct RME_Cap_Captbl* Captbl, 
+                              struct RME_Reg_Struct* Reg, rme_cid_t Cap_Thd)
 {
     struct RME_Cap_Thd* Thd_Op;
-    struct RME_Cap_Thd* Thd_Sched;
-    struct RME_Cap_Sig* Sig_Op;
-    struct RME_Thd_Struct* Thd_Op_Struct;
-    struct RME_Thd_Struct* Thd_Sched_Struct;
-    struct RME_Sig_Struct* Sig_Op_Struct;
-    struct RME_CPU_Local* Old_CPU_Local;
+    struct RME_Thd_Struct* Thd_Struct;
+    /* These are used to free the thread */
     struct RME_CPU_Local* CPU_Local;
     rme_ptr_t Type_Ref;
     
     /* Get the capability slot */
     RME_CAPTBL_GETCAP(Captbl,Cap_Thd,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Op,Type_Ref);
-    RME_CAPTBL_GETCAP(Captbl,Cap_Thd_Sched,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Sched,Type_Ref);
     /* Check if the target cap is not frozen and allows such operations */
-    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_CHILD);
-    RME_CAP_CHECK(Thd_Sched,RME_THD_FLAG_SCHED_PARENT);
+    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_FREE);
     
-    /* See if we need the signal endpoint for this operation */
-    if(Cap_Sig<RME_CAPID_NULL)
+    /* See if the target thread is already binded. If no or binded to other cores, we just quit */
+    CPU_Local=RME_CPU_LOCAL();
+    Thd_Struct=(struct RME_Thd_Struct*)Thd_Op->Head.Object;
+    if(Thd_Struct->Sched.CPU_Local!=CPU_Local)
     {
         RME_COVERAGE_MARKER();
 
-        RME_CAPTBL_GETCAP(Captbl,Cap_Sig,RME_CAP_SIG,struct RME_Cap_Sig*,Sig_Op,Type_Ref);
-        RME_CAP_CHECK(Sig_Op,RME_SIG_FLAG_SCHED);
+        return RME_ERR_PTH_INVSTATE;
     }
     else
     {
         RME_COVERAGE_MARKER();
-
-    	Sig_Op=0;
     }
-
-    /* Check the TID passed in to see whether it is good */
-    if((TID>=RME_THD_FAULT_FLAG)||(TID<0))
+    
+    /* Am I referenced by someone as a scheduler? If yes, we cannot unbind. Because
+     * boot-time thread's refcnt will never be 0, thus they will never pass this checking */
+    if(Thd_Struct->Sched.Refcnt!=0)
     {
         RME_COVERAGE_MARKER();
 
-    	return RME_ERR_PTH_TID;
+        return RME_ERR_PTH_REFCNT;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
+    
+    /* Decrease the parent's reference count */
+    RME_FETCH_ADD(&(Thd_Struct->Sched.Parent->Sched.Refcnt), -1);
+    
+    /* See if we have any events sent to the parent. If yes, remove that event */
+    if(Thd_Struct->Sched.Notif.Next!=&(Thd_Struct->Sched.Notif))
+    {
+        RME_COVERAGE_MARKER();
 
-    /* See if the target thread is already binded. If yes, we just quit */
-    Thd_Op_Struct=RME_CAP_GETOBJ(Thd_Op,struct RME_Thd_Struct*);
-    Old_CPU_Local=Thd_Op_Struct->Sched.CPU_Local;
-    if(Old_CPU_Local!=RME_THD_UNBINDED)
+        __RME_List_Del(Thd_Struct->Sched.Notif.Prev,Thd_Struct->Sched.Notif.Next);
+        __RME_List_Crt(&(Thd_Struct->Sched.Notif));
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* If we have an scheduler event endpoint, release it */
+    if(Thd_Struct->Sched.Sched_Sig!=0)
     {
         RME_COVERAGE_MARKER();
 
-        return RME_ERR_PTH_INVSTATE;
+    	RME_FETCH_ADD(&(Thd_Struct->Sched.Sched_Sig->Refcnt), -1);
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
     
-    /* See if the parent thread is on the same core with the current processor */
-    CPU_Local=RME_CPU_LOCAL();
-    Thd_Sched_Struct=RME_CAP_GETOBJ(Thd_Sched,struct RME_Thd_Struct*);
-    if(Thd_Sched_Struct->Sched.CPU_Local!=CPU_Local)
+    /* If we are in the EDF class, leave it; the EDF list is per-core */
+    if(Thd_Struct->Sched.Period!=0)
     {
         RME_COVERAGE_MARKER();
 
-        return RME_ERR_PTH_INVSTATE;
+        __RME_List_Del(Thd_Struct->Sched.EDF.Prev,Thd_Struct->Sched.EDF.Next);
+        Thd_Struct->Sched.Period=0;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
 
-    /* See if we are trying to bind to ourself. This is prohibited */
-    if(Thd_Op_Struct==Thd_Sched_Struct)
+    /* Now save the system call return value to the caller stack */
+    __RME_Set_Syscall_Retval(Reg,0);  
+    
+    /* If the thread is running, or ready to run, kick it out of the run queue.
+     * If it is blocked on some endpoint, end the blocking and set the return
+     * value to RME_ERR_SIV_FREE. If the thread is killed due to a fault, we will
+     * not clear the fault here, and we will wait for the Exec_Set to clear it. */
+    if(Thd_Struct->Sched.State!=RME_THD_BLOCKED)
     {
         RME_COVERAGE_MARKER();
 
-        return RME_ERR_PTH_NOTIF;
+        if((Thd_Struct->Sched.State==RME_THD_RUNNING)||(Thd_Struct->Sched.State==RME_THD_READY))
+        {
+            RME_COVERAGE_MARKER();
+
+            _RME_Run_Del(Thd_Struct);
+            Thd_Struct->Sched.State=RME_THD_TIMEOUT;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
     }
     else
     {
         RME_COVERAGE_MARKER();
+        
+        /* If it got here, the thread that is operated on cannot be the current thread, so
+         * we are not overwriting the return value of the caller thread */
+        __RME_Set_Syscall_Retval(&(Thd_Struct->Cur_Reg->Reg),RME_ERR_SIV_FREE);
+        Thd_Struct->Sched.Signal->Thd=0;
+        Thd_Struct->Sched.Signal=0;
+        Thd_Struct->Sched.State=RME_THD_TIMEOUT;
     }
+    /* Delete all slices on it */
+    Thd_Struct->Sched.Slices=0;
     
-    /* See if the priority relationship is correct */
-    if(Thd_Sched_Struct->Sched.Max_Prio<Prio)
+    /* See if this thread is the current thread. If yes, then there will be a context switch */
+    if(CPU_Local->Cur_Thd==Thd_Struct)
+    {
+        RME_COVERAGE_MARKER();
+
+        CPU_Local->Cur_Thd=_RME_Run_High(CPU_Local);
+        _RME_Run_Ins(CPU_Local->Cur_Thd);
+        (CPU_Local->Cur_Thd)->Sched.State=RME_THD_RUNNING;
+        _RME_Run_Swt(Reg,Thd_Struct,CPU_Local->Cur_Thd);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Set the state to unbinded so other cores can bind */
+    RME_WRITE_RELEASE((rme_ptr_t*)&(Thd_Struct->Sched.CPU_Local),(rme_ptr_t)RME_THD_UNBINDED);
+    return 0;
+}
+/* End Function:_RME_Thd_Sched_Free ******************************************/
+
+/* Begin Function:_RME_Thd_Sched_Rcv ******************************************
+Description : Try to receive a notification from the scheduler queue. This
+              can only be called from the same core the thread is on.
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              struct RME_Reg_Struct* Reg - The current thread's register set.
+              rme_cid_t Cap_Thd - The capability to the scheduler thread. We are going
+                                  to get timeout or fault notifications for the threads
+                                  that it is responsible for scheduling. This capability
+                                  must point to a thread on the same core. 2-Level.
+Output      : struct RME_Reg_Struct* Reg - The current thread's register set, 
+                                           with the architecture-specific reason of the
+                                           fault populated to the invocation return value
+                                           position of it.
+Return      : rme_ret_t - If successful, the thread ID; or an error code.
+******************************************************************************/
+rme_ret_t _RME_Thd_Sched_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg, rme_cid_t Cap_Thd)
+{
+    struct RME_Cap_Thd* Thd_Op;
+    struct RME_Thd_Struct* Thd_Struct;
+    struct RME_Thd_Struct* Thd_Child;
+    rme_ptr_t Type_Ref;
+    
+    /* Get the capability slot */
+    RME_CAPTBL_GETCAP(Captbl,Cap_Thd,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Op,Type_Ref);
+    /* Check if the target cap is not frozen and allows such operations */
+    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_RCV);
+    
+    /* Check if the CPUID is correct. Only if yes can we proceed */
+    Thd_Struct=(struct RME_Thd_Struct*)Thd_Op->Head.Object;
+    if(Thd_Struct->Sched.CPU_Local!=RME_CPU_LOCAL())
     {
         RME_COVERAGE_MARKER();
 
-        return RME_ERR_PTH_PRIO;
+        return RME_ERR_PTH_INVSTATE;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
-
-    /* Yes, it is on the current processor. Try to bind the thread */
-    if(RME_COMP_SWAP((rme_ptr_t*)&(Thd_Op_Struct->Sched.CPU_Local),
-                     (rme_ptr_t)Old_CPU_Local,
-                     (rme_ptr_t)CPU_Local)==0)
+    
+    /* Are there any notifications? */
+    if(Thd_Struct->Sched.Event.Next==&(Thd_Struct->Sched.Event))
     {
         RME_COVERAGE_MARKER();
 
-        return RME_ERR_PTH_CONFLICT;
+        /* Check the blocking flag to see whether we need to block the thread */
+        return RME_ERR_PTH_NOTIF;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
     
-    /* Binding successful. Do operations to finish this. There's no need to worry about
-     * other cores' operations on this thread because this thread is already binded
-     * to this core */
-    Thd_Op_Struct->Sched.Parent=Thd_Sched_Struct;
-    Thd_Op_Struct->Sched.Prio=Prio;
-    Thd_Op_Struct->Sched.TID=TID;
-
-    /* Tie the signal endpoint to it if not zero */
-    if(Sig_Op==0)
+    /* Return one notification and delete it from the notification list */
+    Thd_Child=(struct RME_Thd_Struct*)(Thd_Struct->Sched.Event.Next-1);
+    __RME_List_Del(Thd_Child->Sched.Notif.Prev,Thd_Child->Sched.Notif.Next);
+    /* We need to do this because we are using this to detect whether the notification is sent */
+    __RME_List_Crt(&(Thd_Child->Sched.Notif));
+    
+    /* See if the child is in a faulty state. If yes, we return a fault notification with that TID */
+    if(Thd_Child->Sched.State==RME_THD_FAULT)
     {
         RME_COVERAGE_MARKER();
-
-    	Thd_Op_Struct->Sched.Sched_Sig=0;
+        /* Set the reason of that fault to the invocation return value register */
+        __RME_Set_Inv_Retval(Reg,Thd_Child->Sched.Fault);
+        /* Return the TID with the fault flag set */
+        return Thd_Child->Sched.TID|RME_THD_FAULT_FLAG;
     }
     else
     {
         RME_COVERAGE_MARKER();
-
-        Sig_Op_Struct=RME_CAP_GETOBJ(Sig_Op,struct RME_Sig_Struct*);
-    	Thd_Op_Struct->Sched.Sched_Sig=Sig_Op_Struct;
-        /* Increase the reference count of the signal endpoint(not the capability!) */
-        RME_FETCH_ADD(&(Sig_Op_Struct->Refcnt), 1);
     }
 
-    /* We can use this because it is core-local */
-    Thd_Sched_Struct->Sched.Refcnt++;
-    
-    return 0;
+    /* Return the notification TID, which means that it is just a timeout */
+    return Thd_Child->Sched.TID;
 }
-/* End Function:_RME_Thd_Sched_Bind ******************************************/
+/* End Function:_RME_Thd_Sched_Rcv *******************************************/
 
-/* Begin Function:_RME_Thd_Sched_Prio *****************************************
-Description : Change a thread's priority level. This can only be called from the
-              core that have the thread binded.
+/* Begin Function:_RME_Thd_Sched_EDF ******************************************
+Description : Put a thread into the EDF class, change its period and budget, or
+              take it out of the EDF class. This can only be called from the core
+              that have the thread binded.
+              An EDF thread stays on its priority level, and runs before all the
+              fixed-priority threads there, in the order of the deadlines. In each
+              period, it gets the budget as its time slices, and the kernel gives
+              them back when the next period begins; the unused slices are lost.
+              The first period begins now. If the thread has infinite time, only
+              the deadlines are used.
               This system call can cause a potential context switch.
-              It is impossible to set a thread's priority beyond its maximum priority. 
 Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
               struct RME_Reg_Struct* Reg - The current register set.
               rme_cid_t Cap_Thd - The capability to the thread. 2-Level.
-              rme_ptr_t Prio - The priority level, higher is more critical.
+              rme_ptr_t Period - The period, in ticks. If this is 0, the thread
+                                 will leave the EDF class.
+              rme_ptr_t Budget - The budget in each period, in ticks.
 Output      : None.
 Return      : rme_ret_t - If successful, 0; or an error code.
 ******************************************************************************/
-rme_ret_t _RME_Thd_Sched_Prio(struct RME_Cap_Captbl* Captbl,
-                              struct RME_Reg_Struct* Reg,
-                              rme_cid_t Cap_Thd, rme_ptr_t Prio)
+rme_ret_t _RME_Thd_Sched_EDF(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_cid_t Cap_Thd, rme_ptr_t Period, rme_ptr_t Budget)
 {
     struct RME_Cap_Thd* Thd_Op;
     struct RME_Thd_Struct* Thd_Struct;
@@ -4485,7 +6731,7 @@ rme_ret_t _RME_Thd_Sched_Prio(struct RME_Cap_Captbl* Captbl,
     /* Get the capability slot */
     RME_CAPTBL_GETCAP(Captbl,Cap_Thd,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Op,Type_Ref);
     /* Check if the target cap is not frozen and allows such operations */
-    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_PRIO);
+    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_EDF);
     
     /* See if the target thread is already binded to this core. If no, we just quit */
     CPU_Local=RME_CPU_LOCAL();
@@ -4501,47 +6747,44 @@ rme_ret_t _RME_Thd_Sched_Prio(struct RME_Cap_Captbl* Captbl,
         RME_COVERAGE_MARKER();
     }
     
-    /* See if the priority relationship is correct */
-    if(Thd_Struct->Sched.Max_Prio<Prio)
+    /* The budget must fit in the period, and the period must be a sane amount of time */
+    if((Period!=0)&&((Budget==0)||(Budget>Period)||(Period>=RME_THD_MAX_TIME)))
     {
         RME_COVERAGE_MARKER();
 
-        return RME_ERR_PTH_PRIO;
+        return RME_ERR_PTH_OVERFLOW;
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
     
-    /* Now save the system call return value to the caller stack */
-    __RME_Set_Syscall_Retval(Reg,0);
+    /* Leave the EDF list if we are in it; we will come back with the new deadline */
+    if(Thd_Struct->Sched.Period!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        __RME_List_Del(Thd_Struct->Sched.EDF.Prev,Thd_Struct->Sched.EDF.Next);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
     
-    /* See if this thread is currently running, or is runnable. If yes, it must be
-     * in the run queue. Remove it from there and change priority, after changing
-     * priority, put it back, and see if we need a reschedule. */
-    if((Thd_Struct->Sched.State==RME_THD_RUNNING)||(Thd_Struct->Sched.State==RME_THD_READY))
+    Thd_Struct->Sched.Period=Period;
+    Thd_Struct->Sched.Budget=Budget;
+    if(Period!=0)
     {
         RME_COVERAGE_MARKER();
 
-        _RME_Run_Del(Thd_Struct);
-        Thd_Struct->Sched.Prio=Prio;
-        _RME_Run_Ins(Thd_Struct);
-        
-        /* Get the current highest-priority running thread */
-        Thd_Struct=_RME_Run_High(CPU_Local);
-        RME_ASSERT(Thd_Struct->Sched.Prio>=(CPU_Local->Cur_Thd)->Sched.Prio);
-        
-        /* See if we need a context switch */
-        if(Thd_Struct->Sched.Prio>(CPU_Local->Cur_Thd)->Sched.Prio)
+        /* The first period begins now, with a full budget */
+        Thd_Struct->Sched.Deadline=RME_Timestamp+Period;
+        _RME_Run_EDF_Ins(Thd_Struct);
+        if(Thd_Struct->Sched.Slices<RME_THD_INF_TIME)
         {
             RME_COVERAGE_MARKER();
 
-            /* This will cause a solid context switch - The current thread will be set
-             * to ready, and we will set the thread that we switch to to be running. */
-            _RME_Run_Swt(Reg,CPU_Local->Cur_Thd,Thd_Struct);
-            (CPU_Local->Cur_Thd)->Sched.State=RME_THD_READY;
-            Thd_Struct->Sched.State=RME_THD_RUNNING;
-            CPU_Local->Cur_Thd=Thd_Struct;
+            Thd_Struct->Sched.Slices=Budget;
         }
         else
         {
@@ -4549,41 +6792,89 @@ rme_ret_t _RME_Thd_Sched_Prio(struct RME_Cap_Captbl* Captbl,
         }
     }
     else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Now save the system call return value to the caller stack */
+    __RME_Set_Syscall_Retval(Reg,0);
+    
+    /* If it is in the run queue, it needs a new place there. If it is out of time
+     * and have some now, it can run */
+    if((Thd_Struct->Sched.State==RME_THD_RUNNING)||(Thd_Struct->Sched.State==RME_THD_READY))
     {
         RME_COVERAGE_MARKER();
 
-        Thd_Struct->Sched.Prio=Prio;
+        _RME_Run_Del(Thd_Struct);
+        _RME_Run_Ins(Thd_Struct);
+    }
+    else if((Thd_Struct->Sched.State==RME_THD_TIMEOUT)&&(Thd_Struct->Sched.Slices!=0))
+    {
+        RME_COVERAGE_MARKER();
+
+        Thd_Struct->Sched.State=RME_THD_READY;
+        _RME_Run_Ins(Thd_Struct);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
     }
     
+    /* See if we need a context switch */
+    _RME_Kern_High(Reg, CPU_Local);
+#if(RME_TICKLESS==RME_TRUE)
+    /* The next EDF period may have changed even if we did not switch */
+    _RME_Tick_Rearm(CPU_Local->Cur_Thd);
+#endif
+    
     return 0;
 }
-/* End Function:_RME_Thd_Sched_Prio ******************************************/
-
-/* Begin Function:_RME_Thd_Sched_Free *****************************************
-Description : Free a thread from its current binding. This function can only be
-              executed from the same core on with the thread.
+/* End Function:_RME_Thd_Sched_EDF *******************************************/
+
+/* Begin Function:_RME_Thd_Sched_Migr *****************************************
+Description : Move a thread to another core, and bind it to a new scheduler thread
+              there. This works like a _RME_Thd_Sched_Free here followed by a
+              _RME_Thd_Sched_Bind there, but the thread keeps its state: a ready
+              thread will be ready there, a blocked one stays blocked on its
+              endpoint, and the slices, the priority, the EDF parameters and the
+              scheduler notification endpoint are all kept.
+              This must be called on the core that have the thread binded, and the
+              scheduler thread must be on another core. The thread is posted to
+              the migration mailbox of that core, and no core can operate on it
+              until that core adopts it; that core is poked when the thread may
+              preempt there, or else it will adopt the thread on its next tick.
+              If the scheduler thread is freed from that core before then, the
+              thread will be freed instead.
               This system call can cause a potential context switch.
 Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
               struct RME_Reg_Struct* Reg - The current register set.
               rme_cid_t Cap_Thd - The capability to the thread. 2-Level.
+              rme_cid_t Cap_Thd_Sched - The new scheduler thread. 2-Level.
 Output      : None.
 Return      : rme_ret_t - If successful, 0; or an error code.
 ******************************************************************************/
-rme_ret_t _RME_Thd_Sched_Free(struct RME_Cap_Captbl* Captbl, 
-                              struct RME_Reg_Struct* Reg, rme_cid_t Cap_Thd)
+rme_ret_t _RME_Thd_Sched_Migr(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                              rme_cid_t Cap_Thd, rme_cid_t Cap_Thd_Sched)
 {
     struct RME_Cap_Thd* Thd_Op;
+    struct RME_Cap_Thd* Thd_Sched;
     struct RME_Thd_Struct* Thd_Struct;
-    /* These are used to free the thread */
+    struct RME_Thd_Struct* Thd_Sched_Struct;
     struct RME_CPU_Local* CPU_Local;
+    struct RME_CPU_Local* Dst_CPU_Local;
+    rme_ptr_t Poke;
+    rme_ptr_t Old_Head;
     rme_ptr_t Type_Ref;
     
     /* Get the capability slot */
     RME_CAPTBL_GETCAP(Captbl,Cap_Thd,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Op,Type_Ref);
-    /* Check if the target cap is not frozen and allows such operations */
-    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_FREE);
+    RME_CAPTBL_GETCAP(Captbl,Cap_Thd_Sched,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Sched,Type_Ref);
+    /* Check if the target cap is not frozen and allows such operations. This frees
+     * the thread here and binds it there, so both are needed */
+    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_FREE|RME_THD_FLAG_SCHED_CHILD);
+    RME_CAP_CHECK(Thd_Sched,RME_THD_FLAG_SCHED_PARENT);
     
-    /* See if the target thread is already binded. If no or binded to other cores, we just quit */
+    /* See if the target thread is binded to this core. If no, we just quit */
     CPU_Local=RME_CPU_LOCAL();
     Thd_Struct=(struct RME_Thd_Struct*)Thd_Op->Head.Object;
     if(Thd_Struct->Sched.CPU_Local!=CPU_Local)
@@ -4597,8 +6888,8 @@ rme_ret_t _RME_Thd_Sched_Free(struct RME_Cap_Captbl* Captbl,
         RME_COVERAGE_MARKER();
     }
     
-    /* Am I referenced by someone as a scheduler? If yes, we cannot unbind. Because
-     * boot-time thread's refcnt will never be 0, thus they will never pass this checking */
+    /* A scheduler cannot leave the threads it schedules behind. Because boot-time
+     * thread's refcnt will never be 0, they will never pass this checking */
     if(Thd_Struct->Sched.Refcnt!=0)
     {
         RME_COVERAGE_MARKER();
@@ -4610,10 +6901,35 @@ rme_ret_t _RME_Thd_Sched_Free(struct RME_Cap_Captbl* Captbl,
         RME_COVERAGE_MARKER();
     }
     
-    /* Decrease the parent's reference count */
-    Thd_Struct->Sched.Parent->Sched.Refcnt--;
+    /* See if the new scheduler is on another core. It may be freed from there after
+     * we look, and the core that adopts the thread will check again */
+    Thd_Sched_Struct=(struct RME_Thd_Struct*)Thd_Sched->Head.Object;
+    Dst_CPU_Local=Thd_Sched_Struct->Sched.CPU_Local;
+    if((Dst_CPU_Local==CPU_Local)||(Dst_CPU_Local==RME_THD_UNBINDED)||(Dst_CPU_Local==RME_THD_MIGRATING))
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PTH_INVSTATE;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
     
-    /* See if we have any events sent to the parent. If yes, remove that event */
+    /* See if the priority relationship is correct */
+    if(Thd_Sched_Struct->Sched.Max_Prio<Thd_Struct->Sched.Prio)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_PTH_PRIO;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Leave the old scheduler, and take back the notification that it did not receive */
+    RME_FETCH_ADD(&(Thd_Struct->Sched.Parent->Sched.Refcnt), -1);
     if(Thd_Struct->Sched.Notif.Next!=&(Thd_Struct->Sched.Notif))
     {
         RME_COVERAGE_MARKER();
@@ -4626,62 +6942,44 @@ rme_ret_t _RME_Thd_Sched_Free(struct RME_Cap_Captbl* Captbl,
         RME_COVERAGE_MARKER();
     }
     
-    /* If we have an scheduler event endpoint, release it */
-    if(Thd_Struct->Sched.Sched_Sig!=0)
+    /* The EDF list is per-core. We keep the period and the deadline, and join the
+     * EDF list of the new core when we get there */
+    if(Thd_Struct->Sched.Period!=0)
     {
         RME_COVERAGE_MARKER();
 
-    	RME_FETCH_ADD(&(Thd_Struct->Sched.Sched_Sig->Refcnt), -1);
+        __RME_List_Del(Thd_Struct->Sched.EDF.Prev,Thd_Struct->Sched.EDF.Next);
     }
     else
     {
         RME_COVERAGE_MARKER();
     }
-
+    
     /* Now save the system call return value to the caller stack */
-    __RME_Set_Syscall_Retval(Reg,0);  
+    __RME_Set_Syscall_Retval(Reg,0);
     
-    /* If the thread is running, or ready to run, kick it out of the run queue.
-     * If it is blocked on some endpoint, end the blocking and set the return
-     * value to RME_ERR_SIV_FREE. If the thread is killed due to a fault, we will
-     * not clear the fault here, and we will wait for the Exec_Set to clear it. */
-    if(Thd_Struct->Sched.State!=RME_THD_BLOCKED)
+    /* If the thread is running, or ready to run, kick it out of the run queue; it will
+     * be ready there. If it is blocked, it stays blocked on the endpoint, and the senders
+     * will only count the signals until it gets there */
+    if((Thd_Struct->Sched.State==RME_THD_RUNNING)||(Thd_Struct->Sched.State==RME_THD_READY))
     {
         RME_COVERAGE_MARKER();
 
-        if((Thd_Struct->Sched.State==RME_THD_RUNNING)||(Thd_Struct->Sched.State==RME_THD_READY))
-        {
-            RME_COVERAGE_MARKER();
-
-            _RME_Run_Del(Thd_Struct);
-            Thd_Struct->Sched.State=RME_THD_TIMEOUT;
-        }
-        else
-        {
-            RME_COVERAGE_MARKER();
-        }
+        _RME_Run_Del(Thd_Struct);
+        Thd_Struct->Sched.State=RME_THD_READY;
     }
     else
     {
         RME_COVERAGE_MARKER();
-        
-        /* If it got here, the thread that is operated on cannot be the current thread, so
-         * we are not overwriting the return value of the caller thread */
-        __RME_Set_Syscall_Retval(&(Thd_Struct->Cur_Reg->Reg),RME_ERR_SIV_FREE);
-        Thd_Struct->Sched.Signal->Thd=0;
-        Thd_Struct->Sched.Signal=0;
-        Thd_Struct->Sched.State=RME_THD_TIMEOUT;
     }
-    /* Delete all slices on it */
-    Thd_Struct->Sched.Slices=0;
     
-    /* See if this thread is the current thread. If yes, then there will be a context switch */
+    /* See if this thread is the current thread. If yes, then there will be a context
+     * switch, and this must be done before we post it so that its registers are saved */
     if(CPU_Local->Cur_Thd==Thd_Struct)
     {
         RME_COVERAGE_MARKER();
 
         CPU_Local->Cur_Thd=_RME_Run_High(CPU_Local);
-        _RME_Run_Ins(CPU_Local->Cur_Thd);
         (CPU_Local->Cur_Thd)->Sched.State=RME_THD_RUNNING;
         _RME_Run_Swt(Reg,Thd_Struct,CPU_Local->Cur_Thd);
     }
@@ -4690,42 +6988,87 @@ rme_ret_t _RME_Thd_Sched_Free(struct RME_Cap_Captbl* Captbl,
         RME_COVERAGE_MARKER();
     }
     
-    /* Set the state to unbinded so other cores can bind */
-    RME_WRITE_RELEASE((rme_ptr_t*)&(Thd_Struct->Sched.CPU_Local),(rme_ptr_t)RME_THD_UNBINDED);
+    /* Only poke the new core if the thread may preempt what is running there, or if it
+     * may have signals to pick up; otherwise the next tick is soon enough. What we see
+     * there may be stale, but that only costs an extra poke or a tick of delay. In
+     * tickless mode, there may be no tick for a long time */
+#if(RME_TICKLESS==RME_TRUE)
+    Poke=1;
+#else
+    Poke=((Thd_Struct->Sched.State==RME_THD_BLOCKED)||
+          ((Thd_Struct->Sched.State==RME_THD_READY)&&
+           (Thd_Struct->Sched.Prio>=(Dst_CPU_Local->Cur_Thd)->Sched.Prio)));
+#endif
+
+    /* Post it to the new core. The new scheduler may be freed and deleted there before
+     * the thread is adopted, so we hold a reference to it, which keeps the deletion away
+     * until that core has looked at it. The compare-and-swap is also the release barrier */
+    RME_FETCH_ADD(&(Thd_Sched_Struct->Sched.Refcnt), 1);
+    Thd_Struct->Sched.Parent=Thd_Sched_Struct;
+    Thd_Struct->Sched.CPU_Local=RME_THD_MIGRATING;
+    do
+    {
+        Old_Head=Dst_CPU_Local->Migr_Head;
+        Thd_Struct->Sched.Migr_Next=Old_Head;
+    }
+    while(RME_COMP_SWAP(&(Dst_CPU_Local->Migr_Head),Old_Head,(rme_ptr_t)Thd_Struct)==0);
+    
+    if(Poke!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        __RME_Wake_IPI(Dst_CPU_Local->CPUID);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
     return 0;
 }
-/* End Function:_RME_Thd_Sched_Free ******************************************/
-
-/* Begin Function:_RME_Thd_Sched_Rcv ******************************************
-Description : Try to receive a notification from the scheduler queue. This
-              can only be called from the same core the thread is on.
+/* End Function:_RME_Thd_Sched_Migr ******************************************/
+
+/* Begin Function:_RME_Thd_Cycle_Get ******************************************
+Description : Get the number of processor cycles that a thread used. The cycles
+              are charged on context switches, invocations and returns, and include
+              the time spent in the invocations that the thread made, as well as
+              the time spent in the kernel on its behalf. The cycles used in the
+              invocations are also counted on their own when they return. This
+              can only be called from the core that have the thread binded, so
+              that the count is not changing when we read it. The count is returned
+              in the registers of the first and second words carried by a signal,
+              together with the current cycle counter value, because it may not
+              fit in the return value. This always fails if the cycle accounting
+              is not compiled in.
 Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
-              struct RME_Reg_Struct* Reg - The current thread's register set.
-              rme_cid_t Cap_Thd - The capability to the scheduler thread. We are going
-                                  to get timeout or fault notifications for the threads
-                                  that it is responsible for scheduling. This capability
-                                  must point to a thread on the same core. 2-Level.
-Output      : struct RME_Reg_Struct* Reg - The current thread's register set, 
-                                           with the architecture-specific reason of the
-                                           fault populated to the invocation return value
-                                           position of it.
-Return      : rme_ret_t - If successful, the thread ID; or an error code.
+              struct RME_Reg_Struct* Reg - The current register set.
+              rme_cid_t Cap_Thd - The capability to the thread. 2-Level.
+              rme_ptr_t Type - RME_THD_CYCLE_ALL for all the cycles, or
+                               RME_THD_CYCLE_INV for those used in the invocations
+                               that have returned.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; or an error code.
 ******************************************************************************/
-rme_ret_t _RME_Thd_Sched_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg, rme_cid_t Cap_Thd)
+rme_ret_t _RME_Thd_Cycle_Get(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                             rme_cid_t Cap_Thd, rme_ptr_t Type)
 {
+#ifdef RME_CYCLE_ACCT
     struct RME_Cap_Thd* Thd_Op;
     struct RME_Thd_Struct* Thd_Struct;
-    struct RME_Thd_Struct* Thd_Child;
+    struct RME_CPU_Local* CPU_Local;
+    rme_ptr_t Now;
+    rme_ptr_t Cycles;
     rme_ptr_t Type_Ref;
     
     /* Get the capability slot */
     RME_CAPTBL_GETCAP(Captbl,Cap_Thd,RME_CAP_THD,struct RME_Cap_Thd*,Thd_Op,Type_Ref);
     /* Check if the target cap is not frozen and allows such operations */
-    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_SCHED_RCV);
+    RME_CAP_CHECK(Thd_Op,RME_THD_FLAG_CYCLE_GET);
     
-    /* Check if the CPUID is correct. Only if yes can we proceed */
+    /* See if the target thread is already binded to this core. If no, we just quit */
+    CPU_Local=RME_CPU_LOCAL();
     Thd_Struct=(struct RME_Thd_Struct*)Thd_Op->Head.Object;
-    if(Thd_Struct->Sched.CPU_Local!=RME_CPU_LOCAL())
+    if(Thd_Struct->Sched.CPU_Local!=CPU_Local)
     {
         RME_COVERAGE_MARKER();
 
@@ -4736,43 +7079,35 @@ rme_ret_t _RME_Thd_Sched_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struc
         RME_COVERAGE_MARKER();
     }
     
-    /* Are there any notifications? */
-    if(Thd_Struct->Sched.Event.Next==&(Thd_Struct->Sched.Event))
+    /* If this is the current thread, it has not been charged for what it used since
+     * it was last accounted */
+    Now=RME_CYCLE_GET();
+    if(Type==RME_THD_CYCLE_INV)
     {
         RME_COVERAGE_MARKER();
 
-        /* Check the blocking flag to see whether we need to block the thread */
-        return RME_ERR_PTH_NOTIF;
-    }
-    else
-    {
-        RME_COVERAGE_MARKER();
-    }
-    
-    /* Return one notification and delete it from the notification list */
-    Thd_Child=(struct RME_Thd_Struct*)(Thd_Struct->Sched.Event.Next-1);
-    __RME_List_Del(Thd_Child->Sched.Notif.Prev,Thd_Child->Sched.Notif.Next);
-    /* We need to do this because we are using this to detect whether the notification is sent */
-    __RME_List_Crt(&(Thd_Child->Sched.Notif));
-    
-    /* See if the child is in a faulty state. If yes, we return a fault notification with that TID */
-    if(Thd_Child->Sched.State==RME_THD_FAULT)
-    {
-        RME_COVERAGE_MARKER();
-        /* Set the reason of that fault to the invocation return value register */
-        __RME_Set_Inv_Retval(Reg,Thd_Child->Sched.Fault);
-        /* Return the TID with the fault flag set */
-        return Thd_Child->Sched.TID|RME_THD_FAULT_FLAG;
+        Cycles=Thd_Struct->Sched.Inv_Cycles;
     }
-    else
+    else if(CPU_Local->Cur_Thd==Thd_Struct)
     {
         RME_COVERAGE_MARKER();
+
+        Cycles=Thd_Struct->Sched.Cycles+Now-CPU_Local->Cycle_Last;
     }
+    else
+    {
+        RME_COVERAGE_MARKER();
 
-    /* Return the notification TID, which means that it is just a timeout */
-    return Thd_Child->Sched.TID;
+        Cycles=Thd_Struct->Sched.Cycles;
+    }
+    
+    __RME_Set_Sig_Data(Reg, Cycles, Now);
+    return 0;
+#else
+    return RME_ERR_PTH_INVSTATE;
+#endif
 }
-/* End Function:_RME_Thd_Sched_Rcv *******************************************/
+/* End Function:_RME_Thd_Cycle_Get *******************************************/
 
 /* Begin Function:_RME_Thd_Time_Xfer ******************************************
 Description : Transfer time from one thread to another. This can only be called
@@ -5073,6 +7408,10 @@ rme_ret_t _RME_Thd_Time_Xfer(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struc
     /* All possible kernel send (scheduler notifications) done, now pick the highest
      * priority thread to run */
     _RME_Kern_High(Reg, CPU_Local);
+#if(RME_TICKLESS==RME_TRUE)
+    /* Our own slices may have changed even if we did not switch */
+    _RME_Tick_Rearm(CPU_Local->Cur_Thd);
+#endif
     
     return 0;
 }
@@ -5310,6 +7649,8 @@ rme_ret_t _RME_Sig_Boot_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl,
     Sig_Struct->Refcnt=1;
     Sig_Struct->Signal_Num=0;
     Sig_Struct->Thd=0;
+    Sig_Struct->Wake_Next=0;
+    Sig_Struct->Ring_Num=0;
     
     /* Fill in the header part */
     Sig_Crt->Head.Parent=0;
@@ -5378,6 +7719,8 @@ rme_ret_t _RME_Sig_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl,
     Sig_Struct->Refcnt=0;
     Sig_Struct->Signal_Num=0;
     Sig_Struct->Thd=0;
+    Sig_Struct->Wake_Next=0;
+    Sig_Struct->Ring_Num=0;
     
     /* Fill in the header part */
     Sig_Crt->Head.Parent=0;
@@ -5391,6 +7734,101 @@ rme_ret_t _RME_Sig_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl,
 }
 /* End Function:_RME_Sig_Crt *************************************************/
 
+/* Begin Function:_RME_Sig_Ring_Crt *******************************************
+Description : Create a signal capability with a payload ring. Each send to it
+              carries RME_SIG_DATA_NUM words, which are placed into the ring, and
+              each receive takes the oldest ones out of it. Because every signal
+              comes with its own payload, only single receives are allowed, and
+              this cannot be used as a scheduler endpoint either.
+Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
+              rme_cid_t Cap_Captbl - The capability to the capability table to use
+                                     for this signal. 2-Level.
+              rme_cid_t Cap_Kmem - The kernel memory capability. 2-Level.
+              rme_cid_t Cap_Sig - The capability slot that you want this newly created
+                                  signal capability to be in. 1-Level.
+              rme_ptr_t Raddr - The relative virtual address to store the signal endpoint
+                                kernel object, followed by the ring.
+              rme_ptr_t Ring_Order - The order of the number of slots in the ring. The
+                                     size of the kernel object is RME_SIG_RING_SIZE of
+                                     that number.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; or an error code.
+******************************************************************************/
+rme_ret_t _RME_Sig_Ring_Crt(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_cid_t Cap_Kmem,
+                            rme_cid_t Cap_Sig, rme_ptr_t Raddr, rme_ptr_t Ring_Order)
+{
+    struct RME_Cap_Captbl* Captbl_Op;
+    struct RME_Cap_Kmem* Kmem_Op;
+    struct RME_Cap_Sig* Sig_Crt;
+    struct RME_Sig_Struct* Sig_Struct;
+    struct RME_Sig_Slot* Slot;
+    rme_ptr_t Type_Ref;
+    rme_ptr_t Vaddr;
+    rme_ptr_t Count;
+    
+    /* See if the ring is too large */
+    if(Ring_Order>RME_SIG_RING_MAX_ORDER)
+    {
+        RME_COVERAGE_MARKER();
+
+        return RME_ERR_CAP_RANGE;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Get the capability slots */
+    RME_CAPTBL_GETCAP(Captbl,Cap_Captbl,RME_CAP_CAPTBL,struct RME_Cap_Captbl*,Captbl_Op,Type_Ref);
+    RME_CAPTBL_GETCAP(Captbl,Cap_Kmem,RME_CAP_KMEM,struct RME_Cap_Kmem*,Kmem_Op,Type_Ref);
+    /* Check if the captbl is not frozen and allows such operations */
+    RME_CAP_CHECK(Captbl_Op,RME_CAPTBL_FLAG_CRT);
+    /* See if the creation is valid for this kmem range */
+    RME_KMEM_CHECK(Kmem_Op,RME_KMEM_FLAG_SIG,Raddr,Vaddr,RME_SIG_RING_SIZE(RME_POW2(Ring_Order)));
+    
+    /* Get the cap slot */
+    RME_CAPTBL_GETSLOT(Captbl_Op,Cap_Sig,struct RME_Cap_Sig*,Sig_Crt);
+    /* Take the slot if possible */
+    RME_CAPTBL_OCCUPY(Sig_Crt,Type_Ref);
+    
+    /* Try to populate the area */
+    if(_RME_Kotbl_Mark(Vaddr, RME_SIG_RING_SIZE(RME_POW2(Ring_Order)))!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        RME_WRITE_RELEASE(&(Sig_Crt->Head.Type_Ref),0);
+        return RME_ERR_CAP_KOTBL;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Fill in the structure */
+    Sig_Struct=(struct RME_Sig_Struct*)Vaddr;
+    Sig_Struct->Refcnt=0;
+    Sig_Struct->Signal_Num=0;
+    Sig_Struct->Thd=0;
+    Sig_Struct->Wake_Next=0;
+    Sig_Struct->Ring_Num=RME_POW2(Ring_Order);
+    Sig_Struct->Ring_Head=0;
+    Sig_Struct->Ring_Tail=0;
+    /* Each slot is free to be filled at its own position */
+    Slot=RME_SIG_RING(Sig_Struct);
+    for(Count=0;Count<Sig_Struct->Ring_Num;Count++)
+        Slot[Count].Seq=Count;
+    
+    /* Fill in the header part */
+    Sig_Crt->Head.Parent=0;
+    Sig_Crt->Head.Object=Vaddr;
+    Sig_Crt->Head.Flags=RME_SIG_FLAG_SND|RME_SIG_FLAG_RCV_BS|RME_SIG_FLAG_RCV_NS;
+    
+    /* Creation complete */
+    RME_WRITE_RELEASE(&(Sig_Crt->Head.Type_Ref),RME_CAP_TYPEREF(RME_CAP_SIG,0));
+    return 0;
+}
+/* End Function:_RME_Sig_Ring_Crt ********************************************/
+
 /* Begin Function:_RME_Sig_Del ************************************************
 Description : Delete a signal capability.
 Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
@@ -5421,8 +7859,9 @@ rme_ret_t _RME_Sig_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_
     /* Get the thread */
     Sig_Struct=RME_CAP_GETOBJ(Sig_Del,struct RME_Sig_Struct*);
     
-    /* See if the signal endpoint is currently used. If yes, we cannot delete it */
-    if(Sig_Struct->Thd!=0)
+    /* See if the signal endpoint is currently used, or is still in some CPU's wakeup
+     * mailbox. If yes, we cannot delete it */
+    if((Sig_Struct->Thd!=0)||(Sig_Struct->Wake_Next!=0))
     {
         RME_COVERAGE_MARKER();
 
@@ -5451,7 +7890,7 @@ rme_ret_t _RME_Sig_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_
     /* Now we can safely delete the cap */
     RME_CAP_REMDEL(Sig_Del,Type_Ref);
     /* Try to depopulate the area - this must be successful */
-    RME_ASSERT(_RME_Kotbl_Erase((rme_ptr_t)Sig_Struct,RME_SIG_SIZE)!=0);
+    RME_ASSERT(_RME_Kotbl_Erase((rme_ptr_t)Sig_Struct,RME_SIG_RING_SIZE(Sig_Struct->Ring_Num))==0);
     
     return 0;
 }
@@ -5491,8 +7930,11 @@ void _RME_Kern_High(struct RME_Reg_Struct* Reg, struct RME_CPU_Local* CPU_Local)
     {
         RME_COVERAGE_MARKER();
 
-        /* Yes, compare the priority to see if we need to do it */
-        if(Thd_Struct->Sched.Prio<=(CPU_Local->Cur_Thd)->Sched.Prio)
+        /* Yes, compare the priority to see if we need to do it. On the same level,
+         * an EDF thread with an earlier deadline will preempt too */
+        if((Thd_Struct->Sched.Prio<(CPU_Local->Cur_Thd)->Sched.Prio)||
+           ((Thd_Struct->Sched.Prio==(CPU_Local->Cur_Thd)->Sched.Prio)&&
+            (RME_EDF_BEFORE(Thd_Struct,CPU_Local->Cur_Thd)==0)))
         {
             RME_COVERAGE_MARKER();
 
@@ -5567,66 +8009,370 @@ rme_ret_t _RME_Kern_Snd(struct RME_Sig_Struct* Sig_Struct)
 
         Unblock=0;
     }
+    RME_TRACE_EVENT(RME_TRACE_KERN_SND,Sig_Struct,(Unblock!=0)?Thd_Struct->Sched.TID:((rme_ptr_t)(-1)));
 
     if(Unblock!=0)
     {
-        RME_COVERAGE_MARKER();
-
-        /* The thread is blocked, and it is on our core. Unblock it, and
-         * set the return value to one as always, Even if we were specifying
-         * multi-receive. This is because other cores may reduce the count
-         * to zero while we are doing this */
-        __RME_Set_Syscall_Retval(&(Thd_Struct->Cur_Reg->Reg), 1);
-        /* See if the thread still have time left */
-        if(Thd_Struct->Sched.Slices!=0)
+        RME_COVERAGE_MARKER();
+
+        /* The thread is blocked, and it is on our core. Unblock it, and
+         * set the return value to one as always, Even if we were specifying
+         * multi-receive. This is because other cores may reduce the count
+         * to zero while we are doing this */
+        __RME_Set_Syscall_Retval(&(Thd_Struct->Cur_Reg->Reg), 1);
+        /* See if the thread still have time left */
+        if(Thd_Struct->Sched.Slices!=0)
+        {
+            RME_COVERAGE_MARKER();
+
+            /* Put this into the runqueue and just set it to ready. We will not switch to it
+             * immediately; this is because we may send to a myriad of endpoints in one
+             * interrupt, and we hope to perform the context switch only once when exiting
+             * that handler. We can save many register push/pops! */
+            _RME_Run_Ins(Thd_Struct);
+            Thd_Struct->Sched.State=RME_THD_READY;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+
+            /* No slices left. The only possible reason is because we delegated
+             * all of its time to someone else. We will not notify its parent again
+             * here because we will have notified it when we transferred all the
+             * timeslices away. We just silently change the state of this thread
+             * to TIMEOUT. Same for the next function. */
+            Thd_Struct->Sched.State=RME_THD_TIMEOUT;
+        }
+        
+        /* Clear the blocking status of the endpoint up - we don't need a write release barrier
+         * here because even if this is reordered to happen earlier it is still fine. */
+        Sig_Struct->Thd=0;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+
+        /* The guy who blocked on it is not on our core, or nobody blocked.
+         * We just faa the counter value and return */
+        if(RME_FETCH_ADD(&(Sig_Struct->Signal_Num),1)>RME_MAX_SIG_NUM)
+        {
+            RME_COVERAGE_MARKER();
+
+            RME_FETCH_ADD(&(Sig_Struct->Signal_Num),-1);
+            return RME_ERR_SIV_FULL;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+        
+        /* Look again after the faa - if someone is blocked on it now, it must be on
+         * another core, and that core have to be told to pick the signal up */
+        Thd_Struct=Sig_Struct->Thd;
+        if(Thd_Struct!=0)
+        {
+            RME_COVERAGE_MARKER();
+
+            _RME_Sig_Wake(Sig_Struct, Thd_Struct->Sched.CPU_Local);
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+    }
+
+    return 0;
+}
+/* End Function:_RME_Kern_Snd ************************************************/
+
+/* Begin Function:_RME_Sig_Wake ***********************************************
+Description : Post a signal endpoint to the wakeup mailbox of another CPU, because
+              some thread on that CPU is blocked on it. The endpoint is posted at
+              most once no matter how many senders get here; the CPU is poked only
+              when the mailbox was empty, because otherwise a poke is on its way.
+              If the thread is moving between cores, or was just freed, there is
+              nobody to post to; the core that adopts it will look at the counter.
+Input       : struct RME_Sig_Struct* Sig_Struct - The signal structure.
+              struct RME_CPU_Local* CPU_Local - The CPU-local data structure of the
+                                                CPU that the thread is on.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Sig_Wake(struct RME_Sig_Struct* Sig_Struct, struct RME_CPU_Local* CPU_Local)
+{
+    rme_ptr_t Old_Head;
+    
+    if((CPU_Local==RME_THD_UNBINDED)||(CPU_Local==RME_THD_MIGRATING))
+    {
+        RME_COVERAGE_MARKER();
+
+        return;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Claim the endpoint. If this fails, it is already in the mailbox, and the other
+     * CPU have not yet looked at the counter, so it will see our signal too */
+    if(RME_COMP_SWAP(&(Sig_Struct->Wake_Next),0,RME_SIG_WAKE_END)==0)
+    {
+        RME_COVERAGE_MARKER();
+
+        return;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Push it onto the mailbox */
+    do
+    {
+        Old_Head=CPU_Local->Wake_Head;
+        Sig_Struct->Wake_Next=Old_Head;
+    }
+    while(RME_COMP_SWAP(&(CPU_Local->Wake_Head),Old_Head,(rme_ptr_t)Sig_Struct)==0);
+    
+    if(Old_Head==RME_SIG_WAKE_END)
+    {
+        RME_COVERAGE_MARKER();
+
+        __RME_Wake_IPI(CPU_Local->CPUID);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+}
+/* End Function:_RME_Sig_Wake ************************************************/
+
+/* Begin Function:_RME_Kern_Wake **********************************************
+Description : Drain the wakeup mailbox of this CPU, and unblock the threads that
+              are still blocked on the posted endpoints if there are signals on
+              them. The threads that moved to another CPU since then have their
+              endpoints passed on there. The threads moved here are adopted first.
+              This is intended to be called in the wakeup IPI handler, and just
+              like _RME_Kern_Snd, the handler shall call _RME_Kern_High after this.
+Input       : struct RME_CPU_Local* CPU_Local - The CPU-local data structure.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Kern_Wake(struct RME_CPU_Local* CPU_Local)
+{
+    struct RME_Sig_Struct* Sig_Struct;
+    struct RME_Thd_Struct* Thd_Struct;
+    rme_ptr_t Sig_Next;
+    rme_ptr_t Old_Value;
+    
+    /* The threads moved here may be blocked on the endpoints in the mailbox */
+    _RME_Run_Migr(CPU_Local);
+    
+    /* Take the whole mailbox at once */
+    do
+    {
+        Sig_Next=CPU_Local->Wake_Head;
+    }
+    while(RME_COMP_SWAP(&(CPU_Local->Wake_Head),Sig_Next,RME_SIG_WAKE_END)==0);
+    
+    while(Sig_Next!=RME_SIG_WAKE_END)
+    {
+        Sig_Struct=(struct RME_Sig_Struct*)Sig_Next;
+        Sig_Next=Sig_Struct->Wake_Next;
+        /* Let senders post it again. This must be a full barrier, so that any sender
+         * that fails to claim it after this will have its signal seen below */
+        RME_FETCH_AND(&(Sig_Struct->Wake_Next),0);
+        
+        /* The thread may have been woken up, timed out or freed since then, or
+         * the counter may have been taken by someone else. Then it is all fine.
+         * Use an intermediate variable Old_Value to see if we took a signal */
+        Thd_Struct=Sig_Struct->Thd;
+        Old_Value=0;
+        if(Thd_Struct!=0)
+        {
+            RME_COVERAGE_MARKER();
+
+            if((Thd_Struct->Sched.CPU_Local==CPU_Local)&&(Thd_Struct->Sched.State==RME_THD_BLOCKED))
+            {
+                RME_COVERAGE_MARKER();
+
+                /* Take one signal for it, just like a single receive */
+                do
+                {
+                    Old_Value=Sig_Struct->Signal_Num;
+                }
+                while((Old_Value!=0)&&(RME_COMP_SWAP(&(Sig_Struct->Signal_Num),Old_Value,Old_Value-1)==0));
+            }
+            else if(Thd_Struct->Sched.CPU_Local!=CPU_Local)
+            {
+                RME_COVERAGE_MARKER();
+
+                /* It moved away after the endpoint was posted here. The senders that could
+                 * not post it again meanwhile are counting on us, so pass it on */
+                _RME_Sig_Wake(Sig_Struct, Thd_Struct->Sched.CPU_Local);
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+        
+        if(Old_Value==0)
+        {
+            RME_COVERAGE_MARKER();
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+
+            /* Unblock it in the same way as _RME_Kern_Snd does, with the payload if any */
+            __RME_Set_Syscall_Retval(&(Thd_Struct->Cur_Reg->Reg), 1);
+            if(Sig_Struct->Ring_Num!=0)
+            {
+                RME_COVERAGE_MARKER();
+
+                _RME_Sig_Ring_Get(Sig_Struct, &(Thd_Struct->Cur_Reg->Reg));
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+            if(Thd_Struct->Sched.Slices!=0)
+            {
+                RME_COVERAGE_MARKER();
+
+                _RME_Run_Ins(Thd_Struct);
+                Thd_Struct->Sched.State=RME_THD_READY;
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+
+                Thd_Struct->Sched.State=RME_THD_TIMEOUT;
+            }
+            
+            Sig_Struct->Thd=0;
+        }
+    }
+}
+/* End Function:_RME_Kern_Wake ***********************************************/
+
+/* Begin Function:_RME_Sig_Ring_Put *******************************************
+Description : Fill a slot in the payload ring of a signal endpoint. The slot is
+              taken by moving the tail, and is marked filled only after the words
+              are written. Any number of processors may fill at the same time.
+Input       : struct RME_Sig_Struct* Sig_Struct - The signal structure.
+              rme_ptr_t Data0 - The first word to carry.
+              rme_ptr_t Data1 - The second word to carry.
+Output      : None.
+Return      : rme_ret_t - If successful, 0, or an error code.
+******************************************************************************/
+rme_ret_t _RME_Sig_Ring_Put(struct RME_Sig_Struct* Sig_Struct, rme_ptr_t Data0, rme_ptr_t Data1)
+{
+    struct RME_Sig_Slot* Slot;
+    rme_ptr_t Pos;
+    rme_ptr_t Seq;
+    
+    while(1)
+    {
+        Pos=Sig_Struct->Ring_Tail;
+        Slot=&(RME_SIG_RING(Sig_Struct)[Pos&(Sig_Struct->Ring_Num-1)]);
+        Seq=RME_READ_ACQUIRE(&(Slot->Seq));
+        
+        /* The slot is still filled with what was put there one round earlier */
+        if(((rme_cnt_t)(Seq-Pos))<0)
         {
             RME_COVERAGE_MARKER();
 
-            /* Put this into the runqueue and just set it to ready. We will not switch to it
-             * immediately; this is because we may send to a myriad of endpoints in one
-             * interrupt, and we hope to perform the context switch only once when exiting
-             * that handler. We can save many register push/pops! */
-            _RME_Run_Ins(Thd_Struct);
-            Thd_Struct->Sched.State=RME_THD_READY;
+            return RME_ERR_SIV_FULL;
         }
         else
         {
             RME_COVERAGE_MARKER();
-
-            /* No slices left. The only possible reason is because we delegated
-             * all of its time to someone else. We will not notify its parent again
-             * here because we will have notified it when we transferred all the
-             * timeslices away. We just silently change the state of this thread
-             * to TIMEOUT. Same for the next function. */
-            Thd_Struct->Sched.State=RME_THD_TIMEOUT;
         }
         
-        /* Clear the blocking status of the endpoint up - we don't need a write release barrier
-         * here because even if this is reordered to happen earlier it is still fine. */
-        Sig_Struct->Thd=0;
+        /* The slot is free at this position, try to take it */
+        if(Seq==Pos)
+        {
+            RME_COVERAGE_MARKER();
+
+            if(RME_COMP_SWAP(&(Sig_Struct->Ring_Tail),Pos,Pos+1)!=0)
+            {
+                RME_COVERAGE_MARKER();
+
+                break;
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
     }
-    else
+    
+    Slot->Data[0]=Data0;
+    Slot->Data[1]=Data1;
+    RME_WRITE_RELEASE(&(Slot->Seq),Pos+1);
+    
+    return 0;
+}
+/* End Function:_RME_Sig_Ring_Put ********************************************/
+
+/* Begin Function:_RME_Sig_Ring_Get *******************************************
+Description : Take the oldest slot out of the payload ring of a signal endpoint,
+              and place the words in the register set of the receiver. Call this
+              only after a signal is taken from the endpoint on behalf of the
+              receiver, so that there is a slot for it. That slot may still be
+              being filled by a sender in the kernel on another processor, and
+              then we wait for it; this is bounded by the length of Put.
+Input       : struct RME_Sig_Struct* Sig_Struct - The signal structure.
+Output      : struct RME_Reg_Struct* Reg - The register set of the receiver.
+Return      : None.
+******************************************************************************/
+void _RME_Sig_Ring_Get(struct RME_Sig_Struct* Sig_Struct, struct RME_Reg_Struct* Reg)
+{
+    struct RME_Sig_Slot* Slot;
+    rme_ptr_t Pos;
+    
+    while(1)
     {
-        RME_COVERAGE_MARKER();
-
-        /* The guy who blocked on it is not on our core, or nobody blocked.
-         * We just faa the counter value and return */
-        if(RME_FETCH_ADD(&(Sig_Struct->Signal_Num),1)>RME_MAX_SIG_NUM)
+        Pos=Sig_Struct->Ring_Head;
+        Slot=&(RME_SIG_RING(Sig_Struct)[Pos&(Sig_Struct->Ring_Num-1)]);
+        
+        /* The slot is filled at this position, try to take it */
+        if(RME_READ_ACQUIRE(&(Slot->Seq))==(Pos+1))
         {
             RME_COVERAGE_MARKER();
 
-            RME_FETCH_ADD(&(Sig_Struct->Signal_Num),-1);
-            return RME_ERR_SIV_FULL;
+            if(RME_COMP_SWAP(&(Sig_Struct->Ring_Head),Pos,Pos+1)!=0)
+            {
+                RME_COVERAGE_MARKER();
+
+                break;
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
         }
         else
         {
             RME_COVERAGE_MARKER();
         }
     }
-
-    return 0;
+    
+    __RME_Set_Sig_Data(Reg, Slot->Data[0], Slot->Data[1]);
+    /* The slot is free to be filled one round later */
+    RME_WRITE_RELEASE(&(Slot->Seq),Pos+Sig_Struct->Ring_Num);
 }
-/* End Function:_RME_Kern_Snd ************************************************/
+/* End Function:_RME_Sig_Ring_Get ********************************************/
 
 /* Begin Function:_RME_Sig_Snd ************************************************
 Description : Try to send a signal from user level. This system call can cause
@@ -5634,10 +8380,15 @@ Description : Try to send a signal from user level. This system call can cause
 Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
               struct RME_Reg_Struct* Reg - The register set.
               rme_cid_t Cap_Sig - The capability to the signal. 2-Level.
+              rme_ptr_t Data0 - The first word to carry, if the endpoint have a
+                                payload ring.
+              rme_ptr_t Data1 - The second word to carry, if the endpoint have a
+                                payload ring.
 Output      : None.
 Return      : rme_ret_t - If successful, 0, or an error code.
 ******************************************************************************/
-rme_ret_t _RME_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg, rme_cid_t Cap_Sig)
+rme_ret_t _RME_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                       rme_cid_t Cap_Sig, rme_ptr_t Data0, rme_ptr_t Data1)
 {
     struct RME_Cap_Sig* Sig_Op;
     struct RME_Sig_Struct* Sig_Struct;
@@ -5653,6 +8404,28 @@ rme_ret_t _RME_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg
     
     CPU_Local=RME_CPU_LOCAL();
     Sig_Struct=RME_CAP_GETOBJ(Sig_Op,struct RME_Sig_Struct*);
+    
+    /* Put the payload in first, so that whoever takes this signal will find it there */
+    if(Sig_Struct->Ring_Num!=0)
+    {
+        RME_COVERAGE_MARKER();
+
+        if(_RME_Sig_Ring_Put(Sig_Struct, Data0, Data1)!=0)
+        {
+            RME_COVERAGE_MARKER();
+
+            return RME_ERR_SIV_FULL;
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
     Thd_Struct=Sig_Struct->Thd;
     /* If and only if we are calling from the same core as the blocked thread do
      * we actually unblock. Use an intermediate variable Unblock to avoid optimizations */
@@ -5679,6 +8452,7 @@ rme_ret_t _RME_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg
 
         Unblock=0;
     }
+    RME_TRACE_EVENT(RME_TRACE_SIG_SND,Sig_Struct,(Unblock!=0)?Thd_Struct->Sched.TID:((rme_ptr_t)(-1)));
     
     if(Unblock!=0)
     {
@@ -5691,6 +8465,18 @@ rme_ret_t _RME_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg
          * multi-receive. This is because other cores may reduce the count
          * to zero while we are doing this */
         __RME_Set_Syscall_Retval(&(Thd_Struct->Cur_Reg->Reg), 1);
+        /* The signal is handed over without touching the count, so take a payload
+         * for it. This may not be ours if there are older ones */
+        if(Sig_Struct->Ring_Num!=0)
+        {
+            RME_COVERAGE_MARKER();
+
+            _RME_Sig_Ring_Get(Sig_Struct, &(Thd_Struct->Cur_Reg->Reg));
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
         /* See if the thread still have time left */
         if(Thd_Struct->Sched.Slices!=0)
         {
@@ -5745,6 +8531,19 @@ rme_ret_t _RME_Sig_Snd(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg
             RME_COVERAGE_MARKER();
         }
         
+        /* Look again after the faa, and tell the other core if someone is there */
+        Thd_Struct=Sig_Struct->Thd;
+        if(Thd_Struct!=0)
+        {
+            RME_COVERAGE_MARKER();
+
+            _RME_Sig_Wake(Sig_Struct, Thd_Struct->Sched.CPU_Local);
+        }
+        else
+        {
+            RME_COVERAGE_MARKER();
+        }
+        
         /* Now save the system call return value to the caller stack */
         __RME_Set_Syscall_Retval(Reg,0);
     }
@@ -5758,9 +8557,13 @@ Description : Try to receive a signal capability. The rules for the signal capab
               is:
               1.If a receive endpoint have many send endpoints, everyone can send to it,
                 and sending to it will increase the signal count by 1.
-              2.If some thread blocks on a receive endpoint, the wakeup is only possible
-                from the same core that thread is on.
+              2.If some thread blocks on a receive endpoint, the wakeup is always done
+                on the same core that thread is on. Senders on other cores post the
+                endpoint to that core's wakeup mailbox and send it an IPI.
               3.It is not recommended to let 2 cores operate on the rcv endpoint simutaneously.
+              4.If the endpoint have a payload ring, each signal received comes with the
+                words that its sender carried, which are placed in the registers by
+                __RME_Set_Sig_Data. Only single receives are allowed on such endpoints.
               This system call can potentially trigger a context switch.
 Input       : struct RME_Cap_Captbl* Captbl - The master capability table.
               struct RME_Reg_Struct* Reg - The register set.
@@ -5886,8 +8689,18 @@ rme_ret_t _RME_Sig_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg
                 RME_COVERAGE_MARKER();
             }
             
-            /* We have taken it, now return what we have taken */
+            /* We have taken it, now return what we have taken, with the payload if any */
             __RME_Set_Syscall_Retval(Reg, 1);
+            if(Sig_Struct->Ring_Num!=0)
+            {
+                RME_COVERAGE_MARKER();
+
+                _RME_Sig_Ring_Get(Sig_Struct, Reg);
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
         }
         else
         {
@@ -5930,6 +8743,40 @@ rme_ret_t _RME_Sig_Rcv(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg
             {
                 RME_COVERAGE_MARKER();
             }
+            
+            /* A sender on another core may have done its faa after we looked at the counter,
+             * but looked for us before the swap above. It will not post a wakeup, so check
+             * again; the swap is a full barrier. If there is a signal, take one just like
+             * _RME_Kern_Wake does, and return without blocking. Any wakeup posted for us in
+             * the meantime will find nobody blocked */
+            do
+            {
+                Old_Value=Sig_Struct->Signal_Num;
+            }
+            while((Old_Value!=0)&&(RME_COMP_SWAP(&(Sig_Struct->Signal_Num),Old_Value,Old_Value-1)==0));
+            
+            if(Old_Value!=0)
+            {
+                RME_COVERAGE_MARKER();
+
+                Sig_Struct->Thd=0;
+                __RME_Set_Syscall_Retval(Reg, 1);
+                if(Sig_Struct->Ring_Num!=0)
+                {
+                    RME_COVERAGE_MARKER();
+
+                    _RME_Sig_Ring_Get(Sig_Struct, Reg);
+                }
+                else
+                {
+                    RME_COVERAGE_MARKER();
+                }
+                return 0;
+            }
+            else
+            {
+                RME_COVERAGE_MARKER();
+            }
 
             /* Now we block our current thread. No need to set any return value to the register
              * set here, because we do not yet know how many signals will be there when the thread
@@ -6076,7 +8923,7 @@ rme_ret_t _RME_Inv_Del(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Captbl, rme_
     /* Dereference the process */
     RME_FETCH_ADD(&(Inv_Struct->Proc->Refcnt), -1);
     /* Try to clear the area - this must be successful */
-    RME_ASSERT(_RME_Kotbl_Erase((rme_ptr_t)Inv_Struct,RME_INV_SIZE)!=0);
+    RME_ASSERT(_RME_Kotbl_Erase((rme_ptr_t)Inv_Struct,RME_INV_SIZE)==0);
     
     return 0;
 }
@@ -6118,19 +8965,22 @@ rme_ret_t _RME_Inv_Set(struct RME_Cap_Captbl* Captbl, rme_cid_t Cap_Inv,
 
 /* Begin Function:_RME_Inv_Act ************************************************
 Description : Activate an invocation capability. That means, do the invocation.
+              Up to RME_INV_ARG_NUM words are passed to the callee in registers;
+              which registers they are is decided by the architecture.
 Input       : struct RME_Cap_Captbl* Captbl - The capability table.
               struct RME_Reg_Struct* Reg - The register set for this thread.
               rme_cid_t Cap_Inv - The capability slot to the invocation stub. 2-Level.
-              rme_ptr_t Param - The parameter for the call.
 Return      : rme_ret_t - If successful, 0; or an error code.
 ******************************************************************************/
 rme_ret_t _RME_Inv_Act(struct RME_Cap_Captbl* Captbl, 
                        struct RME_Reg_Struct* Reg,
-                       rme_cid_t Cap_Inv, rme_ptr_t Param)
+                       rme_cid_t Cap_Inv)
 {
     struct RME_Cap_Inv* Inv_Op;
     struct RME_Inv_Struct* Inv_Struct;
+    struct RME_Inv_Struct* Inv_Top;
     struct RME_Thd_Struct* Thd_Struct;
+    struct RME_Cap_Pgtbl* Curr_Pgtbl;
     rme_ptr_t Active;
     rme_ptr_t Type_Ref;
 
@@ -6173,14 +9023,45 @@ rme_ret_t _RME_Inv_Act(struct RME_Cap_Captbl* Captbl,
      * user-level. We do not set the return value because it will be set by Inv_Ret.
      * The coprocessor state will be consistent across the call */
     __RME_Inv_Reg_Save(&(Inv_Struct->Ret), Reg);
+    /* See which page table we are using before the push */
+    Inv_Top=RME_INVSTK_TOP(Thd_Struct);
+    if(Inv_Top==0)
+    {
+        RME_COVERAGE_MARKER();
+
+        Curr_Pgtbl=Thd_Struct->Sched.Proc->Pgtbl;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+
+        Curr_Pgtbl=Inv_Top->Proc->Pgtbl;
+    }
     /* Push this into the stack: insert after the thread list header */
     __RME_List_Ins(&(Inv_Struct->Head),&(Thd_Struct->Inv_Stack),Thd_Struct->Inv_Stack.Next);
-    /* Setup the register contents, and do the invocation */
-    __RME_Thd_Reg_Init(Inv_Struct->Entry, Inv_Struct->Stack, Param, Reg);
+#ifdef RME_CYCLE_ACCT
+    /* Remember how many cycles the thread has used, so that we know how many it
+     * used in the invocation when it returns */
+    _RME_Cycle_Charge(Thd_Struct);
+    Inv_Struct->Cycle_Act=Thd_Struct->Sched.Cycles;
+#endif
+    /* Setup the register contents and move the arguments, and do the invocation */
+    __RME_Inv_Reg_Init(Inv_Struct->Entry, Inv_Struct->Stack, Reg);
     
-    /* We are assuming that we are always invoking into a new process (why use synchronous
-     * invocation if you don't do so?). So we always switch page tables regardless. */
-    __RME_Pgtbl_Set(RME_CAP_GETOBJ(Inv_Struct->Proc->Pgtbl,rme_ptr_t));
+    /* The callee may well be in the same address space, when several services share
+     * a process, or when the invocation only isolates the capability table. Only
+     * switch page tables when they are different, like what _RME_Run_Swt does */
+    RME_TRACE_EVENT(RME_TRACE_INV_ACT,Inv_Struct,Inv_Struct->Proc);
+    if(RME_CAP_GETOBJ(Curr_Pgtbl,rme_ptr_t)!=RME_CAP_GETOBJ(Inv_Struct->Proc->Pgtbl,rme_ptr_t))
+    {
+        RME_COVERAGE_MARKER();
+
+        __RME_Pgtbl_Set(RME_CAP_GETOBJ(Inv_Struct->Proc->Pgtbl,rme_ptr_t));
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
     
     return 0;
 }
@@ -6189,7 +9070,8 @@ rme_ret_t _RME_Inv_Act(struct RME_Cap_Captbl* Captbl,
 /* Begin Function:_RME_Inv_Ret ************************************************
 Description : Return from the invocation function, and set the return value to
               the old register set. This function does not need a capability
-              table to work.
+              table to work. The other RME_INV_RET_NUM-1 return words are left
+              in the registers where the callee put them.
 Input       : struct RME_Reg_Struct* Reg - The register set for this thread.
               rme_ptr_t Retval - The return value of this synchronous invocation.
               rme_ptr_t Fault_Flag - Are we attempting a return from fault?
@@ -6200,6 +9082,8 @@ rme_ret_t _RME_Inv_Ret(struct RME_Reg_Struct* Reg, rme_ptr_t Retval, rme_ptr_t F
 {
     struct RME_Thd_Struct* Thd_Struct;
     struct RME_Inv_Struct* Inv_Struct;
+    struct RME_Cap_Pgtbl* Curr_Pgtbl;
+    struct RME_Cap_Pgtbl* Next_Pgtbl;
 
     /* See if we can return; If we can, get the structure */
     Thd_Struct=RME_CPU_LOCAL()->Cur_Thd;
@@ -6227,8 +9111,25 @@ rme_ret_t _RME_Inv_Ret(struct RME_Reg_Struct* Reg, rme_ptr_t Retval, rme_ptr_t F
         RME_COVERAGE_MARKER();
     }
 
+    RME_TRACE_EVENT(RME_TRACE_INV_RET,Retval,Fault_Flag);
     /* Pop it from the stack */
     __RME_List_Del(Inv_Struct->Head.Prev,Inv_Struct->Head.Next);
+    Curr_Pgtbl=Inv_Struct->Proc->Pgtbl;
+#ifdef RME_CYCLE_ACCT
+    /* Charge the cycles used in the invocation. The nested invocations are a part
+     * of the outermost one, so only that one is counted */
+    _RME_Cycle_Charge(Thd_Struct);
+    if(RME_INVSTK_TOP(Thd_Struct)==0)
+    {
+        RME_COVERAGE_MARKER();
+
+        Thd_Struct->Sched.Inv_Cycles+=Thd_Struct->Sched.Cycles-Inv_Struct->Cycle_Act;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+#endif
 
     /* Restore the register contents, and set return value. We need to set
      * the return value of the invocation system call itself as well */
@@ -6253,19 +9154,30 @@ rme_ret_t _RME_Inv_Ret(struct RME_Reg_Struct* Reg, rme_ptr_t Retval, rme_ptr_t F
         __RME_Set_Syscall_Retval(Reg, 0);
     }
 
-    /* Same assumptions as in invocation activation */
+    /* Same as in invocation activation, only switch if the page table differs */
     Inv_Struct=RME_INVSTK_TOP(Thd_Struct);
     if(Inv_Struct!=0)
     {
         RME_COVERAGE_MARKER();
 
-        __RME_Pgtbl_Set(RME_CAP_GETOBJ(Inv_Struct->Proc->Pgtbl,rme_ptr_t));
+        Next_Pgtbl=Inv_Struct->Proc->Pgtbl;
     }
     else
     {
         RME_COVERAGE_MARKER();
 
-        __RME_Pgtbl_Set(RME_CAP_GETOBJ(Thd_Struct->Sched.Proc->Pgtbl,rme_ptr_t));
+        Next_Pgtbl=Thd_Struct->Sched.Proc->Pgtbl;
+    }
+    
+    if(RME_CAP_GETOBJ(Curr_Pgtbl,rme_ptr_t)!=RME_CAP_GETOBJ(Next_Pgtbl,rme_ptr_t))
+    {
+        RME_COVERAGE_MARKER();
+
+        __RME_Pgtbl_Set(RME_CAP_GETOBJ(Next_Pgtbl,rme_ptr_t));
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
     }
     
     return 0;
@@ -6335,6 +9247,7 @@ rme_ret_t _RME_Kern_Act(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Re
 {
     struct RME_Cap_Kern* Kern_Op;
     rme_ptr_t Type_Ref;
+    rme_ret_t Retval;
     
     /* Get the capability slot */
     RME_CAPTBL_GETCAP(Captbl,Cap_Kern,RME_CAP_KERN,struct RME_Cap_Kern*,Kern_Op,Type_Ref);    
@@ -6352,11 +9265,146 @@ rme_ret_t _RME_Kern_Act(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Re
         RME_COVERAGE_MARKER();
     }
 
+    /* The capability cache statistics are the same on all platforms */
+    if(Func_ID==RME_KERN_PERF_CAP_CACHE)
+    {
+        RME_COVERAGE_MARKER();
+        
+        Retval=_RME_Captbl_Cache_Stat(Sub_ID);
+        /* Kernel functions are responsible for setting their own return values */
+        if(Retval>=0)
+            __RME_Set_Syscall_Retval(Reg,Retval);
+        
+        return Retval;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+
+    /* So is the kernel event trace */
+    if(Func_ID==RME_KERN_PERF_TRACE)
+    {
+        RME_COVERAGE_MARKER();
+        
+        return _RME_Trace_Get(Reg,Sub_ID,Param1);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+
     /* Return whatever the function returns */
     return __RME_Kern_Func_Handler(Captbl,Reg,Func_ID,Sub_ID,Param1,Param2);
 }
 /* End Function:_RME_Kern_Act ************************************************/
 
+#ifdef RME_TRACE
+/* Begin Function:_RME_Trace_Put **********************************************
+Description : Record a kernel event into the trace ring of a CPU. Only the CPU
+              itself ever writes to its ring, and it does so in the kernel, so
+              no locking is needed. When the ring is full, the oldest event is
+              overwritten.
+Input       : struct RME_CPU_Local* CPU_Local - The CPU-local data structure.
+              rme_ptr_t Type - The event type.
+              rme_ptr_t Arg0 - The first argument of the event.
+              rme_ptr_t Arg1 - The second argument of the event.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void _RME_Trace_Put(struct RME_CPU_Local* CPU_Local, rme_ptr_t Type, rme_ptr_t Arg0, rme_ptr_t Arg1)
+{
+    struct RME_Trace_Entry* Entry;
+
+    Entry=&(CPU_Local->Trace.Entry[CPU_Local->Trace.Head&(RME_TRACE_NUM-1)]);
+    Entry->Time=RME_CYCLE_GET();
+    Entry->Type=Type;
+    Entry->Arg[0]=Arg0;
+    Entry->Arg[1]=Arg1;
+    CPU_Local->Trace.Head++;
+}
+/* End Function:_RME_Trace_Put ***********************************************/
+#endif
+
+/* Begin Function:_RME_Trace_Get **********************************************
+Description : Read the kernel event trace ring of the current CPU. The events are
+              numbered from the first one ever recorded, and only the latest
+              RME_TRACE_NUM ones are still held. The caller polls the head to
+              learn how far the kernel has written, and then reads the events
+              in between. This always fails if the trace is not compiled in.
+Input       : struct RME_Reg_Struct* Reg - The current register set.
+              rme_ptr_t Sub_ID - The operation to do.
+              rme_ptr_t Pos - The number of the event to read. Not used when
+                              reading the head.
+Output      : None.
+Return      : rme_ret_t - If successful, the head, or the time of the event, or
+                          the type of the event whose arguments are returned in
+                          the signal data registers; else an error code.
+******************************************************************************/
+rme_ret_t _RME_Trace_Get(struct RME_Reg_Struct* Reg, rme_ptr_t Sub_ID, rme_ptr_t Pos)
+{
+#ifdef RME_TRACE
+    struct RME_Trace* Trace;
+    struct RME_Trace_Entry* Entry;
+    rme_ret_t Retval;
+
+    Trace=&(RME_CPU_LOCAL()->Trace);
+    
+    if(Sub_ID==RME_KERN_TRACE_HEAD)
+    {
+        RME_COVERAGE_MARKER();
+        
+        Retval=(rme_ret_t)(Trace->Head&RME_MASK_END(sizeof(rme_ptr_t)*8-2));
+        __RME_Set_Syscall_Retval(Reg,Retval);
+        return Retval;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    /* Is the event still in the ring? Unsigned wraparound makes this check right
+     * even after the head itself wraps around */
+    if((Trace->Head-Pos-1)>=RME_TRACE_NUM)
+    {
+        RME_COVERAGE_MARKER();
+        
+        return RME_ERR_KERN_OPFAIL;
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+    }
+    
+    Entry=&(Trace->Entry[Pos&(RME_TRACE_NUM-1)]);
+    if(Sub_ID==RME_KERN_TRACE_TIME)
+    {
+        RME_COVERAGE_MARKER();
+        
+        Retval=(rme_ret_t)(Entry->Time&RME_MASK_END(sizeof(rme_ptr_t)*8-2));
+    }
+    else if(Sub_ID==RME_KERN_TRACE_DATA)
+    {
+        RME_COVERAGE_MARKER();
+        
+        Retval=(rme_ret_t)(Entry->Type);
+        __RME_Set_Sig_Data(Reg,Entry->Arg[0],Entry->Arg[1]);
+    }
+    else
+    {
+        RME_COVERAGE_MARKER();
+        
+        return RME_ERR_KERN_OPFAIL;
+    }
+    
+    __RME_Set_Syscall_Retval(Reg,Retval);
+    return Retval;
+#else
+    return RME_ERR_KERN_OPFAIL;
+#endif
+}
+/* End Function:_RME_Trace_Get ***********************************************/
+
 /* End Of File ***************************************************************/
 
 /* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
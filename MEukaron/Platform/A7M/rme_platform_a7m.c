@@ -398,6 +398,19 @@ void __RME_A7M_Vect_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Vect_Num)
 }
 /* End Function:__RME_A7M_Vect_Handler ***************************************/
 
+/* Begin Function:__RME_Wake_IPI **********************************************
+Description : Ask another processor to drain its signal wakeup mailbox. There is
+              a single processor, so this is never called.
+Input       : rme_ptr_t CPUID - The CPUID of the processor.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Wake_IPI(rme_ptr_t CPUID)
+{
+    /* Empty function */
+}
+/* End Function:__RME_Wake_IPI ***********************************************/
+
 /* Begin Function:__RME_A7M_Debug_Reg_Mod *************************************
 Description : Debug register modification implementation for ARMv7-M.
 Input       : struct RME_Cap_Captbl* Captbl - The current capability table.
@@ -645,6 +658,12 @@ rme_ptr_t __RME_Low_Level_Init(void)
                        RME_A7M_SCB_SHCSR_BUSFAULTENA|
                        RME_A7M_SCB_SHCSR_MEMFAULTENA;
     
+    /* Start the cycle counter. Some Cortex-M7 have the DWT locked */
+    RME_A7M_DEMCR|=RME_A7M_DEMCR_TRCENA;
+    RME_A7M_DWT_LAR=RME_A7M_DWT_LAR_UNLOCK;
+    RME_A7M_DWT_CYCCNT=0;
+    RME_A7M_DWT_CTRL|=RME_A7M_DWT_CTRL_CYCCNTENA;
+    
     /* Set priority grouping */
     Temp=RME_A7M_SCB_AIRCR;
     Temp&=~0xFFFF0700U;
@@ -752,8 +771,8 @@ rme_ptr_t __RME_Boot(void)
     
     /* Clean up the region for vectors and events */
     RME_ASSERT(sizeof(struct __RME_A7M_Phys_Flags)<=512);
-    _RME_Clear((void*)RME_A7M_VECT_FLAG_ADDR,sizeof(struct __RME_A7M_Phys_Flags));
-    _RME_Clear((void*)RME_A7M_EVT_FLAG_ADDR,sizeof(struct __RME_A7M_Phys_Flags));
+    RME_CLEAR(RME_A7M_VECT_FLAG_ADDR,sizeof(struct __RME_A7M_Phys_Flags));
+    RME_CLEAR(RME_A7M_EVT_FLAG_ADDR,sizeof(struct __RME_A7M_Phys_Flags));
     
     /* Activate the first thread, and set its priority */
     RME_ASSERT(_RME_Thd_Boot_Crt(RME_A7M_CPT, RME_BOOT_CAPTBL, RME_BOOT_INIT_THD,
@@ -826,6 +845,21 @@ void __RME_Set_Syscall_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval)
 }
 /* End Function:__RME_Set_Syscall_Retval *************************************/
 
+/* Begin Function:__RME_Set_Sig_Data ******************************************
+Description : Set the words carried by a signal to the register set of the receiver.
+              They are placed where the second and third parameters were passed.
+Input       : rme_ptr_t Data0 - The first word.
+              rme_ptr_t Data1 - The second word.
+Output      : struct RME_Reg_Struct* Reg - The register set.
+Return      : None.
+******************************************************************************/
+void __RME_Set_Sig_Data(struct RME_Reg_Struct* Reg, rme_ptr_t Data0, rme_ptr_t Data1)
+{
+    Reg->R6=Data0;
+    Reg->R7=Data1;
+}
+/* End Function:__RME_Set_Sig_Data *******************************************/
+
 /* Begin Function:__RME_Thd_Reg_Init ******************************************
 Description : Initialize the register set for the thread.
 Input       : rme_ptr_t Entry - The thread entry address.
@@ -927,6 +961,32 @@ void __RME_Thd_Cop_Restore(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Co
 }
 /* End Function:__RME_Thd_Cop_Restore ****************************************/
 
+/* Begin Function:__RME_Inv_Reg_Init ******************************************
+Description : Initialize the register set for the invocation. The caller passes
+              its arguments in R6-R9, and the callee gets them in R5-R8. The
+              return words are left where the callee puts them in R5-R8.
+Input       : rme_ptr_t Entry - The invocation entry address.
+              rme_ptr_t Stack - The invocation stack address.
+Output      : struct RME_Reg_Struct* Reg - The register set, which holds the
+              caller's arguments on entry.
+Return      : None.
+******************************************************************************/
+void __RME_Inv_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, struct RME_Reg_Struct* Reg)
+{
+    rme_ptr_t Arg[RME_INV_ARG_NUM];
+
+    Arg[0]=Reg->R6;
+    Arg[1]=Reg->R7;
+    Arg[2]=Reg->R8;
+    Arg[3]=Reg->R9;
+
+    __RME_Thd_Reg_Init(Entry, Stack, Arg[0], Reg);
+    Reg->R6=Arg[1];
+    Reg->R7=Arg[2];
+    Reg->R8=Arg[3];
+}
+/* End Function:__RME_Inv_Reg_Init *******************************************/
+
 /* Begin Function:__RME_Inv_Reg_Save ******************************************
 Description : Save the necessary registers on invocation for returning. Only the
               registers that will influence program control flow will be saved.
@@ -1041,8 +1101,7 @@ rme_ptr_t __RME_Pgtbl_Init(struct RME_Cap_Pgtbl* Pgtbl_Op)
     
     /* Clean up the table itself - This is could be virtually unbounded if the user
      * pass in some very large length value */
-    for(Count=0;Count<RME_POW2(RME_PGTBL_NUMORD(Pgtbl_Op->Size_Num_Order));Count++)
-        Ptr[Count]=0;
+    RME_CLEAR(Ptr,RME_POW2(RME_PGTBL_NUMORD(Pgtbl_Op->Size_Num_Order))*sizeof(rme_ptr_t));
     
     return 0;
 }
@@ -1386,6 +1445,20 @@ void __RME_Pgtbl_Set(rme_ptr_t Pgtbl)
 }
 /* End Function:__RME_Pgtbl_Set **********************************************/
 
+/* Begin Function:__RME_Pgtbl_Sync ********************************************
+Description : Complete the removals of mappings made in this system call. The MPU
+              metadata is reloaded on every switch and there is a single
+              processor, so there is nothing to do.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Pgtbl_Sync(void)
+{
+    /* Empty function */
+}
+/* End Function:__RME_Pgtbl_Sync *********************************************/
+
 /* Begin Function:__RME_Pgtbl_Page_Map ****************************************
 Description : Map a page into the page table. If a page is mapped into the slot, the
               flags is actually placed on the metadata place because all pages are
@@ -53,6 +53,9 @@ __heap_limit
     EXPORT              __RME_A7M_Wait_Int
     ;Get the MSB in a word
     EXPORT              __RME_A7M_MSB_Get
+    ;Memory primitives
+    EXPORT              __RME_A7M_Clear
+    EXPORT              __RME_A7M_Memcpy
     ;Kernel main function wrapper
     EXPORT              _RME_Kmain
     ;Entering of the user mode
@@ -79,6 +82,9 @@ __heap_limit
     IMPORT              _RME_Tick_Handler
     ;The memory management fault handler of RME. This will be defined in C language.
     IMPORT              __RME_A7M_Fault_Handler
+    ;The generic memory primitives, for unaligned memory. These are in the kernel.
+    IMPORT              _RME_Clear
+    IMPORT              _RME_Memcpy
     ;The generic interrupt handler for all other vectors.
     IMPORT              __RME_A7M_Vect_Handler
 ;/* End Imports **************************************************************/
@@ -1021,6 +1027,78 @@ __RME_A7M_MSB_Get
     BX                  LR
 ;/* End Function:__RME_A7M_MSB_Get *******************************************/
 
+;/* Begin Function:__RME_A7M_Clear ********************************************
+;Description : Zero a memory area with STM bursts of 4 words. If the address or
+;              the size is not word-aligned, the generic version is used instead.
+;Input       : void* Addr - The address to clear.
+;              ptr_t Size - The size to clear.
+;Output      : None.
+;Return      : None.
+;*****************************************************************************/
+__RME_A7M_Clear
+    ORR                 R2,R0,R1
+    TST                 R2,#0x03            ; Are they word-aligned?
+    BEQ                 Clear_Aligned
+    B                   _RME_Clear          ; No, go generic
+Clear_Aligned
+    PUSH                {R4-R5}
+    MOV                 R2,#0
+    MOV                 R3,#0
+    MOV                 R4,#0
+    MOV                 R5,#0
+Clear_Burst
+    SUBS                R1,#16              ; Clear 4 words at a time
+    BLO                 Clear_Tail
+    STMIA               R0!,{R2-R5}
+    B                   Clear_Burst
+Clear_Tail
+    ADDS                R1,#16              ; Clear the words left
+    BEQ                 Clear_Done
+Clear_Word
+    STR                 R2,[R0],#4
+    SUBS                R1,#4
+    BNE                 Clear_Word
+Clear_Done
+    POP                 {R4-R5}
+    BX                  LR
+;/* End Function:__RME_A7M_Clear *********************************************/
+
+;/* Begin Function:__RME_A7M_Memcpy *******************************************
+;Description : Copy memory with LDM/STM bursts of 4 words. If any of the addresses
+;              or the size is not word-aligned, the generic version is used instead.
+;Input       : void* Dst - The destination memory region.
+;              void* Src - The source memory region.
+;              ptr_t Num - The number of bytes to copy.
+;Output      : None.
+;Return      : None.
+;*****************************************************************************/
+__RME_A7M_Memcpy
+    ORR                 R3,R0,R1
+    ORR                 R3,R3,R2
+    TST                 R3,#0x03            ; Are they word-aligned?
+    BEQ                 Memcpy_Aligned
+    B                   _RME_Memcpy         ; No, go generic
+Memcpy_Aligned
+    PUSH                {R4-R7}
+Memcpy_Burst
+    SUBS                R2,#16              ; Copy 4 words at a time
+    BLO                 Memcpy_Tail
+    LDMIA               R1!,{R3-R6}
+    STMIA               R0!,{R3-R6}
+    B                   Memcpy_Burst
+Memcpy_Tail
+    ADDS                R2,#16              ; Copy the words left
+    BEQ                 Memcpy_Done
+Memcpy_Word
+    LDR                 R3,[R1],#4
+    STR                 R3,[R0],#4
+    SUBS                R2,#4
+    BNE                 Memcpy_Word
+Memcpy_Done
+    POP                 {R4-R7}
+    BX                  LR
+;/* End Function:__RME_A7M_Memcpy ********************************************/
+
 ;/* Begin Function:__RME_Enter_User_Mode **************************************
 ;Description : Entering of the user mode, after the system finish its preliminary
 ;              booting. The function shall never return. This function should only
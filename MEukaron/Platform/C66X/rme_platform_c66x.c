@@ -257,6 +257,8 @@ rme_ptr_t __RME_SMP_Low_Level_Init(void)
 
     /* Initialize core-local data structure */
     _RME_CPU_Local_Init(RME_CPU_LOCAL(),__RME_C66X_CPUID_Get());
+    /* Start the cycle counter */
+    __RME_C66X_TSC_Init();
 
     /* Core-local interrupt controller initialization - clear all flags first */
     RME_C66X_LIC_EVTCLR(0)=0xFFFFFFFFUL;
@@ -555,6 +557,21 @@ void __RME_Set_Syscall_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval)
 }
 /* End Function:__RME_Set_Syscall_Retval *************************************/
 
+/* Begin Function:__RME_Set_Sig_Data ******************************************
+Description : Set the words carried by a signal to the register set of the receiver.
+              They are placed where the second and third parameters were passed.
+Input       : rme_ptr_t Data0 - The first word.
+              rme_ptr_t Data1 - The second word.
+Output      : struct RME_Reg_Struct* Reg - The register set.
+Return      : None.
+******************************************************************************/
+void __RME_Set_Sig_Data(struct RME_Reg_Struct* Reg, rme_ptr_t Data0, rme_ptr_t Data1)
+{
+    Reg->A6=Data0;
+    Reg->B6=Data1;
+}
+/* End Function:__RME_Set_Sig_Data *******************************************/
+
 /* Begin Function:__RME_Thd_Reg_Init ******************************************
 Description : Initialize the register set for the thread.
 Input       : rme_ptr_t Entry - The thread entry address.
@@ -708,6 +725,34 @@ void __RME_Thd_Cop_Restore(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Co
 }
 /* End Function:__RME_Thd_Cop_Restore ****************************************/
 
+/* Begin Function:__RME_Inv_Reg_Init ******************************************
+Description : Initialize the register set for the invocation. The caller passes
+              its arguments in A6, B6, A8 and B8, and the callee gets them in
+              A4, B4, A6 and B6, as the C calling convention would have them.
+              The return words are left where the callee puts them in B4, A6,
+              B6 and A8.
+Input       : rme_ptr_t Entry - The invocation entry address.
+              rme_ptr_t Stack - The invocation stack address.
+Output      : struct RME_Reg_Struct* Reg - The register set, which holds the
+              caller's arguments on entry.
+Return      : None.
+******************************************************************************/
+void __RME_Inv_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, struct RME_Reg_Struct* Reg)
+{
+    rme_ptr_t Arg[RME_INV_ARG_NUM];
+
+    Arg[0]=Reg->A6;
+    Arg[1]=Reg->B6;
+    Arg[2]=Reg->A8;
+    Arg[3]=Reg->B8;
+
+    __RME_Thd_Reg_Init(Entry, Stack, Arg[0], Reg);
+    Reg->B4=Arg[1];
+    Reg->A6=Arg[2];
+    Reg->B6=Arg[3];
+}
+/* End Function:__RME_Inv_Reg_Init *******************************************/
+
 /* Begin Function:__RME_Inv_Reg_Save ******************************************
 Description : Save the necessary registers on invocation for returning. Only the
               registers that will influence program control flow will be saved.
@@ -806,6 +851,19 @@ void __RME_Pgtbl_Set(rme_ptr_t Pgtbl)
 }
 /* End Function:__RME_Pgtbl_Set **********************************************/
 
+/* Begin Function:__RME_Pgtbl_Sync ********************************************
+Description : Complete the removals of mappings made in this system call. The XMC
+              regions are reloaded on every switch, so there is nothing to do.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Pgtbl_Sync(void)
+{
+    /* Empty function */
+}
+/* End Function:__RME_Pgtbl_Sync *********************************************/
+
 /* Begin Function:__RME_C66X_MMU_Update ***************************************
 Description : Update the MMU contents according to the metadata.
 Input       : struct RME_Cap_Pgtbl* Pgtbl - The capability to the top-level page table.
@@ -1039,6 +1097,19 @@ void __RME_C66X_Generic_Handler(struct RME_Reg_Struct* Reg)
 }
 /* End Function:__RME_C66X_Generic_Handler ***********************************/
 
+/* Begin Function:__RME_Wake_IPI **********************************************
+Description : Ask another processor to drain its signal wakeup mailbox. There is
+              a single processor, so this is never called.
+Input       : rme_ptr_t CPUID - The CPUID of the processor.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Wake_IPI(rme_ptr_t CPUID)
+{
+    /* Empty function */
+}
+/* End Function:__RME_Wake_IPI ***********************************************/
+
 /* Begin Function:__RME_Pgtbl_Kmem_Init ***************************************
 Description : Initialize the kernel mapping tables, so it can be added to all the
               top-level page tables. In C66X, we do not need to add such pages.
@@ -72,6 +72,10 @@ __RME_C66X_Stack_Addr:
     .global             __RME_C66X_Set_ECR
     ;Set IERR
     .global             __RME_C66X_Get_IERR
+    ;Start the timestamp counter
+    .global             __RME_C66X_TSC_Init
+    ;Read the timestamp counter
+    .global             __RME_C66X_TSC_Get
 ;/* End Exports **************************************************************/
 
 ;/* Begin Imports ************************************************************/
@@ -231,6 +235,30 @@ __RME_C66X_Get_IERR:
     BNOP                B3,5
 ;/* End Function:__RME_C66X_Get_IERR *****************************************/
 
+;/* Begin Function:__RME_C66X_TSC_Init ****************************************
+;Description : Start the timestamp counter of this core. Any write starts it.
+;Input       : None.
+;Output      : None.
+;Return      : None.
+;*****************************************************************************/
+__RME_C66X_TSC_Init:
+    ZERO                B4
+    MVC                 B4,TSCL
+    BNOP                B3,5
+;/* End Function:__RME_C66X_TSC_Init *****************************************/
+
+;/* Begin Function:__RME_C66X_TSC_Get *****************************************
+;Description : Read the low word of the timestamp counter of this core.
+;Input       : None.
+;Output      : None.
+;Return      : A4 - The low word of the timestamp counter.
+;*****************************************************************************/
+__RME_C66X_TSC_Get:
+    MVC                 TSCL,B4
+    MV                  B4,A4
+    BNOP                B3,5
+;/* End Function:__RME_C66X_TSC_Get ******************************************/
+
 ;/* Begin Function:__RME_C66X_Read_Acquire ************************************
 ;Description : Load acquire - no operation will begin until this load finishes.
 ;Input       : rme_ptr_t* A4 - The address to load from.
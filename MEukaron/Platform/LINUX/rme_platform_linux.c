@@ -0,0 +1,1228 @@
+/******************************************************************************
+Filename    : rme_platform_linux.c
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The hardware abstraction layer for running RME in a Linux process.
+              This is a development and testing vehicle: the kernel core runs
+              unmodified, the simulated CPUs are pthreads, the thread register
+              sets are ucontexts, and the timer tick is a per-CPU POSIX timer.
+              Nothing is isolated from anything, as all the "processes" share
+              the host process's address space.
+
+* Generic Code Section *******************************************************
+Small utility functions that can be either implemented with C or assembly, and
+the entry of the kernel. Also responsible for debug printing and CPUID getting.
+
+* Handler Code Section *******************************************************
+Contains the trap paths between the user threads and the kernel loop, the tick
+signal handler and the kernel function handler.
+Caveats:
+1. A tick may preempt a user thread anywhere, including inside the C library.
+   If another thread on the same CPU then calls into the C library, it may
+   deadlock or corrupt its state. Use the kernel debug print from user threads,
+   or set RME_LINUX_TIMER_PREEMPT to RME_FALSE.
+2. The errno and all other host thread-local variables are shared among all
+   user threads running on the same simulated CPU.
+3. glibc's swapcontext saves and restores the signal mask with a system call,
+   so a trap costs at least two host system calls.
+
+* Initialization Code Section ************************************************
+Low-level initialization and booting. The main thread of the process is CPU 0,
+and the other CPUs are started as pthreads after the boot objects are created.
+
+* Register Manipulation Section **********************************************
+Low-level register manipulations and parameter extractions.
+
+* Page Table Section *********************************************************
+Page table related operations are all here. They are pure bookkeeping because
+we cannot change the host's address space on each context switch.
+
+******************************************************************************/
+
+/* Includes ******************************************************************/
+/* SIGEV_THREAD_ID is Linux-specific */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define __HDR_DEFS__
+#include "Platform/LINUX/rme_platform_linux.h"
+#include "Kernel/rme_kernel.h"
+#undef __HDR_DEFS__
+
+#define __HDR_STRUCTS__
+#include "Platform/LINUX/rme_platform_linux.h"
+#include "Kernel/rme_kernel.h"
+#undef __HDR_STRUCTS__
+
+/* Private include */
+#include "Platform/LINUX/rme_platform_linux.h"
+
+#define __HDR_PUBLIC_MEMBERS__
+#include "Kernel/rme_kernel.h"
+#undef __HDR_PUBLIC_MEMBERS__
+
+/* Older C libraries do not have this */
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id          _sigev_un._tid
+#endif
+/* End Includes **************************************************************/
+
+/* Begin Function:main ********************************************************
+Description : The entry of the operating system. The main thread of the process
+              becomes CPU 0.
+Input       : None.
+Output      : None.
+Return      : int - Dummy value, this function never returns.
+******************************************************************************/
+int main(void)
+{
+    /* The main function of the kernel - we will start our kernel boot here */
+    RME_Kmain();
+    return 0;
+}
+/* End Function:main *********************************************************/
+
+/* Begin Function:__RME_Disable_Int *******************************************
+Description : Disable the interrupts on this simulated CPU, by masking the tick
+              and wakeup signals on this host thread.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Disable_Int(void)
+{
+    sigset_t Set;
+
+    sigemptyset(&Set);
+    sigaddset(&Set, RME_LINUX_TICK_SIGNAL);
+    sigaddset(&Set, RME_LINUX_WAKE_SIGNAL);
+    pthread_sigmask(SIG_BLOCK, &Set, 0);
+}
+/* End Function:__RME_Disable_Int ********************************************/
+
+/* Begin Function:__RME_Enable_Int ********************************************
+Description : Enable the interrupts on this simulated CPU, by unmasking the tick
+              and wakeup signals on this host thread.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Enable_Int(void)
+{
+    sigset_t Set;
+
+    sigemptyset(&Set);
+    sigaddset(&Set, RME_LINUX_TICK_SIGNAL);
+    sigaddset(&Set, RME_LINUX_WAKE_SIGNAL);
+    pthread_sigmask(SIG_UNBLOCK, &Set, 0);
+}
+/* End Function:__RME_Enable_Int *********************************************/
+
+/* Begin Function:__RME_Putchar ***********************************************
+Description : Output a character to console. We just write to the standard output.
+Input       : char Char - The character to print.
+Output      : None.
+Return      : rme_ptr_t - Always 0.
+******************************************************************************/
+rme_ptr_t __RME_Putchar(char Char)
+{
+    RME_ASSERT(write(STDOUT_FILENO, &Char, 1)==1);
+    return 0;
+}
+/* End Function:__RME_Putchar ************************************************/
+
+/* Begin Function:__RME_CPUID_Get *********************************************
+Description : Get the CPUID. This is to identify where we are executing.
+Input       : None.
+Output      : None.
+Return      : rme_ptr_t - The CPUID.
+******************************************************************************/
+rme_ptr_t __RME_CPUID_Get(void)
+{
+    return RME_CPU_LOCAL()->CPUID;
+}
+/* End Function:__RME_CPUID_Get **********************************************/
+
+/* Begin Function:__RME_LINUX_Cycle_Get ***************************************
+Description : Get the free-running cycle counter. We have no access to the real
+              one in a portable way, so the host monotonic clock is used.
+Input       : None.
+Output      : None.
+Return      : rme_ptr_t - The counter value, in nanoseconds.
+******************************************************************************/
+rme_ptr_t __RME_LINUX_Cycle_Get(void)
+{
+    struct timespec Time;
+
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return ((rme_ptr_t)Time.tv_sec)*1000000000ULL+(rme_ptr_t)Time.tv_nsec;
+}
+/* End Function:__RME_LINUX_Cycle_Get ****************************************/
+
+/* Begin Function:__RME_LINUX_Kern_Loop ***************************************
+Description : The kernel loop of a simulated CPU. It runs on the host thread's
+              own stack, and the user threads trap back here by swapcontext.
+              The trap frame is in the CPU structure; after the trap is handled
+              we resume whatever context the trap frame points to now.
+Input       : struct __RME_LINUX_CPU* Self - The simulated CPU.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_LINUX_Kern_Loop(struct __RME_LINUX_CPU* Self)
+{
+    while(1)
+    {
+        switch(Self->Trap)
+        {
+            case RME_LINUX_TRAP_SVC:
+            {
+                _RME_Svc_Handler(&(Self->Reg));
+                break;
+            }
+            case RME_LINUX_TRAP_FAULT:
+            {
+                __RME_Thd_Fatal(&(Self->Reg), Self->Reg.Arg1);
+                break;
+            }
+            default:break;
+        }
+
+        /* Take the wakeups and the tick, whether they trapped us here or arrived while
+         * we were in the kernel. The signal handler may set the flags at any time */
+        if(__atomic_exchange_n(&(Self->Wake_Pend), 0, __ATOMIC_SEQ_CST)!=0)
+        {
+            _RME_Kern_Wake(Self->Local);
+            _RME_Kern_High(&(Self->Reg), Self->Local);
+        }
+        if(__atomic_exchange_n(&(Self->Tick_Pend), 0, __ATOMIC_SEQ_CST)!=0)
+        {
+            if(Self->Local->CPUID==0)
+                _RME_Tick_Handler(&(Self->Reg));
+            else
+                _RME_Tick_SMP_Handler(&(Self->Reg));
+        }
+
+        Self->Trap=RME_LINUX_TRAP_NONE;
+        RME_ASSERT(swapcontext(&(Self->Kern_Ctx), (ucontext_t*)(Self->Reg.Ctx))==0);
+    }
+}
+/* End Function:__RME_LINUX_Kern_Loop ****************************************/
+
+/* Begin Function:__RME_LINUX_Kern_Exit ***************************************
+Description : The user-side half of returning from the kernel. A tick or wakeup
+              that came after the kernel loop checked for it is taken here.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_LINUX_Kern_Exit(void)
+{
+    struct __RME_LINUX_CPU* Self;
+
+    /* Keep the trap frame accesses before this point */
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    Self=RME_LINUX_Self;
+    Self->In_Kern=0;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+
+    if(RME_LINUX_TIMER_PREEMPT==RME_TRUE)
+    {
+        if(Self->Tick_Pend!=0)
+            __RME_LINUX_Trap(RME_LINUX_TRAP_TICK, 0);
+        else if(Self->Wake_Pend!=0)
+            __RME_LINUX_Trap(RME_LINUX_TRAP_WAKE, 0);
+    }
+}
+/* End Function:__RME_LINUX_Kern_Exit ****************************************/
+
+/* Begin Function:__RME_LINUX_Trap ********************************************
+Description : Trap from a user thread into the kernel loop. The registers of the
+              user thread are saved into a ucontext on its own stack.
+Input       : rme_ptr_t Trap - The reason of the trap.
+              rme_ptr_t Param - The parameter of the trap, if there is one.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_LINUX_Trap(rme_ptr_t Trap, rme_ptr_t Param)
+{
+    ucontext_t Ctx;
+    struct __RME_LINUX_CPU* Self;
+
+    Self=RME_LINUX_Self;
+    Self->In_Kern=1;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    Self->Trap=Trap;
+    if(Trap==RME_LINUX_TRAP_FAULT)
+        Self->Reg.Arg1=Param;
+    Self->Reg.Ctx=(rme_ptr_t)&Ctx;
+    RME_ASSERT(swapcontext(&Ctx, &(Self->Kern_Ctx))==0);
+
+    __RME_LINUX_Kern_Exit();
+}
+/* End Function:__RME_LINUX_Trap *********************************************/
+
+/* Begin Function:__RME_LINUX_Svc *********************************************
+Description : The system call gate for the user threads. This is the only way
+              that the user threads talk to the kernel.
+Input       : rme_ptr_t Svc_Capid - The system call number and capability ID.
+              rme_ptr_t Param1 - Argument 1.
+              rme_ptr_t Param2 - Argument 2.
+              rme_ptr_t Param3 - Argument 3.
+Output      : rme_ptr_t* Reg_Ret - The argument registers Arg0 to Arg3 after the
+                                 call, 4 words. Arg0 is the invocation return
+                                 value, and Arg2 and Arg3 are the words carried
+                                 by a received signal. Optional.
+Return      : rme_ret_t - The return value of the system call.
+******************************************************************************/
+rme_ret_t __RME_LINUX_Svc(rme_ptr_t Svc_Capid, rme_ptr_t Param1, rme_ptr_t Param2,
+                          rme_ptr_t Param3, rme_ptr_t* Reg_Ret)
+{
+    ucontext_t Ctx;
+    rme_ret_t Retval;
+    struct __RME_LINUX_CPU* Self;
+
+    Self=RME_LINUX_Self;
+    Self->In_Kern=1;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    Self->Trap=RME_LINUX_TRAP_SVC;
+    Self->Reg.Arg0=Svc_Capid;
+    Self->Reg.Arg1=Param1;
+    Self->Reg.Arg2=Param2;
+    Self->Reg.Arg3=Param3;
+    Self->Reg.Ctx=(rme_ptr_t)&Ctx;
+    RME_ASSERT(swapcontext(&Ctx, &(Self->Kern_Ctx))==0);
+
+    /* If the thread was rebound, we may be running on another host thread now */
+    Self=RME_LINUX_Self;
+    Retval=(rme_ret_t)(Self->Reg.Retval);
+    if(Reg_Ret!=0)
+    {
+        Reg_Ret[0]=Self->Reg.Arg0;
+        Reg_Ret[1]=Self->Reg.Arg1;
+        Reg_Ret[2]=Self->Reg.Arg2;
+        Reg_Ret[3]=Self->Reg.Arg3;
+    }
+
+    __RME_LINUX_Kern_Exit();
+    return Retval;
+}
+/* End Function:__RME_LINUX_Svc **********************************************/
+
+/* Begin Function:__RME_LINUX_Thd_Entry ***************************************
+Description : The first function that a new thread or invocation runs. The entry
+              and parameters are still in the trap frame. If the entry returns,
+              we attempt to return from the invocation with its return value;
+              if this is not an invocation, the thread faults.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_LINUX_Thd_Entry(void)
+{
+    rme_ptr_t Entry;
+    rme_ptr_t Param0;
+    rme_ptr_t Param1;
+    rme_ret_t Retval;
+
+    Entry=RME_LINUX_Self->Reg.Entry;
+    Param0=RME_LINUX_Self->Reg.Arg0;
+    Param1=RME_LINUX_Self->Reg.Arg1;
+    __RME_LINUX_Kern_Exit();
+
+    Retval=((rme_ret_t (*)(rme_ptr_t, rme_ptr_t))Entry)(Param0, Param1);
+
+    __RME_LINUX_Svc(((rme_ptr_t)RME_SVC_INV_RET)<<32, (rme_ptr_t)Retval, 0, 0, 0);
+    __RME_LINUX_Trap(RME_LINUX_TRAP_FAULT, RME_LINUX_FAULT_RETURN);
+}
+/* End Function:__RME_LINUX_Thd_Entry ****************************************/
+
+/* Begin Function:__RME_LINUX_Int_Handler *************************************
+Description : The tick and wakeup signal handler. If we are in the kernel, they
+              are left pending for the kernel loop; otherwise we trap right away,
+              from the user thread's stack.
+Input       : int Signal - The signal number.
+              siginfo_t* Info - The signal information.
+              void* Context - The interrupted context.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_LINUX_Int_Handler(int Signal, siginfo_t* Info, void* Context)
+{
+    int Errno;
+    rme_ptr_t Trap;
+    struct __RME_LINUX_CPU* Self;
+
+    Self=RME_LINUX_Self;
+    if(Signal==RME_LINUX_WAKE_SIGNAL)
+    {
+        Self->Wake_Pend=1;
+        Trap=RME_LINUX_TRAP_WAKE;
+    }
+    else
+    {
+        Self->Tick_Pend=1;
+        Trap=RME_LINUX_TRAP_TICK;
+    }
+
+    if((Self->In_Kern!=0)||(RME_LINUX_TIMER_PREEMPT!=RME_TRUE))
+        return;
+
+    /* Other threads may run before this one is resumed */
+    Errno=errno;
+    __RME_LINUX_Trap(Trap, 0);
+    errno=Errno;
+}
+/* End Function:__RME_LINUX_Int_Handler **************************************/
+
+/* Begin Function:__RME_Wake_IPI **********************************************
+Description : Ask another simulated CPU to drain its signal wakeup mailbox. The
+              wakeup signal is sent to its host thread.
+Input       : rme_ptr_t CPUID - The CPUID of the simulated CPU.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Wake_IPI(rme_ptr_t CPUID)
+{
+    RME_ASSERT(pthread_kill(RME_LINUX_CPU[CPUID].Thread, RME_LINUX_WAKE_SIGNAL)==0);
+}
+/* End Function:__RME_Wake_IPI ***********************************************/
+
+/* Begin Function:__RME_Kern_Func_Handler *************************************
+Description : Handle kernel function calls.
+Input       : struct RME_Cap_Captbl* Captbl - The current capability table.
+              struct RME_Reg_Struct* Reg - The current register set.
+              rme_ptr_t Func_ID - The function ID.
+              rme_ptr_t Sub_ID - The subfunction ID.
+              rme_ptr_t Param1 - The first parameter.
+              rme_ptr_t Param2 - The second parameter.
+Output      : None.
+Return      : rme_ret_t - The value that the function returned.
+******************************************************************************/
+rme_ret_t __RME_Kern_Func_Handler(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
+                                  rme_ptr_t Func_ID, rme_ptr_t Sub_ID, rme_ptr_t Param1, rme_ptr_t Param2)
+{
+    sigset_t Set;
+
+    switch(Func_ID)
+    {
+        case RME_KERN_IDLE_SLEEP:
+        {
+            /* Wait for the next tick or wakeup - check and sleep with them masked
+             * so that we cannot miss them. They will be taken on our way out */
+            __RME_Disable_Int();
+            if((RME_LINUX_Self->Tick_Pend==0)&&(RME_LINUX_Self->Wake_Pend==0))
+            {
+                sigemptyset(&Set);
+                sigsuspend(&Set);
+            }
+            __RME_Enable_Int();
+
+            __RME_Set_Syscall_Retval(Reg,0);
+
+            return 0;
+        }
+        case RME_KERN_DEBUG_PRINT:
+        {
+            __RME_Putchar((char)Sub_ID);
+
+            __RME_Set_Syscall_Retval(Reg,0);
+
+            return 0;
+        }
+        default:break;
+    }
+
+    /* If it gets here, we must have failed */
+    return RME_ERR_KERN_OPFAIL;
+}
+/* End Function:__RME_Kern_Func_Handler **************************************/
+
+/* Begin Function:__RME_LINUX_Map *********************************************
+Description : Map a zeroed memory region from the host.
+Input       : rme_ptr_t Size - The size of the region.
+Output      : None.
+Return      : void* - The address of the region.
+******************************************************************************/
+void* __RME_LINUX_Map(rme_ptr_t Size)
+{
+    void* Addr;
+
+    Addr=mmap(0, Size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    RME_ASSERT(Addr!=MAP_FAILED);
+
+    return Addr;
+}
+/* End Function:__RME_LINUX_Map **********************************************/
+
+/* Begin Function:__RME_LINUX_Timer_Init **************************************
+Description : Start the tick timer of this simulated CPU. The timer signal is
+              directed to the calling host thread only.
+Input       : struct __RME_LINUX_CPU* Self - The simulated CPU.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_LINUX_Timer_Init(struct __RME_LINUX_CPU* Self)
+{
+    struct sigevent Event;
+    struct itimerspec Period;
+
+    _RME_Clear(&Event, sizeof(struct sigevent));
+    Event.sigev_notify=SIGEV_THREAD_ID;
+    Event.sigev_signo=RME_LINUX_TICK_SIGNAL;
+    Event.sigev_notify_thread_id=syscall(SYS_gettid);
+    RME_ASSERT(timer_create(CLOCK_MONOTONIC, &Event, &(Self->Timer))==0);
+
+    Period.it_interval.tv_sec=0;
+    Period.it_interval.tv_nsec=1000000000/RME_LINUX_TIMER_FREQ;
+    Period.it_value=Period.it_interval;
+    RME_ASSERT(timer_settime(Self->Timer, 0, &Period, 0)==0);
+}
+/* End Function:__RME_LINUX_Timer_Init ***************************************/
+
+/* Begin Function:__RME_Low_Level_Init ****************************************
+Description : Initialize the low-level hardware. We map the kernel memory, the
+              kernel object table and the hypervisor region, and initialize all
+              the simulated CPUs.
+Input       : None.
+Output      : None.
+Return      : rme_ptr_t - Always 0.
+******************************************************************************/
+rme_ptr_t __RME_Low_Level_Init(void)
+{
+    rme_cnt_t Count;
+    struct sigaction Action;
+
+    RME_LINUX_Kmem_Base=__RME_LINUX_Map(RME_KMEM_SIZE);
+    RME_LINUX_Kotbl=(rme_ptr_t*)__RME_LINUX_Map(RME_KOTBL_WORD_NUM*sizeof(rme_ptr_t));
+    RME_LINUX_Kotbl_Sum=(rme_ptr_t*)__RME_LINUX_Map(RME_KOTBL_SUM_NUM*sizeof(rme_ptr_t));
+    RME_LINUX_Hyp_Base=__RME_LINUX_Map(RME_HYP_SIZE);
+
+    /* Initialize CPU-local data structures, and the init thread stacks */
+    for(Count=0;Count<RME_LINUX_CPU_NUM;Count++)
+    {
+        RME_LINUX_CPU[Count].Local=&RME_LINUX_CPU_Local[Count];
+        _RME_CPU_Local_Init(RME_LINUX_CPU[Count].Local, Count);
+        RME_LINUX_CPU[Count].Init_Stack=(rme_ptr_t)__RME_LINUX_Map(RME_LINUX_INIT_STACK_SIZE);
+    }
+
+    /* We are CPU 0 */
+    RME_LINUX_Self=&RME_LINUX_CPU[0];
+    RME_LINUX_Local=RME_LINUX_CPU[0].Local;
+
+    /* All new threads are created from this context, with the tick unmasked */
+    RME_ASSERT(getcontext(&RME_LINUX_Ctx_Tmpl)==0);
+    sigemptyset(&(RME_LINUX_Ctx_Tmpl.uc_sigmask));
+
+    /* Install the tick and wakeup handler. The tick itself is started when each CPU
+     * boots. Neither of them may interrupt the other */
+    _RME_Clear(&Action, sizeof(struct sigaction));
+    Action.sa_sigaction=__RME_LINUX_Int_Handler;
+    Action.sa_flags=SA_SIGINFO|SA_RESTART;
+    sigemptyset(&(Action.sa_mask));
+    sigaddset(&(Action.sa_mask), RME_LINUX_TICK_SIGNAL);
+    sigaddset(&(Action.sa_mask), RME_LINUX_WAKE_SIGNAL);
+    RME_ASSERT(sigaction(RME_LINUX_TICK_SIGNAL, &Action, 0)==0);
+    RME_ASSERT(sigaction(RME_LINUX_WAKE_SIGNAL, &Action, 0)==0);
+
+    return 0;
+}
+/* End Function:__RME_Low_Level_Init *****************************************/
+
+/* Begin Function:__RME_LINUX_SMP_Entry ***************************************
+Description : The entry of the host threads of the non-booting CPUs. All their
+              kernel objects are ready when they are started.
+Input       : void* Param - The simulated CPU.
+Output      : None.
+Return      : void* - Dummy value, this function never returns.
+******************************************************************************/
+void* __RME_LINUX_SMP_Entry(void* Param)
+{
+    struct __RME_LINUX_CPU* Self;
+
+    Self=(struct __RME_LINUX_CPU*)Param;
+    RME_LINUX_Self=Self;
+    RME_LINUX_Local=Self->Local;
+
+    __RME_Enter_User_Mode((rme_ptr_t)RME_LINUX_INIT_ENTRY,
+                          Self->Init_Stack+RME_LINUX_INIT_STACK_SIZE, Self->Local->CPUID);
+
+    return 0;
+}
+/* End Function:__RME_LINUX_SMP_Entry ****************************************/
+
+/* Begin Function:__RME_Boot **************************************************
+Description : Boot the first process in the system.
+Input       : None.
+Output      : None.
+Return      : rme_ptr_t - Always 0.
+******************************************************************************/
+rme_ptr_t __RME_Boot(void)
+{
+    rme_ptr_t Cur_Addr;
+    rme_cnt_t Count;
+
+    Cur_Addr=RME_KMEM_VA_START;
+
+    /* Create the capability table for the init process */
+    RME_ASSERT(_RME_Captbl_Boot_Init(RME_BOOT_CAPTBL, Cur_Addr, RME_LINUX_BOOT_CAPTBL_SIZE)==0);
+    Cur_Addr+=RME_KOTBL_ROUND(RME_CAPTBL_SIZE(RME_LINUX_BOOT_CAPTBL_SIZE));
+
+    /* Create the page table for the init process - the whole user address space
+     * as one page. This is only bookkeeping anyway */
+    RME_ASSERT(_RME_Pgtbl_Boot_Crt(RME_LINUX_CPT, RME_BOOT_CAPTBL, RME_BOOT_PGTBL,
+               Cur_Addr, 0, RME_PGTBL_TOP, RME_PGTBL_SIZE_128T, RME_PGTBL_NUM_1)==0);
+    Cur_Addr+=RME_KOTBL_ROUND(RME_PGTBL_SIZE_TOP(RME_PGTBL_NUM_1));
+    RME_ASSERT(_RME_Pgtbl_Boot_Add(RME_LINUX_CPT, RME_BOOT_PGTBL, 0, 0, RME_PGTBL_ALL_PERM)==0);
+
+    /* Activate the first process - This process cannot be deleted */
+    RME_ASSERT(_RME_Proc_Boot_Crt(RME_LINUX_CPT, RME_BOOT_CAPTBL, RME_BOOT_INIT_PROC,
+                                  RME_BOOT_CAPTBL, RME_BOOT_PGTBL, Cur_Addr)==0);
+    Cur_Addr+=RME_KOTBL_ROUND(RME_PROC_SIZE);
+
+    /* Create the initial kernel function capability, and kernel memory capability */
+    RME_ASSERT(_RME_Kern_Boot_Crt(RME_LINUX_CPT, RME_BOOT_CAPTBL, RME_BOOT_INIT_KERN)==0);
+    RME_ASSERT(_RME_Kmem_Boot_Crt(RME_LINUX_CPT,
+                                  RME_BOOT_CAPTBL,
+                                  RME_BOOT_INIT_KMEM,
+                                  RME_KMEM_VA_START,
+                                  RME_KMEM_VA_START+RME_KMEM_SIZE-1,
+                                  RME_KMEM_FLAG_CAPTBL|RME_KMEM_FLAG_PGTBL|RME_KMEM_FLAG_PROC|
+                                  RME_KMEM_FLAG_THD|RME_KMEM_FLAG_SIG|RME_KMEM_FLAG_INV)==0);
+
+    /* Create the initial kernel endpoints for timer ticks */
+    RME_ASSERT(_RME_Captbl_Boot_Crt(RME_LINUX_CPT, RME_BOOT_CAPTBL, RME_BOOT_TBL_TIMER, Cur_Addr, RME_LINUX_CPU_NUM)==0);
+    Cur_Addr+=RME_KOTBL_ROUND(RME_CAPTBL_SIZE(RME_LINUX_CPU_NUM));
+    for(Count=0;Count<RME_LINUX_CPU_NUM;Count++)
+    {
+        RME_LINUX_CPU[Count].Local->Tick_Sig=(struct RME_Sig_Struct*)Cur_Addr;
+        RME_ASSERT(_RME_Sig_Boot_Crt(RME_LINUX_CPT, RME_BOOT_TBL_TIMER, Count, Cur_Addr)==0);
+        Cur_Addr+=RME_KOTBL_ROUND(RME_SIG_SIZE);
+    }
+
+    /* Create the initial kernel endpoints for all other interrupts */
+    RME_ASSERT(_RME_Captbl_Boot_Crt(RME_LINUX_CPT, RME_BOOT_CAPTBL, RME_BOOT_TBL_INT, Cur_Addr, RME_LINUX_CPU_NUM)==0);
+    Cur_Addr+=RME_KOTBL_ROUND(RME_CAPTBL_SIZE(RME_LINUX_CPU_NUM));
+    for(Count=0;Count<RME_LINUX_CPU_NUM;Count++)
+    {
+        RME_LINUX_CPU[Count].Local->Vect_Sig=(struct RME_Sig_Struct*)Cur_Addr;
+        RME_ASSERT(_RME_Sig_Boot_Crt(RME_LINUX_CPT, RME_BOOT_TBL_INT, Count, Cur_Addr)==0);
+        Cur_Addr+=RME_KOTBL_ROUND(RME_SIG_SIZE);
+    }
+
+    /* Activate the first threads, one on each CPU */
+    RME_ASSERT(_RME_Captbl_Boot_Crt(RME_LINUX_CPT, RME_BOOT_CAPTBL, RME_BOOT_TBL_THD, Cur_Addr, RME_LINUX_CPU_NUM)==0);
+    Cur_Addr+=RME_KOTBL_ROUND(RME_CAPTBL_SIZE(RME_LINUX_CPU_NUM));
+    for(Count=0;Count<RME_LINUX_CPU_NUM;Count++)
+    {
+        RME_ASSERT(_RME_Thd_Boot_Crt(RME_LINUX_CPT, RME_BOOT_TBL_THD, Count, RME_BOOT_INIT_PROC,
+                                     Cur_Addr, 0, RME_LINUX_CPU[Count].Local)>=0);
+        Cur_Addr+=RME_KOTBL_ROUND(RME_THD_SIZE);
+    }
+
+    RME_PRINTK_S("\r\nKmem frontier: 0x");
+    RME_PRINTK_U(Cur_Addr);
+
+    /* Now other processors may go into their threads */
+    for(Count=1;Count<RME_LINUX_CPU_NUM;Count++)
+    {
+        RME_ASSERT(pthread_create(&(RME_LINUX_CPU[Count].Thread), 0,
+                                  __RME_LINUX_SMP_Entry, &RME_LINUX_CPU[Count])==0);
+    }
+
+    /* Boot into the init thread */
+    RME_LINUX_CPU[0].Thread=pthread_self();
+    __RME_Enter_User_Mode((rme_ptr_t)RME_LINUX_INIT_ENTRY,
+                          RME_LINUX_CPU[0].Init_Stack+RME_LINUX_INIT_STACK_SIZE, 0);
+
+    /* Dummy return, never reaches here */
+    return 0;
+}
+/* End Function:__RME_Boot ***************************************************/
+
+/* Begin Function:__RME_Enter_User_Mode ***************************************
+Description : Start the tick and enter the init thread of this simulated CPU.
+Input       : rme_ptr_t Entry_Addr - The entry address of the init thread.
+              rme_ptr_t Stack_Addr - The stack address of the init thread.
+              rme_ptr_t CPUID - The CPUID, passed to the init thread.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Enter_User_Mode(rme_ptr_t Entry_Addr, rme_ptr_t Stack_Addr, rme_ptr_t CPUID)
+{
+    struct __RME_LINUX_CPU* Self;
+
+    Self=RME_LINUX_Self;
+    __RME_Thd_Reg_Init(Entry_Addr, Stack_Addr, CPUID, &(Self->Reg));
+    Self->Trap=RME_LINUX_TRAP_NONE;
+    Self->In_Kern=1;
+
+    __RME_LINUX_Timer_Init(Self);
+    __RME_Enable_Int();
+
+    __RME_LINUX_Kern_Loop(Self);
+}
+/* End Function:__RME_Enter_User_Mode ****************************************/
+
+/* Begin Function:__RME_Get_Syscall_Param *************************************
+Description : Get the system call parameters from the trap frame.
+Input       : struct RME_Reg_Struct* Reg - The register set.
+Output      : rme_ptr_t* Svc - The system service number.
+              rme_ptr_t* Capid - The capability ID number.
+              rme_ptr_t* Param - The parameters.
+Return      : None.
+******************************************************************************/
+void __RME_Get_Syscall_Param(struct RME_Reg_Struct* Reg, rme_ptr_t* Svc, rme_ptr_t* Capid, rme_ptr_t* Param)
+{
+    *Svc=(Reg->Arg0)>>32;
+    *Capid=(Reg->Arg0)&0xFFFFFFFF;
+    Param[0]=Reg->Arg1;
+    Param[1]=Reg->Arg2;
+    Param[2]=Reg->Arg3;
+}
+/* End Function:__RME_Get_Syscall_Param **************************************/
+
+/* Begin Function:__RME_Set_Syscall_Retval ************************************
+Description : Set the system call return value to the trap frame.
+Input       : rme_ret_t Retval - The return value.
+Output      : struct RME_Reg_Struct* Reg - The register set.
+Return      : None.
+******************************************************************************/
+void __RME_Set_Syscall_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval)
+{
+    Reg->Retval=(rme_ptr_t)Retval;
+}
+/* End Function:__RME_Set_Syscall_Retval *************************************/
+
+/* Begin Function:__RME_Set_Sig_Data ******************************************
+Description : Set the words carried by a signal to the register set of the receiver.
+              They are placed where the second and third parameters were passed.
+Input       : rme_ptr_t Data0 - The first word.
+              rme_ptr_t Data1 - The second word.
+Output      : struct RME_Reg_Struct* Reg - The register set.
+Return      : None.
+******************************************************************************/
+void __RME_Set_Sig_Data(struct RME_Reg_Struct* Reg, rme_ptr_t Data0, rme_ptr_t Data1)
+{
+    Reg->Arg2=Data0;
+    Reg->Arg3=Data1;
+}
+/* End Function:__RME_Set_Sig_Data *******************************************/
+
+/* Begin Function:__RME_Thd_Reg_Init ******************************************
+Description : Initialize the register set for the thread. The ucontext is placed
+              at the top of the thread's stack, and the stack grows below it.
+              We copy it from a template rather than calling getcontext, which
+              would cost a host system call on every invocation.
+Input       : rme_ptr_t Entry - The thread entry address.
+              rme_ptr_t Stack - The thread stack address.
+              rme_ptr_t Param - The parameter to pass.
+Output      : struct RME_Reg_Struct* Reg - The register set content generated.
+Return      : None.
+******************************************************************************/
+void __RME_Thd_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, rme_ptr_t Param, struct RME_Reg_Struct* Reg)
+{
+    ucontext_t* Ctx;
+
+    Ctx=(ucontext_t*)RME_ROUND_DOWN(Stack-sizeof(ucontext_t), 4);
+    _RME_Memcpy(Ctx, &RME_LINUX_Ctx_Tmpl, sizeof(ucontext_t));
+    /* makecontext only uses the top of the stack */
+    Ctx->uc_stack.ss_sp=0;
+    Ctx->uc_stack.ss_size=(size_t)Ctx;
+    Ctx->uc_link=0;
+    makecontext(Ctx, __RME_LINUX_Thd_Entry, 0);
+
+    Reg->Retval=0;
+    Reg->Arg0=Param;
+    Reg->Arg1=0;
+    Reg->Arg2=0;
+    Reg->Arg3=0;
+    Reg->Entry=Entry;
+    Reg->Ctx=(rme_ptr_t)Ctx;
+}
+/* End Function:__RME_Thd_Reg_Init *******************************************/
+
+/* Begin Function:__RME_Thd_Reg_Copy ******************************************
+Description : Copy one set of registers into another.
+Input       : struct RME_Reg_Struct* Src - The source register set.
+Output      : struct RME_Reg_Struct* Dst - The destination register set.
+Return      : None.
+******************************************************************************/
+void __RME_Thd_Reg_Copy(struct RME_Reg_Struct* Dst, struct RME_Reg_Struct* Src)
+{
+    /* Make sure that the ordering is the same so the compiler can optimize */
+    Dst->Retval=Src->Retval;
+    Dst->Arg0=Src->Arg0;
+    Dst->Arg1=Src->Arg1;
+    Dst->Arg2=Src->Arg2;
+    Dst->Arg3=Src->Arg3;
+    Dst->Entry=Src->Entry;
+    Dst->Ctx=Src->Ctx;
+}
+/* End Function:__RME_Thd_Reg_Copy *******************************************/
+
+/* Begin Function:__RME_Thd_Cop_Init ******************************************
+Description : Initialize the coprocessor register set for the thread.
+Input       : struct RME_Reg_Struct* Reg - The register struct to help initialize the coprocessor.
+Output      : struct RME_Reg_Cop_Struct* Cop_Reg - The register set content generated.
+Return      : None.
+******************************************************************************/
+void __RME_Thd_Cop_Init(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg)
+{
+    /* Empty function, the FPU state lives in the ucontext */
+}
+/* End Function:__RME_Thd_Cop_Init *******************************************/
+
+/* Begin Function:__RME_Thd_Cop_Save ******************************************
+Description : Save the co-op register sets. The FPU state lives in the ucontext.
+Input       : struct RME_Reg_Struct* Reg - The context, used to decide whether
+                                           to save the context of the coprocessor.
+Output      : struct RME_Cop_Struct* Cop_Reg - The pointer to the coprocessor contents.
+Return      : None.
+******************************************************************************/
+void __RME_Thd_Cop_Save(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg)
+{
+    /* Empty function, the FPU state lives in the ucontext */
+}
+/* End Function:__RME_Thd_Cop_Save *******************************************/
+
+/* Begin Function:__RME_Thd_Cop_Restore ***************************************
+Description : Restore the co-op register sets. The FPU state lives in the ucontext.
+Input       : struct RME_Reg_Struct* Reg - The context, used to decide whether
+                                           to restore the context of the coprocessor.
+Output      : struct RME_Cop_Struct* Cop_Reg - The pointer to the coprocessor contents.
+Return      : None.
+******************************************************************************/
+void __RME_Thd_Cop_Restore(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg)
+{
+    /* Empty function, the FPU state lives in the ucontext */
+}
+/* End Function:__RME_Thd_Cop_Restore ****************************************/
+
+/* Begin Function:__RME_Inv_Reg_Init ******************************************
+Description : Initialize the register set for the invocation. The caller passes
+              its arguments in Arg2 and Arg3, and the callee gets them in Arg0
+              and Arg1. The return words are left where the callee puts them in
+              Arg1, Arg2 and Arg3, and the first one is then moved to Arg0.
+Input       : rme_ptr_t Entry - The invocation entry address.
+              rme_ptr_t Stack - The invocation stack address.
+Output      : struct RME_Reg_Struct* Reg - The register set, which holds the
+              caller's arguments on entry.
+Return      : None.
+******************************************************************************/
+void __RME_Inv_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, struct RME_Reg_Struct* Reg)
+{
+    rme_ptr_t Arg[RME_INV_ARG_NUM];
+
+    Arg[0]=Reg->Arg2;
+    Arg[1]=Reg->Arg3;
+
+    __RME_Thd_Reg_Init(Entry, Stack, Arg[0], Reg);
+    Reg->Arg1=Arg[1];
+}
+/* End Function:__RME_Inv_Reg_Init *******************************************/
+
+/* Begin Function:__RME_Inv_Reg_Save ******************************************
+Description : Save the necessary registers on invocation for returning. The
+              caller's ucontext is on its own stack, so we only need the pointer.
+Input       : struct RME_Reg_Struct* Reg - The register set.
+Output      : struct RME_Iret_Struct* Ret - The invocation return register context.
+Return      : None.
+******************************************************************************/
+void __RME_Inv_Reg_Save(struct RME_Iret_Struct* Ret, struct RME_Reg_Struct* Reg)
+{
+    Ret->Ctx=Reg->Ctx;
+}
+/* End Function:__RME_Inv_Reg_Save *******************************************/
+
+/* Begin Function:__RME_Inv_Reg_Restore ***************************************
+Description : Restore the necessary registers for returning from an invocation.
+Input       : struct RME_Iret_Struct* Ret - The invocation return register context.
+Output      : struct RME_Reg_Struct* Reg - The register set.
+Return      : None.
+******************************************************************************/
+void __RME_Inv_Reg_Restore(struct RME_Reg_Struct* Reg, struct RME_Iret_Struct* Ret)
+{
+    Reg->Ctx=Ret->Ctx;
+}
+/* End Function:__RME_Inv_Reg_Restore ****************************************/
+
+/* Begin Function:__RME_Set_Inv_Retval ****************************************
+Description : Set the invocation return value to the trap frame.
+Input       : rme_ret_t Retval - The return value.
+Output      : struct RME_Reg_Struct* Reg - The register set.
+Return      : None.
+******************************************************************************/
+void __RME_Set_Inv_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval)
+{
+    Reg->Arg0=(rme_ptr_t)Retval;
+}
+/* End Function:__RME_Set_Inv_Retval *****************************************/
+
+/* Begin Function:__RME_Pgtbl_Kmem_Init ***************************************
+Description : Initialize the kernel mapping tables, so it can be added to all the
+              top-level page tables. The kernel is always in the host's address
+              space, so we do not need such pages.
+Input       : None.
+Output      : None.
+Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Kmem_Init(void)
+{
+    /* Empty function, always immediately successful */
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Kmem_Init ****************************************/
+
+/* Begin Function:__RME_Pgtbl_Init ********************************************
+Description : Initialize the page table data structure, according to the capability.
+Input       : struct RME_Cap_Pgtbl* - The capability to the page table to operate on.
+Output      : None.
+Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Init(struct RME_Cap_Pgtbl* Pgtbl_Op)
+{
+    rme_cnt_t Count;
+    rme_ptr_t* Ptr;
+    struct __RME_LINUX_Pgtbl_Meta* Meta;
+
+    /* Get the actual table */
+    Meta=RME_CAP_GETOBJ(Pgtbl_Op,struct __RME_LINUX_Pgtbl_Meta*);
+
+    /* Initialize the causal metadata */
+    Meta->Base_Addr=Pgtbl_Op->Base_Addr;
+    Meta->Size_Num_Order=Pgtbl_Op->Size_Num_Order;
+    Meta->Parent_Cnt=0;
+    Meta->Child_Cnt=0;
+
+    /* Clean up the table itself - This is could be virtually unbounded if the user
+     * pass in some very large length value */
+    Ptr=RME_LINUX_PGTBL_TBL((rme_ptr_t*)Meta);
+    for(Count=0;Count<RME_POW2(RME_PGTBL_NUMORD(Pgtbl_Op->Size_Num_Order));Count++)
+        Ptr[Count]=0;
+
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Init *********************************************/
+
+/* Begin Function:__RME_Pgtbl_Check *******************************************
+Description : Check if the page table parameters are feasible, according to the
+              parameters. This is only used in page table creation.
+Input       : rme_ptr_t Base_Addr - The start mapping address.
+              rme_ptr_t Top_Flag - The top-level flag,
+              rme_ptr_t Size_Order - The size order of the page directory.
+              rme_ptr_t Num_Order - The number order of the page directory.
+              rme_ptr_t Vaddr - The virtual address of the page directory.
+Output      : None.
+Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Check(rme_ptr_t Base_Addr, rme_ptr_t Top_Flag,
+                            rme_ptr_t Size_Order, rme_ptr_t Num_Order, rme_ptr_t Vaddr)
+{
+    /* We need the low bits of the page entries for the flags */
+    if(Size_Order<RME_PGTBL_SIZE_4K)
+        return RME_ERR_PGT_OPFAIL;
+    /* The user address space of the host is 128TB */
+    if((Size_Order+Num_Order)>RME_PGTBL_SIZE_128T)
+        return RME_ERR_PGT_OPFAIL;
+    if((Vaddr&0x07)!=0)
+        return RME_ERR_PGT_OPFAIL;
+
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Check ********************************************/
+
+/* Begin Function:__RME_Pgtbl_Del_Check ***************************************
+Description : Check if the page table can be deleted.
+Input       : struct RME_Cap_Pgtbl Pgtbl_Op* - The capability to the page table to operate on.
+Output      : None.
+Return      : rme_ptr_t - If can be deleted, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Del_Check(struct RME_Cap_Pgtbl* Pgtbl_Op)
+{
+    struct __RME_LINUX_Pgtbl_Meta* Meta;
+
+    Meta=RME_CAP_GETOBJ(Pgtbl_Op,struct __RME_LINUX_Pgtbl_Meta*);
+
+    /* Check if we are standalone, and not mapped into anything */
+    if((RME_READ_ACQUIRE(&(Meta->Child_Cnt))!=0)||(RME_READ_ACQUIRE(&(Meta->Parent_Cnt))!=0))
+        return RME_ERR_PGT_OPFAIL;
+
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Del_Check ****************************************/
+
+/* Begin Function:__RME_Pgtbl_Set *********************************************
+Description : Set the processor's page table. All processes share the host's
+              address space, so there is nothing to do.
+Input       : rme_ptr_t Pgtbl - The virtual address of the page table.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Pgtbl_Set(rme_ptr_t Pgtbl)
+{
+    /* Empty function */
+}
+/* End Function:__RME_Pgtbl_Set **********************************************/
+
+/* Begin Function:__RME_Pgtbl_Sync ********************************************
+Description : Complete the removals of mappings made in this system call. All
+              processes share the host's address space, so there is nothing to do.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Pgtbl_Sync(void)
+{
+    /* Empty function */
+}
+/* End Function:__RME_Pgtbl_Sync *********************************************/
+
+/* Begin Function:__RME_Pgtbl_Page_Map ****************************************
+Description : Map a page into the page table.
+Input       : struct RME_Cap_Pgtbl* - The cap ability to the page table to operate on.
+              rme_ptr_t Paddr - The physical address to map to.
+              rme_ptr_t Pos - The position in the page table.
+              rme_ptr_t Flags - The RME standard page attributes.
+Output      : None.
+Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Page_Map(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Paddr, rme_ptr_t Pos, rme_ptr_t Flags)
+{
+    rme_ptr_t* Table;
+
+    /* It should at least be readable */
+    if((Flags&RME_PGTBL_READ)==0)
+        return RME_ERR_PGT_OPFAIL;
+
+    /* Get the table */
+    Table=RME_LINUX_PGTBL_TBL(RME_CAP_GETOBJ(Pgtbl_Op,rme_ptr_t*));
+
+    /* Try to map it in - other CPUs may be mapping into the same slot */
+    if(RME_COMP_SWAP(&(Table[Pos]),0,RME_LINUX_PGTBL_PRESENT|RME_LINUX_PGTBL_TERMINAL|
+                     RME_LINUX_PGTBL_FLAG_SET(Flags)|
+                     RME_ROUND_DOWN(Paddr,RME_PGTBL_SIZEORD(Pgtbl_Op->Size_Num_Order)))==0)
+        return RME_ERR_PGT_OPFAIL;
+
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Page_Map *****************************************/
+
+/* Begin Function:__RME_Pgtbl_Page_Unmap **************************************
+Description : Unmap a page from the page table.
+Input       : struct RME_Cap_Pgtbl* - The capability to the page table to operate on.
+              rme_ptr_t Pos - The position in the page table.
+Output      : None.
+Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Page_Unmap(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos)
+{
+    rme_ptr_t* Table;
+    rme_ptr_t Temp;
+
+    /* Get the table */
+    Table=RME_LINUX_PGTBL_TBL(RME_CAP_GETOBJ(Pgtbl_Op,rme_ptr_t*));
+
+    /* Check if we are trying to remove something that does not exist, or trying to
+     * remove a page directory */
+    Temp=Table[Pos];
+    if(((Temp&RME_LINUX_PGTBL_PRESENT)==0)||((Temp&RME_LINUX_PGTBL_TERMINAL)==0))
+        return RME_ERR_PGT_OPFAIL;
+
+    /* Try to unmap it. Use CAS just in case */
+    if(RME_COMP_SWAP(&(Table[Pos]),Temp,0)==0)
+        return RME_ERR_PGT_OPFAIL;
+
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Page_Unmap ***************************************/
+
+/* Begin Function:__RME_Pgtbl_Pgdir_Map ***************************************
+Description : Map a page directory into the page table. This architecture does not
+              support page directory flags.
+Input       : struct RME_Cap_Pgtbl* Pgtbl_Parent - The parent page table.
+              struct RME_Cap_Pgtbl* Pgtbl_Child - The child page table.
+              rme_ptr_t Pos - The position in the destination page table.
+              rme_ptr_t Flags - This have no effect.
+Output      : None.
+Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Pgdir_Map(struct RME_Cap_Pgtbl* Pgtbl_Parent, rme_ptr_t Pos,
+                                struct RME_Cap_Pgtbl* Pgtbl_Child, rme_ptr_t Flags)
+{
+    rme_ptr_t* Parent_Table;
+    struct __RME_LINUX_Pgtbl_Meta* Parent_Meta;
+    struct __RME_LINUX_Pgtbl_Meta* Child_Meta;
+
+    /* Get the metadata */
+    Parent_Meta=RME_CAP_GETOBJ(Pgtbl_Parent,struct __RME_LINUX_Pgtbl_Meta*);
+    Child_Meta=RME_CAP_GETOBJ(Pgtbl_Child,struct __RME_LINUX_Pgtbl_Meta*);
+    Parent_Table=RME_LINUX_PGTBL_TBL((rme_ptr_t*)Parent_Meta);
+
+    /* Try to map it in - the address is always aligned to the kernel memory slot */
+    if(RME_COMP_SWAP(&(Parent_Table[Pos]),0,
+                     RME_LINUX_PGTBL_PRESENT|RME_LINUX_PGTBL_PGD_ADDR((rme_ptr_t)Child_Meta))==0)
+        return RME_ERR_PGT_OPFAIL;
+
+    /* Map complete, increase reference count for both page tables */
+    RME_FETCH_ADD(&(Child_Meta->Parent_Cnt),1);
+    RME_FETCH_ADD(&(Parent_Meta->Child_Cnt),1);
+
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Pgdir_Map ****************************************/
+
+/* Begin Function:__RME_Pgtbl_Pgdir_Unmap *************************************
+Description : Unmap a page directory from the page table.
+Input       : struct RME_Cap_Pgtbl* Pgtbl_Op - The page table to operate on.
+              rme_ptr_t Pos - The position in the page table.
+Output      : None.
+Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Pgdir_Unmap(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos)
+{
+    rme_ptr_t* Table;
+    rme_ptr_t Temp;
+    struct __RME_LINUX_Pgtbl_Meta* Parent_Meta;
+    struct __RME_LINUX_Pgtbl_Meta* Child_Meta;
+
+    /* Get the metadata */
+    Parent_Meta=RME_CAP_GETOBJ(Pgtbl_Op,struct __RME_LINUX_Pgtbl_Meta*);
+    Table=RME_LINUX_PGTBL_TBL((rme_ptr_t*)Parent_Meta);
+
+    /* Check if we try to remove something nonexistent, or a page */
+    Temp=Table[Pos];
+    if(((Temp&RME_LINUX_PGTBL_PRESENT)==0)||((Temp&RME_LINUX_PGTBL_TERMINAL)!=0))
+        return RME_ERR_PGT_OPFAIL;
+
+    Child_Meta=(struct __RME_LINUX_Pgtbl_Meta*)RME_LINUX_PGTBL_PGD_ADDR(Temp);
+    /* Try to unmap it. Use CAS just in case */
+    if(RME_COMP_SWAP(&(Table[Pos]),Temp,0)==0)
+        return RME_ERR_PGT_OPFAIL;
+
+    /* Decrease reference count */
+    RME_FETCH_ADD(&(Child_Meta->Parent_Cnt),-1);
+    RME_FETCH_ADD(&(Parent_Meta->Child_Cnt),-1);
+
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Pgdir_Unmap **************************************/
+
+/* Begin Function:__RME_Pgtbl_Lookup ******************************************
+Description : Lookup a page entry in a page directory.
+Input       : struct RME_Cap_Pgtbl* Pgtbl_Op - The page directory to lookup.
+              rme_ptr_t Pos - The position to look up.
+Output      : rme_ptr_t* Paddr - The physical address of the page.
+              rme_ptr_t* Flags - The RME standard flags of the page.
+Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Lookup(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos, rme_ptr_t* Paddr, rme_ptr_t* Flags)
+{
+    rme_ptr_t* Table;
+    rme_ptr_t Temp;
+
+    /* Check if the position is within the range of this page table */
+    if((Pos>>RME_PGTBL_NUMORD(Pgtbl_Op->Size_Num_Order))!=0)
+        return RME_ERR_PGT_OPFAIL;
+
+    /* Get the table */
+    Table=RME_LINUX_PGTBL_TBL(RME_CAP_GETOBJ(Pgtbl_Op,rme_ptr_t*));
+    Temp=Table[Pos];
+
+    /* Start lookup */
+    if(((Temp&RME_LINUX_PGTBL_PRESENT)==0)||((Temp&RME_LINUX_PGTBL_TERMINAL)==0))
+        return RME_ERR_PGT_OPFAIL;
+
+    /* This is a page. Return the physical address and flags */
+    if(Paddr!=0)
+        *Paddr=RME_LINUX_PGTBL_PTE_ADDR(Temp);
+
+    if(Flags!=0)
+        *Flags=RME_LINUX_PGTBL_FLAG_GET(Temp);
+
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Lookup *******************************************/
+
+/* Begin Function:__RME_Pgtbl_Walk ********************************************
+Description : Walking function for the page table. This function just does page
+              table lookups. The page table that is being walked must be the top-
+              level page table. The output values are optional; only pass in pointers
+              when you need that value.
+Input       : struct RME_Cap_Pgtbl* Pgtbl_Op - The page table to walk.
+              rme_ptr_t Vaddr - The virtual address to look up.
+Output      : rme_ptr_t* Pgtbl - The pointer to the page table level.
+              rme_ptr_t* Map_Vaddr - The virtual address that starts mapping.
+              rme_ptr_t* Paddr - The physical address of the page.
+              rme_ptr_t* Size_Order - The size order of the page.
+              rme_ptr_t* Num_Order - The entry order of the page.
+              rme_ptr_t* Flags - The RME standard flags of the page.
+Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
+******************************************************************************/
+rme_ptr_t __RME_Pgtbl_Walk(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Vaddr, rme_ptr_t* Pgtbl,
+                           rme_ptr_t* Map_Vaddr, rme_ptr_t* Paddr, rme_ptr_t* Size_Order,
+                           rme_ptr_t* Num_Order, rme_ptr_t* Flags)
+{
+    struct __RME_LINUX_Pgtbl_Meta* Meta;
+    rme_ptr_t* Table;
+    rme_ptr_t Pos;
+    rme_ptr_t Temp;
+
+    /* Check if this is the top-level page table */
+    if(((Pgtbl_Op->Base_Addr)&RME_PGTBL_TOP)==0)
+        return RME_ERR_PGT_OPFAIL;
+
+    /* Get the table and start lookup */
+    Meta=RME_CAP_GETOBJ(Pgtbl_Op, struct __RME_LINUX_Pgtbl_Meta*);
+
+    /* Do lookup recursively */
+    while(1)
+    {
+        Table=RME_LINUX_PGTBL_TBL((rme_ptr_t*)Meta);
+        /* Check if the virtual address is in our range */
+        if(Vaddr<RME_LINUX_PGTBL_START(Meta->Base_Addr))
+            return RME_ERR_PGT_OPFAIL;
+        /* Calculate where is the entry */
+        Pos=(Vaddr-RME_LINUX_PGTBL_START(Meta->Base_Addr))>>RME_PGTBL_SIZEORD(Meta->Size_Num_Order);
+        /* See if the entry is overrange */
+        if((Pos>>RME_PGTBL_NUMORD(Meta->Size_Num_Order))!=0)
+            return RME_ERR_PGT_OPFAIL;
+        /* Find the position of the entry - Is there a page, a directory, or nothing? */
+        Temp=Table[Pos];
+        if((Temp&RME_LINUX_PGTBL_PRESENT)==0)
+            return RME_ERR_PGT_OPFAIL;
+        if((Temp&RME_LINUX_PGTBL_TERMINAL)!=0)
+        {
+            /* This is a page - we found it */
+            if(Pgtbl!=0)
+                *Pgtbl=(rme_ptr_t)Meta;
+            if(Map_Vaddr!=0)
+                *Map_Vaddr=RME_LINUX_PGTBL_START(Meta->Base_Addr)+(Pos<<RME_PGTBL_SIZEORD(Meta->Size_Num_Order));
+            if(Paddr!=0)
+                *Paddr=RME_LINUX_PGTBL_PTE_ADDR(Temp);
+            if(Size_Order!=0)
+                *Size_Order=RME_PGTBL_SIZEORD(Meta->Size_Num_Order);
+            if(Num_Order!=0)
+                *Num_Order=RME_PGTBL_NUMORD(Meta->Size_Num_Order);
+            if(Flags!=0)
+                *Flags=RME_LINUX_PGTBL_FLAG_GET(Temp);
+
+            break;
+        }
+        else
+        {
+            /* This is a directory, we goto that directory to continue walking */
+            Meta=(struct __RME_LINUX_Pgtbl_Meta*)RME_LINUX_PGTBL_PGD_ADDR(Temp);
+        }
+    }
+    return 0;
+}
+/* End Function:__RME_Pgtbl_Walk *********************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
@@ -184,6 +184,7 @@ Return      : rme_ret_t - If successful, 0; else -1.
 rme_ret_t __RME_X64_SMP_Detect(struct RME_X64_ACPI_MADT_Hdr* MADT)
 {
     struct RME_X64_ACPI_MADT_LAPIC_Record* LAPIC;
+    struct RME_X64_ACPI_MADT_X2APIC_Record* X2APIC;
     struct RME_X64_ACPI_MADT_IOAPIC_Record* IOAPIC;
     struct RME_X64_ACPI_MADT_SRC_OVERRIDE_Record* OVERRIDE;
     rme_ptr_t Length;
@@ -237,6 +238,34 @@ rme_ret_t __RME_X64_SMP_Detect(struct RME_X64_ACPI_MADT_Hdr* MADT)
                 /* Log this CPU into our per-CPU data structure */
                 RME_X64_CPU_Info[RME_X64_Num_CPU].LAPIC_ID=LAPIC->APIC_ID;
                 RME_X64_CPU_Info[RME_X64_Num_CPU].Boot_Done=0;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].Node=0;
+                RME_X64_Num_CPU++;
+                RME_ASSERT(RME_X64_Num_CPU<=RME_X64_CPU_NUM);
+                break;
+            }
+            /* This is a x2APIC. The firmware only lists these for IDs above 254, and
+             * those can only be reached when we are in x2APIC mode */
+            case RME_X64_MADT_X2APIC:
+            {
+                X2APIC=(struct RME_X64_ACPI_MADT_X2APIC_Record*)Ptr;
+                /* Is the length correct? */
+                if(Length<sizeof(struct RME_X64_ACPI_MADT_X2APIC_Record))
+                    break;
+                /* Is this x2APIC enabled, and can we address it? */
+                if((X2APIC->Flags&RME_X64_APIC_LAPIC_ENABLED)==0)
+                    break;
+                if(RME_X64_X2APIC==0)
+                    break;
+
+                RME_PRINTK_S("\n\rACPI: CPU ");
+                RME_Print_Int(RME_X64_Num_CPU);
+                RME_PRINTK_S(", x2APIC ID ");
+                RME_Print_Int(X2APIC->X2APIC_ID);
+
+                /* Log this CPU into our per-CPU data structure */
+                RME_X64_CPU_Info[RME_X64_Num_CPU].LAPIC_ID=X2APIC->X2APIC_ID;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].Boot_Done=0;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].Node=0;
                 RME_X64_Num_CPU++;
                 RME_ASSERT(RME_X64_Num_CPU<=RME_X64_CPU_NUM);
                 break;
@@ -300,6 +329,275 @@ rme_ret_t __RME_X64_SMP_Detect(struct RME_X64_ACPI_MADT_Hdr* MADT)
 }
 /* End Function:__RME_X64_SMP_Detect *****************************************/
 
+/* Begin Function:__RME_X64_NUMA_Domain ***************************************
+Description : Get the node number of a proximity domain, and allocate a new node
+              for it if we have not seen it. If there are too many domains, the
+              extra ones are all merged into the last node.
+Input       : rme_ptr_t Domain - The proximity domain.
+Output      : None.
+Return      : rme_ptr_t - The node number.
+******************************************************************************/
+rme_ptr_t __RME_X64_NUMA_Domain(rme_ptr_t Domain)
+{
+    rme_ptr_t Count;
+
+    for(Count=0;Count<RME_X64_Num_Node;Count++)
+    {
+        if(RME_X64_Node_Domain[Count]==Domain)
+            return Count;
+    }
+
+    if(RME_X64_Num_Node>=RME_X64_NODE_NUM)
+        return RME_X64_NODE_NUM-1;
+
+    RME_X64_Node_Domain[RME_X64_Num_Node]=Domain;
+    RME_X64_Num_Node++;
+    return RME_X64_Num_Node-1;
+}
+/* End Function:__RME_X64_NUMA_Domain ****************************************/
+
+/* Begin Function:__RME_X64_NUMA_Detect ***************************************
+Description : Detect the NUMA configuration in the system. The SRAT tells which
+              node each CPU and memory range is on, and the SLIT tells how far
+              apart the nodes are. Without a SRAT, everything is on node 0.
+              This must be called after the CPUs are found in the MADT.
+Input       : struct RME_X64_ACPI_SRAT_Hdr* SRAT - The pointer to the SRAT header.
+              struct RME_X64_ACPI_SLIT_Hdr* SLIT - The pointer to the SLIT header.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_NUMA_Detect(struct RME_X64_ACPI_SRAT_Hdr* SRAT, struct RME_X64_ACPI_SLIT_Hdr* SLIT)
+{
+    struct RME_X64_ACPI_SRAT_LAPIC_Record* LAPIC;
+    struct RME_X64_ACPI_SRAT_X2APIC_Record* X2APIC;
+    struct RME_X64_ACPI_SRAT_MEM_Record* MEM;
+    rme_ptr_t Length;
+    rme_ptr_t Domain;
+    rme_ptr_t APIC_ID;
+    rme_ptr_t Count;
+    rme_ptr_t Node;
+    rme_u8_t* Ptr;
+    rme_u8_t* End;
+
+    RME_X64_Num_Node=0;
+    RME_X64_Num_NUMA_Mem=0;
+    for(Count=0;Count<RME_X64_NODE_NUM;Count++)
+    {
+        for(Node=0;Node<RME_X64_NODE_NUM;Node++)
+            RME_X64_Node_Dist[Count][Node]=(Count==Node)?RME_X64_NUMA_DIST_LOCAL:RME_X64_NUMA_DIST_REMOTE;
+    }
+
+    /* Is there a SRAT, and is it valid? */
+    if((SRAT!=0)&&(SRAT->Header.Length>=sizeof(struct RME_X64_ACPI_SRAT_Hdr)))
+    {
+        Ptr=SRAT->Table;
+        End=Ptr+SRAT->Header.Length-sizeof(struct RME_X64_ACPI_SRAT_Hdr);
+        while(Ptr<End)
+        {
+            /* See if we have finished scanning the table */
+            if((End-Ptr)<2)
+                break;
+            Length=Ptr[1];
+            if(((End-Ptr)<Length)||(Length==0))
+                break;
+
+            APIC_ID=RME_ALLBITS;
+            switch(Ptr[0])
+            {
+                /* This is a LAPIC */
+                case RME_X64_SRAT_LAPIC:
+                {
+                    LAPIC=(struct RME_X64_ACPI_SRAT_LAPIC_Record*)Ptr;
+                    if(Length<sizeof(struct RME_X64_ACPI_SRAT_LAPIC_Record))
+                        break;
+                    if((LAPIC->Flags&RME_X64_SRAT_ENABLED)==0)
+                        break;
+
+                    Domain=LAPIC->Domain_Low|(((rme_ptr_t)LAPIC->Domain_High[0])<<8)|
+                           (((rme_ptr_t)LAPIC->Domain_High[1])<<16)|(((rme_ptr_t)LAPIC->Domain_High[2])<<24);
+                    APIC_ID=LAPIC->APIC_ID;
+                    break;
+                }
+                /* This is a x2APIC */
+                case RME_X64_SRAT_X2APIC:
+                {
+                    X2APIC=(struct RME_X64_ACPI_SRAT_X2APIC_Record*)Ptr;
+                    if(Length<sizeof(struct RME_X64_ACPI_SRAT_X2APIC_Record))
+                        break;
+                    if((X2APIC->Flags&RME_X64_SRAT_ENABLED)==0)
+                        break;
+
+                    Domain=X2APIC->Domain;
+                    APIC_ID=X2APIC->X2APIC_ID;
+                    break;
+                }
+                /* This is a memory range */
+                case RME_X64_SRAT_MEM:
+                {
+                    MEM=(struct RME_X64_ACPI_SRAT_MEM_Record*)Ptr;
+                    if(Length<sizeof(struct RME_X64_ACPI_SRAT_MEM_Record))
+                        break;
+                    if((MEM->Flags&RME_X64_SRAT_ENABLED)==0)
+                        break;
+                    if(RME_X64_Num_NUMA_Mem>=RME_X64_NUMA_MEM_NUM)
+                        break;
+
+                    Node=__RME_X64_NUMA_Domain(MEM->Domain);
+                    RME_X64_NUMA_Mem[RME_X64_Num_NUMA_Mem].Start=MEM->Base_Low|(((rme_ptr_t)MEM->Base_High)<<32);
+                    RME_X64_NUMA_Mem[RME_X64_Num_NUMA_Mem].End=RME_X64_NUMA_Mem[RME_X64_Num_NUMA_Mem].Start+
+                                                               (MEM->Length_Low|(((rme_ptr_t)MEM->Length_High)<<32));
+                    RME_X64_NUMA_Mem[RME_X64_Num_NUMA_Mem].Node=Node;
+
+                    RME_PRINTK_S("\n\rSRAT: Node ");
+                    RME_Print_Int(Node);
+                    RME_PRINTK_S(", memory 0x");
+                    RME_Print_Uint(RME_X64_NUMA_Mem[RME_X64_Num_NUMA_Mem].Start);
+                    RME_PRINTK_S(" - 0x");
+                    RME_Print_Uint(RME_X64_NUMA_Mem[RME_X64_Num_NUMA_Mem].End);
+                    RME_X64_Num_NUMA_Mem++;
+                    break;
+                }
+                /* All other types are ignored */
+                default:break;
+            }
+
+            /* Put the CPU on its node */
+            if(APIC_ID!=RME_ALLBITS)
+            {
+                Node=__RME_X64_NUMA_Domain(Domain);
+                for(Count=0;Count<RME_X64_Num_CPU;Count++)
+                {
+                    if(RME_X64_CPU_Info[Count].LAPIC_ID!=APIC_ID)
+                        continue;
+
+                    RME_X64_CPU_Info[Count].Node=Node;
+                    RME_PRINTK_S("\n\rSRAT: Node ");
+                    RME_Print_Int(Node);
+                    RME_PRINTK_S(", CPU ");
+                    RME_Print_Int(Count);
+                    break;
+                }
+            }
+
+            Ptr+=Length;
+        }
+    }
+    else
+        RME_PRINTK_S("\n\rSRAT: Not present, all on node 0");
+
+    if(RME_X64_Num_Node==0)
+    {
+        RME_X64_Node_Domain[0]=0;
+        RME_X64_Num_Node=1;
+    }
+
+    /* Is there a SLIT, and is it valid? Its rows and columns are proximity domains */
+    if((SLIT==0)||(SLIT->Header.Length<sizeof(struct RME_X64_ACPI_SLIT_Hdr)))
+        return;
+    Length=SLIT->Localities;
+    if((Length>=RME_POW2(16))||((SLIT->Header.Length-sizeof(struct RME_X64_ACPI_SLIT_Hdr))<(Length*Length)))
+        return;
+
+    for(Count=0;Count<RME_X64_Num_Node;Count++)
+    {
+        for(Node=0;Node<RME_X64_Num_Node;Node++)
+        {
+            if((RME_X64_Node_Domain[Count]>=Length)||(RME_X64_Node_Domain[Node]>=Length))
+                continue;
+            RME_X64_Node_Dist[Count][Node]=SLIT->Entry[RME_X64_Node_Domain[Count]*Length+RME_X64_Node_Domain[Node]];
+        }
+    }
+}
+/* End Function:__RME_X64_NUMA_Detect ****************************************/
+
+/* Begin Function:__RME_X64_NUMA_Node *****************************************
+Description : Get the node of a physical address. The addresses that are not in
+              the SRAT are on node 0.
+Input       : rme_ptr_t Addr - The physical address.
+Output      : None.
+Return      : rme_ptr_t - The node number.
+******************************************************************************/
+rme_ptr_t __RME_X64_NUMA_Node(rme_ptr_t Addr)
+{
+    rme_ptr_t Count;
+
+    for(Count=0;Count<RME_X64_Num_NUMA_Mem;Count++)
+    {
+        if((Addr>=RME_X64_NUMA_Mem[Count].Start)&&(Addr<RME_X64_NUMA_Mem[Count].End))
+            return RME_X64_NUMA_Mem[Count].Node;
+    }
+
+    return 0;
+}
+/* End Function:__RME_X64_NUMA_Node ******************************************/
+
+/* Begin Function:__RME_X64_NUMA_Bound ****************************************
+Description : Find the first place in a physical memory range where the node may
+              change, so that the range can be split into parts on single nodes.
+Input       : rme_ptr_t Start - The start address of the range.
+              rme_ptr_t End - The end address of the range, exclusive.
+Output      : None.
+Return      : rme_ptr_t - The first SRAT range boundary inside the range, or End
+                          if there is none.
+******************************************************************************/
+rme_ptr_t __RME_X64_NUMA_Bound(rme_ptr_t Start, rme_ptr_t End)
+{
+    rme_ptr_t Count;
+    rme_ptr_t Bound;
+
+    Bound=End;
+    for(Count=0;Count<RME_X64_Num_NUMA_Mem;Count++)
+    {
+        if((RME_X64_NUMA_Mem[Count].Start>Start)&&(RME_X64_NUMA_Mem[Count].Start<Bound))
+            Bound=RME_X64_NUMA_Mem[Count].Start;
+        if((RME_X64_NUMA_Mem[Count].End>Start)&&(RME_X64_NUMA_Mem[Count].End<Bound))
+            Bound=RME_X64_NUMA_Mem[Count].End;
+    }
+
+    return Bound;
+}
+/* End Function:__RME_X64_NUMA_Bound *****************************************/
+
+/* Begin Function:__RME_X64_NUMA_Carve ****************************************
+Description : Take a naturally aligned block of memory for a CPU from the top of
+              the Kmem2 of a node. If that node does not have enough, the nearest
+              node that does is used; if none does, the block is taken from the
+              top of the first Kmem1 trunk.
+Input       : rme_ptr_t Node - The node that the block should be on.
+              rme_ptr_t Size_Order - The size order of the block.
+Output      : None.
+Return      : rme_ptr_t - The virtual address of the block.
+******************************************************************************/
+rme_ptr_t __RME_X64_NUMA_Carve(rme_ptr_t Node, rme_ptr_t Size_Order)
+{
+    rme_ptr_t Count;
+    rme_ptr_t Best;
+    rme_ptr_t Addr;
+
+    Best=RME_X64_NODE_NUM;
+    for(Count=0;Count<RME_X64_Num_Node;Count++)
+    {
+        Addr=RME_ROUND_DOWN(RME_X64_Layout.Kmem2_Start[Count]+RME_X64_Layout.Kmem2_Size[Count],Size_Order);
+        if(Addr<(RME_X64_Layout.Kmem2_Start[Count]+RME_POW2(Size_Order)))
+            continue;
+        if((Best==RME_X64_NODE_NUM)||(RME_X64_Node_Dist[Node][Count]<RME_X64_Node_Dist[Node][Best]))
+            Best=Count;
+    }
+
+    if(Best!=RME_X64_NODE_NUM)
+    {
+        Addr=RME_ROUND_DOWN(RME_X64_Layout.Kmem2_Start[Best]+RME_X64_Layout.Kmem2_Size[Best],Size_Order)-RME_POW2(Size_Order);
+        RME_X64_Layout.Kmem2_Size[Best]=Addr-RME_X64_Layout.Kmem2_Start[Best];
+        return Addr;
+    }
+
+    Addr=RME_ROUND_DOWN(RME_X64_Layout.Kmem1_Start[0]+RME_X64_Layout.Kmem1_Size[0],Size_Order)-RME_POW2(Size_Order);
+    RME_ASSERT(Addr>=RME_X64_Layout.Kmem1_Start[0]);
+    RME_X64_Layout.Kmem1_Size[0]=Addr-RME_X64_Layout.Kmem1_Start[0];
+    return Addr;
+}
+/* End Function:__RME_X64_NUMA_Carve *****************************************/
+
 /* Begin Function:__RME_X64_ACPI_Debug ****************************************
 Description : Print the information about the ACPI table entry.
 Input       : struct RME_X64_ACPI_MADT_Hdr* MADT - The pointer to the MADT header.
@@ -346,7 +644,8 @@ void __RME_X64_ACPI_Debug(struct RME_X64_ACPI_Desc_Hdr *Header)
 /* End Function:__RME_X64_ACPI_Debug *****************************************/
 
 /* Begin Function:__RME_X64_ACPI_Init *****************************************
-Description : Detect the SMP configuration in the system and set up the per-CPU info.
+Description : Detect the SMP and NUMA configuration in the system and set up the
+              per-CPU info.
 Input       : struct RME_X64_ACPI_MADT_Hdr* MADT - The pointer to the MADT header.
 Output      : None.
 Return      : rme_ret_t - If successful, 0; else -1.
@@ -358,6 +657,8 @@ rme_ret_t __RME_X64_ACPI_Init(void)
     struct RME_X64_ACPI_RDSP_Desc* RDSP;
     struct RME_X64_ACPI_RSDT_Hdr* RSDT;
     struct RME_X64_ACPI_MADT_Hdr* MADT;
+    struct RME_X64_ACPI_SRAT_Hdr* SRAT;
+    struct RME_X64_ACPI_SLIT_Hdr* SLIT;
     struct RME_X64_ACPI_Desc_Hdr* Header;
 
     /* Try to find RDSP */
@@ -370,6 +671,9 @@ rme_ret_t __RME_X64_ACPI_Init(void)
     RME_PRINTK_U((rme_ptr_t)RSDT);
     Table_Num=(RSDT->Header.Length-sizeof(struct RME_X64_ACPI_RSDT_Hdr))>>2;
 
+    MADT=0;
+    SRAT=0;
+    SLIT=0;
     for(Count=0;Count<Table_Num;Count++)
     {
         /* See what did we find */
@@ -378,9 +682,18 @@ rme_ret_t __RME_X64_ACPI_Init(void)
         /* See if this is the MADT */
         if(_RME_Memcmp(Header->Signature, "APIC", 4)==0)
             MADT=(struct RME_X64_ACPI_MADT_Hdr*)Header;
+        /* The NUMA tables */
+        else if(_RME_Memcmp(Header->Signature, "SRAT", 4)==0)
+            SRAT=(struct RME_X64_ACPI_SRAT_Hdr*)Header;
+        else if(_RME_Memcmp(Header->Signature, "SLIT", 4)==0)
+            SLIT=(struct RME_X64_ACPI_SLIT_Hdr*)Header;
     }
 
-    return __RME_X64_SMP_Detect(MADT);
+    if(__RME_X64_SMP_Detect(MADT)!=0)
+        return -1;
+
+    __RME_X64_NUMA_Detect(SRAT, SLIT);
+    return 0;
 }
 /* End Function:__RME_X64_ACPI_Init ******************************************/
 
@@ -395,6 +708,10 @@ Return      : None.
 void __RME_X64_Feature_Get(void)
 {
     rme_cnt_t Count;
+    rme_ptr_t EAX;
+    rme_ptr_t EBX;
+    rme_ptr_t ECX;
+    rme_ptr_t EDX;
 
     /* What's the maximum feature? */
     RME_X64_Feature.Max_Func=__RME_X64_CPUID_Get(RME_X64_CPUID_0_VENDOR_ID,
@@ -429,14 +746,70 @@ void __RME_X64_Feature_Get(void)
                                                           (rme_ptr_t*)&(RME_X64_Feature.Ext[Count][3]));
     }
 
+    /* XSAVEOPT is reported in the sub-leaf 1 of the extended state leaf */
+    RME_X64_XSAVEOPT=0;
+    if(RME_X64_Feature.Max_Func>=RME_X64_CPUID_D_XSTATE)
+    {
+        EBX=0;
+        ECX=1;
+        EDX=0;
+        EAX=__RME_X64_CPUID_Get(RME_X64_CPUID_D_XSTATE, &EBX, &ECX, &EDX);
+        if((EAX&RME_X64_CPUID_D_ECX1_EAX_XSAVEOPT)!=0)
+            RME_X64_XSAVEOPT=1;
+    }
+
+    /* PCID needs INVPCID to be really useful, but can do without */
+    if((RME_X64_FUNC(RME_X64_CPUID_1_INFO_FEATURE,2)&RME_X64_CPUID_1_ECX_PCID)!=0)
+        RME_X64_PCID=1;
+    else
+        RME_X64_PCID=0;
+    if((RME_X64_Feature.Max_Func>=RME_X64_CPUID_7_ECX0_INTEL_EXT)&&
+       ((RME_X64_FUNC(RME_X64_CPUID_7_ECX0_INTEL_EXT,1)&RME_X64_CPUID_7_EBX_INVPCID)!=0))
+        RME_X64_INVPCID=1;
+    else
+        RME_X64_INVPCID=0;
+
+    /* With ERMS, REP MOVSB is the fastest way to copy memory of any size */
+    if((RME_X64_Feature.Max_Func>=RME_X64_CPUID_7_ECX0_INTEL_EXT)&&
+       ((RME_X64_FUNC(RME_X64_CPUID_7_ECX0_INTEL_EXT,1)&RME_X64_CPUID_7_EBX_ERMS)!=0))
+        RME_X64_ERMS=1;
+    else
+        RME_X64_ERMS=0;
+
+    /* Use the x2APIC whenever we have it - the MSR interface is cheaper than MMIO */
+    if((RME_X64_FUNC(RME_X64_CPUID_1_INFO_FEATURE,2)&RME_X64_CPUID_1_ECX_X2APIC)!=0)
+        RME_X64_X2APIC=1;
+    else
+        RME_X64_X2APIC=0;
+
     /* TODO: Check these flags. If not satisfied, we hang immediately. */
 }
 /* End Function:__RME_X64_Feature_Get ****************************************/
 
+/* Begin Function:__RME_X64_Memcpy ********************************************
+Description : Copy one segment of memory to another segment with the string
+              instructions. With ERMS, REP MOVSB is used throughout; without it,
+              the bulk is copied with REP MOVSQ.
+Input       : void* Dst - The destination memory region.
+              void* Src - The source memory region.
+              rme_ptr_t Num - The number of bytes to copy.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_Memcpy(void* Dst, void* Src, rme_ptr_t Num)
+{
+    if(RME_X64_ERMS!=0)
+        __RME_X64_Movsb(Dst, Src, Num);
+    else
+        __RME_X64_Movsq(Dst, Src, Num);
+}
+/* End Function:__RME_X64_Memcpy *********************************************/
+
 /* Begin Function:__RME_X64_Mem_Init ******************************************
 Description : Initialize the memory map, and get the size of kernel object
               allocation registration table(Kotbl) and page table reference
-              count registration table(Pgreg).
+              count registration table(Pgreg). The memory segments are split
+              where the NUMA node changes, so each is on a single node.
 Input       : rme_ptr_t MMap_Addr - The GRUB multiboot memory map data address.
               rme_ptr_t MMap_Length - The GRUB multiboot memory map data length.
 Output      : None.
@@ -449,6 +822,7 @@ struct __RME_X64_Mem
     struct RME_List Head;
     rme_ptr_t Start_Addr;
     rme_ptr_t Length;
+    rme_ptr_t Node;
 };
 /* The header of the physical memory linked list */
 struct RME_List RME_X64_Phys_Mem;
@@ -459,8 +833,10 @@ void __RME_X64_Mem_Init(rme_ptr_t MMap_Addr, rme_ptr_t MMap_Length)
 {
     struct multiboot_mmap_entry* MMap;
     volatile struct RME_List* Trav_Ptr;
+    struct __RME_X64_Mem* Mem;
     rme_ptr_t MMap_Cnt;
     rme_ptr_t Info_Cnt;
+    rme_ptr_t Bound;
 
     MMap_Cnt=0;
     Info_Cnt=0;
@@ -517,6 +893,32 @@ void __RME_X64_Mem_Init(rme_ptr_t MMap_Addr, rme_ptr_t MMap_Length)
         Trav_Ptr=Trav_Ptr->Next;
     }
 
+    /* Split the segments that span multiple NUMA nodes */
+    Trav_Ptr=RME_X64_Phys_Mem.Next;
+    while(Trav_Ptr!=&RME_X64_Phys_Mem)
+    {
+        Mem=(struct __RME_X64_Mem*)Trav_Ptr;
+        Mem->Node=__RME_X64_NUMA_Node(Mem->Start_Addr);
+        Bound=__RME_X64_NUMA_Bound(Mem->Start_Addr, Mem->Start_Addr+Mem->Length);
+        if(Bound!=(Mem->Start_Addr+Mem->Length))
+        {
+            RME_ASSERT(Info_Cnt<1024);
+            RME_X64_Mem[Info_Cnt].Start_Addr=Bound;
+            RME_X64_Mem[Info_Cnt].Length=Mem->Start_Addr+Mem->Length-Bound;
+            __RME_List_Ins(&(RME_X64_Mem[Info_Cnt].Head),Trav_Ptr,Trav_Ptr->Next);
+            Mem->Length=Bound-Mem->Start_Addr;
+            Info_Cnt++;
+        }
+
+        RME_PRINTK_S("\n\rNUMA memory: 0x");
+        RME_Print_Uint(Mem->Start_Addr);
+        RME_PRINTK_S(", 0x");
+        RME_Print_Uint(Mem->Length);
+        RME_PRINTK_S(", node ");
+        RME_Print_Uint(Mem->Node);
+        Trav_Ptr=Trav_Ptr->Next;
+    }
+
     /* Calculate total memory */
     MMap_Cnt=0;
     Trav_Ptr=RME_X64_Phys_Mem.Next;
@@ -535,19 +937,15 @@ void __RME_X64_Mem_Init(rme_ptr_t MMap_Addr, rme_ptr_t MMap_Length)
     RME_X64_Layout.Kotbl_Start=(rme_ptr_t)RME_KOTBL;
     /* +1G in cases where we have > 3GB memory for covering the memory hole */
     Info_Cnt=(MMap_Cnt>3*RME_POW2(RME_PGTBL_SIZE_1G))?(MMap_Cnt+RME_POW2(RME_PGTBL_SIZE_1G)):MMap_Cnt;
-    RME_X64_Layout.Kotbl_Size=((Info_Cnt>>RME_KMEM_SLOT_ORDER)>>RME_WORD_ORDER)+1;
+    Info_Cnt=((Info_Cnt>>RME_KMEM_SLOT_ORDER)>>RME_WORD_ORDER)+1;
+    /* The summary bitmap follows the table, and the size is in bytes */
+    RME_X64_Kotbl_Sum=RME_KOTBL+Info_Cnt;
+    RME_X64_Layout.Kotbl_Size=(Info_Cnt+((Info_Cnt+RME_WORD_BITS-1)>>RME_WORD_ORDER))*sizeof(rme_ptr_t);
 
     /* Calculate the size of page table registration table size - we always assume 4GB range */
     Info_Cnt=(MMap_Cnt>RME_POW2(RME_PGTBL_SIZE_4G))?RME_POW2(RME_PGTBL_SIZE_4G):MMap_Cnt;
     RME_X64_Layout.Pgreg_Start=RME_X64_Layout.Kotbl_Start+RME_X64_Layout.Kotbl_Size;
     RME_X64_Layout.Pgreg_Size=((Info_Cnt>>RME_PGTBL_SIZE_4K)+1)*sizeof(struct __RME_X64_Pgreg);
-
-    /* Calculate the per-CPU data structure size - each CPU have two 4k pages */
-    RME_X64_Layout.PerCPU_Start=RME_ROUND_UP(RME_X64_Layout.Pgreg_Start+RME_X64_Layout.Pgreg_Size,RME_PGTBL_SIZE_4K);
-    RME_X64_Layout.PerCPU_Size=2*RME_POW2(RME_PGTBL_SIZE_4K)*RME_X64_Num_CPU;
-
-    /* Now decide the size of the stack */
-    RME_X64_Layout.Stack_Size=RME_X64_Num_CPU<<RME_X64_KSTACK_ORDER;
 }
 /* End Function:__RME_X64_Mem_Init *******************************************/
 
@@ -556,11 +954,11 @@ Description : Initialize CPU-local data structures. The layout of each CPU-local
               data structure is:
               |       4kB      |    1kB    |  3kB-3*8Bytes  |   3*8Bytes   |
               |    IDT[255:0]  |  GDT/TSS  |  RME_CPU_Local | RME_X64_Temp |
-Input       : None.
+Input       : rme_ptr_t CPUID - The CPUID of this processor.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-void __RME_X64_CPU_Local_Init(void)
+void __RME_X64_CPU_Local_Init(rme_ptr_t CPUID)
 {
     volatile rme_u16_t Desc[5];
     struct RME_X64_IDT_Entry* IDT_Table;
@@ -570,7 +968,7 @@ void __RME_X64_CPU_Local_Init(void)
     rme_ptr_t TSS_Table;
     rme_cnt_t Count;
 
-    IDT_Table=(struct RME_X64_IDT_Entry*)RME_X64_CPU_LOCAL_BASE(RME_X64_CPU_Cnt);
+    IDT_Table=(struct RME_X64_IDT_Entry*)RME_X64_CPU_LOCAL_BASE(CPUID);
     /* Clean up the whole IDT */
     for(Count=0;Count<256;Count++)
         IDT_Table[Count].Type_Attr=0;
@@ -733,14 +1131,13 @@ void __RME_X64_CPU_Local_Init(void)
     RME_X64_USER_IDT(IDT_Table, 252); RME_X64_USER_IDT(IDT_Table, 253);
     RME_X64_USER_IDT(IDT_Table, 254); RME_X64_USER_IDT(IDT_Table, 255);
 
-    /* Replace systick handler with customized ones - spurious interrupts
-     * and IPIs are handled in the general interrupt path. SysTick handler
-     * is only processed by the first processor, so we don't register it
-     * for other auxiliary processors */
-    if(RME_X64_CPU_Cnt==0)
-        RME_X64_SET_IDT(IDT_Table, RME_X64_INT_SYSTICK, RME_X64_IDT_VECT, SysTick_Handler);
-    /* Register SMP handlers */
-    RME_X64_SET_IDT(IDT_Table, RME_X64_INT_SMP_SYSTICK, RME_X64_IDT_VECT, SysTick_SMP_Handler);
+    /* Replace the timer handler with customized ones - spurious interrupts
+     * and IPIs are handled in the general interrupt path. Every processor
+     * has its own LAPIC timer, but only the first one keeps the timestamp */
+    if(CPUID==0)
+        RME_X64_SET_IDT(IDT_Table, RME_X64_INT_TIMER, RME_X64_IDT_VECT, SysTick_Handler);
+    else
+        RME_X64_SET_IDT(IDT_Table, RME_X64_INT_TIMER, RME_X64_IDT_VECT, SysTick_SMP_Handler);
 
     /* Load the IDT */
     Desc[0]=RME_POW2(RME_PGTBL_SIZE_4K)-1;
@@ -750,8 +1147,8 @@ void __RME_X64_CPU_Local_Init(void)
     Desc[4]=((rme_ptr_t)IDT_Table)>>48;
     __RME_X64_IDT_Load((rme_ptr_t*)Desc);
 
-    GDT_Table=(rme_ptr_t*)(RME_X64_CPU_LOCAL_BASE(RME_X64_CPU_Cnt)+RME_POW2(RME_PGTBL_SIZE_4K));
-    TSS_Table=(rme_ptr_t)(RME_X64_CPU_LOCAL_BASE(RME_X64_CPU_Cnt)+RME_POW2(RME_PGTBL_SIZE_4K)+16*sizeof(rme_ptr_t));
+    GDT_Table=(rme_ptr_t*)(RME_X64_CPU_LOCAL_BASE(CPUID)+RME_POW2(RME_PGTBL_SIZE_4K));
+    TSS_Table=(rme_ptr_t)(RME_X64_CPU_LOCAL_BASE(CPUID)+RME_POW2(RME_PGTBL_SIZE_4K)+16*sizeof(rme_ptr_t));
 
     /* Dummy entry */
     GDT_Table[0]=0x0000000000000000ULL;
@@ -777,22 +1174,22 @@ void __RME_X64_CPU_Local_Init(void)
     Desc[4]=((rme_ptr_t)GDT_Table)>>48;
     __RME_X64_GDT_Load((rme_ptr_t*)Desc);
     /* Set the RSP to TSS */
-    ((rme_u32_t*)TSS_Table)[1]=RME_X64_KSTACK(RME_X64_CPU_Cnt);
-    ((rme_u32_t*)TSS_Table)[2]=RME_X64_KSTACK(RME_X64_CPU_Cnt)>>32;
+    ((rme_u32_t*)TSS_Table)[1]=RME_X64_KSTACK(CPUID);
+    ((rme_u32_t*)TSS_Table)[2]=RME_X64_KSTACK(CPUID)>>32;
     /* IO Map Base = End of TSS (What's this?) */
     ((rme_u32_t*)TSS_Table)[16]=0x00680000;
     __RME_X64_TSS_Load(6*sizeof(rme_ptr_t));
 
     /* Initialize the RME per-cpu data here */
-    CPU_Local=(struct RME_CPU_Local*)(RME_X64_CPU_LOCAL_BASE(RME_X64_CPU_Cnt)+
+    CPU_Local=(struct RME_CPU_Local*)(RME_X64_CPU_LOCAL_BASE(CPUID)+
     		                          RME_POW2(RME_PGTBL_SIZE_4K)+
 									  RME_POW2(RME_PGTBL_SIZE_1K));
-    _RME_CPU_Local_Init(CPU_Local,RME_X64_CPU_Cnt);
+    _RME_CPU_Local_Init(CPU_Local,CPUID);
 
     /* Initialize x64 specific CPU-local data structure */
-    Temp=(struct RME_X64_Temp*)(RME_X64_CPU_LOCAL_BASE(RME_X64_CPU_Cnt+1)-sizeof(struct RME_X64_Temp));
+    Temp=(struct RME_X64_Temp*)(RME_X64_CPU_LOCAL_BASE(CPUID)+RME_X64_CPU_LOCAL_SIZE-sizeof(struct RME_X64_Temp));
     Temp->CPU_Local_Addr=(rme_ptr_t)CPU_Local;
-    Temp->Kernel_SP=RME_X64_KSTACK(RME_X64_CPU_Cnt);
+    Temp->Kernel_SP=RME_X64_KSTACK(CPUID);
     Temp->Temp_User_SP=0;
 
     /* Set the base of GS to this memory */
@@ -835,8 +1232,33 @@ void __RME_X64_LAPIC_Ack(void)
 }
 /* End Function:__RME_X64_LAPIC_Ack ******************************************/
 
+/* Begin Function:__RME_X64_LAPIC_IPI *****************************************
+Description : Send an inter-processor interrupt through the LAPIC. In x2APIC
+              mode this is a single MSR write and there is no delivery status;
+              in xAPIC mode we write the ICR halves and wait for delivery.
+Input       : rme_ptr_t LAPIC_ID - The destination LAPIC ID.
+              rme_ptr_t Cmd - The command to put in the low half of the ICR.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_LAPIC_IPI(rme_ptr_t LAPIC_ID, rme_ptr_t Cmd)
+{
+    if(RME_X64_X2APIC!=0)
+    {
+        __RME_X64_Write_MSR(RME_X64_X2APIC_ICR, (LAPIC_ID<<32)|Cmd);
+        return;
+    }
+
+    RME_X64_XAPIC_WRITE(RME_X64_LAPIC_ICRHI, LAPIC_ID<<24);
+    RME_X64_XAPIC_WRITE(RME_X64_LAPIC_ICRLO, Cmd);
+    while(RME_X64_XAPIC_READ(RME_X64_LAPIC_ICRLO)&RME_X64_LAPIC_ICRLO_DELIVS);
+}
+/* End Function:__RME_X64_LAPIC_IPI ******************************************/
+
 /* Begin Function:__RME_X64_LAPIC_Init ****************************************
 Description : Initialize LAPIC controllers - this will be run once on everycore.
+              If the processor supports it, the LAPIC is switched to x2APIC
+              mode before anything else is touched.
 Input       : None.
 Output      : None.
 Return      : None.
@@ -846,6 +1268,14 @@ void __RME_X64_LAPIC_Init(void)
     /* LAPIC initialization - Check if there is any LAPIC */
     RME_ASSERT(RME_X64_LAPIC_Addr!=0);
 
+    /* Go x2APIC. It is entered from xAPIC mode, so both bits must be set together */
+    if(RME_X64_X2APIC!=0)
+    {
+        __RME_X64_Write_MSR(RME_X64_MSR_IA32_APIC_BASE,
+                            __RME_X64_Read_MSR(RME_X64_MSR_IA32_APIC_BASE)|
+                            RME_X64_MSR_IA32_APIC_BASE_EN|RME_X64_MSR_IA32_APIC_BASE_EXTD);
+    }
+
     /* Enable local APIC; set spurious interrupt vector to 32 */
     RME_X64_LAPIC_WRITE(RME_X64_LAPIC_SVR, RME_X64_LAPIC_SVR_ENABLE|RME_X64_INT_SPUR);
 
@@ -867,12 +1297,14 @@ void __RME_X64_LAPIC_Init(void)
     /* Acknowledge any outstanding interrupts */
     __RME_X64_LAPIC_Ack();
 
-    /* Send an Init Level De-Assert to synchronise arbitration IDs */
-    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, 0);
-    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_BCAST|
-                                             RME_X64_LAPIC_ICRLO_INIT|
-                                             RME_X64_LAPIC_ICRLO_LEVEL);
-    while(RME_X64_LAPIC_READ(RME_X64_LAPIC_ICRLO)&RME_X64_LAPIC_ICRLO_DELIVS);
+    /* Send an Init Level De-Assert to synchronise arbitration IDs. The x2APIC
+     * does not support this and does not need it either */
+    if(RME_X64_X2APIC==0)
+    {
+        __RME_X64_LAPIC_IPI(0, RME_X64_LAPIC_ICRLO_BCAST|
+                               RME_X64_LAPIC_ICRLO_INIT|
+                               RME_X64_LAPIC_ICRLO_LEVEL);
+    }
 
     /* Enable interrupts on the APIC */
     RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TPR, 0);
@@ -976,8 +1408,11 @@ void __RME_X64_IOAPIC_Init(void)
 /* End Function:__RME_X64_IOAPIC_Init ****************************************/
 
 /* Begin Function:__RME_X64_SMP_Init ******************************************
-Description : Start all other processors, one by one. We cannot start all of them
-              at once because of the stupid self modifying code of X64!
+Description : Start all other processors. All of them go through the same AP
+              trampoline, so each one is given a boot slot with its LAPIC ID and
+              kernel stack, where it finds itself when it reaches 64-bit mode. The
+              INIT and SIPIs are sent to all of them back-to-back, so the delays
+              are only taken once, and they initialize themselves concurrently.
 Input       : None.
 Output      : None.
 Return      : None.
@@ -986,95 +1421,503 @@ void __RME_X64_SMP_Init(void)
 {
     rme_u8_t* Code;
     rme_cnt_t Count;
+    rme_ptr_t Start_TSC;
     rme_u16_t* Warm_Reset;
+    volatile struct RME_X64_Boot_Slot* Slot;
 
-    /* Write entry code to unused memory at 0x7000 */
-    Code=(rme_u8_t*)RME_X64_PA2VA(0x7000);
+    /* Write entry code to unused memory */
+    Code=(rme_u8_t*)RME_X64_PA2VA(RME_X64_BOOT_CODE);
     for(Count=0;Count<sizeof(RME_X64_Boot_Code);Count++)
         Code[Count]=RME_X64_Boot_Code[Count];
 
-    /* Start the CPUs one by one - the first one is ourself */
-    RME_X64_CPU_Cnt=1;
+    /* Temporary stack. This is shared, but the APs only push the same return address
+     * there before they are in 64-bit mode and on their own kernel stacks */
+    *(rme_u32_t*)(Code-4)=RME_X64_BOOT_TEMP_STACK;
+    *(rme_u32_t*)(Code-8)=RME_X64_TEXT_VA2PA(__RME_X64_SMP_Boot_32);
+
+    /* Fill in the boot slots - the first one is ourself, and the list is terminated
+     * by an invalid LAPIC ID */
+    Slot=(volatile struct RME_X64_Boot_Slot*)RME_X64_PA2VA(RME_X64_BOOT_SLOT);
+    for(Count=0;Count<RME_X64_Num_CPU;Count++)
+    {
+        Slot[Count].LAPIC_ID=RME_X64_CPU_Info[Count].LAPIC_ID;
+        Slot[Count].Stack=RME_X64_KSTACK(Count);
+    }
+    Slot[Count].LAPIC_ID=RME_ALLBITS;
+    Slot[Count].Stack=0;
+
+    /* Initialize CMOS shutdown code to 0AH */
+    __RME_X64_Out(RME_X64_RTC_CMD,0xF);
+    __RME_X64_Out(RME_X64_RTC_DATA,0xA);
+    /* Warm reset vector point to AP code */
+    Warm_Reset=(rme_u16_t*)RME_X64_PA2VA((0x40<<4|0x67));
+    Warm_Reset[0]=0;
+    Warm_Reset[1]=RME_X64_BOOT_CODE>>4;
+
+    /* The APs will wait here until we have finished booting */
+    RME_X64_CPU_Cnt=RME_X64_Num_CPU;
+    /* The bring-up time of each AP is measured from here */
+    Start_TSC=__RME_X64_RDTSC();
+
+    /* Send INIT (level-triggered) interrupt to reset all other CPUs */
+    for(Count=1;Count<RME_X64_Num_CPU;Count++)
+    {
+        __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[Count].LAPIC_ID, RME_X64_LAPIC_ICRLO_INIT|
+                                                              RME_X64_LAPIC_ICRLO_LEVEL|
+                                                              RME_X64_LAPIC_ICRLO_ASSERT);
+    }
+    RME_X64_UDELAY(200);
+    /* The de-assert is only there for old xAPICs */
+    if(RME_X64_X2APIC==0)
+    {
+        for(Count=1;Count<RME_X64_Num_CPU;Count++)
+        {
+            __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[Count].LAPIC_ID, RME_X64_LAPIC_ICRLO_INIT|
+                                                                  RME_X64_LAPIC_ICRLO_LEVEL);
+        }
+    }
+    RME_X64_UDELAY(10000);
+
+    /* Send startup IPI twice according to Intel manuals. The processors that have
+     * started on the first one will ignore the second one */
+    for(Count=1;Count<RME_X64_Num_CPU;Count++)
+        __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[Count].LAPIC_ID, RME_X64_LAPIC_ICRLO_STARTUP|(RME_X64_BOOT_CODE>>12));
+    RME_X64_UDELAY(200);
+    for(Count=1;Count<RME_X64_Num_CPU;Count++)
+        __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[Count].LAPIC_ID, RME_X64_LAPIC_ICRLO_STARTUP|(RME_X64_BOOT_CODE>>12));
+    RME_X64_UDELAY(200);
+
+    /* Wait for all CPUs to finish their own initialization */
     for(Count=1;Count<RME_X64_Num_CPU;Count++)
     {
-        RME_PRINTK_S("\n\rBooting CPU ");
+        while(RME_X64_CPU_Info[Count].Boot_Done==0);
+        RME_PRINTK_S("\n\rBooted CPU ");
         RME_PRINTK_I(Count);
-        /* Temporary stack */
-        *(rme_u32_t*)(Code-4)=0x8000;
-        *(rme_u32_t*)(Code-8)=RME_X64_TEXT_VA2PA(__RME_X64_SMP_Boot_32);
-        *(rme_ptr_t*)(Code-16)=RME_X64_KSTACK(Count);
-
-        /* Initialize CMOS shutdown code to 0AH */
-        __RME_X64_Out(RME_X64_RTC_CMD,0xF);
-        __RME_X64_Out(RME_X64_RTC_DATA,0xA);
-        /* Warm reset vector point to AP code */
-        Warm_Reset=(rme_u16_t*)RME_X64_PA2VA((0x40<<4|0x67));
-        Warm_Reset[0]=0;
-        Warm_Reset[1]=0x7000>>4;
-
-        /* Send INIT (level-triggered) interrupt to reset other CPU */
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, RME_X64_CPU_Info[Count].LAPIC_ID<<24);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_INIT|
-                                                 RME_X64_LAPIC_ICRLO_LEVEL|
-                                                 RME_X64_LAPIC_ICRLO_ASSERT);
-        RME_X64_UDELAY(200);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_INIT|
-                                                 RME_X64_LAPIC_ICRLO_LEVEL);
-        RME_X64_UDELAY(10000);
-
-        /* Send startup IPI twice according to Intel manuals */
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, RME_X64_CPU_Info[Count].LAPIC_ID<<24);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_STARTUP|(0x7000>>12));
-        RME_X64_UDELAY(200);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, RME_X64_CPU_Info[Count].LAPIC_ID<<24);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_STARTUP|(0x7000>>12));
-        RME_X64_UDELAY(200);
-
-        /* Wait for CPU to finish its own initialization */
-        while(RME_X64_CPU_Info[RME_X64_CPU_Cnt].Boot_Done==0);
-        RME_X64_CPU_Cnt++;
+        /* The TSCs of all processors are reset together, so this is comparable */
+        RME_PRINTK_S(", TSC +0x");
+        RME_PRINTK_U(RME_X64_CPU_Info[Count].Boot_TSC-Start_TSC);
     }
+    RME_PRINTK_S("\n\rAll CPUs booted, TSC +0x");
+    RME_PRINTK_U(__RME_X64_RDTSC()-Start_TSC);
 }
 /* End Function:__RME_X64_SMP_Init *******************************************/
 
-/* Begin Function:__RME_X64_SMP_Tick ******************************************
-Description : Send IPI to all other cores,to run their handler on the time.
+/* Begin Function:__RME_X64_FPU_Init ******************************************
+Description : Initialize the FPU and the extended states on this processor. The
+              FPU is left with CR0.TS set, so the first use of it by any thread
+              will trap into the kernel and load that thread's context.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_FPU_Init(void)
+{
+    rme_u8_t Probe[RME_X64_COP_SIZE+RME_X64_COP_ALIGN];
+    rme_ptr_t Area;
+
+#if(RME_X64_FPU_TYPE!=RME_FALSE)
+    /* Check that the processor has what we are configured for; hang if not */
+    RME_ASSERT((RME_X64_FUNC(RME_X64_CPUID_1_INFO_FEATURE,2)&RME_X64_CPUID_1_ECX_XSAVE)!=0);
+    RME_ASSERT((RME_X64_FUNC(RME_X64_CPUID_1_INFO_FEATURE,2)&RME_X64_CPUID_1_ECX_AVX)!=0);
+#if(RME_X64_FPU_TYPE==RME_X64_FPU_AVX512)
+    RME_ASSERT((RME_X64_FUNC(RME_X64_CPUID_7_ECX0_INTEL_EXT,1)&RME_X64_CPUID_7_EBX_AVX512F)!=0);
+#endif
+    __RME_X64_CR4_Set(__RME_X64_CR4_Get()|RME_X64_CR4_OSFXSR|
+                      RME_X64_CR4_OSXMMEXCPT|RME_X64_CR4_OSXSAVE);
+    __RME_X64_XCR0_Set(RME_X64_XCR0);
+#else
+    __RME_X64_CR4_Set(__RME_X64_CR4_Get()|RME_X64_CR4_OSFXSR|RME_X64_CR4_OSXMMEXCPT);
+#endif
+
+    /* The FPU is there and we want the WAIT instructions to trap as well */
+    __RME_X64_CR0_Set((__RME_X64_CR0_Get()&(~((rme_ptr_t)RME_X64_CR0_EM)))|
+                      RME_X64_CR0_MP|RME_X64_CR0_TS);
+
+    /* Find out what MXCSR bits are allowed, so that we can sanitize the ones
+     * given to us in the hypervisor register areas later on */
+    if(RME_CPU_LOCAL()->CPUID==0)
+    {
+        Area=RME_ROUND_UP((rme_ptr_t)Probe,RME_X64_COP_ALIGN_ORDER);
+        *(rme_u32_t*)(Area+RME_X64_COP_MXCSR_MASK)=0;
+        __RME_X64_CLTS();
+        __RME_X64_FXSAVE(Area);
+        __RME_X64_CR0_Set(__RME_X64_CR0_Get()|RME_X64_CR0_TS);
+        RME_X64_MXCSR_Mask=*(rme_u32_t*)(Area+RME_X64_COP_MXCSR_MASK);
+        if(RME_X64_MXCSR_Mask==0)
+            RME_X64_MXCSR_Mask=RME_X64_MXCSR_MASK_DEF;
+    }
+}
+/* End Function:__RME_X64_FPU_Init *******************************************/
+
+/* Begin Function:__RME_X64_TLB_Init ******************************************
+Description : Enable PCIDs on this processor if we have them. This must be done
+              when CR3 still points to the kernel tables with PCID 0.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_TLB_Init(void)
+{
+    RME_X64_CPU_Info[RME_CPU_LOCAL()->CPUID].TLB_Epoch=RME_X64_TLB_Epoch;
+
+    if(RME_X64_PCID!=0)
+        __RME_X64_CR4_Set(__RME_X64_CR4_Get()|RME_X64_CR4_PCIDE);
+}
+/* End Function:__RME_X64_TLB_Init *******************************************/
+
+/* Begin Function:__RME_X64_TLB_Flush *****************************************
+Description : Flush all the non-global TLB entries of all PCIDs on this processor.
+              Without INVPCID, toggling CR4.PGE does this, though the global
+              entries go away as well.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_TLB_Flush(void)
+{
+    rme_ptr_t CR4;
+
+    if(RME_X64_INVPCID!=0)
+        __RME_X64_INVPCID(RME_X64_INVPCID_ALL, 0, 0);
+    else
+    {
+        CR4=__RME_X64_CR4_Get();
+        __RME_X64_CR4_Set(CR4^RME_X64_CR4_PGE);
+        __RME_X64_CR4_Set(CR4);
+    }
+}
+/* End Function:__RME_X64_TLB_Flush ******************************************/
+
+/* Begin Function:__RME_X64_PCID_Alloc ****************************************
+Description : Allocate a PCID for a top-level page table. Each live top-level
+              table has its own PCID, so that switching to it need not flush;
+              when they run out, the shared PCID is returned.
+Input       : None.
+Output      : None.
+Return      : rme_ptr_t - The PCID allocated.
+******************************************************************************/
+rme_ptr_t __RME_X64_PCID_Alloc(void)
+{
+    rme_cnt_t Count;
+    rme_ptr_t Old;
+    rme_ptr_t Bit;
+
+    if(RME_X64_PCID==0)
+        return RME_X64_PCID_SHARED;
+
+    for(Count=0;Count<RME_X64_PCID_NUM/RME_WORD_BITS;Count++)
+    {
+        while(1)
+        {
+            Old=RME_X64_PCID_Bitmap[Count];
+            if(Old==RME_ALLBITS)
+                break;
+
+            Bit=RME_MSB_GET(~Old);
+            if(RME_COMP_SWAP((rme_ptr_t*)&RME_X64_PCID_Bitmap[Count],Old,Old|RME_POW2(Bit))!=0)
+                return (Count<<RME_WORD_ORDER)+Bit;
+        }
+    }
+
+    return RME_X64_PCID_SHARED;
+}
+/* End Function:__RME_X64_PCID_Alloc *****************************************/
+
+/* Begin Function:__RME_X64_PCID_Free *****************************************
+Description : Free the PCID of a top-level page table that is being deleted. The
+              table is not in use anywhere, so the processors that have run in
+              it are only told to flush the PCID before they use it again.
+Input       : rme_ptr_t PCID - The PCID to free.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_PCID_Free(rme_ptr_t PCID)
+{
+    rme_ptr_t Count;
+
+    if(PCID==RME_X64_PCID_SHARED)
+        return;
+
+    for(Count=0;Count<RME_X64_Num_CPU;Count++)
+    {
+        if((RME_X64_PCID_CPU[PCID][Count>>RME_WORD_ORDER]&RME_POW2(Count&RME_MASK_END(RME_WORD_ORDER-1)))!=0)
+            __RME_X64_Bitmap_Set(RME_X64_CPU_Info[Count].PCID_Stale, PCID);
+    }
+
+    for(Count=0;Count<RME_X64_CPU_WORDS;Count++)
+        RME_X64_PCID_CPU[PCID][Count]=0;
+
+    RME_FETCH_AND((rme_ptr_t*)&RME_X64_PCID_Bitmap[PCID>>RME_WORD_ORDER],
+                  ~RME_POW2(PCID&RME_MASK_END(RME_WORD_ORDER-1)));
+}
+/* End Function:__RME_X64_PCID_Free ******************************************/
+
+/* Begin Function:__RME_X64_Bitmap_Set ****************************************
+Description : Set a bit in a bitmap that other processors may be changing.
+Input       : volatile rme_ptr_t* Bitmap - The bitmap.
+              rme_ptr_t Pos - The position of the bit.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_Bitmap_Set(volatile rme_ptr_t* Bitmap, rme_ptr_t Pos)
+{
+    rme_ptr_t Old;
+    rme_ptr_t Bit;
+
+    Bitmap=&Bitmap[Pos>>RME_WORD_ORDER];
+    Bit=RME_POW2(Pos&RME_MASK_END(RME_WORD_ORDER-1));
+
+    do
+    {
+        Old=*Bitmap;
+        if((Old&Bit)!=0)
+            return;
+    }
+    while(RME_COMP_SWAP((rme_ptr_t*)Bitmap,Old,Old|Bit)==0);
+}
+/* End Function:__RME_X64_Bitmap_Set *****************************************/
+
+/* Begin Function:__RME_X64_Shoot_Inv *****************************************
+Description : Invalidate a removed translation on this processor. Only the TLB
+              entries of the current PCID can be invalidated by address.
+Input       : rme_ptr_t PCID - The PCID, which is either the current one or
+                               RME_X64_SHOOT_PCID_ANY.
+              rme_ptr_t Addr - The address, or RME_X64_SHOOT_ADDR_ALL.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_Shoot_Inv(rme_ptr_t PCID, rme_ptr_t Addr)
+{
+    if(Addr!=RME_X64_SHOOT_ADDR_ALL)
+        __RME_X64_INVLPG(Addr);
+    else if((PCID!=RME_X64_SHOOT_PCID_ANY)&&(RME_X64_INVPCID!=0))
+        __RME_X64_INVPCID(RME_X64_INVPCID_SINGLE, PCID, 0);
+    else
+        __RME_X64_TLB_Flush();
+}
+/* End Function:__RME_X64_Shoot_Inv ******************************************/
+
+/* Begin Function:__RME_X64_Shoot_Add *****************************************
+Description : Note that a translation has been removed. This processor drops it
+              right away, and the processors that may be using it are queued
+              for an IPI that is sent when the system call finishes, so that
+              many removals cost one IPI round. The processors that may have it
+              cached under a PCID they are not running in will flush that PCID
+              before they use it again.
+              When the PCID is known, the processors that never ran in it are
+              left alone; when it is not, the TLB epoch is increased and all
+              processors have to be told.
+Input       : rme_ptr_t PCID - The PCID, or RME_X64_SHOOT_PCID_ANY.
+              rme_ptr_t Addr - The address, or RME_X64_SHOOT_ADDR_ALL.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_Shoot_Add(rme_ptr_t PCID, rme_ptr_t Addr)
+{
+    rme_ptr_t Count;
+    rme_ptr_t CPUID;
+    rme_ptr_t Target;
+    volatile struct RME_X64_CPU_Info* Local;
+
+    CPUID=RME_CPU_LOCAL()->CPUID;
+    Local=&RME_X64_CPU_Info[CPUID];
+    Target=0;
+
+    if(PCID==RME_X64_SHOOT_PCID_ANY)
+    {
+        RME_FETCH_ADD((rme_ptr_t*)&RME_X64_TLB_Epoch,1);
+        __RME_X64_Shoot_Inv(PCID, Addr);
+
+        for(Count=0;Count<RME_X64_Num_CPU;Count++)
+        {
+            if(Count==CPUID)
+                continue;
+            __RME_X64_Bitmap_Set(Local->Shoot_To, Count);
+            Target=1;
+        }
+    }
+    else
+    {
+        /* Mark the PCID stale everywhere first, then see who is running in it.
+         * This pairs with __RME_Pgtbl_Set, which does the opposite */
+        for(Count=0;Count<RME_X64_Num_CPU;Count++)
+        {
+            if((Count==CPUID)&&(Local->Cur_PCID==PCID))
+                __RME_X64_Shoot_Inv(PCID, Addr);
+            else if((RME_X64_PCID_CPU[PCID][Count>>RME_WORD_ORDER]&RME_POW2(Count&RME_MASK_END(RME_WORD_ORDER-1)))!=0)
+                __RME_X64_Bitmap_Set(RME_X64_CPU_Info[Count].PCID_Stale, PCID);
+        }
+
+        __RME_X64_Write_Release();
+
+        for(Count=0;Count<RME_X64_Num_CPU;Count++)
+        {
+            if((Count==CPUID)||(RME_X64_CPU_Info[Count].Cur_PCID!=PCID))
+                continue;
+            __RME_X64_Bitmap_Set(Local->Shoot_To, Count);
+            Target=1;
+        }
+    }
+
+    if(Target==0)
+        return;
+
+    if(Local->Shoot_Num<RME_X64_SHOOT_MAX)
+    {
+        Local->Shoot[Local->Shoot_Num].PCID=PCID;
+        Local->Shoot[Local->Shoot_Num].Addr=Addr;
+        Local->Shoot_Num++;
+    }
+    else
+        Local->Shoot_Full=1;
+}
+/* End Function:__RME_X64_Shoot_Add ******************************************/
+
+/* Begin Function:__RME_X64_Shoot_Handler *************************************
+Description : Carry out the TLB shootdown requests that other processors sent
+              to this processor, and acknowledge them. This is called from the
+              IPI, and also by a processor that is waiting for its own requests
+              to complete, because the kernel runs with interrupts disabled.
 Input       : None.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-void __RME_X64_SMP_Tick(void)
+void __RME_X64_Shoot_Handler(void)
 {
-    /* Is this a SMP? */
-    if(RME_X64_Num_CPU>1)
+    rme_ptr_t Count;
+    rme_ptr_t Shoot_Cnt;
+    rme_ptr_t Bit;
+    rme_ptr_t Cur_PCID;
+    volatile struct RME_X64_CPU_Info* Local;
+    volatile struct RME_X64_CPU_Info* Remote;
+
+    Local=&RME_X64_CPU_Info[RME_CPU_LOCAL()->CPUID];
+    Cur_PCID=Local->Cur_PCID;
+
+    for(Count=0;Count<RME_X64_Num_CPU;Count++)
     {
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, 0xFFULL<<24);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_EXC_SELF|
-                                                 RME_X64_LAPIC_ICRLO_FIXED|
-                                                 RME_X64_INT_SMP_SYSTICK);
+        Bit=RME_POW2(Count&RME_MASK_END(RME_WORD_ORDER-1));
+        if((Local->Shoot_From[Count>>RME_WORD_ORDER]&Bit)==0)
+            continue;
+        RME_FETCH_AND((rme_ptr_t*)&Local->Shoot_From[Count>>RME_WORD_ORDER],~Bit);
+
+        /* The sender will not touch its requests until all of us acknowledge */
+        Remote=&RME_X64_CPU_Info[Count];
+        if(Remote->Shoot_Full!=0)
+            __RME_X64_TLB_Flush();
+        else
+        {
+            for(Shoot_Cnt=0;Shoot_Cnt<Remote->Shoot_Num;Shoot_Cnt++)
+            {
+                if((Remote->Shoot[Shoot_Cnt].PCID==RME_X64_SHOOT_PCID_ANY)||
+                   (Remote->Shoot[Shoot_Cnt].PCID==Cur_PCID))
+                    __RME_X64_Shoot_Inv(Remote->Shoot[Shoot_Cnt].PCID, Remote->Shoot[Shoot_Cnt].Addr);
+            }
+        }
+
+        RME_FETCH_ADD((rme_ptr_t*)&Remote->Shoot_Wait,-1);
     }
 }
-/* End Function:__RME_X64_SMP_Tick *******************************************/
+/* End Function:__RME_X64_Shoot_Handler **************************************/
+
+/* Begin Function:__RME_X64_Timer_Calib **************************************
+Description : Calibrate the LAPIC timer against the PIT. The PIT channel 2 is
+              run in one-shot mode for a fixed window, and we count how many
+              LAPIC timer cycles pass in it. The PIT is not used after this.
+              This is only done by the booting processor, and all the LAPIC
+              timers are assumed to run at the same frequency.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_Timer_Calib(void)
+{
+    rme_ptr_t Elapsed;
+
+    /* Stop the LAPIC timer, and let it count at the bus clock */
+    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TIMER, RME_X64_LAPIC_MASKED|RME_X64_INT_TIMER);
+    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TDCR, RME_X64_LAPIC_TIMER_X1);
+
+    /* Enable the channel 2 gate, and disable the speaker */
+    __RME_X64_Out(RME_X64_PIT_CH2_GATE, (__RME_X64_In(RME_X64_PIT_CH2_GATE)&0xFD)|0x01);
+    /* Channel 2, lobyte/hibyte, mode 0 (interrupt on terminal count) */
+    __RME_X64_Out(RME_X64_PIT_CMD, 0xB0);
+    __RME_X64_Out(RME_X64_PIT_CH2, (RME_X64_PIT_FREQ/RME_X64_TIMER_CALIB_FREQ)&0xFF);
+    __RME_X64_Out(RME_X64_PIT_CH2, ((RME_X64_PIT_FREQ/RME_X64_TIMER_CALIB_FREQ)>>8)&0xFF);
+
+    /* Restart the PIT by toggling the gate, and start the LAPIC timer right away */
+    __RME_X64_Out(RME_X64_PIT_CH2_GATE, __RME_X64_In(RME_X64_PIT_CH2_GATE)&0xFE);
+    __RME_X64_Out(RME_X64_PIT_CH2_GATE, __RME_X64_In(RME_X64_PIT_CH2_GATE)|0x01);
+    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TICR, 0xFFFFFFFFU);
+
+    /* Wait until the PIT output goes high */
+    while((__RME_X64_In(RME_X64_PIT_CH2_GATE)&0x20)==0);
+
+    Elapsed=0xFFFFFFFFU-RME_X64_LAPIC_READ(RME_X64_LAPIC_TCCR);
+    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TICR, 0);
+
+    RME_X64_LAPIC_Tick_Cnt=Elapsed*RME_X64_TIMER_CALIB_FREQ/RME_X64_TIMER_FREQ;
+    RME_ASSERT(RME_X64_LAPIC_Tick_Cnt!=0);
+
+    RME_PRINTK_S("\r\nLAPIC timer count per tick: ");
+    RME_PRINTK_I(RME_X64_LAPIC_Tick_Cnt);
+}
+/* End Function:__RME_X64_Timer_Calib ****************************************/
 
 /* Begin Function:__RME_X64_Timer_Init ****************************************
-Description : Initialize the on-board timer. We use the PIT because it is stable;
-              Then we let the main CPU send out timer IPI interrupts to all other
-              CPUs.
+Description : Start the LAPIC timer of this processor in periodic mode. Each
+              processor calls this by itself, after the timer is calibrated.
+              In tickless mode, the non-booting processors use one-shot mode
+              instead, and their timers stay stopped until the kernel arms them.
 Input       : None.
 Output      : None.
 Return      : None.
 ******************************************************************************/
 void __RME_X64_Timer_Init(void)
 {
-    /* For timer interrupts, they will always be handled by core 1, and all the other
-     * cores should receive a IPI for that, so their scheduler can look after their
-     * threads. We are using square wave mode. */
-    __RME_X64_Out(RME_X64_PIT_CMD,0x34);
-    __RME_X64_Out(RME_X64_PIT_CH0,(1193182/2/RME_X64_TIMER_FREQ)&0xFF);
-    __RME_X64_Out(RME_X64_PIT_CH0,((1193182/2/RME_X64_TIMER_FREQ)>>8)&0xFF);
+    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TDCR, RME_X64_LAPIC_TIMER_X1);
+#if(RME_TICKLESS==RME_TRUE)
+    /* The booting processor always ticks, because it keeps the timestamp */
+    if(RME_CPU_LOCAL()->CPUID!=0)
+    {
+        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TIMER, RME_X64_INT_TIMER);
+        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TICR, 0);
+        return;
+    }
+#endif
+    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TIMER, RME_X64_LAPIC_TIMER_PERIODIC|RME_X64_INT_TIMER);
+    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TICR, RME_X64_LAPIC_Tick_Cnt);
 }
 /* End Function:__RME_X64_Timer_Init *****************************************/
 
+/* Begin Function:__RME_Timer_Set *********************************************
+Description : Arm the one-shot LAPIC timer of this processor, in tickless mode.
+              The booting processor is always periodic, so this does nothing
+              there. Deadlines beyond the range of the counter are clipped, and
+              the kernel will just rearm the timer when it fires.
+Input       : rme_ptr_t Ticks - The number of ticks until the next event. If
+                                this is RME_THD_INF_TIME, the timer is stopped.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Timer_Set(rme_ptr_t Ticks)
+{
+    if(RME_CPU_LOCAL()->CPUID==0)
+        return;
+
+    if(Ticks>=RME_THD_INF_TIME)
+    {
+        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TICR, 0);
+        return;
+    }
+
+    if(Ticks>(0xFFFFFFFFU/RME_X64_LAPIC_Tick_Cnt))
+        Ticks=0xFFFFFFFFU/RME_X64_LAPIC_Tick_Cnt;
+
+    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TICR, Ticks*RME_X64_LAPIC_Tick_Cnt);
+}
+/* End Function:__RME_Timer_Set **********************************************/
+
 /* Begin Function:__RME_Low_Level_Init ****************************************
 Description : Initialize the low-level hardware.
 Input       : None.
@@ -1085,10 +1928,10 @@ rme_ptr_t __RME_Low_Level_Init(void)
 {
     /* We are here now ! */
     __RME_X64_UART_Init();
-    /* Read APIC tables and detect the configurations. Now we are not NUMA-aware */
-    RME_ASSERT(__RME_X64_ACPI_Init()==0);
-    /* Detect CPU features */
+    /* Detect CPU features - the MADT parsing needs to know if we have x2APIC */
     __RME_X64_Feature_Get();
+    /* Read APIC tables and detect the configurations, including the NUMA topology */
+    RME_ASSERT(__RME_X64_ACPI_Init()==0);
     /* Extract memory specifications */
     __RME_X64_Mem_Init(RME_X64_MBInfo->mmap_addr,RME_X64_MBInfo->mmap_length);
 
@@ -1099,7 +1942,8 @@ rme_ptr_t __RME_Low_Level_Init(void)
 /* Begin Function:__RME_Pgtbl_Kmem_Init ***************************************
 Description : Initialize the kernel mapping tables, so it can be added to all the
               top-level page tables. Currently this have no consideration for >1TB
-              RAM, and is not NUMA-aware.
+              RAM. The memory above 4GB is mapped node by node, and each CPU gets
+              its per-CPU data structure and kernel stack from its own node.
 Input       : None.
 Output      : None.
 Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
@@ -1109,19 +1953,26 @@ rme_ptr_t __RME_Pgtbl_Kmem_Init(void)
     rme_cnt_t PML4_Cnt;
     rme_cnt_t PDP_Cnt;
     rme_cnt_t PDE_Cnt;
+    rme_cnt_t Node_Cnt;
     rme_cnt_t Addr_Cnt;
+    rme_ptr_t Kmem2_Addr;
     struct __RME_X64_Pgreg* Pgreg;
     struct __RME_X64_Mem* Mem;
+    struct __RME_X64_Mem* Kmem2_Mem;
 
     /* Now initialize the kernel object allocation table */
-    _RME_Kotbl_Init(RME_X64_Layout.Kotbl_Size/sizeof(rme_ptr_t));
-    /* Reset PCID counter */
-    RME_X64_PCID_Inc=0;
+    _RME_Kotbl_Init(RME_X64_Kotbl_Sum-RME_KOTBL);
+    /* Reset PCID allocation - the shared one is never given out */
+    for(PML4_Cnt=0;PML4_Cnt<RME_X64_PCID_NUM/RME_WORD_BITS;PML4_Cnt++)
+        RME_X64_PCID_Bitmap[PML4_Cnt]=0;
+    RME_X64_PCID_Bitmap[0]=RME_POW2(RME_X64_PCID_SHARED);
+    RME_X64_TLB_Epoch=0;
 
     /* And the page table registration table as well */
     Pgreg=(struct __RME_X64_Pgreg*)RME_X64_Layout.Pgreg_Start;
     for(PML4_Cnt=0;PML4_Cnt<RME_X64_Layout.Pgreg_Size/sizeof(struct __RME_X64_Pgreg);PML4_Cnt++)
     {
+        Pgreg[PML4_Cnt].PCID=RME_X64_PCID_SHARED;
         Pgreg[PML4_Cnt].Child_Cnt=0;
         Pgreg[PML4_Cnt].Parent_Cnt=0;
     }
@@ -1181,10 +2032,11 @@ rme_ptr_t __RME_Pgtbl_Kmem_Init(void)
 
     /* The first Kmem1 trunk must start at smaller or equal to 16MB */
     RME_ASSERT(Mem->Start_Addr<=RME_POW2(RME_PGTBL_SIZE_16M));
-    /* The raw sizes of kernel memory segment 1 - per CPU area is already aligned so no need to align again */
-    RME_X64_Layout.Kmem1_Start[0]=RME_X64_Layout.PerCPU_Start+RME_X64_Layout.PerCPU_Size;
+    /* The raw sizes of kernel memory segment 1 - it starts right after the Pgreg */
+    RME_X64_Layout.Kmem1_Start[0]=RME_ROUND_UP(RME_X64_Layout.Pgreg_Start+RME_X64_Layout.Pgreg_Size,RME_PGTBL_SIZE_4K);
     RME_X64_Layout.Kmem1_Size[0]=Mem->Start_Addr+Mem->Length-RME_POW2(RME_PGTBL_SIZE_16M)-
     		                     RME_X64_VA2PA(RME_X64_Layout.Kmem1_Start[0]);
+    RME_X64_Layout.Kmem1_Node[0]=Mem->Node;
 
     /* Add the rest of Kmem1 into the array */
     Addr_Cnt=1;
@@ -1211,6 +2063,7 @@ rme_ptr_t __RME_Pgtbl_Kmem_Init(void)
         }
         RME_X64_Layout.Kmem1_Start[Addr_Cnt]=RME_X64_PA2VA(RME_ROUND_UP(Mem->Start_Addr,RME_PGTBL_SIZE_2M));
         RME_X64_Layout.Kmem1_Size[Addr_Cnt]=RME_ROUND_DOWN(Mem->Length,RME_PGTBL_SIZE_2M);
+        RME_X64_Layout.Kmem1_Node[Addr_Cnt]=Mem->Node;
         Addr_Cnt++;
     }
     RME_X64_Layout.Kmem1_Trunks=Addr_Cnt;
@@ -1221,54 +2074,70 @@ rme_ptr_t __RME_Pgtbl_Kmem_Init(void)
 
     /* Create kernel page mappings for memory above 4GB - we assume only one segment below 4GB */
     RME_X64_Layout.Kpgtbl_Start=RME_X64_Layout.Kmem1_Start[0];
-    RME_X64_Layout.Kmem2_Start=RME_X64_PA2VA(RME_POW2(RME_PGTBL_SIZE_4G));
-    RME_X64_Layout.Kmem2_Size=0;
 
-    /* We have filled the first 4 1GB superpages */
-    PML4_Cnt=0;
-    PDP_Cnt=3;
-    PDE_Cnt=511;
+    /* Throw away small segments, and align the rest to 2MB */
+    Kmem2_Mem=Mem;
     while(Mem!=(struct __RME_X64_Mem*)(&RME_X64_Phys_Mem))
     {
-        /* Throw away small segments */
         if(Mem->Length<2*RME_POW2(RME_PGTBL_SIZE_2M))
         {
             RME_PRINTK_S("\n\rAbandoning physical memory above 4G: addr 0x");
             RME_PRINTK_U(Mem->Start_Addr);
             RME_PRINTK_S(", length 0x");
             RME_PRINTK_U(Mem->Length);
-            Mem=(struct __RME_X64_Mem*)(Mem->Head.Next);
-            continue;
+            Mem->Length=0;
+        }
+        else
+        {
+            Addr_Cnt=RME_ROUND_DOWN(Mem->Start_Addr+Mem->Length,RME_PGTBL_SIZE_2M);
+            Mem->Start_Addr=RME_ROUND_UP(Mem->Start_Addr,RME_PGTBL_SIZE_2M);
+            Mem->Length=Addr_Cnt-Mem->Start_Addr;
         }
 
-        /* Align the memory segment to 2MB */
-        Mem->Start_Addr=RME_ROUND_UP(Mem->Start_Addr,RME_PGTBL_SIZE_2M);
-        Mem->Length=RME_ROUND_DOWN(Mem->Length-1,RME_PGTBL_SIZE_2M);
+        Mem=(struct __RME_X64_Mem*)(Mem->Head.Next);
+    }
+
+    /* Add these pages into the kernel at addresses above 4GB offset as 2MB pages. We
+     * go through the nodes one by one, so that the Kmem2 of each node is contiguous.
+     * We have filled the first 4 1GB superpages */
+    PML4_Cnt=0;
+    PDP_Cnt=3;
+    PDE_Cnt=511;
+    Kmem2_Addr=RME_X64_PA2VA(RME_POW2(RME_PGTBL_SIZE_4G));
+    for(Node_Cnt=0;Node_Cnt<RME_X64_Num_Node;Node_Cnt++)
+    {
+        RME_X64_Layout.Kmem2_Start[Node_Cnt]=Kmem2_Addr;
+        RME_X64_Layout.Kmem2_Size[Node_Cnt]=0;
 
-        /* Add these pages into the kernel at addresses above 4GB offset as 2MB pages */
-        for(Addr_Cnt=0;Addr_Cnt<Mem->Length;Addr_Cnt+=RME_POW2(RME_PGTBL_SIZE_2M))
+        for(Mem=Kmem2_Mem;Mem!=(struct __RME_X64_Mem*)(&RME_X64_Phys_Mem);Mem=(struct __RME_X64_Mem*)(Mem->Head.Next))
         {
-            PDE_Cnt++;
-            if(PDE_Cnt==512)
+            if(Mem->Node!=Node_Cnt)
+                continue;
+
+            for(Addr_Cnt=0;Addr_Cnt<Mem->Length;Addr_Cnt+=RME_POW2(RME_PGTBL_SIZE_2M))
             {
-                PDE_Cnt=0;
-                PDP_Cnt++;
-                if(PDP_Cnt==512)
+                PDE_Cnt++;
+                if(PDE_Cnt==512)
                 {
-                    PDP_Cnt=0;
-                    PML4_Cnt++;
+                    PDE_Cnt=0;
+                    PDP_Cnt++;
+                    if(PDP_Cnt==512)
+                    {
+                        PDP_Cnt=0;
+                        PML4_Cnt++;
+                    }
+                    /* Map this PDE into the PDP */
+                    RME_X64_Kpgt.PDP[PML4_Cnt][PDP_Cnt]|=RME_X64_MMU_ADDR(RME_X64_VA2PA(RME_X64_Layout.Kmem1_Start[0]))|RME_X64_MMU_P;
                 }
-                /* Map this PDE into the PDP */
-                RME_X64_Kpgt.PDP[PML4_Cnt][PDP_Cnt]|=RME_X64_MMU_ADDR(RME_X64_VA2PA(RME_X64_Layout.Kmem1_Start[0]))|RME_X64_MMU_P;
-            }
 
-            ((rme_ptr_t*)(RME_X64_Layout.Kmem1_Start[0]))[0]=RME_X64_MMU_ADDR(Mem->Start_Addr+Addr_Cnt)|RME_X64_MMU_KERN_PDE;
-            RME_X64_Layout.Kmem1_Start[0]+=sizeof(rme_ptr_t);
-            RME_X64_Layout.Kmem1_Size[0]-=sizeof(rme_ptr_t);
-            RME_X64_Layout.Kmem2_Size+=RME_POW2(RME_PGTBL_SIZE_2M);
+                ((rme_ptr_t*)(RME_X64_Layout.Kmem1_Start[0]))[0]=RME_X64_MMU_ADDR(Mem->Start_Addr+Addr_Cnt)|RME_X64_MMU_KERN_PDE;
+                RME_X64_Layout.Kmem1_Start[0]+=sizeof(rme_ptr_t);
+                RME_X64_Layout.Kmem1_Size[0]-=sizeof(rme_ptr_t);
+                RME_X64_Layout.Kmem2_Size[Node_Cnt]+=RME_POW2(RME_PGTBL_SIZE_2M);
+            }
         }
 
-        Mem=(struct __RME_X64_Mem*)(Mem->Head.Next);
+        Kmem2_Addr+=RME_X64_Layout.Kmem2_Size[Node_Cnt];
     }
 
     /* Copy the new page tables to the temporary entries, so that we can boot SMP */
@@ -1279,24 +2148,21 @@ rme_ptr_t __RME_Pgtbl_Kmem_Init(void)
     RME_X64_Layout.Kmem1_Start[0]=RME_ROUND_UP(RME_X64_Layout.Kmem1_Start[0],RME_PGTBL_SIZE_2M);
     RME_X64_Layout.Kmem1_Size[0]=RME_ROUND_DOWN(RME_X64_Layout.Kmem1_Size[0]-1,RME_PGTBL_SIZE_2M);
 
-    /* All memory is mapped. Now figure out the size of kernel stacks */
+    /* All memory is mapped */
     RME_X64_Layout.Kpgtbl_Size=RME_X64_Layout.Kmem1_Start[0]-RME_X64_Layout.Kpgtbl_Start;
 
-    /* See if we are allocating the stack from Kmem2 or Kmem1 */
-    if(RME_X64_Layout.Kmem2_Size==0)
-    {
-        RME_X64_Layout.Stack_Start=RME_ROUND_DOWN(RME_X64_Layout.Kmem1_Start[0]+RME_X64_Layout.Kmem1_Size[0]-1,RME_X64_KSTACK_ORDER);
-        RME_X64_Layout.Stack_Start-=RME_X64_Layout.Stack_Size;
-        RME_X64_Layout.Kmem1_Size[0]=RME_X64_Layout.Stack_Start-RME_X64_Layout.Kmem1_Start[0];
-    }
+    /* Take the kernel stacks and then the per-CPU data structures for each CPU from
+     * its own node. The stacks go first because they are aligned to larger sizes */
+    for(Addr_Cnt=0;Addr_Cnt<RME_X64_Num_CPU;Addr_Cnt++)
+        RME_X64_Layout.Stack_Start[Addr_Cnt]=__RME_X64_NUMA_Carve(RME_X64_CPU_Info[Addr_Cnt].Node,RME_X64_KSTACK_ORDER);
+    for(Addr_Cnt=0;Addr_Cnt<RME_X64_Num_CPU;Addr_Cnt++)
+        RME_X64_Layout.PerCPU_Start[Addr_Cnt]=__RME_X64_NUMA_Carve(RME_X64_CPU_Info[Addr_Cnt].Node,RME_PGTBL_SIZE_4K+1);
 
-
-    else
-    {
-        RME_X64_Layout.Stack_Start=RME_ROUND_DOWN(RME_X64_Layout.Kmem2_Start+RME_X64_Layout.Kmem2_Size-1,RME_X64_KSTACK_ORDER);
-        RME_X64_Layout.Stack_Start-=RME_X64_Layout.Stack_Size;
-        RME_X64_Layout.Kmem2_Size=RME_X64_Layout.Stack_Start-RME_X64_Layout.Kmem2_Start;
-    }
+    /* These are mapped to the init process in 2MB pages, and they must not cover
+     * what we just took */
+    RME_X64_Layout.Kmem1_Size[0]=RME_ROUND_DOWN(RME_X64_Layout.Kmem1_Size[0],RME_PGTBL_SIZE_2M);
+    for(Node_Cnt=0;Node_Cnt<RME_X64_Num_Node;Node_Cnt++)
+        RME_X64_Layout.Kmem2_Size[Node_Cnt]=RME_ROUND_DOWN(RME_X64_Layout.Kmem2_Size[Node_Cnt],RME_PGTBL_SIZE_2M);
 
     /* Now report all mapping info */
     RME_PRINTK_S("\n\r\n\rKotbl_Start:     0x");
@@ -1307,10 +2173,6 @@ rme_ptr_t __RME_Pgtbl_Kmem_Init(void)
     RME_PRINTK_U(RME_X64_Layout.Pgreg_Start);
     RME_PRINTK_S("\n\rPgreg_Size:      0x");
     RME_PRINTK_U(RME_X64_Layout.Pgreg_Size);
-    RME_PRINTK_S("\n\rPerCPU_Start:    0x");
-    RME_PRINTK_U(RME_X64_Layout.PerCPU_Start);
-    RME_PRINTK_S("\n\rPerCPU_Size:     0x");
-    RME_PRINTK_U(RME_X64_Layout.PerCPU_Size);
     RME_PRINTK_S("\n\rKpgtbl_Start:    0x");
     RME_PRINTK_U(RME_X64_Layout.Kpgtbl_Start);
     RME_PRINTK_S("\n\rKpgtbl_Size:     0x");
@@ -1325,44 +2187,70 @@ rme_ptr_t __RME_Pgtbl_Kmem_Init(void)
         RME_PRINTK_I(Addr_Cnt);
         RME_PRINTK_S("]:   0x");
         RME_PRINTK_U(RME_X64_Layout.Kmem1_Size[Addr_Cnt]);
+        RME_PRINTK_S("\n\rKmem1_Node[");
+        RME_PRINTK_I(Addr_Cnt);
+        RME_PRINTK_S("]:   ");
+        RME_PRINTK_I(RME_X64_Layout.Kmem1_Node[Addr_Cnt]);
     }
     RME_PRINTK_S("\n\rHole_Start:      0x");
     RME_PRINTK_U(RME_X64_Layout.Hole_Start);
     RME_PRINTK_S("\n\rHole_Size:       0x");
     RME_PRINTK_U(RME_X64_Layout.Hole_Size);
-    RME_PRINTK_S("\n\rKmem2_Start:     0x");
-    RME_PRINTK_U(RME_X64_Layout.Kmem2_Start);
-    RME_PRINTK_S("\n\rKmem2_Size:      0x");
-    RME_PRINTK_U(RME_X64_Layout.Kmem2_Size);
-    RME_PRINTK_S("\n\rStack_Start:     0x");
-    RME_PRINTK_U(RME_X64_Layout.Stack_Start);
-    RME_PRINTK_S("\n\rStack_Size:      0x");
-    RME_PRINTK_U(RME_X64_Layout.Stack_Size);
+    for(Node_Cnt=0;Node_Cnt<RME_X64_Num_Node;Node_Cnt++)
+    {
+        RME_PRINTK_S("\n\rKmem2_Start[");
+        RME_PRINTK_I(Node_Cnt);
+        RME_PRINTK_S("]:  0x");
+        RME_PRINTK_U(RME_X64_Layout.Kmem2_Start[Node_Cnt]);
+        RME_PRINTK_S("\n\rKmem2_Size[");
+        RME_PRINTK_I(Node_Cnt);
+        RME_PRINTK_S("]:   0x");
+        RME_PRINTK_U(RME_X64_Layout.Kmem2_Size[Node_Cnt]);
+    }
+    for(Addr_Cnt=0;Addr_Cnt<RME_X64_Num_CPU;Addr_Cnt++)
+    {
+        RME_PRINTK_S("\n\rPerCPU_Start[");
+        RME_PRINTK_I(Addr_Cnt);
+        RME_PRINTK_S("]: 0x");
+        RME_PRINTK_U(RME_X64_Layout.PerCPU_Start[Addr_Cnt]);
+        RME_PRINTK_S("\n\rStack_Start[");
+        RME_PRINTK_I(Addr_Cnt);
+        RME_PRINTK_S("]:  0x");
+        RME_PRINTK_U(RME_X64_Layout.Stack_Start[Addr_Cnt]);
+    }
 
     return 0;
 }
 /* End Function:__RME_Pgtbl_Kmem_Init ****************************************/
 
 /* Begin Function:__RME_SMP_Low_Level_Init ************************************
-Description : Low-level initialization for all other cores.
-Input       : None.
+Description : Low-level initialization for all other cores. The cores come here
+              concurrently, and each of them has found its own CPUID and kernel
+              stack in the boot slots.
+Input       : rme_ptr_t CPUID - The CPUID of this processor.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-rme_ptr_t __RME_SMP_Low_Level_Init(void)
+rme_ptr_t __RME_SMP_Low_Level_Init(rme_ptr_t CPUID)
 {
     struct RME_CPU_Local* CPU_Local;
 
     /* Initialize all vector tables */
-    __RME_X64_CPU_Local_Init();
+    __RME_X64_CPU_Local_Init(CPUID);
     /* Initialize LAPIC */
     __RME_X64_LAPIC_Init();
+    /* Initialize FPU */
+    __RME_X64_FPU_Init();
+    /* Initialize PCID */
+    __RME_X64_TLB_Init();
 
     /* Check to see if we are booting this correctly */
     CPU_Local=RME_CPU_LOCAL();
-    RME_ASSERT(CPU_Local->CPUID==RME_X64_CPU_Cnt);
+    RME_ASSERT(CPU_Local->CPUID==CPUID);
 
-    RME_X64_CPU_Info[RME_X64_CPU_Cnt].Boot_Done=1;
+    /* Stores are not reordered, so the BSP sees the timestamp when it sees the flag */
+    RME_X64_CPU_Info[CPUID].Boot_TSC=__RME_X64_RDTSC();
+    RME_X64_CPU_Info[CPUID].Boot_Done=1;
     /* Spin until the global CPU counter is zero again, which means the booting
      * processor has done booting and we can proceed now */
     while(RME_X64_CPU_Cnt!=0);
@@ -1373,6 +2261,8 @@ rme_ptr_t __RME_SMP_Low_Level_Init(void)
     RME_ASSERT(CPU_Local->Tick_Sig!=0);
     RME_ASSERT(CPU_Local->Vect_Sig!=0);
 
+    /* Start our own timer - it is calibrated now */
+    __RME_X64_Timer_Init();
     /* Change page tables */
     __RME_Pgtbl_Set(RME_CAP_GETOBJ((CPU_Local->Cur_Thd)->Sched.Proc->Pgtbl,rme_ptr_t));
     /* Boot into the init thread - never returns */
@@ -1393,6 +2283,7 @@ rme_ptr_t __RME_Boot(void)
     rme_ptr_t Cur_Addr;
     rme_cnt_t Count;
     rme_cnt_t Kmem1_Cnt;
+    rme_cnt_t Addr_Cnt;
     rme_ptr_t Phys_Addr;
     rme_ptr_t Page_Ptr;
     struct RME_Cap_Captbl* Captbl;
@@ -1401,10 +2292,14 @@ rme_ptr_t __RME_Boot(void)
     /* Initialize our own CPU-local data structures */
     RME_X64_CPU_Cnt=0;
     RME_PRINTK_S("\r\nCPU 0 local IDT/GDT init");
-    __RME_X64_CPU_Local_Init();
+    __RME_X64_CPU_Local_Init(0);
     /* Initialize interrupt controllers (PIC, LAPIC, IOAPIC) */
     RME_PRINTK_S("\r\nCPU 0 LAPIC init");
     __RME_X64_LAPIC_Init();
+    RME_PRINTK_S("\r\nCPU 0 FPU init");
+    __RME_X64_FPU_Init();
+    RME_PRINTK_S("\r\nCPU 0 PCID init");
+    __RME_X64_TLB_Init();
     RME_PRINTK_S("\r\nPIC init");
     __RME_X64_PIC_Init();
     RME_PRINTK_S("\r\nIOAPIC init");
@@ -1476,22 +2371,29 @@ rme_ptr_t __RME_Boot(void)
     RME_PRINTK_U(Page_Ptr*RME_POW2(RME_PGTBL_SIZE_2M)+RME_POW2(RME_PGTBL_SIZE_2M)-1);
     RME_PRINTK_S("]");
 
-    /* Map the Kmem2 in - don't want lookups, we know where they are. Offset by 2048 because they are mapped above 4G */
-    RME_PRINTK_S("\r\nKmem2 pages: 0x");
-    RME_PRINTK_U(RME_X64_Layout.Kmem2_Size/RME_POW2(RME_PGTBL_SIZE_2M));
-    RME_PRINTK_S(", [0x");
-    RME_PRINTK_U(Page_Ptr*RME_POW2(RME_PGTBL_SIZE_2M)+RME_POW2(RME_PGTBL_SIZE_2M));
-    RME_PRINTK_S(", 0x");
-    for(Count=2048;Count<(RME_X64_Layout.Kmem2_Size/RME_POW2(RME_PGTBL_SIZE_2M)+2048);Count++)
+    /* Map the Kmem2 in node by node - don't want lookups, we know where they are. Offset by
+     * 2048 because they are mapped above 4G */
+    for(Kmem1_Cnt=0;Kmem1_Cnt<RME_X64_Num_Node;Kmem1_Cnt++)
     {
-        Phys_Addr=RME_X64_PA2VA(RME_X64_MMU_ADDR(RME_X64_Kpgt.PDP[Count>>18][(Count>>9)&0x1FF]));
-        Phys_Addr=RME_X64_MMU_ADDR(((rme_ptr_t*)Phys_Addr)[Count&0x1FF]);
-        RME_ASSERT(_RME_Pgtbl_Boot_Add(RME_X64_CPT, RME_CAPID(RME_BOOT_TBL_PGTBL,RME_BOOT_PDE(Page_Ptr>>9)),
-                                       Phys_Addr, Page_Ptr&0x1FF, RME_PGTBL_ALL_PERM)==0);
-        Page_Ptr++;
+        RME_PRINTK_S("\r\nKmem2 pages of node ");
+        RME_PRINTK_I(Kmem1_Cnt);
+        RME_PRINTK_S(": 0x");
+        RME_PRINTK_U(RME_X64_Layout.Kmem2_Size[Kmem1_Cnt]/RME_POW2(RME_PGTBL_SIZE_2M));
+        RME_PRINTK_S(", [0x");
+        RME_PRINTK_U(Page_Ptr*RME_POW2(RME_PGTBL_SIZE_2M)+RME_POW2(RME_PGTBL_SIZE_2M));
+        RME_PRINTK_S(", 0x");
+        Addr_Cnt=2048+(RME_X64_Layout.Kmem2_Start[Kmem1_Cnt]-RME_X64_PA2VA(RME_POW2(RME_PGTBL_SIZE_4G)))/RME_POW2(RME_PGTBL_SIZE_2M);
+        for(Count=Addr_Cnt;Count<(RME_X64_Layout.Kmem2_Size[Kmem1_Cnt]/RME_POW2(RME_PGTBL_SIZE_2M)+Addr_Cnt);Count++)
+        {
+            Phys_Addr=RME_X64_PA2VA(RME_X64_MMU_ADDR(RME_X64_Kpgt.PDP[Count>>18][(Count>>9)&0x1FF]));
+            Phys_Addr=RME_X64_MMU_ADDR(((rme_ptr_t*)Phys_Addr)[Count&0x1FF]);
+            RME_ASSERT(_RME_Pgtbl_Boot_Add(RME_X64_CPT, RME_CAPID(RME_BOOT_TBL_PGTBL,RME_BOOT_PDE(Page_Ptr>>9)),
+                                           Phys_Addr, Page_Ptr&0x1FF, RME_PGTBL_ALL_PERM)==0);
+            Page_Ptr++;
+        }
+        RME_PRINTK_U(Page_Ptr*RME_POW2(RME_PGTBL_SIZE_2M)+RME_POW2(RME_PGTBL_SIZE_2M)-1);
+        RME_PRINTK_S("]");
     }
-    RME_PRINTK_U(Page_Ptr*RME_POW2(RME_PGTBL_SIZE_2M)+RME_POW2(RME_PGTBL_SIZE_2M)-1);
-    RME_PRINTK_S("]");
 
     /* Activate the first process - This process cannot be deleted */
     RME_ASSERT(_RME_Proc_Boot_Crt(RME_X64_CPT, RME_BOOT_CAPTBL, RME_BOOT_INIT_PROC,
@@ -1501,9 +2403,9 @@ rme_ptr_t __RME_Boot(void)
     /* Create the initial kernel function capability */
     RME_ASSERT(_RME_Kern_Boot_Crt(RME_X64_CPT, RME_BOOT_CAPTBL, RME_BOOT_INIT_KERN)==0);
 
-    /* Create a capability table for initial kernel memory capabilities. We need a few for Kmem1, and another one for Kmem2 */
-    RME_ASSERT(_RME_Captbl_Boot_Crt(RME_X64_CPT, RME_BOOT_CAPTBL, RME_BOOT_TBL_KMEM, Cur_Addr, RME_X64_KMEM1_MAXSEGS+1)==0);
-    Cur_Addr+=RME_KOTBL_ROUND(RME_CAPTBL_SIZE(RME_X64_KMEM1_MAXSEGS+1));
+    /* Create a capability table for initial kernel memory capabilities. We need a few for Kmem1, and one for the Kmem2 of each node */
+    RME_ASSERT(_RME_Captbl_Boot_Crt(RME_X64_CPT, RME_BOOT_CAPTBL, RME_BOOT_TBL_KMEM, Cur_Addr, RME_X64_KMEM1_MAXSEGS+RME_X64_NODE_NUM)==0);
+    Cur_Addr+=RME_KOTBL_ROUND(RME_CAPTBL_SIZE(RME_X64_KMEM1_MAXSEGS+RME_X64_NODE_NUM));
     /* Create Kmem1 capabilities - can create page tables here */
     for(Count=0;Count<RME_X64_Layout.Kmem1_Trunks;Count++)
     {
@@ -1514,13 +2416,18 @@ rme_ptr_t __RME_Boot(void)
                                       RME_KMEM_FLAG_CAPTBL|RME_KMEM_FLAG_PGTBL|RME_KMEM_FLAG_PROC|
                                       RME_KMEM_FLAG_THD|RME_KMEM_FLAG_SIG|RME_KMEM_FLAG_INV)==0);
     }
-    /* Create Kmem2 capability - cannot create page tables here */
-    RME_ASSERT(_RME_Kmem_Boot_Crt(RME_X64_CPT,
-                                  RME_BOOT_TBL_KMEM, RME_X64_KMEM1_MAXSEGS,
-                                  RME_X64_Layout.Kmem2_Start,
-                                  RME_X64_Layout.Kmem2_Start+RME_X64_Layout.Kmem2_Size,
-                                  RME_KMEM_FLAG_CAPTBL|RME_KMEM_FLAG_PROC|
-                                  RME_KMEM_FLAG_THD|RME_KMEM_FLAG_SIG|RME_KMEM_FLAG_INV)==0);
+    /* Create Kmem2 capabilities, one for each node - cannot create page tables here */
+    for(Count=0;Count<RME_X64_Num_Node;Count++)
+    {
+        if(RME_X64_Layout.Kmem2_Size[Count]==0)
+            continue;
+        RME_ASSERT(_RME_Kmem_Boot_Crt(RME_X64_CPT,
+                                      RME_BOOT_TBL_KMEM, RME_X64_KMEM1_MAXSEGS+Count,
+                                      RME_X64_Layout.Kmem2_Start[Count],
+                                      RME_X64_Layout.Kmem2_Start[Count]+RME_X64_Layout.Kmem2_Size[Count],
+                                      RME_KMEM_FLAG_CAPTBL|RME_KMEM_FLAG_PROC|
+                                      RME_KMEM_FLAG_THD|RME_KMEM_FLAG_SIG|RME_KMEM_FLAG_INV)==0);
+    }
 
     /* Create the initial kernel endpoints for timer ticks */
     RME_ASSERT(_RME_Captbl_Boot_Crt(RME_X64_CPT, RME_BOOT_CAPTBL, RME_BOOT_TBL_TIMER, Cur_Addr, RME_X64_Num_CPU)==0);
@@ -1569,17 +2476,17 @@ rme_ptr_t __RME_Boot(void)
     RME_PRINTK_S("\r\nEndpoint object size: ");
     RME_PRINTK_I(sizeof(struct RME_Sig_Struct)/sizeof(rme_ptr_t));
 
-    /* Initialize the timer and start its interrupt routing */
+    /* Calibrate the LAPIC timer and start our own one */
     RME_PRINTK_S("\r\nTimer init\r\n");
+    __RME_X64_Timer_Calib();
     __RME_X64_Timer_Init();
-    //__RME_X64_IOAPIC_Int_Enable(2,0);
     /* Change page tables */
     __RME_Pgtbl_Set(RME_CAP_GETOBJ((RME_CPU_LOCAL()->Cur_Thd)->Sched.Proc->Pgtbl,rme_ptr_t));
 
 
     /* Load the init process to address 0x00 - It should be smaller than 2MB */
     extern const unsigned char UVM_Init[];
-    _RME_Memcpy(0,(void*)UVM_Init,RME_POW2(RME_PGTBL_SIZE_2M));
+    RME_MEMCPY(0,(void*)UVM_Init,RME_POW2(RME_PGTBL_SIZE_2M));
 
 
     /* Now other non-booting processors may proceed and go into their threads */
@@ -1650,6 +2557,21 @@ void __RME_Set_Syscall_Retval(struct RME_Reg_Struct* Reg, rme_ret_t Retval)
 }
 /* End Function:__RME_Set_Syscall_Retval *************************************/
 
+/* Begin Function:__RME_Set_Sig_Data ******************************************
+Description : Set the words carried by a signal to the register set of the receiver.
+              They are placed where the second and third parameters were passed.
+Input       : rme_ptr_t Data0 - The first word.
+              rme_ptr_t Data1 - The second word.
+Output      : struct RME_Reg_Struct* Reg - The register set.
+Return      : None.
+******************************************************************************/
+void __RME_Set_Sig_Data(struct RME_Reg_Struct* Reg, rme_ptr_t Data0, rme_ptr_t Data1)
+{
+    Reg->RDX=Data0;
+    Reg->R8=Data1;
+}
+/* End Function:__RME_Set_Sig_Data *******************************************/
+
 /* Begin Function:__RME_Thd_Reg_Init ******************************************
 Description : Initialize the register set for the thread.
 Input       : rme_ptr_t Entry - The thread entry address.
@@ -1711,20 +2633,32 @@ void __RME_Thd_Reg_Copy(struct RME_Reg_Struct* Dst, struct RME_Reg_Struct* Src)
 /* End Function:__RME_Thd_Reg_Copy *******************************************/
 
 /* Begin Function:__RME_Thd_Cop_Init ******************************************
-Description : Initialize the coprocessor register set for the thread.
+Description : Initialize the coprocessor register set for the thread. All the
+              extended states are marked as initial, and the control words
+              have all the exceptions masked.
 Input       : struct RME_Reg_Struct* Reg - The register struct to help initialize the coprocessor.
 Output      : struct RME_Reg_Cop_Struct* Cop_Reg - The register set content generated.
 Return      : None.
 ******************************************************************************/
 void __RME_Thd_Cop_Init(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg)
 {
-    /* Empty function, return immediately. The FPU contents is not predictable */
+    rme_ptr_t Area;
+    rme_cnt_t Count;
+
+    Area=RME_X64_COP_AREA(Cop_Reg);
+    for(Count=0;Count<RME_X64_COP_SIZE;Count+=sizeof(rme_ptr_t))
+        *(rme_ptr_t*)(Area+Count)=0;
+
+    *(rme_u16_t*)(Area+RME_X64_COP_FCW)=RME_X64_FCW_INIT;
+    *(rme_u32_t*)(Area+RME_X64_COP_MXCSR)=RME_X64_MXCSR_INIT;
 }
 /* End Function:__RME_Thd_Cop_Reg_Init ***************************************/
 
 /* Begin Function:__RME_Thd_Cop_Save ******************************************
 Description : Save the co-op register sets. This operation is flexible - If the
-              program does not use the FPU, we do not save its context.
+              program does not use the FPU, we do not save its context. If it
+              did not touch the FPU since it was switched in, CR0.TS is still set
+              and the context in memory is already up to date.
 Input       : struct RME_Reg_Struct* Reg - The context, used to decide whether
                                            to save the context of the coprocessor.
 Output      : struct RME_Cop_Struct* Cop_Reg - The pointer to the coprocessor contents.
@@ -1732,13 +2666,31 @@ Return      : None.
 ******************************************************************************/
 void __RME_Thd_Cop_Save(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg)
 {
-    /* Not used for now */
+    rme_ptr_t CR0;
+
+    CR0=__RME_X64_CR0_Get();
+    if((CR0&RME_X64_CR0_TS)!=0)
+        return;
+
+#if(RME_X64_FPU_TYPE!=RME_FALSE)
+    if(RME_X64_XSAVEOPT!=0)
+        __RME_X64_XSAVEOPT(RME_X64_COP_AREA(Cop_Reg));
+    else
+        __RME_X64_XSAVE(RME_X64_COP_AREA(Cop_Reg));
+#else
+    __RME_X64_FXSAVE(RME_X64_COP_AREA(Cop_Reg));
+#endif
+
+    /* Trap the next thread's first use of the FPU */
+    __RME_X64_CR0_Set(CR0|RME_X64_CR0_TS);
 }
 /* End Function:__RME_Thd_Cop_Save *******************************************/
 
 /* Begin Function:__RME_Thd_Cop_Restore ***************************************
 Description : Restore the co-op register sets. This operation is flexible - If the
-              FPU is not used, we do not restore its context.
+              FPU is not used, we do not restore its context. The restoration
+              is deferred to the first FPU instruction the thread executes,
+              which traps to __RME_X64_FPU_Handler because CR0.TS is set.
 Input       : struct RME_Reg_Struct* Reg - The context, used to decide whether
                                            to save the context of the coprocessor.
 Output      : struct RME_Cop_Struct* Cop_Reg - The pointer to the coprocessor contents.
@@ -1746,10 +2698,72 @@ Return      : None.
 ******************************************************************************/
 void __RME_Thd_Cop_Restore(struct RME_Reg_Struct* Reg, struct RME_Cop_Struct* Cop_Reg)
 {
-    /* Not used for now */
+    /* Nothing to do here - see above */
 }
 /* End Function:__RME_Thd_Cop_Restore ****************************************/
 
+/* Begin Function:__RME_X64_FPU_Handler ***************************************
+Description : Load the current thread's coprocessor context on its first use of
+              the FPU after being switched in. The context may be in a hypervisor
+              register area that the user can write, so the fields that would
+              fault on restore are sanitized first.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_FPU_Handler(void)
+{
+    rme_ptr_t Area;
+
+    Area=RME_X64_COP_AREA(&(RME_CPU_LOCAL()->Cur_Thd->Cur_Reg->Cop_Reg));
+    *(rme_u32_t*)(Area+RME_X64_COP_MXCSR)&=RME_X64_MXCSR_Mask;
+
+    __RME_X64_CLTS();
+#if(RME_X64_FPU_TYPE!=RME_FALSE)
+    *(rme_ptr_t*)(Area+RME_X64_COP_XSTATE_BV)&=RME_X64_XCR0;
+    *(rme_ptr_t*)(Area+RME_X64_COP_XCOMP_BV)=0;
+    *(rme_ptr_t*)(Area+RME_X64_COP_XHDR_RSVD)=0;
+    __RME_X64_XRSTOR(Area);
+#else
+    __RME_X64_FXRSTOR(Area);
+#endif
+}
+/* End Function:__RME_X64_FPU_Handler ****************************************/
+
+/* Begin Function:__RME_Inv_Reg_Init ******************************************
+Description : Initialize the register set for the invocation. The caller passes
+              its arguments in RDX, R8, R9, R10, R12 and R13, after the system
+              call number and the invocation capability. They are placed in the
+              order of the Linux system call convention, because SYSRET uses RCX;
+              the user-level stub needs to move R10 to RCX if it is a C function.
+              The return words are left where the callee puts them in RSI, RDX,
+              R8, R9, R10 and R12, and the first one is then moved to RDI.
+Input       : rme_ptr_t Entry - The invocation entry address.
+              rme_ptr_t Stack - The invocation stack address.
+Output      : struct RME_Reg_Struct* Reg - The register set, which holds the
+              caller's arguments on entry.
+Return      : None.
+******************************************************************************/
+void __RME_Inv_Reg_Init(rme_ptr_t Entry, rme_ptr_t Stack, struct RME_Reg_Struct* Reg)
+{
+    rme_ptr_t Arg[RME_INV_ARG_NUM];
+
+    Arg[0]=Reg->RDX;
+    Arg[1]=Reg->R8;
+    Arg[2]=Reg->R9;
+    Arg[3]=Reg->R10;
+    Arg[4]=Reg->R12;
+    Arg[5]=Reg->R13;
+
+    __RME_Thd_Reg_Init(Entry, Stack, Arg[0], Reg);
+    Reg->RSI=Arg[1];
+    Reg->RDX=Arg[2];
+    Reg->R10=Arg[3];
+    Reg->R8=Arg[4];
+    Reg->R9=Arg[5];
+}
+/* End Function:__RME_Inv_Reg_Init *******************************************/
+
 /* Begin Function:__RME_Inv_Reg_Save ******************************************
 Description : Save the necessary registers on invocation for returning. Only the
               registers that will influence program control flow will be saved.
@@ -1819,9 +2833,38 @@ Return      : rme_ret_t - The value that the function returned.
 rme_ret_t __RME_Kern_Func_Handler(struct RME_Cap_Captbl* Captbl, struct RME_Reg_Struct* Reg,
                                   rme_ptr_t Func_ID, rme_ptr_t Sub_ID, rme_ptr_t Param1, rme_ptr_t Param2)
 {
-    /* Now always call the HALT */
     char String[16];
 
+    switch(Func_ID)
+    {
+        /* Report the NUMA topology, so that the user can place its kernel objects */
+        case RME_KERN_HPNP_NUMA_INFO:
+        {
+            if(Sub_ID==RME_KERN_NUMA_NODE_NUM)
+            {
+                __RME_Set_Syscall_Retval(Reg, RME_X64_Num_Node);
+                return 0;
+            }
+            if(Sub_ID==RME_KERN_NUMA_CPU_NODE)
+            {
+                if(Param1>=RME_X64_Num_CPU)
+                    return RME_ERR_KERN_OPFAIL;
+                __RME_Set_Syscall_Retval(Reg, RME_X64_CPU_Info[Param1].Node);
+                return 0;
+            }
+            if(Sub_ID==RME_KERN_NUMA_NODE_DIST)
+            {
+                if((Param1>=RME_X64_Num_Node)||(Param2>=RME_X64_Num_Node))
+                    return RME_ERR_KERN_OPFAIL;
+                __RME_Set_Syscall_Retval(Reg, RME_X64_Node_Dist[Param1][Param2]);
+                return 0;
+            }
+            return RME_ERR_KERN_OPFAIL;
+        }
+        default:break;
+    }
+
+    /* Now always call the HALT */
     String[0]=Param1/10000000+'0';
     String[1]=(Param1/1000000)%10+'0';
     String[2]=(Param1/100000)%10+'0';
@@ -1848,6 +2891,13 @@ Return      : None.
 ******************************************************************************/
 void __RME_X64_Fault_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Reason)
 {
+    /* The first FPU use of a user thread after a context switch - load its context */
+    if((Reason==RME_X64_FAULT_NM)&&((Reg->CS&0x03)==0x03))
+    {
+        __RME_X64_FPU_Handler();
+        return;
+    }
+
     /* Not handling faults */
     RME_PRINTK_S("\n\r\n\r*** Fault: ");RME_PRINTK_I(Reason);RME_PRINTK_S(" - ");
     /* When handling debug exceptions, note CVE 2018-8897, we may get something at
@@ -1915,6 +2965,21 @@ Return      : None.
 ******************************************************************************/
 void __RME_X64_Generic_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Int_Num)
 {
+    /* TLB shootdown requests from other processors */
+    if(Int_Num==RME_X64_INT_IPI)
+    {
+        __RME_X64_Shoot_Handler();
+        return;
+    }
+    
+    /* Signal wakeup requests from other processors */
+    if(Int_Num==RME_X64_INT_WAKE)
+    {
+        _RME_Kern_Wake(RME_CPU_LOCAL());
+        _RME_Kern_High(Reg, RME_CPU_LOCAL());
+        return;
+    }
+
     /* Not handling interrupts */
     RME_PRINTK_S("\r\nGeneral int:");
     RME_PRINTK_I(Int_Num);
@@ -1929,18 +2994,122 @@ void __RME_X64_Generic_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Int_Num)
 }
 /* End Function:__RME_X64_Generic_Handler ************************************/
 
+/* Begin Function:__RME_Wake_IPI **********************************************
+Description : Ask another processor to drain its signal wakeup mailbox.
+Input       : rme_ptr_t CPUID - The CPUID of the processor.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Wake_IPI(rme_ptr_t CPUID)
+{
+    __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[CPUID].LAPIC_ID, RME_X64_LAPIC_ICRLO_FIXED|RME_X64_INT_WAKE);
+}
+/* End Function:__RME_Wake_IPI ***********************************************/
+
 /* Begin Function:__RME_Pgtbl_Set *********************************************
-Description : Set the processor's page table.
+Description : Set the processor's page table. Tables with their own PCID keep
+              their TLB entries across switches, unless some mappings have been
+              removed since this processor last caught up with the TLB epoch,
+              or the PCID has been marked stale on this processor.
 Input       : rme_ptr_t Pgtbl - The virtual address of the page table.
 Output      : None.
 Return      : None.
 ******************************************************************************/
 void __RME_Pgtbl_Set(rme_ptr_t Pgtbl)
 {
-    __RME_X64_Pgtbl_Set(RME_X64_VA2PA(Pgtbl)|RME_X64_PGREG_POS(Pgtbl).PCID);
+    rme_ptr_t PCID;
+    rme_ptr_t CPUID;
+    rme_ptr_t Bit;
+    volatile struct RME_X64_CPU_Info* Info;
+
+    PCID=RME_X64_PGREG_POS(Pgtbl).PCID;
+    CPUID=RME_CPU_LOCAL()->CPUID;
+    Info=&RME_X64_CPU_Info[CPUID];
+
+    /* Publish the PCID before looking at the epoch and the stale marks. This pairs
+     * with __RME_X64_Shoot_Add, which does the opposite */
+    if(PCID!=RME_X64_PCID_SHARED)
+        __RME_X64_Bitmap_Set(RME_X64_PCID_CPU[PCID], CPUID);
+    Info->Cur_PCID=PCID;
+    __RME_X64_Write_Release();
+
+    if(PCID==RME_X64_PCID_SHARED)
+    {
+        __RME_X64_Pgtbl_Set(RME_X64_VA2PA(Pgtbl));
+        return;
+    }
+
+    /* Take the snapshot before flushing, so that we see any removal after it */
+    if(Info->TLB_Epoch!=RME_X64_TLB_Epoch)
+    {
+        Info->TLB_Epoch=RME_X64_TLB_Epoch;
+        __RME_X64_TLB_Flush();
+    }
+
+    /* Loading CR3 without the no-flush bit flushes this PCID only */
+    Bit=RME_POW2(PCID&RME_MASK_END(RME_WORD_ORDER-1));
+    if((Info->PCID_Stale[PCID>>RME_WORD_ORDER]&Bit)!=0)
+    {
+        RME_FETCH_AND((rme_ptr_t*)&Info->PCID_Stale[PCID>>RME_WORD_ORDER],~Bit);
+        __RME_X64_Pgtbl_Set(RME_X64_VA2PA(Pgtbl)|PCID);
+        return;
+    }
+
+    __RME_X64_Pgtbl_Set(RME_X64_VA2PA(Pgtbl)|PCID|RME_X64_CR3_NOFLUSH);
 }
 /* End Function:__RME_Pgtbl_Set **********************************************/
 
+/* Begin Function:__RME_Pgtbl_Sync ********************************************
+Description : Send out the TLB shootdown requests that this processor made in
+              this system call, and wait for them to complete. This is called
+              by the kernel before it returns from a system call that may have
+              removed mappings.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_Pgtbl_Sync(void)
+{
+    rme_ptr_t Count;
+    rme_ptr_t Bit;
+    rme_ptr_t Wait;
+    rme_ptr_t CPUID;
+    volatile struct RME_X64_CPU_Info* Local;
+
+    CPUID=RME_CPU_LOCAL()->CPUID;
+    Local=&RME_X64_CPU_Info[CPUID];
+    if((Local->Shoot_Num==0)&&(Local->Shoot_Full==0))
+        return;
+
+    /* Count the receivers before any of them can acknowledge */
+    Wait=0;
+    for(Count=0;Count<RME_X64_Num_CPU;Count++)
+    {
+        if((Local->Shoot_To[Count>>RME_WORD_ORDER]&RME_POW2(Count&RME_MASK_END(RME_WORD_ORDER-1)))!=0)
+            Wait++;
+    }
+    Local->Shoot_Wait=Wait;
+
+    for(Count=0;Count<RME_X64_Num_CPU;Count++)
+    {
+        Bit=RME_POW2(Count&RME_MASK_END(RME_WORD_ORDER-1));
+        if((Local->Shoot_To[Count>>RME_WORD_ORDER]&Bit)==0)
+            continue;
+        Local->Shoot_To[Count>>RME_WORD_ORDER]&=~Bit;
+
+        __RME_X64_Bitmap_Set(RME_X64_CPU_Info[Count].Shoot_From, CPUID);
+        __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[Count].LAPIC_ID, RME_X64_LAPIC_ICRLO_FIXED|RME_X64_INT_IPI);
+    }
+
+    /* Others may be waiting for us at the same time */
+    while(Local->Shoot_Wait!=0)
+        __RME_X64_Shoot_Handler();
+
+    Local->Shoot_Num=0;
+    Local->Shoot_Full=0;
+}
+/* End Function:__RME_Pgtbl_Sync *********************************************/
+
 /* Begin Function:__RME_Pgtbl_Check *******************************************
 Description : Check if the page table parameters are feasible, according to the
               parameters. This is only used in page table creation.
@@ -1984,29 +3153,21 @@ Return      : rme_ptr_t - If successful, 0; else RME_ERR_PGT_OPFAIL.
 ******************************************************************************/
 rme_ptr_t __RME_Pgtbl_Init(struct RME_Cap_Pgtbl* Pgtbl_Op)
 {
-    rme_cnt_t Count;
     rme_ptr_t* Ptr;
     
     /* Get the actual table */
     Ptr=RME_CAP_GETOBJ(Pgtbl_Op,rme_ptr_t*);
 
-    /* Hopefully the compiler optimize this to rep stos */
-    for(Count=0;Count<256;Count++)
-        Ptr[Count]=0;
-
-    /* Hopefully the compiler optimize this to rep movs */
+    /* The top-level tables have the kernel mappings in their upper half */
     if((Pgtbl_Op->Base_Addr&RME_PGTBL_TOP)!=0)
     {
-        for(;Count<512;Count++)
-            Ptr[Count]=RME_X64_Kpgt.PML4[Count-256];
+        RME_CLEAR(Ptr, 256*sizeof(rme_ptr_t));
+        RME_MEMCPY(&Ptr[256], (void*)(RME_X64_Kpgt.PML4), 256*sizeof(rme_ptr_t));
 
-        RME_X64_PGREG_POS(Ptr).PCID=RME_FETCH_ADD((rme_ptr_t*)&RME_X64_PCID_Inc,1)&0xFFF;
+        RME_X64_PGREG_POS(Ptr).PCID=__RME_X64_PCID_Alloc();
     }
     else
-    {
-        for(;Count<512;Count++)
-            Ptr[Count]=0;
-    }
+        RME_CLEAR(Ptr, 512*sizeof(rme_ptr_t));
 
     /* Initialize its pgreg table to all zeros */
     RME_X64_PGREG_POS(Ptr).Parent_Cnt=0;
@@ -2031,7 +3192,15 @@ rme_ptr_t __RME_Pgtbl_Del_Check(struct RME_Cap_Pgtbl* Pgtbl_Op)
     /* Check if it is mapped into other page tables. If yes, then it cannot be deleted.
      * also, it must not contain mappings of lower levels, or it is not deletable. */
     if((RME_X64_PGREG_POS(Table).Parent_Cnt==0)&&(RME_X64_PGREG_POS(Table).Child_Cnt==0))
+    {
+        /* The deletion always goes through after this, so give back the PCID */
+        if((Pgtbl_Op->Base_Addr&RME_PGTBL_TOP)!=0)
+        {
+            __RME_X64_PCID_Free(RME_X64_PGREG_POS(Table).PCID);
+            RME_X64_PGREG_POS(Table).PCID=RME_X64_PCID_SHARED;
+        }
         return 0;
+    }
 
     return RME_ERR_PGT_OPFAIL;
 }
@@ -2089,6 +3258,7 @@ rme_ptr_t __RME_Pgtbl_Page_Unmap(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos)
 {
     rme_ptr_t* Table;
     rme_ptr_t Temp;
+    rme_ptr_t PCID;
 
     /* Are we trying to unmap the kernel space on the top level? */
     if(((Pgtbl_Op->Base_Addr&RME_PGTBL_TOP)!=0)&&(Pos>=256))
@@ -2110,6 +3280,14 @@ rme_ptr_t __RME_Pgtbl_Page_Unmap(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos)
     if(RME_COMP_SWAP(&(Table[Pos]),Temp,0)==0)
         return RME_ERR_PGT_OPFAIL;
 
+    /* Only a top-level table knows its PCID; the others may be shared */
+    if((Pgtbl_Op->Base_Addr&RME_PGTBL_TOP)!=0)
+        PCID=RME_X64_PGREG_POS(Table).PCID;
+    else
+        PCID=RME_X64_SHOOT_PCID_ANY;
+    __RME_X64_Shoot_Add(PCID, RME_PGTBL_START(Pgtbl_Op->Base_Addr)+
+                              (Pos<<RME_PGTBL_SIZEORD(Pgtbl_Op->Size_Num_Order)));
+
     return 0;
 }
 /* End Function:__RME_Pgtbl_Page_Unmap ***************************************/
@@ -2169,6 +3347,7 @@ rme_ptr_t __RME_Pgtbl_Pgdir_Unmap(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos)
     rme_ptr_t* Parent_Table;
     rme_ptr_t* Child_Table;
     rme_ptr_t Temp;
+    rme_ptr_t PCID;
 
     /* Are we trying to unmap the kernel space on the top level? */
     if(((Pgtbl_Op->Base_Addr&RME_PGTBL_TOP)!=0)&&(Pos>=256))
@@ -2195,6 +3374,13 @@ rme_ptr_t __RME_Pgtbl_Pgdir_Unmap(struct RME_Cap_Pgtbl* Pgtbl_Op, rme_ptr_t Pos)
     RME_FETCH_ADD((rme_ptr_t*)&(RME_X64_PGREG_POS(Child_Table).Parent_Cnt),-1);
     RME_FETCH_ADD((rme_ptr_t*)&(RME_X64_PGREG_POS(Parent_Table).Child_Cnt),-1);
 
+    /* All the translations through it are gone, which could be a lot of pages */
+    if((Pgtbl_Op->Base_Addr&RME_PGTBL_TOP)!=0)
+        PCID=RME_X64_PGREG_POS(Parent_Table).PCID;
+    else
+        PCID=RME_X64_SHOOT_PCID_ANY;
+    __RME_X64_Shoot_Add(PCID, RME_X64_SHOOT_ADDR_ALL);
+
     return 0;
 }
 /* End Function:__RME_Pgtbl_Pgdir_Unmap **************************************/
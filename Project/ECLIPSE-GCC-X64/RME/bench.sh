@@ -0,0 +1,37 @@
+# Build the benchmark into Bench/UVM_Bench.o, and then build the kernel with it
+# in place of the normal init process in UVM.c; see makefile.defs. Then run
+# qemu-bench.sh and bench.gdb. Delete Debug/RME and build again without
+# RME_X64_BENCH=1 to get the normal init process back.
+BENCH=../../../MEukaron/Benchmark
+CFLAGS="-m64 -O2 -ffreestanding -fno-pic -fno-stack-protector -fno-asynchronous-unwind-tables -mno-sse -mno-mmx -I. -I$BENCH -I../../../MEukaron/Include"
+mkdir -p Bench
+gcc $CFLAGS -c $BENCH/rme_benchmark_x64_asm.S -o Bench/rme_benchmark_x64_asm.o
+gcc $CFLAGS -c $BENCH/rme_benchmark.c -o Bench/rme_benchmark.o
+gcc $CFLAGS -c $BENCH/rme_benchmark_x64.c -o Bench/rme_benchmark_x64.o
+# The entry must come first; the kernel copies the first 2MB of the image to address 0
+ld -static -nostdlib -z noexecstack -Ttext=0 -e RME_Entry -o Bench/bench.elf \
+Bench/rme_benchmark_x64_asm.o Bench/rme_benchmark.o Bench/rme_benchmark_x64.o
+# The kernel does not clear the .bss, so it goes into the image as zeros
+objcopy -O binary -j .text -j .rodata -j .data -j .bss --set-section-flags .bss=alloc,load,contents \
+Bench/bench.elf Bench/bench.bin
+{
+echo "/******************************************************************************"
+echo "Filename    : UVM_Bench.c"
+echo "Author      : bench.sh."
+echo "Description : The *.c code containing the array of the binary image."
+echo "              File generated by bench.sh from the RME benchmark."
+echo "******************************************************************************/"
+echo ""
+echo "/* Begin Contents ************************************************************/"
+echo "const unsigned char UVM_Init[$(stat -c %s Bench/bench.bin)]="
+echo "{"
+xxd -p -u -c1 Bench/bench.bin | sed 's/^/    0x/;s/$/,/'
+echo "};"
+echo "/* End Contents **************************************************************/"
+echo ""
+echo "/* End Of File ***************************************************************/"
+} > Bench/UVM_Bench.c
+# This only holds the array, so the kernel code model is all it needs
+gcc -m64 -mcmodel=kernel -fno-pic -ffreestanding -c Bench/UVM_Bench.c -o Bench/UVM_Bench.o
+rm -f Debug/RME
+make -C Debug all RME_X64_BENCH=1
@@ -0,0 +1,3 @@
+# Run the benchmark image headless, with the gdbstub on tcp::1234; then run "gdb -x bench.gdb".
+# One processor only, so that nothing else runs. Pass -enable-kvm for the real TSC.
+qemu-system-x86_64 -serial stdio -display none -net none -smp 1 -m 512 -cdrom Debug/os.iso -s "$@"
@@ -0,0 +1,15 @@
+/******************************************************************************
+Filename    : rme_platform.h
+Author      : pry 
+Date        : 16/10/2026
+Licence     : LGPL v3+; see COPYING for details.
+Description : The platform specific types for RME.
+******************************************************************************/
+
+/* Platform Includes *********************************************************/
+#include "Platform/LINUX/rme_platform_linux.h"
+/* End Platform Includes *****************************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
@@ -0,0 +1,209 @@
+/******************************************************************************
+Filename    : rme_bench.c
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The kernel microbenchmarks for the Linux-hosted RME. This replaces
+              the init process, and calls into the kernel directly from CPU 0's
+              init thread, which is possible only because everything shares the
+              host process. The tick is masked during the measurements, so it
+              is as if we were in the kernel. Build it with "make bench", which
+              also runs it for a few RME_MAX_PREEMPT_PRIO settings.
+******************************************************************************/
+
+/* Includes ******************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define __HDR_DEFS__
+#include "Platform/rme_platform.h"
+#include "Kernel/rme_kernel.h"
+#undef __HDR_DEFS__
+
+#define __HDR_STRUCTS__
+#include "Platform/rme_platform.h"
+#include "Kernel/rme_kernel.h"
+#undef __HDR_STRUCTS__
+
+#define __HDR_PUBLIC_MEMBERS__
+#include "Platform/rme_platform.h"
+#include "Kernel/rme_kernel.h"
+#undef __HDR_PUBLIC_MEMBERS__
+/* End Includes **************************************************************/
+
+/* Defines *******************************************************************/
+/* The number of rounds for each measurement */
+#define RME_BENCH_ROUNDS                    10000000
+/* The signal endpoint that the system call dispatch benchmark sends to */
+#define RME_BENCH_SIG                       8
+#define RME_BENCH_SIG_SIZE                  0x100
+/* A system call number that is not used, so it costs nothing but the dispatch */
+#define RME_BENCH_SVC_NULL                  (RME_SVC_TBL_NUM-1)
+/* End Defines ***************************************************************/
+
+/* Private C Function Prototypes *********************************************/
+static rme_ptr_t RME_Bench_Time(void);
+static void RME_Bench_Kern_High(void);
+static void RME_Bench_Svc_One(const char* Name, rme_ptr_t Svc_Capid,
+                              rme_ptr_t Param1, rme_ptr_t Param2, rme_ptr_t Param3);
+static void RME_Bench_Svc(void);
+/* End Private C Function Prototypes *****************************************/
+
+/* Public C Function Prototypes **********************************************/
+void RME_Bench(rme_ptr_t CPUID);
+/* End Public C Function Prototypes ******************************************/
+
+/* Begin Function:RME_Bench_Time **********************************************
+Description : Get the host monotonic time.
+Input       : None.
+Output      : None.
+Return      : rme_ptr_t - The time in nanoseconds.
+******************************************************************************/
+rme_ptr_t RME_Bench_Time(void)
+{
+    struct timespec Time;
+
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+
+    return ((rme_ptr_t)Time.tv_sec)*1000000000ULL+(rme_ptr_t)Time.tv_nsec;
+}
+/* End Function:RME_Bench_Time ***********************************************/
+
+/* Begin Function:RME_Bench_Kern_High *****************************************
+Description : Measure _RME_Kern_High. The init thread is the only thread in the
+              run queue, and it is at priority 0, so the highest priority is at
+              the far end of the bitmap. This is the worst case for the lookup.
+              Because it is also the current thread, no switch will happen.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Kern_High(void)
+{
+    struct RME_Reg_Struct Reg;
+    rme_ptr_t Start;
+    rme_ptr_t End;
+    rme_cnt_t Count;
+
+    __RME_Disable_Int();
+    /* Warm up the caches */
+    for(Count=0;Count<RME_BENCH_ROUNDS/10;Count++)
+        _RME_Kern_High(&Reg, RME_CPU_LOCAL());
+
+    Start=RME_Bench_Time();
+    for(Count=0;Count<RME_BENCH_ROUNDS;Count++)
+        _RME_Kern_High(&Reg, RME_CPU_LOCAL());
+    End=RME_Bench_Time();
+    __RME_Enable_Int();
+
+    printf("\r\n_RME_Kern_High, %d priorities: %.2f ns\r\n",
+           RME_MAX_PREEMPT_PRIO, ((double)(End-Start))/RME_BENCH_ROUNDS);
+}
+/* End Function:RME_Bench_Kern_High ******************************************/
+
+/* Begin Function:RME_Bench_Svc_One *******************************************
+Description : Measure _RME_Svc_Handler with one system call, as if the trap frame
+              held it. This is the cost of the kernel side of the system call,
+              without the host context switch that the __RME_LINUX_Svc gate adds.
+Input       : const char* Name - The name of the system call.
+              rme_ptr_t Svc_Capid - The system call number and capability ID.
+              rme_ptr_t Param1 - Argument 1.
+              rme_ptr_t Param2 - Argument 2.
+              rme_ptr_t Param3 - Argument 3.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Svc_One(const char* Name, rme_ptr_t Svc_Capid,
+                       rme_ptr_t Param1, rme_ptr_t Param2, rme_ptr_t Param3)
+{
+    struct RME_Reg_Struct Reg;
+    rme_ptr_t Start;
+    rme_ptr_t End;
+    rme_cnt_t Count;
+
+    __RME_Disable_Int();
+    for(Count=0;Count<RME_BENCH_ROUNDS/10;Count++)
+    {
+        Reg.Arg0=Svc_Capid;
+        Reg.Arg1=Param1;
+        Reg.Arg2=Param2;
+        Reg.Arg3=Param3;
+        _RME_Svc_Handler(&Reg);
+    }
+
+    Start=RME_Bench_Time();
+    for(Count=0;Count<RME_BENCH_ROUNDS;Count++)
+    {
+        Reg.Arg0=Svc_Capid;
+        Reg.Arg1=Param1;
+        Reg.Arg2=Param2;
+        Reg.Arg3=Param3;
+        _RME_Svc_Handler(&Reg);
+    }
+    End=RME_Bench_Time();
+    __RME_Enable_Int();
+
+    printf("\r\n_RME_Svc_Handler, %s: %.2f ns\r\n",
+           Name, ((double)(End-Start))/RME_BENCH_ROUNDS);
+}
+/* End Function:RME_Bench_Svc_One ********************************************/
+
+/* Begin Function:RME_Bench_Svc ***********************************************
+Description : Measure the system call dispatch. An unused system call number goes
+              through the dispatch only; a send to a signal endpoint that nobody
+              waits on also looks up a capability and updates the endpoint. The
+              thread switch picks the highest priority thread, which is the init
+              thread itself, and the capability delegation is refused because the
+              destination slot is in use, so all of them can be repeated.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench_Svc(void)
+{
+    rme_ret_t Raddr;
+
+    Raddr=__RME_LINUX_Svc((((rme_ptr_t)RME_SVC_KMEM_FIND)<<(sizeof(rme_ptr_t)*4))|RME_BOOT_INIT_KMEM,
+                          RME_BENCH_SIG_SIZE, 0, 0, 0);
+    RME_ASSERT(Raddr>=0);
+    RME_ASSERT(__RME_LINUX_Svc((((rme_ptr_t)RME_SVC_SIG_CRT)<<(sizeof(rme_ptr_t)*4))|RME_BOOT_CAPTBL,
+                               RME_BOOT_INIT_KMEM, RME_BENCH_SIG, (rme_ptr_t)Raddr, 0)==0);
+
+    RME_Bench_Svc_One("unused", ((rme_ptr_t)RME_BENCH_SVC_NULL)<<(sizeof(rme_ptr_t)*4), 0, 0, 0);
+    RME_Bench_Svc_One("RME_SVC_SIG_SND", ((rme_ptr_t)RME_SVC_SIG_SND)<<(sizeof(rme_ptr_t)*4),
+                      RME_BENCH_SIG, 0, 0);
+    RME_Bench_Svc_One("RME_SVC_THD_SWT", ((rme_ptr_t)RME_SVC_THD_SWT)<<(sizeof(rme_ptr_t)*4),
+                      RME_CAPID_NULL, 0, 0);
+    RME_Bench_Svc_One("RME_SVC_CAPTBL_ADD", ((rme_ptr_t)RME_SVC_CAPTBL_ADD)<<(sizeof(rme_ptr_t)*4),
+                      (((rme_ptr_t)RME_BOOT_CAPTBL)<<(sizeof(rme_ptr_t)*4))|RME_BENCH_SIG,
+                      (((rme_ptr_t)RME_BOOT_CAPTBL)<<(sizeof(rme_ptr_t)*4))|RME_BENCH_SIG,
+                      RME_SIG_FLAG_SND);
+}
+/* End Function:RME_Bench_Svc ************************************************/
+
+/* Begin Function:RME_Bench ***************************************************
+Description : The init thread of each CPU. CPU 0 runs the benchmarks and then
+              exits the host process; the other CPUs just sleep on their ticks.
+Input       : rme_ptr_t CPUID - The CPUID.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Bench(rme_ptr_t CPUID)
+{
+    if(CPUID==0)
+    {
+        RME_Bench_Kern_High();
+        RME_Bench_Svc();
+        exit(EXIT_SUCCESS);
+    }
+
+    while(1)
+        __RME_LINUX_Svc((((rme_ptr_t)RME_SVC_KERN)<<(sizeof(rme_ptr_t)*4))|RME_BOOT_INIT_KERN,
+                        RME_KERN_IDLE_SLEEP, 0, 0, 0);
+}
+/* End Function:RME_Bench ****************************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
@@ -0,0 +1,15 @@
+/******************************************************************************
+Filename    : rme_benchmark_platform.h
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The platform specific header of the RME benchmark.
+******************************************************************************/
+
+/* Platform Includes *********************************************************/
+#include "rme_benchmark_linux.h"
+/* End Platform Includes *****************************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/
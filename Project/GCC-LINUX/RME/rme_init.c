@@ -0,0 +1,471 @@
+/******************************************************************************
+Filename    : rme_init.c
+Author      : pry
+Date        : 16/10/2026
+Licence     : The Unlicense; see LICENSE for details.
+Description : The init process for the Linux-hosted RME. It is linked into the
+              same host process as the kernel, and talks to it through the
+              __RME_LINUX_Svc gate only. CPU 0 runs a small smoke test and then
+              exits the host process; the other CPUs just sleep on their ticks.
+******************************************************************************/
+
+/* Includes ******************************************************************/
+#include <stdlib.h>
+/* End Includes **************************************************************/
+
+/* Defines *******************************************************************/
+/* Types */
+typedef signed long long s64;
+typedef unsigned long long u64;
+typedef u64 ptr_t;
+typedef s64 cnt_t;
+typedef s64 cid_t;
+typedef s64 ret_t;
+
+/* System service stub */
+#define RME_CAP_OP(OP,CAPID,ARG1,ARG2,ARG3) __RME_LINUX_Svc((((ptr_t)(OP))<<(sizeof(ptr_t)*4))|(CAPID),ARG1,ARG2,ARG3,0)
+#define RME_PARAM_D_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*4))
+/* The parameter passing - not to be confused with kernel macros. These macros just place the parameters */
+#define RME_PARAM_D1(X)                     (((X)&RME_PARAM_D_MASK)<<(sizeof(ptr_t)*4))
+#define RME_PARAM_D0(X)                     ((X)&RME_PARAM_D_MASK)
+/* Two-level capability ID */
+#define RME_CAPID_2L                        (((ptr_t)1)<<(sizeof(ptr_t)*2-1))
+#define RME_CAPID(X,Y)                      (((X)<<(sizeof(ptr_t)*2))|(Y)|RME_CAPID_2L)
+
+/* System calls used */
+#define RME_SVC_INV_ACT                     1
+#define RME_SVC_SIG_SND                     2
+#define RME_SVC_SIG_RCV                     3
+#define RME_SVC_KERN                        4
+#define RME_SVC_THD_TIME_XFER               7
+#define RME_SVC_THD_SWT                     8
+#define RME_SVC_CAPTBL_CRT                  9
+#define RME_SVC_CAPTBL_DEL                  10
+#define RME_SVC_CAPTBL_ADD                  12
+#define RME_SVC_CAPTBL_REM                  13
+#define RME_SVC_THD_CRT                     24
+#define RME_SVC_THD_EXEC_SET                26
+#define RME_SVC_THD_SCHED_BIND              28
+#define RME_SVC_SIG_CRT                     30
+#define RME_SVC_SIG_DEL                     31
+#define RME_SVC_INV_CRT                     32
+#define RME_SVC_INV_SET                     34
+#define RME_SVC_BATCH                       35
+#define RME_SVC_KMEM_FIND                   36
+#define RME_SVC_SIG_RING_CRT                37
+#define RME_SVC_THD_SCHED_EDF               38
+#define RME_SVC_THD_SCHED_MIGR              39
+#define RME_SVC_THD_CYCLE_GET               40
+/* Kernel functions used */
+#define RME_KERN_PERF_CAP_CACHE             0xF507
+#define RME_KERN_IDLE_SLEEP                 0xF400
+#define RME_KERN_DEBUG_PRINT                0xF800
+
+/* Initial boot capabilities - This should be in accordance with the kernel settings */
+/* The capability table of the init process */
+#define RME_BOOT_CAPTBL                     0
+/* The init process */
+#define RME_BOOT_INIT_PROC                  2
+/* The capability table of the init threads, one for each CPU */
+#define RME_BOOT_TBL_THD                    3
+/* The kernel function capability */
+#define RME_BOOT_INIT_KERN                  4
+/* The kernel memory capability */
+#define RME_BOOT_INIT_KMEM                  5
+
+/* The test signal endpoint, and the size of the free range we look for to place it.
+ * The range is found by the kernel, after the boot objects placed at the start */
+#define RME_INIT_SIG                        8
+#define RME_INIT_SIG_SIZE                   0x100
+/* The test signal endpoint with a payload ring of 2 slots, placed in the next range */
+#define RME_INIT_SIG_RING                   9
+#define RME_INIT_SIG_RING_ORDER             1
+/* The slot that the batch test delegates the test signal endpoint to */
+#define RME_INIT_SIG_BATCH                  10
+/* The capability tables that the capability cache test creates, in the same memory
+ * one after another, and the size of the free ranges we look for to place them */
+#define RME_INIT_CAPTBL                     11
+#define RME_INIT_CAPTBL_REUSE               12
+#define RME_INIT_CAPTBL_SIZE                0x100
+#define RME_INIT_CAPTBL_NUM                 2
+/* The endpoints that the deletion test creates and deletes twice, in the same memory */
+#define RME_INIT_SIG_DEL                    13
+#define RME_INIT_SIG_RING_DEL               14
+/* The thread that the EDF preemption test creates, the endpoint that it receives from,
+ * the size of the free range we look for to place it, and the size of its stack. The
+ * endpoint takes the slot that the deletion test left empty */
+#define RME_INIT_THD                        15
+#define RME_INIT_SIG_THD                    RME_INIT_SIG_DEL
+#define RME_INIT_THD_SIZE                   0x1000
+#define RME_INIT_THD_STACK_SIZE             0x4000
+/* The invocation that the cycle accounting test creates, and the size of the free
+ * range we look for to place it. It takes the slot that the deletion test left empty */
+#define RME_INIT_INV                        RME_INIT_SIG_RING_DEL
+#define RME_INIT_INV_SIZE                   0x100
+/* The cycle reading option for the cycles used in the invocations */
+#define RME_THD_CYCLE_INV                   1
+/* The priority of the init threads, which the test thread shares */
+#define RME_INIT_PRIO                       0
+/* The time transfer amount that gives a thread an infinite budget, and the amount
+ * that revokes all the time of the source thread */
+#define RME_THD_INF_TIME                    ((((ptr_t)(-1))>>1)-1)
+#define RME_THD_INIT_TIME                   (((ptr_t)(-1))>>1)
+/* The blocking single receive option */
+#define RME_RCV_BS                          0
+/* The value that a receive returns when a send wakes the receiver up */
+#define RME_INIT_RCV_WAKE                   1
+/* The capability ID that means none */
+#define RME_CAPID_NULL                      (((ptr_t)1)<<(sizeof(ptr_t)*4-1))
+/* All capability table capability flags */
+#define RME_CAPTBL_FLAG_ALL                 0xFF
+/* The number of ticks to wait for a newly created capability to become quiescent */
+#define RME_INIT_QUIE_TICKS                 20
+/* The signal endpoint capability flag that allows sending */
+#define RME_SIG_FLAG_SND                    1
+/* The error code returned when the operation is not allowed in a batch */
+#define RME_ERR_CAP_NULL                    (-1)
+/* The error code returned when the batch array is not usable */
+#define RME_ERR_PGT_ADDR                    (-11)
+/* The error code returned when the payload ring is full */
+#define RME_ERR_SIV_FULL                    (-33)
+/* The error code returned when the capability does not allow the operation */
+#define RME_ERR_CAP_FLAG                    (-7)
+/* The error code returned when the thread is not on this CPU */
+#define RME_ERR_PTH_INVSTATE                (-24)
+/* The number of ticks to sleep for before exiting */
+#define RME_INIT_TICKS                      100
+/* The EDF period and budget of the init thread while it sleeps */
+#define RME_INIT_EDF_PERIOD                 10
+#define RME_INIT_EDF_BUDGET                 5
+
+/* Batched system call operation, as placed in the user buffer */
+struct RME_Svc_Batch_Op
+{
+    ptr_t Svc_Capid;
+    ptr_t Param[3];
+    ptr_t Retval;
+};
+/* End Defines ***************************************************************/
+
+/* Private Global Variables **************************************************/
+/* The stack of the EDF preemption test thread */
+static ptr_t RME_Init_Thd_Stack[RME_INIT_THD_STACK_SIZE];
+/* What the first receive of that thread returned, or 0 if it has not returned yet */
+static volatile ret_t RME_Init_Thd_Rcv;
+/* The stack of the invocation that the cycle accounting test creates */
+static ptr_t RME_Init_Inv_Stack[RME_INIT_THD_STACK_SIZE];
+/* End Private Global Variables **********************************************/
+
+/* Private C Function Prototypes *********************************************/
+static ret_t RME_Init_Thd(ptr_t Param0, ptr_t Param1);
+static ret_t RME_Init_Inv(ptr_t Param0, ptr_t Param1);
+static void RME_Init_Print_S(const char* String);
+static void RME_Init_Print_H(ptr_t Value);
+static void RME_Init_Check(const char* Name, ret_t Retval);
+static void RME_Init_Wait(cnt_t Ticks);
+/* End Private C Function Prototypes *****************************************/
+
+/* Public C Function Prototypes **********************************************/
+extern ret_t __RME_LINUX_Svc(ptr_t Svc_Capid, ptr_t Param1, ptr_t Param2,
+                             ptr_t Param3, ptr_t* Reg_Ret);
+void RME_Init(ptr_t CPUID);
+/* End Public C Function Prototypes ******************************************/
+
+/* Begin Function:RME_Init_Print_S ********************************************
+Description : Print a string with the kernel debug print function.
+Input       : const char* String - The string.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Init_Print_S(const char* String)
+{
+    while(*String!='\0')
+    {
+        RME_CAP_OP(RME_SVC_KERN, RME_BOOT_INIT_KERN,
+                   RME_PARAM_D1((ptr_t)*String)|RME_PARAM_D0(RME_KERN_DEBUG_PRINT), 0, 0);
+        String++;
+    }
+}
+/* End Function:RME_Init_Print_S *********************************************/
+
+/* Begin Function:RME_Init_Print_H ********************************************
+Description : Print a number in hexadecimal with the kernel debug print function.
+Input       : ptr_t Value - The number.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Init_Print_H(ptr_t Value)
+{
+    char Buf[19];
+    cnt_t Count;
+
+    Buf[0]='0';
+    Buf[1]='x';
+    for(Count=0;Count<16;Count++)
+        Buf[17-Count]="0123456789ABCDEF"[(Value>>(Count*4))&0x0F];
+    Buf[18]='\0';
+
+    RME_Init_Print_S(Buf);
+}
+/* End Function:RME_Init_Print_H *********************************************/
+
+/* Begin Function:RME_Init_Check **********************************************
+Description : Print the result of a system call, and exit if it failed.
+Input       : const char* Name - The name of the system call.
+              ret_t Retval - The return value.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Init_Check(const char* Name, ret_t Retval)
+{
+    RME_Init_Print_S("\r\n");
+    RME_Init_Print_S(Name);
+    RME_Init_Print_S(": ");
+    RME_Init_Print_H((ptr_t)Retval);
+
+    if(Retval<0)
+    {
+        RME_Init_Print_S(" - failed.\r\n");
+        exit(EXIT_FAILURE);
+    }
+}
+/* End Function:RME_Init_Check ***********************************************/
+
+/* Begin Function:RME_Init_Wait ***********************************************
+Description : Sleep for some ticks, so that the capabilities we just created or
+              delegated become quiescent and can be deleted or removed.
+Input       : cnt_t Ticks - The number of ticks.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Init_Wait(cnt_t Ticks)
+{
+    cnt_t Count;
+
+    for(Count=0;Count<Ticks;Count++)
+        RME_CAP_OP(RME_SVC_KERN, RME_BOOT_INIT_KERN, RME_PARAM_D0(RME_KERN_IDLE_SLEEP), 0, 0);
+}
+/* End Function:RME_Init_Wait ************************************************/
+
+/* Begin Function:RME_Init_Thd ***********************************************
+Description : The thread that the EDF preemption test creates. It receives from its
+              endpoint, records what the first receive returned, and gives all its
+              time back. When it gets some again, it moves itself to CPU 1, and
+              then blocks on its endpoint forever.
+Input       : ptr_t Param0 - Unused.
+              ptr_t Param1 - Unused.
+Output      : None.
+Return      : ret_t - This function never returns.
+******************************************************************************/
+ret_t RME_Init_Thd(ptr_t Param0, ptr_t Param1)
+{
+    RME_Init_Thd_Rcv=RME_CAP_OP(RME_SVC_SIG_RCV, 0, RME_INIT_SIG_THD, RME_RCV_BS, 0);
+    RME_CAP_OP(RME_SVC_THD_TIME_XFER, 0, RME_CAPID(RME_BOOT_TBL_THD, 0), RME_INIT_THD, RME_THD_INIT_TIME);
+    RME_CAP_OP(RME_SVC_THD_SCHED_MIGR, 0, RME_INIT_THD, RME_CAPID(RME_BOOT_TBL_THD, 1), 0);
+
+    while(1)
+        RME_CAP_OP(RME_SVC_SIG_RCV, 0, RME_INIT_SIG_THD, RME_RCV_BS, 0);
+
+    return 0;
+}
+/* End Function:RME_Init_Thd *************************************************/
+
+/* Begin Function:RME_Init_Inv ***********************************************
+Description : The invocation that the cycle accounting test creates.
+Input       : ptr_t Param0 - The first argument.
+              ptr_t Param1 - The second argument.
+Output      : None.
+Return      : ret_t - The sum of the two arguments.
+******************************************************************************/
+ret_t RME_Init_Inv(ptr_t Param0, ptr_t Param1)
+{
+    return (ret_t)(Param0+Param1);
+}
+/* End Function:RME_Init_Inv *************************************************/
+
+/* Begin Function:RME_Init ****************************************************
+Description : The init thread of each CPU.
+Input       : ptr_t CPUID - The CPUID.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Init(ptr_t CPUID)
+{
+    cnt_t Count;
+    ret_t Raddr;
+    ret_t Next;
+    ret_t Retval;
+    ptr_t Reg_Ret[4];
+    struct RME_Svc_Batch_Op Batch[3];
+
+    if(CPUID==0)
+    {
+        RME_Init_Print_S("\r\nRME init running on the Linux host.");
+
+        /* Find some free kernel memory, then create a signal endpoint there and send
+         * to it. The init threads are not allowed to receive, so we leave the signals */
+        Raddr=RME_CAP_OP(RME_SVC_KMEM_FIND, RME_BOOT_INIT_KMEM, RME_INIT_SIG_SIZE, 0, 0);
+        RME_Init_Check("Kmem_Find", Raddr);
+        RME_Init_Check("Sig_Crt", RME_CAP_OP(RME_SVC_SIG_CRT, RME_BOOT_CAPTBL,
+                                             RME_BOOT_INIT_KMEM, RME_INIT_SIG, Raddr));
+        /* The start of that range is taken now, so the next search must skip it */
+        Next=RME_CAP_OP(RME_SVC_KMEM_FIND, RME_BOOT_INIT_KMEM, RME_INIT_SIG_SIZE, Raddr, 0);
+        RME_Init_Check("Kmem_Find", (Next>Raddr)?Next:-1);
+        RME_Init_Check("Sig_Snd", RME_CAP_OP(RME_SVC_SIG_SND, 0, RME_INIT_SIG, 0, 0));
+        
+        /* Put the endpoint with a payload ring there. The ring takes two sends, and
+         * then it is full because we cannot receive to drain it */
+        RME_Init_Check("Sig_Ring_Crt", RME_CAP_OP(RME_SVC_SIG_RING_CRT, RME_BOOT_CAPTBL,
+                                                  RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_D0(RME_INIT_SIG_RING),
+                                                  Next, RME_INIT_SIG_RING_ORDER));
+        RME_Init_Check("Sig_Snd", RME_CAP_OP(RME_SVC_SIG_SND, 0, RME_INIT_SIG_RING, 0x12, 0x34));
+        RME_Init_Check("Sig_Snd", RME_CAP_OP(RME_SVC_SIG_SND, 0, RME_INIT_SIG_RING, 0x56, 0x78));
+        Retval=RME_CAP_OP(RME_SVC_SIG_SND, 0, RME_INIT_SIG_RING, 0x9A, 0xBC);
+        RME_Init_Check("Sig_Snd full", (Retval==RME_ERR_SIV_FULL)?0:-1);
+        /* Do a batch on our own stack: find some kernel memory, delegate the signal
+         * endpoint to another slot, and then try a send, which cannot be batched */
+        Batch[0].Svc_Capid=(((ptr_t)RME_SVC_KMEM_FIND)<<(sizeof(ptr_t)*4))|RME_BOOT_INIT_KMEM;
+        Batch[0].Param[0]=RME_INIT_SIG_SIZE;
+        Batch[0].Param[1]=0;
+        Batch[0].Param[2]=0;
+        Batch[1].Svc_Capid=((ptr_t)RME_SVC_CAPTBL_ADD)<<(sizeof(ptr_t)*4);
+        Batch[1].Param[0]=RME_PARAM_D1(RME_BOOT_CAPTBL)|RME_PARAM_D0(RME_INIT_SIG_BATCH);
+        Batch[1].Param[1]=RME_PARAM_D1(RME_BOOT_CAPTBL)|RME_PARAM_D0(RME_INIT_SIG);
+        Batch[1].Param[2]=RME_SIG_FLAG_SND;
+        Batch[2].Svc_Capid=((ptr_t)RME_SVC_SIG_SND)<<(sizeof(ptr_t)*4);
+        Batch[2].Param[0]=RME_INIT_SIG_BATCH;
+        Batch[2].Param[1]=0;
+        Batch[2].Param[2]=0;
+        Retval=RME_CAP_OP(RME_SVC_BATCH, 0, (ptr_t)Batch, 3, 0);
+        RME_Init_Check("Batch", ((Retval==2)&&(((ret_t)Batch[0].Retval)>=0)&&(Batch[1].Retval==0)&&
+                                 (((ret_t)Batch[2].Retval)==RME_ERR_CAP_NULL))?Retval:-1);
+        RME_Init_Check("Sig_Snd batched", RME_CAP_OP(RME_SVC_SIG_SND, 0, RME_INIT_SIG_BATCH, 0, 0));
+        Retval=RME_CAP_OP(RME_SVC_BATCH, 0, ((ptr_t)Batch)+1, 1, 0);
+        RME_Init_Check("Batch unaligned", (Retval==RME_ERR_PGT_ADDR)?0:-1);
+        /* Send through a new captbl, so that the lookup is cached. Then delete that
+         * captbl and put another one in its memory, with a captbl capability where
+         * the signal endpoint was. When the first captbl is created again elsewhere,
+         * the same lookup must find the endpoint there, not the stale slot */
+        Raddr=RME_CAP_OP(RME_SVC_KMEM_FIND, RME_BOOT_INIT_KMEM, RME_INIT_CAPTBL_SIZE, 0, 0);
+        RME_Init_Check("Kmem_Find", Raddr);
+        RME_Init_Check("Captbl_Crt", RME_CAP_OP(RME_SVC_CAPTBL_CRT, RME_BOOT_CAPTBL,
+                                                RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_D0(RME_INIT_CAPTBL),
+                                                Raddr, RME_INIT_CAPTBL_NUM));
+        RME_Init_Check("Captbl_Add", RME_CAP_OP(RME_SVC_CAPTBL_ADD, 0,
+                                                RME_PARAM_D1(RME_INIT_CAPTBL)|RME_PARAM_D0(0),
+                                                RME_PARAM_D1(RME_BOOT_CAPTBL)|RME_PARAM_D0(RME_INIT_SIG),
+                                                RME_SIG_FLAG_SND));
+        RME_Init_Check("Sig_Snd 2-level", RME_CAP_OP(RME_SVC_SIG_SND, 0, RME_CAPID(RME_INIT_CAPTBL, 0), 0, 0));
+        RME_Init_Check("Sig_Snd 2-level", RME_CAP_OP(RME_SVC_SIG_SND, 0, RME_CAPID(RME_INIT_CAPTBL, 0), 0, 0));
+        RME_Init_Wait(RME_INIT_QUIE_TICKS);
+        RME_Init_Check("Captbl_Rem", RME_CAP_OP(RME_SVC_CAPTBL_REM, RME_INIT_CAPTBL, 0, 0, 0));
+        RME_Init_Check("Captbl_Del", RME_CAP_OP(RME_SVC_CAPTBL_DEL, RME_BOOT_CAPTBL, RME_INIT_CAPTBL, 0, 0));
+        RME_Init_Check("Captbl_Crt reuse", RME_CAP_OP(RME_SVC_CAPTBL_CRT, RME_BOOT_CAPTBL,
+                                                      RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_D0(RME_INIT_CAPTBL_REUSE),
+                                                      Raddr, RME_INIT_CAPTBL_NUM));
+        RME_Init_Check("Captbl_Add", RME_CAP_OP(RME_SVC_CAPTBL_ADD, 0,
+                                                RME_PARAM_D1(RME_INIT_CAPTBL_REUSE)|RME_PARAM_D0(0),
+                                                RME_PARAM_D1(RME_BOOT_CAPTBL)|RME_PARAM_D0(RME_BOOT_CAPTBL),
+                                                RME_CAPTBL_FLAG_ALL));
+        Raddr=RME_CAP_OP(RME_SVC_KMEM_FIND, RME_BOOT_INIT_KMEM, RME_INIT_CAPTBL_SIZE, 0, 0);
+        RME_Init_Check("Kmem_Find", Raddr);
+        RME_Init_Check("Captbl_Crt", RME_CAP_OP(RME_SVC_CAPTBL_CRT, RME_BOOT_CAPTBL,
+                                                RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_D0(RME_INIT_CAPTBL),
+                                                Raddr, RME_INIT_CAPTBL_NUM));
+        RME_Init_Check("Captbl_Add", RME_CAP_OP(RME_SVC_CAPTBL_ADD, 0,
+                                                RME_PARAM_D1(RME_INIT_CAPTBL)|RME_PARAM_D0(0),
+                                                RME_PARAM_D1(RME_BOOT_CAPTBL)|RME_PARAM_D0(RME_INIT_SIG),
+                                                RME_SIG_FLAG_SND));
+        RME_Init_Check("Sig_Snd 2-level recreated", RME_CAP_OP(RME_SVC_SIG_SND, 0, RME_CAPID(RME_INIT_CAPTBL, 0), 0, 0));
+        /* Create a plain endpoint and a ring endpoint, delete them, and do it again in the
+         * same memory, which must have been released by the deletions */
+        Raddr=RME_CAP_OP(RME_SVC_KMEM_FIND, RME_BOOT_INIT_KMEM, RME_INIT_SIG_SIZE, 0, 0);
+        RME_Init_Check("Kmem_Find", Raddr);
+        Next=RME_CAP_OP(RME_SVC_KMEM_FIND, RME_BOOT_INIT_KMEM, RME_INIT_SIG_SIZE, Raddr+RME_INIT_SIG_SIZE, 0);
+        RME_Init_Check("Kmem_Find", (Next>Raddr)?Next:-1);
+        for(Count=0;Count<2;Count++)
+        {
+            RME_Init_Check("Sig_Crt", RME_CAP_OP(RME_SVC_SIG_CRT, RME_BOOT_CAPTBL,
+                                                 RME_BOOT_INIT_KMEM, RME_INIT_SIG_DEL, Raddr));
+            RME_Init_Check("Sig_Ring_Crt", RME_CAP_OP(RME_SVC_SIG_RING_CRT, RME_BOOT_CAPTBL,
+                                                      RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_D0(RME_INIT_SIG_RING_DEL),
+                                                      Next, RME_INIT_SIG_RING_ORDER));
+            RME_Init_Wait(RME_INIT_QUIE_TICKS);
+            RME_Init_Check("Sig_Del", RME_CAP_OP(RME_SVC_SIG_DEL, RME_BOOT_CAPTBL, RME_INIT_SIG_DEL, 0, 0));
+            RME_Init_Check("Sig_Del ring", RME_CAP_OP(RME_SVC_SIG_DEL, RME_BOOT_CAPTBL, RME_INIT_SIG_RING_DEL, 0, 0));
+        }
+        /* Init threads cannot be freed, so they can never move to another CPU either */
+        Retval=RME_CAP_OP(RME_SVC_THD_SCHED_MIGR, 0, RME_CAPID(RME_BOOT_TBL_THD, 0), RME_CAPID(RME_BOOT_TBL_THD, 1), 0);
+        RME_Init_Check("Thd_Sched_Migr flag", (Retval==RME_ERR_CAP_FLAG)?0:-1);
+        /* We have been running all along, so we must have used some cycles */
+        Retval=__RME_LINUX_Svc((((ptr_t)RME_SVC_THD_CYCLE_GET)<<(sizeof(ptr_t)*4)), RME_CAPID(RME_BOOT_TBL_THD, 0), 0, 0, Reg_Ret);
+        RME_Init_Check("Thd_Cycle_Get", ((Retval==0)&&(Reg_Ret[2]!=0))?(ret_t)Reg_Ret[2]:-1);
+        /* Make an invocation, and then we must have used some cycles in invocations too */
+        Raddr=RME_CAP_OP(RME_SVC_KMEM_FIND, RME_BOOT_INIT_KMEM, RME_INIT_INV_SIZE, 0, 0);
+        RME_Init_Check("Kmem_Find", Raddr);
+        RME_Init_Check("Inv_Crt", RME_CAP_OP(RME_SVC_INV_CRT, RME_BOOT_CAPTBL,
+                                             RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_D0(RME_INIT_INV),
+                                             RME_BOOT_INIT_PROC, Raddr));
+        RME_Init_Check("Inv_Set", RME_CAP_OP(RME_SVC_INV_SET, 0, RME_PARAM_D0(RME_INIT_INV), (ptr_t)RME_Init_Inv,
+                                             (ptr_t)&RME_Init_Inv_Stack[RME_INIT_THD_STACK_SIZE]));
+        Retval=__RME_LINUX_Svc(((ptr_t)RME_SVC_INV_ACT)<<(sizeof(ptr_t)*4), RME_INIT_INV, 0x12, 0x34, Reg_Ret);
+        RME_Init_Check("Inv_Act", ((Retval==0)&&(Reg_Ret[0]==0x46))?0:-1);
+        Retval=__RME_LINUX_Svc((((ptr_t)RME_SVC_THD_CYCLE_GET)<<(sizeof(ptr_t)*4)), RME_CAPID(RME_BOOT_TBL_THD, 0),
+                               RME_THD_CYCLE_INV, 0, Reg_Ret);
+        RME_Init_Check("Thd_Cycle_Get invocation", ((Retval==0)&&(Reg_Ret[2]!=0))?(ret_t)Reg_Ret[2]:-1);
+        /* Create a thread on our priority, and let it block on an endpoint. Then wake
+         * it up by a send, which leaves it behind us because it is on our level. When
+         * it becomes an EDF thread, it preempts us on that level, and must find the
+         * return value of its receive intact */
+        Raddr=RME_CAP_OP(RME_SVC_KMEM_FIND, RME_BOOT_INIT_KMEM, RME_INIT_SIG_SIZE, 0, 0);
+        RME_Init_Check("Kmem_Find", Raddr);
+        Next=RME_CAP_OP(RME_SVC_KMEM_FIND, RME_BOOT_INIT_KMEM, RME_INIT_THD_SIZE, Raddr+RME_INIT_SIG_SIZE, 0);
+        RME_Init_Check("Kmem_Find", (Next>Raddr)?Next:-1);
+        RME_Init_Check("Sig_Crt", RME_CAP_OP(RME_SVC_SIG_CRT, RME_BOOT_CAPTBL,
+                                             RME_BOOT_INIT_KMEM, RME_INIT_SIG_THD, Raddr));
+        RME_Init_Check("Thd_Crt", RME_CAP_OP(RME_SVC_THD_CRT, RME_BOOT_CAPTBL,
+                                             RME_PARAM_D1(RME_BOOT_INIT_KMEM)|RME_PARAM_D0(RME_INIT_THD),
+                                             RME_PARAM_D1(RME_BOOT_INIT_PROC)|RME_PARAM_D0(RME_INIT_PRIO), Next));
+        RME_Init_Check("Thd_Sched_Bind", RME_CAP_OP(RME_SVC_THD_SCHED_BIND, RME_INIT_THD,
+                                                    RME_PARAM_D1(RME_CAPID(RME_BOOT_TBL_THD, 0))|RME_PARAM_D0(RME_CAPID_NULL),
+                                                    RME_INIT_THD, RME_INIT_PRIO));
+        RME_Init_Check("Thd_Exec_Set", RME_CAP_OP(RME_SVC_THD_EXEC_SET, RME_INIT_THD, (ptr_t)RME_Init_Thd,
+                                                  (ptr_t)&RME_Init_Thd_Stack[RME_INIT_THD_STACK_SIZE], 0));
+        RME_Init_Check("Thd_Time_Xfer", RME_CAP_OP(RME_SVC_THD_TIME_XFER, 0, RME_INIT_THD,
+                                                   RME_CAPID(RME_BOOT_TBL_THD, 0), RME_THD_INF_TIME));
+        RME_Init_Check("Thd_Swt", RME_CAP_OP(RME_SVC_THD_SWT, 0, RME_INIT_THD, 0, 0));
+        RME_Init_Check("Sig_Snd", RME_CAP_OP(RME_SVC_SIG_SND, 0, RME_INIT_SIG_THD, 0, 0));
+        RME_Init_Check("Thd_Rcv pending", (RME_Init_Thd_Rcv==0)?0:-1);
+        RME_Init_Check("Thd_Sched_EDF preempt", RME_CAP_OP(RME_SVC_THD_SCHED_EDF, 0, RME_INIT_THD,
+                                                           RME_INIT_EDF_PERIOD, RME_INIT_EDF_BUDGET));
+        RME_Init_Check("Thd_Rcv", (RME_Init_Thd_Rcv==RME_INIT_RCV_WAKE)?0:-1);
+        /* It has given its time back by now. When we give it some again, it preempts
+         * us and moves itself to CPU 1, and we must find the return value of our
+         * transfer intact */
+        Retval=RME_CAP_OP(RME_SVC_THD_TIME_XFER, 0, RME_INIT_THD, RME_CAPID(RME_BOOT_TBL_THD, 0), RME_THD_INF_TIME);
+        RME_Init_Check("Thd_Time_Xfer preempt", (Retval==RME_THD_INF_TIME)?Retval:-1);
+        Retval=RME_CAP_OP(RME_SVC_THD_SCHED_EDF, 0, RME_INIT_THD, 0, 0);
+        RME_Init_Check("Thd_Sched_Migr", (Retval==RME_ERR_PTH_INVSTATE)?0:-1);
+        RME_Init_Check("Cap cache hits", RME_CAP_OP(RME_SVC_KERN, RME_BOOT_INIT_KERN,
+                                                    RME_PARAM_D1(0)|RME_PARAM_D0(RME_KERN_PERF_CAP_CACHE), 0, 0));
+
+        /* Make sure that the ticks are coming. We are an EDF thread meanwhile, so the
+         * periods begin on the ticks too; init threads have infinite budget anyway */
+        RME_Init_Check("Thd_Sched_EDF", RME_CAP_OP(RME_SVC_THD_SCHED_EDF, 0, RME_CAPID(RME_BOOT_TBL_THD, 0),
+                                                   RME_INIT_EDF_PERIOD, RME_INIT_EDF_BUDGET));
+        for(Count=0;Count<RME_INIT_TICKS;Count++)
+            RME_CAP_OP(RME_SVC_KERN, RME_BOOT_INIT_KERN, RME_PARAM_D0(RME_KERN_IDLE_SLEEP), 0, 0);
+        RME_Init_Check("Thd_Sched_EDF", RME_CAP_OP(RME_SVC_THD_SCHED_EDF, 0, RME_CAPID(RME_BOOT_TBL_THD, 0), 0, 0));
+
+        RME_Init_Print_S("\r\nAll tests passed.\r\n");
+        exit(EXIT_SUCCESS);
+    }
+
+    while(1)
+        RME_CAP_OP(RME_SVC_KERN, RME_BOOT_INIT_KERN, RME_PARAM_D0(RME_KERN_IDLE_SLEEP), 0, 0);
+}
+/* End Function:RME_Init *****************************************************/
+
+/* End Of File ***************************************************************/
+
+/* Copyright (C) Evo-Devo Instrum. All rights reserved ***********************/